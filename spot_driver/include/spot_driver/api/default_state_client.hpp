@@ -3,6 +3,7 @@
 #pragma once
 
 #include <bosdyn/client/robot_state/robot_state_client.h>
+#include <future>
 #include <spot_driver/api/state_client_interface.hpp>
 #include <string>
 #include <tl_expected/expected.hpp>
@@ -26,6 +27,13 @@ class DefaultStateClient final : public StateClientInterface {
    */
   [[nodiscard]] tl::expected<bosdyn::api::RobotState, std::string> getRobotState() override;
 
+  /**
+   * @brief Send a request for Spot's most recent robot state data and return without waiting for the response.
+   * @return Returns a future which resolves to a RobotState message if the request was completed successfully or an
+   * error message if the request could not be completed.
+   */
+  [[nodiscard]] std::future<tl::expected<bosdyn::api::RobotState, std::string>> getRobotStateAsync() override;
+
  private:
   /** @brief A pointer to a RobotStateClient provided to this class during construction. */
   ::bosdyn::client::RobotStateClient* client_;
@@ -5,6 +5,7 @@
 #include <spot_driver/api/world_object_client_interface.hpp>
 
 #include <bosdyn/client/world_objects/world_object_client.h>
+#include <future>
 #include <memory>
 #include <string>
 #include <tl_expected/expected.hpp>
@@ -22,6 +23,8 @@ class DefaultWorldObjectClient : public WorldObjectClientInterface {
       ::bosdyn::api::ListWorldObjectRequest& request) const override;
   tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string> mutateWorldObject(
       ::bosdyn::api::MutateWorldObjectRequest& request) const override;
+  std::future<tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>> mutateWorldObjectAsync(
+      ::bosdyn::api::MutateWorldObjectRequest& request) const override;
 
  private:
   /**
@@ -44,6 +44,15 @@ class SpotApi {
    * @return A shared_ptr to an instance of StateClientInterface which is owned by this object.
    */
   virtual std::shared_ptr<StateClientInterface> stateClientInterface() const = 0;
+  /**
+   * @brief Get a StateClientInterface that receives robot state from Spot's robot state streaming service, if it could
+   * be created.
+   * @details The streaming service requires Spot SDK and firmware version 4.0 or newer, so it is not guaranteed to
+   * exist.
+   * @return A shared_ptr to an instance of StateClientInterface which is owned by this object. If the streaming service
+   * is not available, returns a nullptr.
+   */
+  virtual std::shared_ptr<StateClientInterface> streamingStateClientInterface() const = 0;
   virtual std::shared_ptr<TimeSyncApi> timeSyncInterface() const = 0;
   [[nodiscard]] virtual std::shared_ptr<WorldObjectClientInterface> worldObjectClientInterface() const = 0;
 };
@@ -5,6 +5,7 @@
 #include <bosdyn/api/robot_state.pb.h>
 #include <tl_expected/expected.hpp>
 
+#include <future>
 #include <string>
 
 namespace spot_ros2 {
@@ -30,5 +31,24 @@ class StateClientInterface {
    * describing the failure.
    */
   virtual tl::expected<bosdyn::api::RobotState, std::string> getRobotState() = 0;
+
+  /**
+   * @brief Start a request for Spot's most recent robot state data without waiting for the response.
+   * @details The default implementation defers to getRobotState(), which then runs when the result is retrieved from
+   * the future. Clients that can issue the request without blocking should override this so that the request is
+   * already in flight by the time this function returns.
+   * @return Returns a future which resolves to the same result getRobotState() would have returned.
+   */
+  virtual std::future<tl::expected<bosdyn::api::RobotState, std::string>> getRobotStateAsync() {
+    return std::async(std::launch::deferred, [this] {
+      return getRobotState();
+    });
+  }
+
+  /**
+   * @brief Whether this client answers each request with the next state streamed by the robot.
+   * @details Such a client paces the requests itself, so they are sent without any throttling of their own.
+   */
+  [[nodiscard]] virtual bool isStreaming() const { return false; }
 };
 }  // namespace spot_ros2
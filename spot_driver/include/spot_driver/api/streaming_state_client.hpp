@@ -0,0 +1,97 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+// The robot state streaming service was added in version 4.0 of the Spot SDK. Older SDKs do not provide the client, so
+// everything in this file is only available if its header can be found.
+#if __has_include(<bosdyn/client/robot_state/robot_state_streaming_client.h>)
+#define SPOT_DRIVER_HAS_ROBOT_STATE_STREAMING 1
+
+#include <bosdyn/api/robot_state.pb.h>
+#include <bosdyn/client/robot_state/robot_state_streaming_client.h>
+#include <spot_driver/api/state_client_interface.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Overwrite the fast-changing fields of a polled robot state with those of a streamed robot state.
+ * @details The streamed joint positions, velocities and loads are matched to the polled state's joints by name, using
+ * the fixed joint order of the streaming service. Joints the stream does not report, such as arm0.hr0, are left as
+ * polled. The odom and vision transforms of the snapshot are replaced by the streamed body poses. If the stream only
+ * reports the body pose in odom, the vision transform keeps the vision_tform_odom relationship from the polled state.
+ * The stream does not report the velocity of the body, so velocity_of_body_in_odom and velocity_of_body_in_vision are
+ * left as polled, like all other fields and every other frame in the snapshot.
+ *
+ * @param polled The most recent robot state from Spot's robot state service. It is updated in place.
+ * @param streamed The most recent response from Spot's robot state streaming service.
+ */
+void mergeStreamedRobotState(bosdyn::api::RobotState& polled, const bosdyn::api::RobotStateStreamResponse& streamed);
+
+/**
+ * @brief Provides robot state at the rate of Spot's robot state streaming service.
+ * @details A background thread reads the stream continuously, so that it never falls behind, and another thread polls
+ * the full robot state at a low rate for the fields the stream does not carry, such as battery, wifi and fault states.
+ * getRobotState() waits for the next streamed response and returns the last polled robot state updated with it. Both
+ * threads are started by the first call to getRobotState().
+ */
+class StreamingStateClient final : public StateClientInterface {
+ public:
+  /**
+   * @brief constructor for StreamingStateClient.
+   *
+   * @param streaming_client A pointer to Spot's RobotStateStreamingClient. A StreamingStateClient SHOULD NOT delete
+   * this pointer since it does not take ownership.
+   * @param polled_client Provides the full robot state at a low rate.
+   */
+  StreamingStateClient(::bosdyn::client::RobotStateStreamingClient* streaming_client,
+                       const std::shared_ptr<StateClientInterface>& polled_client);
+
+  /**
+   * @brief Stops the threads that read the stream and poll the full robot state.
+   */
+  ~StreamingStateClient() override;
+
+  /**
+   * @brief Wait for the next streamed robot state, and merge it into the most recent polled robot state.
+   * @return Returns an expected which contains a RobotState message if a new streamed response arrived in time and a
+   * polled robot state is available, or an error message otherwise.
+   */
+  [[nodiscard]] tl::expected<bosdyn::api::RobotState, std::string> getRobotState() override;
+
+  [[nodiscard]] bool isStreaming() const override { return true; }
+
+ private:
+  void streamLoop();
+  void pollLoop();
+
+  /** @brief A pointer to a RobotStateStreamingClient provided to this class during construction. */
+  ::bosdyn::client::RobotStateStreamingClient* streaming_client_;
+  std::shared_ptr<StateClientInterface> polled_client_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::optional<bosdyn::api::RobotStateStreamResponse> latest_streamed_;
+  std::uint64_t streamed_count_{0};
+  std::uint64_t last_returned_count_{0};
+  std::optional<bosdyn::api::RobotState> latest_polled_;
+  std::string last_error_;
+  std::atomic_bool stop_{false};
+
+  std::once_flag threads_started_;
+  std::thread stream_thread_;
+  std::thread poll_thread_;
+};
+
+}  // namespace spot_ros2
+
+#endif  // __has_include(<bosdyn/client/robot_state/robot_state_streaming_client.h>)
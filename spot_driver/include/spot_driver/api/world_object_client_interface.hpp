@@ -4,6 +4,7 @@
 
 #include <bosdyn/api/world_object.pb.h>
 #include <bosdyn/client/world_objects/world_object_client.h>
+#include <future>
 #include <string>
 #include <tl_expected/expected.hpp>
 
@@ -26,5 +27,19 @@ class WorldObjectClientInterface {
 
   virtual tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string> mutateWorldObject(
       ::bosdyn::api::MutateWorldObjectRequest& request) const = 0;
+
+  /**
+   * @brief Start a request to mutate a world object without waiting for the response.
+   * @details The default implementation defers to mutateWorldObject(), which then runs when the result is retrieved
+   * from the future. Clients that can issue the request without blocking should override this so that the request is
+   * already in flight by the time this function returns.
+   * @return Returns a future which resolves to the same result mutateWorldObject() would have returned.
+   */
+  virtual std::future<tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>> mutateWorldObjectAsync(
+      ::bosdyn::api::MutateWorldObjectRequest& request) const {
+    return std::async(std::launch::deferred, [this, request]() mutable {
+      return mutateWorldObject(request);
+    });
+  }
 };
 }  // namespace spot_ros2
@@ -0,0 +1,60 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <functional>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace spot_ros2 {
+
+/** @brief How a frame of a FrameTreeSnapshot is published to TF. */
+struct CachedFrameName {
+  /** @brief Name of the frame in the snapshot. */
+  std::string name;
+  /** @brief ID of the frame in TF, with the prefix applied if the name in the snapshot did not already have one. */
+  std::string frame_id;
+  /** @brief If true, the transform to this frame from its parent is left out of TF. */
+  bool is_ignored;
+};
+
+/**
+ * @brief Resolves the names of the frames in Spot's FrameTreeSnapshots to TF frame IDs, remembering the result for each
+ * name.
+ * @details The same few frame names appear in every snapshot, so resolving each name only once avoids building the
+ * prefixed frame ID and checking it against the frames to ignore for every transform of every snapshot. Names are never
+ * evicted, since the robot and the world objects it tracks only ever use a limited set of them. A FrameNameCache is not
+ * thread-safe.
+ */
+class FrameNameCache {
+ public:
+  /**
+   * @brief Constructor for FrameNameCache.
+   *
+   * @param prefix The prefix to apply to all robot frame IDs. This corresponds to the name of the robot. It is expected
+   * to terminate with `/`.
+   * @param frames_to_ignore Set of frames to not include in the TF tree, in addition to the duplicates of arm_link_wr1
+   * which are always left out.
+   */
+  explicit FrameNameCache(const std::string& prefix, const std::set<std::string, std::less<>>& frames_to_ignore = {});
+
+  /**
+   * @brief Resolve the name of a frame in a FrameTreeSnapshot.
+   * @return How the frame is published to TF. The reference stays valid for the lifetime of the cache.
+   */
+  const CachedFrameName& get(const std::string& name);
+
+  /**
+   * @brief Look up a frame name which was resolved before, without resolving it.
+   * @return How the frame is published to TF, or nullptr if get() was never called with the name.
+   */
+  const CachedFrameName* find(const std::string& name) const;
+
+ private:
+  std::string prefix_;
+  std::set<std::string, std::less<>> frames_to_ignore_;
+  std::unordered_map<std::string, CachedFrameName> frame_names_;
+};
+
+}  // namespace spot_ros2
@@ -4,7 +4,9 @@
 
 #include <bosdyn/api/robot_state.pb.h>
 #include <bosdyn_api_msgs/msg/manipulator_state.hpp>
+#include <builtin_interfaces/msg/time.hpp>
 #include <functional>
+#include <geometry_msgs/msg/transform_stamped.hpp>
 #include <geometry_msgs/msg/twist_with_covariance_stamped.hpp>
 #include <geometry_msgs/msg/vector3_stamped.hpp>
 #include <map>
@@ -14,15 +16,19 @@
 #include <sensor_msgs/msg/image.hpp>
 #include <sensor_msgs/msg/joint_state.hpp>
 #include <set>
+#include <spot_driver/conversions/frame_name_cache.hpp>
 #include <spot_msgs/msg/battery_state_array.hpp>
 #include <spot_msgs/msg/behavior_fault_state.hpp>
+#include <spot_msgs/msg/compact_joint_state.hpp>
 #include <spot_msgs/msg/e_stop_state_array.hpp>
 #include <spot_msgs/msg/foot_state_array.hpp>
+#include <spot_msgs/msg/joint_name_manifest.hpp>
 #include <spot_msgs/msg/power_state.hpp>
 #include <spot_msgs/msg/system_fault_state.hpp>
 #include <spot_msgs/msg/wi_fi_state.hpp>
 #include <string>
 #include <tf2_msgs/msg/tf_message.hpp>
+#include <vector>
 
 namespace spot_ros2 {
 
@@ -91,6 +97,35 @@ std::optional<sensor_msgs::msg::JointState> getJointStates(const ::bosdyn::api::
                                                            const google::protobuf::Duration& clock_skew,
                                                            const std::string& prefix);
 
+/**
+ * @brief Get the position of a joint in the canonical joint order of CompactJointState messages, which is the order of
+ * kFriendlyJointNames.
+ *
+ * @param name Name of the joint in the Spot API.
+ * @return The index of the joint, or nullopt if the joint is not in kFriendlyJointNames.
+ */
+std::optional<std::size_t> getCanonicalJointIndex(const std::string& name);
+
+/**
+ * @brief Create a CompactJointState ROS message by parsing a RobotState message and applying a clock skew to it.
+ *
+ * @param robot_state Robot state message from Spot.
+ * @param clock_skew The clock skew reported by Spot at the timepoint when the robot state was created.
+ * @return If the robot state message contains joint state data, return a CompactJointState message containing this
+ * data in the canonical joint order. Otherwise, return nullopt.
+ */
+std::optional<spot_msgs::msg::CompactJointState> getCompactJointStates(const ::bosdyn::api::RobotState& robot_state,
+                                                                       const google::protobuf::Duration& clock_skew);
+
+/**
+ * @brief Create the JointNameManifest ROS message which names the joints of CompactJointState messages.
+ *
+ * @param prefix The prefix to apply to all robot joint names. This corresponds to the name of the robot. It is expected
+ * to terminate with `/`.
+ * @return The names of the joints in the canonical joint order, as they are named in JointState messages.
+ */
+spot_msgs::msg::JointNameManifest getJointNameManifest(const std::string& prefix);
+
 /**
  * @brief Create a ROS TFMessage by parsing a RobotState message.
  *
@@ -125,6 +160,61 @@ std::optional<tf2_msgs::msg::TFMessage> getTf(const ::bosdyn::api::FrameTreeSnap
                                               const google::protobuf::Duration& clock_skew, const std::string& prefix,
                                               const std::string& preferred_base_frame_id,
                                               const std::set<std::string, std::less<>>& frames_to_ignore = {});
+
+/**
+ * @brief Create a ROS TFMessage by parsing a RobotState message, resolving frame names through a cache.
+ * @details Produces the same message as the overload which takes a prefix, without building the frame IDs again for
+ * every robot state.
+ *
+ * @param robot_state Robot state message from Spot.
+ * @param clock_skew The clock skew reported by Spot at the timepoint when the robot state was created.
+ * @param frame_names Resolves the names of the frames in the snapshot to TF frame IDs, and remembers them for the next
+ * call.
+ * @param preferred_base_frame_id Frame ID to use as the base frame of the TF tree. Must be either "odom" or "vision".
+ * @return If the robot state message contains a FrameTreeSnapshot and robot frame data, return a TFMessage containing
+ * this data. Otherwise, return nullopt.
+ */
+std::optional<tf2_msgs::msg::TFMessage> getTf(const ::bosdyn::api::RobotState& robot_state,
+                                              const google::protobuf::Duration& clock_skew,
+                                              FrameNameCache& frame_names, const std::string& preferred_base_frame_id);
+
+/**
+ * @brief Create a ROS TFMessage by parsing a FrameTreeSnapshot message, resolving frame names through a cache.
+ * @details Produces the same message as the overload which takes a prefix and frames to ignore, without building the
+ * frame IDs and checking them against the frames to ignore again for every snapshot.
+ *
+ * @param frame_tree_snapshot Frame tree snapshot from Spot.
+ * @param timestamp_robot The robot-relative timestamp to use when assigning timestamps to the headers of the output
+ * tramsform messages.
+ * @param clock_skew The clock skew reported by Spot at the timepoint when the robot state was created.
+ * @param frame_names Resolves the names of the frames in the snapshot to TF frame IDs, and remembers them for the next
+ * call.
+ * @param preferred_base_frame_id Frame ID to use as the base frame of the TF tree. Must be either "odom" or "vision".
+ * @return If the input frame tree snapshot contains a non-zero number of entries, return a TFMessage containing
+ * this data. Otherwise, return nullopt.
+ */
+std::optional<tf2_msgs::msg::TFMessage> getTf(const ::bosdyn::api::FrameTreeSnapshot& frame_tree_snapshot,
+                                              const google::protobuf::Timestamp& timestamp_robot,
+                                              const google::protobuf::Duration& clock_skew,
+                                              FrameNameCache& frame_names, const std::string& preferred_base_frame_id);
+
+/**
+ * @brief Overwrite a list of transforms with the edges of a FrameTreeSnapshot message, in the same form as getTf().
+ * @details Transforms already in the list are reused, so that converting a snapshot with no more edges than the last
+ * one does not allocate.
+ *
+ * @param frame_tree_snapshot Frame tree snapshot from Spot.
+ * @param stamp Local timestamp to assign to the headers of the transforms.
+ * @param frame_names Resolves the names of the frames in the snapshot to TF frame IDs, and remembers them for the next
+ * call.
+ * @param preferred_base_frame_id Frame ID to use as the base frame of the TF tree. Must be either "odom" or "vision".
+ * @param transforms List of transforms to overwrite.
+ */
+void convertFrameTreeSnapshot(const ::bosdyn::api::FrameTreeSnapshot& frame_tree_snapshot,
+                              const builtin_interfaces::msg::Time& stamp, FrameNameCache& frame_names,
+                              const std::string& preferred_base_frame_id,
+                              std::vector<geometry_msgs::msg::TransformStamped>& transforms);
+
 /**
  * @brief Create an TwistWithCovarianceStamped ROS message representing Spot's body velocity by parsing a RobotState
  * message.
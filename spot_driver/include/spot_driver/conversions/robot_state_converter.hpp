@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <bosdyn/api/geometry.pb.h>
+#include <bosdyn/api/robot_state.pb.h>
+#include <google/protobuf/duration.pb.h>
+#include <spot_driver/conversions/frame_name_cache.hpp>
+#include <builtin_interfaces/msg/time.hpp>
+#include <spot_driver/types.hpp>
+
+#include <bitset>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace spot_ros2 {
+
+/** @brief Set of RobotStateOutput values, indexed by the value of each output. */
+using RobotStateOutputSet = std::bitset<kRobotStateOutputCount>;
+
+/**
+ * @brief Converts Spot's robot state to the ROS messages published by the robot state publisher. The get* functions in
+ * robot_state.hpp convert each of their messages through a RobotStateConverter too.
+ * @details The converter is meant to be reused for every robot state. It keeps the messages from the previous
+ * conversion and overwrites them in place, so that once their vectors and strings have grown to the size of a robot
+ * state, converting the next one does not allocate. Prefixed joint and frame names are computed the first time each
+ * name is seen, and the odometry twist is only converted once even if both odometry outputs are requested.
+ *
+ * A RobotStateConverter is not thread-safe.
+ */
+class RobotStateConverter {
+ public:
+  /**
+   * @brief Constructor for RobotStateConverter.
+   *
+   * @param prefix Prefix to apply to the names of joints and frames, such as the robot name followed by a slash.
+   * @param preferred_base_frame_id Full name of the frame to make the root of the TF tree.
+   * @param is_using_vision If true, odometry is expressed in the vision frame instead of the odom frame.
+   */
+  RobotStateConverter(const std::string& prefix, const std::string& preferred_base_frame_id, bool is_using_vision);
+
+  /**
+   * @brief Convert a robot state to ROS messages.
+   *
+   * @param robot_state Robot state message from Spot.
+   * @param clock_skew The clock skew reported by Spot at the timepoint when the robot state was created.
+   * @param outputs The outputs to convert.
+   * @return The converted messages. Messages of outputs which were not requested, or which could not be created from
+   * the robot state, are not set. The reference stays valid until the next call to convert().
+   */
+  const RobotStateMessages& convert(const ::bosdyn::api::RobotState& robot_state,
+                                    const google::protobuf::Duration& clock_skew, const RobotStateOutputSet& outputs);
+
+ private:
+  template <typename MessageT>
+  MessageT& acquire(std::optional<MessageT> RobotStateMessages::*field);
+
+  template <typename MessageT>
+  void release(std::optional<MessageT> RobotStateMessages::*field);
+
+  // Each of these fills the message of one output in place, and returns false without touching it if the robot state
+  // does not contain what the output is converted from.
+  bool convertBatteryStates(const ::bosdyn::api::RobotState& robot_state, const google::protobuf::Duration& clock_skew);
+  bool convertWifiState(const ::bosdyn::api::RobotState& robot_state);
+  bool convertFootState(const ::bosdyn::api::RobotState& robot_state);
+  bool convertEstopStates(const ::bosdyn::api::RobotState& robot_state, const google::protobuf::Duration& clock_skew);
+  bool convertJointStates(const ::bosdyn::api::RobotState& robot_state, const builtin_interfaces::msg::Time& stamp);
+  bool convertCompactJointStates(const ::bosdyn::api::RobotState& robot_state,
+                                 const builtin_interfaces::msg::Time& stamp);
+  bool convertTf(const ::bosdyn::api::RobotState& robot_state, const builtin_interfaces::msg::Time& stamp);
+  bool convertOdomTwist(const ::bosdyn::api::RobotState& robot_state, const builtin_interfaces::msg::Time& stamp);
+  bool convertOdom(const ::bosdyn::api::RobotState& robot_state, const builtin_interfaces::msg::Time& stamp);
+  bool convertPowerState(const ::bosdyn::api::RobotState& robot_state, const google::protobuf::Duration& clock_skew);
+  bool convertSystemFaultState(const ::bosdyn::api::RobotState& robot_state,
+                               const google::protobuf::Duration& clock_skew);
+  bool convertManipulatorState(const ::bosdyn::api::RobotState& robot_state);
+  bool convertEndEffectorForce(const ::bosdyn::api::RobotState& robot_state,
+                               const builtin_interfaces::msg::Time& stamp);
+  bool convertBehaviorFaultState(const ::bosdyn::api::RobotState& robot_state,
+                                 const google::protobuf::Duration& clock_skew);
+
+  std::string prefix_;
+  std::string preferred_base_frame_id_;
+  bool is_using_vision_;
+
+  std::string odom_frame_id_;
+  std::string body_frame_id_;
+  std::string hand_frame_id_;
+  /** @brief Map from the joint names used within the Spot API to the prefixed joint names used in the Spot driver. */
+  std::unordered_map<std::string, std::string> joint_names_;
+  /** @brief Spot API name of each joint in the joint states message, in the same order. */
+  std::vector<std::string> joint_source_names_;
+  /** @brief Map from the joint names used within the Spot API to their index in compact joint state messages. */
+  std::unordered_map<std::string, std::size_t> canonical_joint_indices_;
+  FrameNameCache frame_names_;
+
+  /** @brief Messages returned by the last call to convert(). */
+  RobotStateMessages messages_;
+  /** @brief Messages which were not set by the last conversion, kept so that their storage can be reused. */
+  RobotStateMessages spare_messages_;
+  ::bosdyn::api::SE3Pose tform_body_;
+};
+
+}  // namespace spot_ros2
@@ -0,0 +1,80 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/matx.hpp>
+#include <opencv2/core/types.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Metric grid on the ground plane that the bird's-eye view is rendered into.
+ * @details The grid is centered on the body frame origin. Image rows run from the front of the robot (+x) to the back,
+ * and image columns run from the left of the robot (+y) to the right, so "up" in the image is "forward" for the robot.
+ */
+struct GroundPlaneGrid {
+  /** @brief Size of one output pixel, in meters. */
+  double resolution;
+  /** @brief Width of the output image, in pixels. */
+  int width;
+  /** @brief Height of the output image, in pixels. */
+  int height;
+  /** @brief Height of the ground plane along the z axis of the body frame, in meters. */
+  double ground_height;
+};
+
+/** @brief Intrinsics and extrinsics of one camera that contributes to the bird's-eye view. */
+struct GroundPlaneCamera {
+  cv::Matx33d intrinsics;
+  cv::Size image_size;
+  cv::Matx44d body_tform_camera;
+};
+
+/**
+ * @brief Composites the images of several cameras into a top-down orthographic view of the ground plane.
+ * @details All projection math happens once in the constructor, which builds a remapping LUT and a blending weight map
+ * for each camera. Composing a frame then only does table lookups and a weighted blend. The output is split into row
+ * tiles that are processed in parallel.
+ */
+class BirdsEyeView {
+ public:
+  BirdsEyeView(const GroundPlaneGrid& grid, const std::vector<GroundPlaneCamera>& cameras);
+
+  /**
+   * @brief Composite a set of camera images into the bird's-eye view.
+   * @param images BGR8 images, in the same order as the cameras passed to the constructor. Empty images are skipped,
+   * and the cameras that remain are reweighted to cover the gap where possible.
+   * @return A BGR8 image of the size defined by the grid. Pixels that no camera observes are black.
+   */
+  cv::Mat compose(const std::vector<cv::Mat>& images) const;
+
+  cv::Size size() const { return size_; }
+
+  /**
+   * @brief Get the region of the output which a camera observes, which is empty if the camera does not see the ground.
+   * @param camera Index of the camera, in the order passed to the constructor.
+   */
+  const cv::Rect& observedRegion(std::size_t camera) const { return luts_.at(camera).roi; }
+
+ private:
+  /** @brief Precomputed per-camera lookup tables. */
+  struct CameraLut {
+    // Fixed-point remapping tables produced by cv::convertMaps, which are faster to sample than floating-point maps.
+    cv::Mat map1;
+    cv::Mat map2;
+    // Per-pixel blending weight of this camera. Zero wherever the camera does not observe the ground.
+    cv::Mat weights;
+    // Bounding box of the nonzero weights, used to skip cameras that do not overlap an output tile.
+    cv::Rect roi;
+  };
+
+  void composeTile(const std::vector<cv::Mat>& images, const cv::Rect& tile, cv::Mat& output) const;
+
+  cv::Size size_;
+  std::vector<CameraLut> luts_;
+};
+
+}  // namespace spot_ros2
@@ -0,0 +1,68 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <image_transport/image_transport.hpp>
+#include <image_transport/publisher.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <rclcpp/node.hpp>
+#include <rclcpp/node_interfaces/node_base_interface.hpp>
+#include <rclcpp/node_options.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/image_stitcher/birds_eye_view.hpp>
+#include <spot_driver/interfaces/logger_interface_base.hpp>
+#include <spot_driver/interfaces/tf_listener_interface_base.hpp>
+#include <string>
+#include <vector>
+
+namespace spot_ros2 {
+/**
+ * @brief Publishes a top-down view of the ground around Spot composited from its body cameras.
+ * @details Subscribes to camera/<name>/image and camera/<name>/camera_info for each configured camera and caches the
+ * latest image of each. Once intrinsics and extrinsics are known for every camera the per-camera lookup tables are
+ * built, after which a timer composes and publishes the latest images on birds_eye_view/image.
+ */
+class BirdsEyeViewNode {
+ public:
+  explicit BirdsEyeViewNode(const rclcpp::NodeOptions& options);
+
+  std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> get_node_base_interface();
+
+ private:
+  /** @brief Latest data received for one camera. */
+  struct CameraInput {
+    std::string name;
+    sensor_msgs::msg::Image::ConstSharedPtr image;
+    sensor_msgs::msg::CameraInfo::ConstSharedPtr info;
+    rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr image_subscriber;
+    rclcpp::Subscription<sensor_msgs::msg::CameraInfo>::SharedPtr info_subscriber;
+  };
+
+  void timerCallback();
+
+  /**
+   * @brief Build the per-camera lookup tables from the cached camera info and the current TF tree.
+   * @return True if every camera could be resolved and the view was built.
+   */
+  bool tryBuildView();
+
+  std::shared_ptr<rclcpp::Node> node_;
+  std::unique_ptr<TfListenerInterfaceBase> tf_listener_;
+  std::unique_ptr<LoggerInterfaceBase> logger_;
+  image_transport::ImageTransport image_transport_;
+  image_transport::Publisher publisher_;
+  rclcpp::TimerBase::SharedPtr timer_;
+
+  std::string body_frame_;
+  GroundPlaneGrid grid_;
+
+  /** @brief Protects inputs_, which is written by the subscriber callbacks and read by the timer. */
+  std::mutex inputs_mutex_;
+  std::vector<CameraInput> inputs_;
+
+  std::optional<BirdsEyeView> view_;
+};
+}  // namespace spot_ros2
@@ -5,6 +5,9 @@
 #include <message_filters/subscriber.h>
 #include <message_filters/sync_policies/approximate_time.h>
 #include <message_filters/synchronizer.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <eigen3/Eigen/Dense>
 #include <functional>
 #include <image_transport/camera_publisher.hpp>
@@ -12,6 +15,7 @@
 #include <image_transport/subscriber.hpp>
 #include <image_transport/subscriber_filter.hpp>
 #include <memory>
+#include <mutex>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/matx.hpp>
 #include <opencv2/core/types.hpp>
@@ -19,14 +23,20 @@
 #include <opencv2/stitching/detail/exposure_compensate.hpp>
 #include <opencv2/stitching/detail/seam_finders.hpp>
 #include <optional>
+#include <rclcpp/node.hpp>
 #include <rclcpp/node_interfaces/node_base_interface.hpp>
 #include <rclcpp/node_options.hpp>
+#include <rclcpp/parameter_event_handler.hpp>
+#include <rclcpp/publisher.hpp>
+#include <rclcpp/time.hpp>
 #include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/compressed_image.hpp>
 #include <sensor_msgs/msg/image.hpp>
 #include <spot_driver/interfaces/logger_interface_base.hpp>
 #include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
 #include <spot_driver/interfaces/tf_listener_interface_base.hpp>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -52,6 +62,7 @@ virtual camera intrinsics
  */
 namespace spot_ros2 {
 using Image = sensor_msgs::msg::Image;
+using CompressedImage = sensor_msgs::msg::CompressedImage;
 using CameraInfo = sensor_msgs::msg::CameraInfo;
 using Transform = geometry_msgs::msg::Transform;
 using Time = builtin_interfaces::msg::Time;
@@ -65,6 +76,11 @@ class CameraSynchronizerBase {
   virtual void registerCallback(const DualImageCallbackFn& fn) = 0;
 };
 
+/**
+ * Synchronizes the left and right camera streams. By default it subscribes to the raw left/image and right/image
+ * topics. If the compressed_input parameter is set, it subscribes to the JPEG left/compressed and right/compressed
+ * topics instead and decodes both images in parallel, optionally at a reduced scale set by input_decode_scale.
+ */
 class RclcppCameraSynchronizer : public CameraSynchronizerBase {
  public:
   explicit RclcppCameraSynchronizer(const std::shared_ptr<rclcpp::Node>& node);
@@ -74,13 +90,31 @@ class RclcppCameraSynchronizer : public CameraSynchronizerBase {
  private:
   using ApproximateTimePolicy = message_filters::sync_policies::ApproximateTime<Image, CameraInfo, Image, CameraInfo>;
   using Synchronizer = message_filters::Synchronizer<ApproximateTimePolicy>;
+  using CompressedApproximateTimePolicy =
+      message_filters::sync_policies::ApproximateTime<CompressedImage, CameraInfo, CompressedImage, CameraInfo>;
+  using CompressedSynchronizer = message_filters::Synchronizer<CompressedApproximateTimePolicy>;
+
+  void compressedCallback(const std::shared_ptr<const CompressedImage>& image_left,
+                          const std::shared_ptr<const CameraInfo>& info_left,
+                          const std::shared_ptr<const CompressedImage>& image_right,
+                          const std::shared_ptr<const CameraInfo>& info_right);
+
+  /** Factor by which compressed inputs are downscaled while decoding. One of 1, 2, 4 or 8. */
+  int decode_scale_;
+  DualImageCallbackFn callback_;
+  /** Used to warn about images which could not be decoded, at a limited rate. */
+  rclcpp::Logger logger_;
+  rclcpp::Clock::SharedPtr clock_;
 
   std::unique_ptr<Synchronizer> sync_;
+  std::unique_ptr<CompressedSynchronizer> compressed_sync_;
 
   image_transport::SubscriberFilter subscriber_image1_;
   message_filters::Subscriber<CameraInfo> subscriber_info1_;
   image_transport::SubscriberFilter subscriber_image2_;
   message_filters::Subscriber<CameraInfo> subscriber_info2_;
+  message_filters::Subscriber<CompressedImage> subscriber_compressed1_;
+  message_filters::Subscriber<CompressedImage> subscriber_compressed2_;
 };
 
 /**
@@ -97,8 +131,17 @@ class CameraHandleBase {
   virtual cv::Vec3d getPlaneNormal() const = 0;
   virtual double getPlaneDistance() const = 0;
   virtual int getRowPadding() const = 0;
+  /**
+   * Register a function that is called whenever one of the virtual camera parameters above changes at runtime.
+   */
+  virtual void registerParameterCallback(const std::function<void()>& fn) = 0;
 };
 
+/**
+ * Publishes the stitched image either raw on virtual_camera/image, or JPEG-compressed on virtual_camera/compressed if
+ * the compressed_output parameter is set. When the inputs are decoded at a reduced scale, the virtual camera
+ * intrinsics and row padding are scaled to match.
+ */
 class RclcppCameraHandle : public CameraHandleBase {
  public:
   explicit RclcppCameraHandle(const std::shared_ptr<rclcpp::Node>& node);
@@ -111,24 +154,65 @@ class RclcppCameraHandle : public CameraHandleBase {
   cv::Vec3d getPlaneNormal() const override;
   double getPlaneDistance() const override;
   int getRowPadding() const override;
+  void registerParameterCallback(const std::function<void()>& fn) override;
 
  private:
+  /**
+   * Parse the virtual camera parameters among @p parameters into the given values, leaving the others untouched.
+   * @return Whether any of the parameters was a virtual camera parameter.
+   * @throws std::exception if a virtual camera parameter has the wrong type or number of elements.
+   */
+  bool parseParameters(const std::vector<rclcpp::Parameter>& parameters, cv::Matx33d& intrinsics,
+                       cv::Vec3d& plane_normal, double& plane_distance, int& row_padding) const;
+  /** Reject parameter updates that cannot be parsed, without applying anything. */
+  rcl_interfaces::msg::SetParametersResult onSetParameters(const std::vector<rclcpp::Parameter>& parameters) const;
+  /** Apply virtual camera parameters once they have been set on this node. */
+  void onParameterEvent(const rcl_interfaces::msg::ParameterEvent& event);
+
+  std::shared_ptr<rclcpp::Node> node_;
+  rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr parameter_callback_handle_;
+  std::shared_ptr<rclcpp::ParameterEventHandler> parameter_event_handler_;
+  rclcpp::ParameterEventCallbackHandle::SharedPtr parameter_event_callback_handle_;
+  std::function<void()> parameter_changed_callback_;
   image_transport::ImageTransport image_transport_;
   image_transport::CameraPublisher camera_publisher_;
+  rclcpp::Publisher<CompressedImage>::SharedPtr compressed_publisher_;
+  rclcpp::Publisher<CameraInfo>::SharedPtr info_publisher_;
   RclcppTfBroadcasterInterface tf_broadcaster_;
   std::string body_frame_;
   std::string camera_frame_;
+  /** Protects the virtual camera parameters below, which can be changed at runtime. */
+  mutable std::mutex parameters_mutex_;
   cv::Matx33d intrinsics_;
   cv::Vec3d plane_normal_;
   double plane_distance_;
   int row_padding_;
+  /** Factor by which the input images are downscaled, which the intrinsics and row padding are scaled to match. */
+  int decode_scale_;
+  bool compressed_output_;
+  int compressed_output_quality_;
+};
+
+/**
+ * Wall time spent in each stage of MiddleCamera::stitch
+ */
+struct StitchTimings {
+  std::chrono::nanoseconds warp{0};
+  std::chrono::nanoseconds compensate{0};
+  std::chrono::nanoseconds seam{0};
+  std::chrono::nanoseconds blend{0};
 };
 
 struct MiddleCamera {
   MiddleCamera(const cv::Matx33d& virtual_intrinsics, const cv::Vec3d& plane_normal, double plane_distance,
                int row_padding, const Transform& body_tform_left, const Transform& body_tform_right,
                const CameraInfo& info_left, const CameraInfo& info_right);
-  Image::SharedPtr stitch(const std::shared_ptr<const Image>& left, const std::shared_ptr<const Image>& right);
+  /**
+   * Stitch a pair of images into the virtual camera image.
+   * @param timings If not null, filled with the time spent in each stage of the pipeline.
+   */
+  Image::SharedPtr stitch(const std::shared_ptr<const Image>& left, const std::shared_ptr<const Image>& right,
+                          StitchTimings* timings = nullptr);
   Transform getTransform();
 
  private:
@@ -136,10 +220,16 @@ struct MiddleCamera {
   cv::Matx44d body_tform_left_;
   cv::Matx44d body_tform_right_;
   cv::Matx44d body_tform_virtual_;
+  // Homographies from each input image into its ROI of the stitched image
   std::vector<cv::Matx33d> homography_;
-  // Top left corners of each image
+  // Bounding box of the pixels each image covers in the stitched image, grown to whole gain compensator blocks. Only
+  // these regions are warped, compensated, seamed and blended, which skips most of the padding rows.
+  std::vector<cv::Rect> rois_;
+  // Top left corners of each image's ROI within the stitched image
   std::vector<cv::Point> corners_;
-  // These are where the warped images/masks go. They are in vector form because later
+  // Union of the ROIs, which is the only part of the stitched image the blender has to fill
+  cv::Rect blend_roi_;
+  // These are where the warped images/masks go, cropped to their ROIs. They are in vector form because later
   // they get passed into functions that need them in vector form.
   std::vector<cv::UMat> warped_images_;
   // Warped images encoded in CV_16S and CV_32F, respectively.
@@ -149,6 +239,9 @@ struct MiddleCamera {
   std::vector<cv::UMat> warped_masks_;
   std::vector<std::pair<cv::UMat, uchar>> level_masks_;
   cv::UMat blend_mask_;
+  // Blender output covering blend_roi_
+  cv::UMat blended_;
+  // Full size stitched image. Pixels outside blend_roi_ are never written and stay black.
   cv::UMat result_;
   cv::Size result_size_;
   /* Parts of the stitching pipeline that make the images look good */
@@ -161,21 +254,70 @@ struct MiddleCamera {
   cv::detail::MultiBandBlender blender_;
 };
 
+/**
+ * Everything a MiddleCamera is built from. When any of it changes, the camera has to be rebuilt.
+ */
+struct MiddleCameraInputs {
+  cv::Matx33d intrinsics;
+  cv::Vec3d plane_normal;
+  double plane_distance;
+  int row_padding;
+  Transform body_tform_left;
+  Transform body_tform_right;
+  CameraInfo info_left;
+  CameraInfo info_right;
+};
+
 class ImageStitcher {
  public:
   ImageStitcher(std::unique_ptr<CameraSynchronizerBase> synchronizer,
                 std::unique_ptr<TfListenerInterfaceBase> tf_listener, std::unique_ptr<CameraHandleBase> camera_handle,
                 std::unique_ptr<LoggerInterfaceBase> logger);
+  ~ImageStitcher();
 
  private:
+  /** A MiddleCamera together with the inputs it was built from. */
+  struct BuiltCamera {
+    MiddleCameraInputs inputs;
+    MiddleCamera camera;
+  };
+
   void callback(const std::shared_ptr<const Image>&, const std::shared_ptr<const CameraInfo>&,
                 const std::shared_ptr<const Image>&, const std::shared_ptr<const CameraInfo>&);
 
+  /**
+   * Gather the current parameters, extrinsics and intrinsics, and queue a rebuild if they differ from those of the
+   * current camera. Runs on the stitching thread, but never waits for the rebuild itself.
+   */
+  void checkForCalibrationChange(const std::shared_ptr<const BuiltCamera>& current, const CameraInfo& info_left,
+                                 const CameraInfo& info_right);
+
+  /** Body of rebuild_thread_, which builds queued cameras and swaps them in. */
+  void rebuildLoop();
+
   std::unique_ptr<CameraSynchronizerBase> synchronizer_;
   std::unique_ptr<TfListenerInterfaceBase> tf_listener_;
   std::unique_ptr<CameraHandleBase> camera_handle_;
   std::unique_ptr<LoggerInterfaceBase> logger_;
 
-  std::optional<MiddleCamera> camera_;
+  /**
+   * The camera used for stitching. It is replaced by rebuild_thread_ and read by the stitching thread, so it must only
+   * be accessed through std::atomic_load and std::atomic_store.
+   */
+  std::shared_ptr<BuiltCamera> camera_;
+  /** The camera whose transform was last broadcast. Only used by the stitching thread. */
+  std::shared_ptr<const BuiltCamera> broadcast_camera_;
+  /** The inputs of the most recently queued rebuild, to avoid queueing the same rebuild again. */
+  std::optional<MiddleCameraInputs> requested_inputs_;
+  /** Stamp of the last time the extrinsics were checked for changes. */
+  std::optional<rclcpp::Time> last_calibration_check_;
+  /** Set by the parameter callback to force a calibration check on the next frame. */
+  std::atomic_bool parameters_changed_{false};
+
+  std::mutex rebuild_mutex_;
+  std::condition_variable rebuild_condition_;
+  std::optional<MiddleCameraInputs> pending_rebuild_;
+  bool stop_rebuild_thread_{false};
+  std::thread rebuild_thread_;
 };
 }  // namespace spot_ros2
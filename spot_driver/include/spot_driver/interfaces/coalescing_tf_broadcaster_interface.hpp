@@ -0,0 +1,71 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
+#include <spot_driver/interfaces/timer_interface_base.hpp>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace spot_ros2 {
+/**
+ * @brief Implements TfBroadcasterInterfaceBase by collecting the transforms submitted between ticks of a timer, and
+ * passing them on to another TfBroadcasterInterfaceBase in a single call per tick.
+ * @details Subscribers to /tf then receive one message per tick instead of one message per call. Transforms to the same
+ * child frame are deduplicated, keeping the transform with the latest stamp. Static and dynamic transforms are
+ * collected separately.
+ *
+ * Transforms can be submitted from any thread.
+ */
+class CoalescingTfBroadcasterInterface : public TfBroadcasterInterfaceBase {
+ public:
+  /**
+   * @brief The constructor for CoalescingTfBroadcasterInterface.
+   * @param tf_broadcaster_interface Publishes the coalesced transforms.
+   * @param timer_interface Triggers publishing the transforms collected since the previous tick.
+   * @param period Period of the timer.
+   */
+  CoalescingTfBroadcasterInterface(std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
+                                   std::unique_ptr<TimerInterfaceBase> timer_interface,
+                                   std::chrono::duration<double> period);
+
+  /**
+   * @brief Collect static transforms to be published at the next tick.
+   * @param transforms Transforms to publish as static transforms.
+   */
+  void updateStaticTransforms(const std::vector<geometry_msgs::msg::TransformStamped>& transforms) override;
+
+  /**
+   * @brief Collect dynamic transforms to be published at the next tick.
+   * @param transforms Vector of transforms to broadcast.
+   */
+  void sendDynamicTransforms(const std::vector<geometry_msgs::msg::TransformStamped>& transforms) override;
+
+ private:
+  using TransformsByChildFrame = std::map<std::string, geometry_msgs::msg::TransformStamped>;
+
+  /** @brief Add transforms to a collection, replacing transforms to the same child frame which are not newer. */
+  static void collect(const std::vector<geometry_msgs::msg::TransformStamped>& transforms,
+                      TransformsByChildFrame& collected);
+
+  /** @brief Timer callback which passes on the transforms collected since the previous tick. */
+  void flush();
+
+  std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface_;
+  std::unique_ptr<TimerInterfaceBase> timer_interface_;
+
+  /** @brief Protects the collected transforms, which are submitted from other threads than the timer's. */
+  std::mutex mutex_;
+  TransformsByChildFrame static_transforms_;
+  TransformsByChildFrame dynamic_transforms_;
+  // Reused at every tick, so that the vectors passed on keep their capacity.
+  std::vector<geometry_msgs::msg::TransformStamped> static_batch_;
+  std::vector<geometry_msgs::msg::TransformStamped> dynamic_batch_;
+};
+}  // namespace spot_ros2
@@ -40,6 +40,55 @@ class ParameterInterfaceBase {
   virtual bool getPublishDepthImages() const = 0;
   virtual bool getPublishDepthRegisteredImages() const = 0;
   virtual std::string getPreferredOdomFrame() const = 0;
+  virtual bool getAsyncRobotStatePolling() const = 0;
+  /**
+   * @brief Get the maximum rate at which robot state is requested when polling asynchronously, in Hz.
+   * @return The configured rate. A rate of zero or less sends the next request as soon as a response arrives.
+   */
+  virtual double getAsyncRobotStatePollingRate() const = 0;
+  virtual bool getStreamRobotState() const = 0;
+  /**
+   * @brief Get the maximum rate at which an output of the robot state publisher is published, in Hz.
+   * @return The configured rate. A rate of zero or less publishes the output for every robot state received.
+   */
+  virtual double getRobotStatePublishRate(RobotStateOutput output) const = 0;
+  virtual bool getPublishStatusOnChange() const = 0;
+  virtual double getStatusHeartbeatPeriod() const = 0;
+  virtual bool getPublishCompactJointStates() const = 0;
+  /**
+   * @brief Get the name of the POSIX shared memory segment the robot state is exported to.
+   * @return The configured name. An empty name disables the export.
+   */
+  virtual std::string getSharedMemoryStateName() const = 0;
+  /**
+   * @brief Get the rate at which the extrapolated pose of the body is published to TF, in Hz.
+   * @return The configured rate. A rate of zero or less disables the extrapolation.
+   */
+  virtual double getBodyTfExtrapolationRate() const = 0;
+  /** @brief Get how far past the latest robot state the pose of the body may be extrapolated, in seconds. */
+  virtual double getBodyTfExtrapolationHorizon() const = 0;
+  /**
+   * @brief Get how far a TF frame must move, in meters, before its world object in Spot's world model is updated.
+   * @details Frames which moved less are only updated before their world object would expire.
+   */
+  virtual double getWorldObjectSyncTranslationThreshold() const = 0;
+  /** @brief Get how far a TF frame must rotate, in radians, before its world object is updated. */
+  virtual double getWorldObjectSyncRotationThreshold() const = 0;
+  /**
+   * @brief Get whether world objects are synced only for the TF frames which received new transforms on /tf or
+   * /tf_static, instead of by polling every frame in the TF tree.
+   */
+  virtual bool getWorldObjectSyncOnTfUpdates() const = 0;
+  /**
+   * @brief Get the rate at which the transforms a node broadcasts to TF are coalesced into a single message, in Hz.
+   * @return The configured rate. A rate of zero or less publishes the transforms as soon as they are submitted.
+   */
+  virtual double getTfCoalescingRate() const = 0;
+  /**
+   * @brief Get the rate at which Spot is polled for new detections of fiducials and docks, in Hz.
+   * @return The configured rate. A rate of zero or less does not poll for detections.
+   */
+  virtual double getWorldObjectDetectionRate() const = 0;
   virtual std::string getSpotName() const = 0;
   virtual std::set<spot_ros2::SpotCamera> getDefaultCamerasUsed(bool has_arm) const = 0;
   virtual tl::expected<std::set<spot_ros2::SpotCamera>, std::string> getCamerasUsed(bool has_arm) const = 0;
@@ -57,6 +106,24 @@ class ParameterInterfaceBase {
   static constexpr bool kDefaultPublishDepthImages{true};
   static constexpr bool kDefaultPublishDepthRegisteredImages{true};
   static constexpr auto kDefaultPreferredOdomFrame = "odom";
+  static constexpr bool kDefaultAsyncRobotStatePolling{false};
+  // The same rate as the timer that polls robot state when not polling asynchronously.
+  static constexpr double kDefaultAsyncRobotStatePollingRate{50.0};
+  static constexpr bool kDefaultStreamRobotState{false};
+  // Every output is published for every robot state unless its rate is configured.
+  static constexpr double kDefaultRobotStatePublishRate{0.0};
+  static constexpr bool kDefaultPublishStatusOnChange{false};
+  static constexpr double kDefaultStatusHeartbeatPeriod{1.0};
+  static constexpr bool kDefaultPublishCompactJointStates{false};
+  static constexpr auto kDefaultSharedMemoryStateName = "";
+  static constexpr double kDefaultBodyTfExtrapolationRate{0.0};
+  // A few robot state periods, beyond which a constant velocity is no longer a good prediction.
+  static constexpr double kDefaultBodyTfExtrapolationHorizon{0.1};
+  static constexpr double kDefaultWorldObjectSyncTranslationThreshold{0.01};
+  static constexpr double kDefaultWorldObjectSyncRotationThreshold{0.01};
+  static constexpr bool kDefaultWorldObjectSyncOnTfUpdates{false};
+  static constexpr double kDefaultTfCoalescingRate{0.0};
+  static constexpr double kDefaultWorldObjectDetectionRate{0.0};
   static constexpr auto kDefaultCamerasUsedWithoutArm = {"frontleft", "frontright", "left", "right", "back"};
   static constexpr auto kDefaultCamerasUsedWithArm = {"frontleft", "frontright", "left", "right", "back", "hand"};
 };
@@ -35,6 +35,21 @@ class RclcppParameterInterface : public ParameterInterfaceBase {
   [[nodiscard]] bool getPublishDepthImages() const override;
   [[nodiscard]] bool getPublishDepthRegisteredImages() const override;
   [[nodiscard]] std::string getPreferredOdomFrame() const override;
+  [[nodiscard]] bool getAsyncRobotStatePolling() const override;
+  [[nodiscard]] double getAsyncRobotStatePollingRate() const override;
+  [[nodiscard]] bool getStreamRobotState() const override;
+  [[nodiscard]] double getRobotStatePublishRate(RobotStateOutput output) const override;
+  [[nodiscard]] bool getPublishStatusOnChange() const override;
+  [[nodiscard]] double getStatusHeartbeatPeriod() const override;
+  [[nodiscard]] bool getPublishCompactJointStates() const override;
+  [[nodiscard]] std::string getSharedMemoryStateName() const override;
+  [[nodiscard]] double getBodyTfExtrapolationRate() const override;
+  [[nodiscard]] double getBodyTfExtrapolationHorizon() const override;
+  [[nodiscard]] double getWorldObjectSyncTranslationThreshold() const override;
+  [[nodiscard]] double getWorldObjectSyncRotationThreshold() const override;
+  [[nodiscard]] bool getWorldObjectSyncOnTfUpdates() const override;
+  [[nodiscard]] double getTfCoalescingRate() const override;
+  [[nodiscard]] double getWorldObjectDetectionRate() const override;
   [[nodiscard]] std::string getSpotName() const override;
   [[nodiscard]] std::set<spot_ros2::SpotCamera> getDefaultCamerasUsed(const bool has_arm) const override;
   [[nodiscard]] tl::expected<std::set<spot_ros2::SpotCamera>, std::string> getCamerasUsed(
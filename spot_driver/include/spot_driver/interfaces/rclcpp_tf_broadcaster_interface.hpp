@@ -8,8 +8,8 @@
 #include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
 
 #include <memory>
-#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace spot_ros2 {
@@ -25,7 +25,11 @@ class RclcppTfBroadcasterInterface : public TfBroadcasterInterfaceBase {
   explicit RclcppTfBroadcasterInterface(const std::shared_ptr<rclcpp::Node>& node);
 
   /**
-   * @brief Add new transforms to the StaticTransformBroadcaster.
+   * @brief Add new transforms to the StaticTransformBroadcaster, or update the values of transforms it already
+   * publishes.
+   * @details Only the transforms to child frames which were never published, or whose parent frame or pose differs from
+   * the last published value by more than a small tolerance, are passed to the StaticTransformBroadcaster. Nothing is
+   * published if all transforms match their last published values.
    * @param transforms Transforms to publish as static transforms.
    */
   void updateStaticTransforms(const std::vector<geometry_msgs::msg::TransformStamped>& transforms) override;
@@ -45,12 +49,10 @@ class RclcppTfBroadcasterInterface : public TfBroadcasterInterfaceBase {
    * a rate.
    *
    * The StaticTransformBroadcaster internally stores the transforms it has previously published. When sendTransform()
-   * is called with a transform that has a child frame that is not represented among the existing stored transforms,
-   * it adds this transforms to the stored transform. This means that calling sendTransform() with a set of transforms
-   * that all have child frames that are already represented in the stored transforms will not update the values of any
-   * of the stored transforms and will only republish the prior values of all stored transforms.
+   * is called, each transform replaces the stored transform with the same child frame, or is added to the stored
+   * transforms if there is none, and then all stored transforms are republished in a single message.
    *
-   * These characteristics mean that we should only call sendTransform() with never-before-published transforms, to
+   * These characteristics mean that we should only call sendTransform() with transforms that are new or changed, to
    * minimize unnecessary calls to publish onto the /tf_static topic.
    */
   tf2_ros::StaticTransformBroadcaster static_tf_broadcaster_;
@@ -58,10 +60,14 @@ class RclcppTfBroadcasterInterface : public TfBroadcasterInterfaceBase {
   tf2_ros::TransformBroadcaster dynamic_tf_broadcaster_;
 
   /**
-   * @brief Tracks transforms which are currently being broadcast through the static transform broadcaster.
+   * @brief Last published value of each transform currently being broadcast through the static transform broadcaster,
+   * keyed by child frame.
    * @details This is used to check if any transforms passed into updateStaticTransforms() are being published for the
-   * very first time.
+   * very first time, or have changed since they were last published.
    */
-  std::set<std::string> current_static_child_frames_;
+  std::unordered_map<std::string, geometry_msgs::msg::TransformStamped> current_static_transforms_;
+
+  /** @brief New or changed static transforms to publish, reused between calls to updateStaticTransforms(). */
+  std::vector<geometry_msgs::msg::TransformStamped> static_transforms_to_publish_;
 };
 }  // namespace spot_ros2
@@ -3,14 +3,19 @@
 #pragma once
 
 #include <tf2_ros/buffer.h>
-#include <tf2_ros/transform_listener.h>
 #include <rclcpp/duration.hpp>
 #include <rclcpp/node.hpp>
 #include <spot_driver/interfaces/tf_listener_interface_base.hpp>
+#include <tf2_msgs/msg/tf_message.hpp>
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace spot_ros2 {
@@ -22,10 +27,10 @@ class RclcppTfListenerInterface : public TfListenerInterfaceBase {
  public:
   /**
    * @brief The constructor for RclcppTfListenerInterface.
-   * @details When creating the TF listener, we use the version of its constructor that takes an existing node, and we
-   * set that the listener should use an existing executor when monitoring TF data instead of creating its own. This
-   * makes the executor which the node is assigned to responsible for handling the TF subscriber callbacks and prevents
-   * the TF listener from creating its own internal node.
+   * @details Instead of creating a tf2_ros::TransformListener, this class subscribes to /tf and /tf_static itself with
+   * the same QoS, so that the same subscriptions can also record which frames receive new transforms. The executor
+   * which the node is assigned to is responsible for handling the TF subscriber callbacks, so no internal node or
+   * thread is created.
    * @param node A shared_ptr to a rclcpp node. RclcppTfListenerInterface shares ownership of the shared_ptr.
    */
   explicit RclcppTfListenerInterface(const std::shared_ptr<rclcpp::Node>& node);
@@ -49,8 +54,56 @@ class RclcppTfListenerInterface : public TfListenerInterfaceBase {
   tl::expected<geometry_msgs::msg::TransformStamped, std::string> lookupTransform(
       const std::string& parent, const std::string& child, const rclcpp::Time& timepoint) const override;
 
+  /**
+   * @brief Look up the transforms from a parent frame to several child frames at the same timepoint, in the same
+   * convention as lookupTransform().
+   * @details At a nonzero timepoint, every transform of a chain is interpolated at that same time, so a chain can be
+   * split at any frame without changing the result. The transform between the parent frame and the lowest frame which
+   * all the child frames descend from is then looked up once, and each child frame is only looked up from that frame.
+   * The ancestors of each frame are known from the TF messages this interface received. With an all-zero timepoint,
+   * tf2 resolves each chain at the latest time common to all its transforms, which differs between child frames, so
+   * each child frame is looked up on its own. Child frames which cannot be looked up through the shared frame are
+   * looked up with lookupTransform(), which also provides the error message.
+   */
+  std::vector<tl::expected<geometry_msgs::msg::TransformStamped, std::string>> lookupTransforms(
+      const std::string& parent, const std::vector<std::string>& children,
+      const rclcpp::Time& timepoint) const override;
+
+  /**
+   * @brief Start recording which child frames receive new transforms in the TF messages added to the buffer.
+   */
+  void startTrackingUpdatedFrames() override;
+
+  std::map<std::string, rclcpp::Time> takeUpdatedFrames() override;
+
  private:
+  /** @brief Subscription callback which adds the transforms of a TF message to the buffer. */
+  void addTransforms(const tf2_msgs::msg::TFMessage& message, bool is_static);
+
+  /** @brief Record the child frames of a TF message as updated. */
+  void recordUpdatedFrames(const tf2_msgs::msg::TFMessage& message, bool is_static);
+
+  /**
+   * @brief Find the lowest frame which all of @p frames descend from, or which is one of them, using the parents
+   * recorded from the TF messages.
+   * @return The common ancestor, or nullopt if the frames have none or a frame is unknown.
+   */
+  std::optional<std::string> findCommonAncestor(const std::vector<std::string>& frames) const;
+
+  std::shared_ptr<rclcpp::Node> node_;
   tf2_ros::Buffer buffer_;
-  tf2_ros::TransformListener listener_;
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr tf_subscription_;
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr tf_static_subscription_;
+
+  /** @brief Set by startTrackingUpdatedFrames(), since most users of this class only look up transforms. */
+  std::atomic<bool> is_tracking_updated_frames_{false};
+  /** @brief Protects updated_frames_, which is written from subscription callbacks. */
+  std::mutex updated_frames_mutex_;
+  std::map<std::string, rclcpp::Time> updated_frames_;
+
+  /** @brief Protects parents_, which is written from subscription callbacks. */
+  mutable std::mutex parents_mutex_;
+  /** @brief The parent of each frame in the most recent transform to it. */
+  std::unordered_map<std::string, std::string> parents_;
 };
 }  // namespace spot_ros2
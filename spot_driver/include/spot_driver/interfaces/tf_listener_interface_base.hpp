@@ -7,6 +7,7 @@
 #include <rclcpp/time.hpp>
 #include <tl_expected/expected.hpp>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -42,5 +43,42 @@ class TfListenerInterfaceBase {
    */
   [[nodiscard]] virtual tl::expected<geometry_msgs::msg::TransformStamped, std::string> lookupTransform(
       const std::string& parent, const std::string& child, const rclcpp::Time& timepoint) const = 0;
+
+  /**
+   * @brief Look up the transforms from a parent frame to several child frames at the same timepoint.
+   * @details The default implementation calls lookupTransform() for each child frame. Implementations can override it
+   * to resolve the transforms which the child frames have in common only once, as long as every result stays the same
+   * as that of lookupTransform(). With an all-zero timepoint, that is the transform at the latest time for which all
+   * the transforms between the two frames are available, not the latest version of each of them.
+   * @param parent Parent frame ID.
+   * @param children Child frame IDs.
+   * @param timepoint Get transforms that are valid for this timestamp. Set an all-zero timepoint to get the latest
+   * valid transforms.
+   * @return For each child frame, in the same order, either the transform following the convention parent_tform_child
+   * or an error message.
+   */
+  [[nodiscard]] virtual std::vector<tl::expected<geometry_msgs::msg::TransformStamped, std::string>> lookupTransforms(
+      const std::string& parent, const std::vector<std::string>& children, const rclcpp::Time& timepoint) const {
+    std::vector<tl::expected<geometry_msgs::msg::TransformStamped, std::string>> transforms;
+    transforms.reserve(children.size());
+    for (const auto& child : children) {
+      transforms.push_back(lookupTransform(parent, child, timepoint));
+    }
+    return transforms;
+  }
+
+  /**
+   * @brief Start recording which child frames receive new transforms, to be retrieved with takeUpdatedFrames().
+   */
+  virtual void startTrackingUpdatedFrames() = 0;
+
+  /**
+   * @brief Get the child frames which received new transforms since the previous call, and clear them.
+   * @details Several transforms to the same child frame are coalesced into one entry with the latest stamp. Static
+   * transforms are valid at any time, so their frames are reported with an all-zero stamp.
+   * @return A map from child frame ID to the stamp at which to look up the frame. Empty unless
+   * startTrackingUpdatedFrames() was called.
+   */
+  [[nodiscard]] virtual std::map<std::string, rclcpp::Time> takeUpdatedFrames() = 0;
 };
 }  // namespace spot_ros2
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <set>
+#include <spot_driver/conversions/frame_name_cache.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace spot_ros2 {
+
+/** @brief Classes of frames which ObjectSynchronizer treats differently. A frame may belong to several classes. */
+enum class FrameClass {
+  /** @brief Frames internal to Spot, such as the links of the robot and its cameras. */
+  INTERNAL,
+  /** @brief Frames of world objects which ObjectSynchronizer must not modify, such as fiducials and docks. */
+  NON_MUTABLE,
+  /** @brief Frames which ObjectSynchronizer added to Spot's world model. */
+  MANAGED,
+  // New classes go last, so that kFrameClassCount can be derived from the last value
+};
+
+/** @brief Number of values in FrameClass. */
+constexpr std::size_t kFrameClassCount = static_cast<std::size_t>(FrameClass::MANAGED) + 1;
+
+/**
+ * @brief Interns the names of frames, and tracks which classes each frame belongs to as a set of flags.
+ * @details Frames are identified by their name in Spot's world model, which is their TF frame ID without the robot's
+ * prefix. Names are interned by a FrameNameCache, which also tells which frames are internal to Spot, and each TF frame
+ * ID is only stripped of its prefix the first time it is seen. Checking whether a frame belongs to a class is then a
+ * hash lookup and a bit test, rather than a string copy and a search of a set of strings. Each class also keeps a list
+ * of its members, so that replacing the members of a class only touches the frames which were or become members.
+ */
+class FrameClassificationTable {
+ public:
+  /** @brief Index of an interned frame, which stays valid for the lifetime of the table. */
+  using FrameIndex = std::size_t;
+
+  /**
+   * @brief Constructor for FrameClassificationTable.
+   *
+   * @param prefix The prefix of the TF frame IDs of the robot's frames. It is expected to terminate with `/`.
+   * @param internal_frames Names of the frames internal to Spot, which become members of FrameClass::INTERNAL when they
+   * are interned, along with the frames which FrameNameCache always ignores.
+   */
+  FrameClassificationTable(const std::string& prefix, const std::set<std::string, std::less<>>& internal_frames);
+
+  /** @brief Intern the name of a frame in Spot's world model, which does not carry the prefix. */
+  FrameIndex internName(const std::string& name);
+
+  /** @brief Intern a TF frame ID, which may carry the prefix. */
+  FrameIndex internFrameId(const std::string& frame_id);
+
+  /** @brief Get the index of a frame by its name, if the name was interned. */
+  std::optional<FrameIndex> findName(const std::string& name) const;
+
+  /** @brief Get the name of an interned frame. The reference stays valid for the lifetime of the table. */
+  const std::string& getName(FrameIndex index) const;
+
+  /**
+   * @brief Get the TF frame ID of an interned frame. This is the frame ID it was first interned by, or if it was only
+   * interned by its name, the name with the prefix applied. The reference stays valid for the lifetime of the table.
+   */
+  const std::string& getFrameId(FrameIndex index) const;
+
+  /** @brief Check whether a frame belongs to a class. */
+  bool isMember(FrameIndex index, FrameClass frame_class) const;
+
+  /** @brief Add a frame to a class. */
+  void addMember(FrameIndex index, FrameClass frame_class);
+
+  /** @brief Make the given frames the only members of a class. */
+  void assignMembers(FrameClass frame_class, const std::vector<FrameIndex>& indices);
+
+  /** @brief Get the frames which belong to a class, in the order they were added. */
+  const std::vector<FrameIndex>& getMembers(FrameClass frame_class) const;
+
+ private:
+  struct Frame {
+    const CachedFrameName* cached_name;
+    // Empty until the frame is interned by a TF frame ID.
+    std::string frame_id;
+    std::bitset<kFrameClassCount> classes;
+  };
+
+  std::string prefix_;
+  FrameNameCache frame_names_;
+  // A deque never moves its elements, so references to the frame IDs stay valid as frames are interned.
+  std::deque<Frame> frames_;
+  std::unordered_map<const CachedFrameName*, FrameIndex> indices_by_name_;
+  std::unordered_map<std::string, FrameIndex> indices_by_frame_id_;
+  std::array<std::vector<FrameIndex>, kFrameClassCount> members_;
+};
+
+}  // namespace spot_ros2
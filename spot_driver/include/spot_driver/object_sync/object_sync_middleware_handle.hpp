@@ -0,0 +1,58 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <rclcpp/node.hpp>
+#include <spot_driver/object_sync/object_synchronizer.hpp>
+#include <spot_msgs/msg/world_object_array.hpp>
+#include <spot_msgs/msg/world_object_detection_array.hpp>
+#include <spot_msgs/srv/list_cached_world_objects.hpp>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Production implementation of an ObjectSynchronizer::MiddlewareHandle
+ */
+class ObjectSyncMiddlewareHandle : public ObjectSynchronizer::MiddlewareHandle {
+ public:
+  /**
+   * @brief Constructor for ObjectSyncMiddlewareHandle.
+   * @param node A shared_ptr to an instance of rclcpp::Node.
+   */
+  explicit ObjectSyncMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node);
+
+  ~ObjectSyncMiddlewareHandle() override = default;
+
+  /**
+   * @brief Publish the cached world objects, which late subscribers also receive
+   * @param world_objects Cached world objects
+   */
+  void publishWorldObjects(const spot_msgs::msg::WorldObjectArray& world_objects) override;
+
+  /**
+   * @brief Publish detections of fiducials and docks
+   * @param detections Fiducials and docks whose acquisition time advanced since they were last published
+   */
+  void publishWorldObjectDetections(const spot_msgs::msg::WorldObjectDetectionArray& detections) override;
+
+  /**
+   * @brief Create the service which lists the cached world objects
+   * @param callback Called with each request to the service
+   */
+  void createListCachedWorldObjectsService(
+      std::function<void(const std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Request>,
+                         std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Response>)>
+          callback) override;
+
+ private:
+  /** @brief Shared instance of an rclcpp node to create publishers and services */
+  std::shared_ptr<rclcpp::Node> node_;
+
+  std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::WorldObjectArray>> world_objects_publisher_;
+  std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::WorldObjectDetectionArray>> world_object_detections_publisher_;
+  std::shared_ptr<rclcpp::Service<spot_msgs::srv::ListCachedWorldObjects>> list_cached_world_objects_service_;
+};
+
+}  // namespace spot_ros2
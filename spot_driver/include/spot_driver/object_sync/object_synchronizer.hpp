@@ -2,22 +2,39 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <google/protobuf/duration.pb.h>
+#include <geometry_msgs/msg/transform.hpp>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <map>
 #include <memory>
 #include <rclcpp/node.hpp>
+#include <rclcpp/time.hpp>
+#include <mutex>
 #include <set>
+#include <spot_driver/api/middleware_handle_base.hpp>
 #include <spot_driver/api/state_client_interface.hpp>
 #include <spot_driver/api/time_sync_api.hpp>
 #include <spot_driver/api/world_object_client_interface.hpp>
+#include <spot_driver/conversions/frame_name_cache.hpp>
 #include <spot_driver/interfaces/clock_interface_base.hpp>
 #include <spot_driver/interfaces/logger_interface_base.hpp>
 #include <spot_driver/interfaces/parameter_interface_base.hpp>
 #include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
 #include <spot_driver/interfaces/tf_listener_interface_base.hpp>
 #include <spot_driver/interfaces/timer_interface_base.hpp>
+#include <spot_driver/object_sync/frame_classification_table.hpp>
+#include <spot_driver/object_sync/world_object_cache.hpp>
 #include <spot_driver/types.hpp>
+#include <spot_msgs/msg/world_object_array.hpp>
+#include <spot_msgs/msg/world_object_detection_array.hpp>
+#include <spot_msgs/srv/list_cached_world_objects.hpp>
 #include <string>
 #include <tl_expected/expected.hpp>
+#include <unordered_map>
+#include <vector>
 
 namespace spot_ros2 {
 /**
@@ -26,82 +43,206 @@ namespace spot_ros2 {
  * or managed by Spot (AprilTags, docks, etc.), add a new WorldObject to Spot's internal world model to represent this
  * object.
  *
+ * The world objects listed from Spot to publish their frames to TF are also kept in a cache, which is published on a
+ * latched topic whenever it changes, and from which a service lists world objects without sending a request to Spot.
+ *
+ * Optionally, a third timer polls Spot at a higher rate for fiducials and docks only, using a timestamp filter so that
+ * most requests return nothing, and publishes each detection with its pose as soon as Spot reports it.
  */
 class ObjectSynchronizer {
  public:
+  /**
+   * @brief A handle that enables dependency injection of ROS and rclcpp::Node operations
+   */
+  class MiddlewareHandle : public MiddlewareHandleBase {
+   public:
+    virtual ~MiddlewareHandle() = default;
+    virtual void publishWorldObjects(const spot_msgs::msg::WorldObjectArray& world_objects) = 0;
+    virtual void publishWorldObjectDetections(const spot_msgs::msg::WorldObjectDetectionArray& detections) = 0;
+    virtual void createListCachedWorldObjectsService(
+        std::function<void(const std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Request>,
+                           std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Response>)>
+            callback) = 0;
+  };
+
   /**
    * @brief Constructor for ObjectSynchronizer
    *
    * @param world_object_client_interface Queries and modifies the objects in Spot's world model.
    * @param time_sync_api Gets clock skew measurements from Spot.
+   * @param middleware_handle Publishes the cached world objects and serves listings of them.
    * @param parameter_interface Retrieves runtime configuration settings needed to connect to and communicate with Spot.
    * @param logger_interface Logs info, warning, and error messages to the middleware.
    * @param tf_listener_interface Allows performing transform lookups between frames in the TF tree.
    * @param world_object_update_timer Allows repeatedly requesting the lists of known world objects and known TF frame
    * IDs.
    * @param tf_broadcaster_timer Regularly publishes TF frames for Spot world objects.
+   * @param detection_timer Polls for detections of fiducials and docks, if enabled.
    * @param clock_interface Gets the current timestamp when looking up transforms.
    */
   ObjectSynchronizer(const std::shared_ptr<WorldObjectClientInterface>& world_object_client_interface,
                      const std::shared_ptr<TimeSyncApi>& time_sync_api,
+                     std::unique_ptr<MiddlewareHandle> middleware_handle,
                      std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                      std::unique_ptr<LoggerInterfaceBase> logger_interface,
                      std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
                      std::unique_ptr<TfListenerInterfaceBase> tf_listener_interface,
                      std::unique_ptr<TimerInterfaceBase> world_object_update_timer,
                      std::unique_ptr<TimerInterfaceBase> tf_broadcaster_timer,
+                     std::unique_ptr<TimerInterfaceBase> detection_timer,
                      std::unique_ptr<ClockInterfaceBase> clock_interface);
 
   /**
    * @brief Get the frame IDs of TF frames which have been added to Spot's world model by ObjectSynchronizer. Locks
-   * managed_frames_mutex_.
-   * @return Returns a copy of the contents of managed_frames_.
+   * frame_classes_mutex_.
+   * @return Returns the frame IDs of the members of FrameClass::MANAGED in frame_classes_, as they were added.
    */
   std::set<std::string, std::less<>> getManagedFrames() const;
 
+  /** @brief The transform to a TF frame which was last written to its world object, and when it was written. */
+  struct SyncedTransform {
+    geometry_msgs::msg::Transform transform;
+    rclcpp::Time synced_at;
+  };
+
  protected:
   /**
-   * @brief Add a frame ID to managed_frames_. Locks managed_frames_mutex_.
+   * @brief Add a frame to FrameClass::MANAGED in frame_classes_. Locks frame_classes_mutex_.
    * @details This function is marked protected because it should not be part of ObjectSynchronizer's public API, but we
    * do want to be able to manually add managed frames while testing ObjectSynchronizer.
    *
-   * @param frame_id The frame ID to add to managed_frames_.
+   * @param frame_id The TF frame ID of the frame to add.
    */
   void addManagedFrame(const std::string& frame_id);
 
- private:
   /**
-   * @brief Timer callback function triggered by world_object_update_timer_.
+   * @brief Sync the world objects of all the TF frames which should be synced.
    * @details All the work of retrieving TF and world object information and updating world objects as needed happens
-   * within this function.
+   * within this function. Requests to add or modify world objects are sent without waiting for the previous ones to
+   * complete, with at most a fixed number in flight, so a sync costs about one round trip to Spot rather than one per
+   * frame. This is not triggered by a timer, and is marked protected so that it can be called while testing
+   * ObjectSynchronizer.
    */
   void syncWorldObjects();
 
+ private:
+  /**
+   * @brief Check whether a world object was added to Spot's world model by this class. Locks frame_classes_mutex_.
+   * @param name Name of the world object, which is the name of its frame.
+   */
+  bool isManagedFrame(const std::string& name) const;
+
+  /**
+   * @brief Timer callback function triggered by world_object_update_timer_ if syncing on TF updates is enabled.
+   * @details Only syncs the frames which received new transforms since the previous call, each looked up at the stamp
+   * of its latest transform, along with managed frames whose world objects are about to expire.
+   */
+  void syncUpdatedWorldObjects();
+
+  /**
+   * @brief Add or modify the world objects of TF frames to match their transforms from the preferred base frame.
+   * @param frames Map from the ID of each frame to sync to the timepoint at which to look it up. An all-zero timepoint
+   * looks up the latest transform.
+   * @param timepoint_now The current time, which transforms are checked for staleness against.
+   */
+  void syncFrames(const std::map<std::string, rclcpp::Time>& frames, const rclcpp::Time& timepoint_now);
+
+  /**
+   * @brief Check whether the world object of a TF frame needs to be updated, because the frame moved or rotated by at
+   * least the configured thresholds since it was last updated, or because the world object is about to expire.
+   */
+  bool isSyncDue(const std::string& child_frame_id, const geometry_msgs::msg::Transform& base_tform_child,
+                 const rclcpp::Time& timepoint_now) const;
+
+  /**
+   * @brief Handle the response to a request to add or modify the world object of a TF frame. If it succeeded, the frame
+   * is added to the managed frames and the transform that was written is remembered, otherwise a warning is logged.
+   */
+  void completeMutation(const std::string& child_frame_id, const SyncedTransform& synced_transform,
+                        const tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>& response);
+
   /**
    * @brief Timer callback function triggered by tf_broadcaster_timer_.
-   * @details Lists world objects known to Spot and broadcasts TF data for all objects which were not added to Spot's
-   * world model by this class.
+   * @details Lists the world objects known to Spot which changed since the previous call, converts the TF data of those
+   * which were not added to Spot's world model by this class, and broadcasts the TF data of all the cached objects. If
+   * the cache of world objects changed, it is published as well.
    */
   void broadcastWorldObjectTransforms();
 
+  /**
+   * @brief Timer callback function triggered by detection_timer_.
+   * @details Lists the fiducials and docks acquired after the newest one seen so far, and publishes the detections of
+   * those whose acquisition time advanced, with their poses in the preferred base frame.
+   */
+  void publishWorldObjectDetections();
+
+  /**
+   * @brief Convert the contents of world_object_cache_ to ROS messages, publish them, and keep them to serve listings
+   * from.
+   * @param clock_skew Converts the acquisition times of the objects to the host's clock.
+   */
+  void publishCachedWorldObjects(const google::protobuf::Duration& clock_skew);
+
+  /**
+   * @brief Service callback which lists the cached world objects of the requested types, acquired after the requested
+   * time.
+   */
+  void listCachedWorldObjects(const std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Request> request,
+                              std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Response> response) const;
+
   std::string frame_prefix_;
   std::string preferred_base_frame_;
   std::string preferred_base_frame_with_prefix_;
+  /** @brief Resolves the frame names in the snapshots of world objects, ignoring Spot's internal frames. */
+  std::unique_ptr<FrameNameCache> frame_name_cache_;
 
-  /** @brief Protects access to managed_frames_, since it can be read and modified from multiple threads. */
-  mutable std::mutex managed_frames_mutex_;
-  /** @brief Stores the frame IDs of all TF frames which have been added to Spot's world model by this class. */
-  std::set<std::string, std::less<>> managed_frames_;
+  /** @brief Latest version of each world object, only accessed by broadcastWorldObjectTransforms(). */
+  WorldObjectCache world_object_cache_;
+  /** @brief TF frames of each cached world object which was not added by this class, keyed by object ID. */
+  std::unordered_map<std::int32_t, std::vector<geometry_msgs::msg::TransformStamped>> object_transforms_;
+  /** @brief Contents of object_transforms_ in one message, rebuilt whenever world_object_cache_ changes. */
+  std::vector<geometry_msgs::msg::TransformStamped> broadcast_transforms_;
+  /** @brief Number of successful listings of world objects, used to schedule complete listings. */
+  std::size_t world_object_listings_{0};
+  /**
+   * @brief Contents of world_object_cache_ as last published, which the service lists objects from. Protected by
+   * world_object_msgs_mutex_, since services may be called from other threads than the timers.
+   */
+  spot_msgs::msg::WorldObjectArray world_object_msgs_;
+  mutable std::mutex world_object_msgs_mutex_;
+  /** @brief Latest version of each fiducial and dock, only accessed by publishWorldObjectDetections(). */
+  WorldObjectCache detection_cache_;
+
+  /**
+   * @brief Stamp of the latest transform received by each synced TF frame, only used when syncing on TF updates. Pruned
+   * to the frames in synced_transforms_ after every sync.
+   */
+  std::map<std::string, rclcpp::Time> tf_frame_stamps_;
+  /** @brief Last transform written to the world object of each managed frame, only accessed while syncing. */
+  std::unordered_map<std::string, SyncedTransform> synced_transforms_;
+  /** @brief How far a frame must move or rotate before its world object is updated again. */
+  double sync_translation_threshold_{0.0};
+  double sync_rotation_threshold_{0.0};
+
+  /** @brief Protects access to frame_classes_, since managed frames can be read and modified from multiple threads. */
+  mutable std::mutex frame_classes_mutex_;
+  /**
+   * @brief Tracks which frames are internal to Spot, which are frames of world objects that this class must not modify,
+   * and which have been added to Spot's world model by this class.
+   */
+  std::unique_ptr<FrameClassificationTable> frame_classes_;
 
   // Interface classes to interact with Spot and the middleware.
   std::shared_ptr<WorldObjectClientInterface> world_object_client_interface_;
   std::shared_ptr<TimeSyncApi> time_sync_interface_;
+  std::unique_ptr<MiddlewareHandle> middleware_handle_;
   std::unique_ptr<ParameterInterfaceBase> parameter_interface_;
   std::unique_ptr<LoggerInterfaceBase> logger_interface_;
   std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface_;
   std::unique_ptr<TfListenerInterfaceBase> tf_listener_interface_;
   std::unique_ptr<TimerInterfaceBase> world_object_update_timer_;
   std::unique_ptr<TimerInterfaceBase> tf_broadcaster_timer_;
+  std::unique_ptr<TimerInterfaceBase> detection_timer_;
   std::unique_ptr<ClockInterfaceBase> clock_interface_;
 };
 
@@ -29,20 +29,24 @@ class ObjectSynchronizerNode {
    * @param node_base_interface Exposes the NodeBaseInterface of this class's rclcpp::Node so this class can be spun by
    * an rclcpp executor.
    * @param spot_api Connects to Spot and exposes interfaces to request data from it.
+   * @param middleware_handle Publishes the cached world objects and serves listings of them.
    * @param parameter_interface Retrieves runtime configuration settings needed to connect to and communicate with Spot.
    * @param logger_interface Logs info, warning, and error messages to the middleware.
    * @param tf_listener_interface Allows performing transform lookups between frames in the TF tree.
    * @param timer_interface Allows repeatedly requesting the lists of known world objects and known TF frame IDs.
+   * @param detection_timer Polls for detections of fiducials and docks, if enabled.
    * @param clock_interface Gets the current timestamp when looking up transforms.
    *
    */
   ObjectSynchronizerNode(std::unique_ptr<NodeInterfaceBase> node_base_interface, std::unique_ptr<SpotApi> spot_api,
+                         std::unique_ptr<ObjectSynchronizer::MiddlewareHandle> middleware_handle,
                          std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                          std::unique_ptr<LoggerInterfaceBase> logger_interface,
                          std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
                          std::unique_ptr<TfListenerInterfaceBase> tf_listener_interface,
                          std::unique_ptr<TimerInterfaceBase> world_object_update_timer,
                          std::unique_ptr<TimerInterfaceBase> tf_broadcaster_timer,
+                         std::unique_ptr<TimerInterfaceBase> detection_timer,
                          std::unique_ptr<ClockInterfaceBase> clock_interface);
 
   /**
@@ -68,20 +72,25 @@ class ObjectSynchronizerNode {
    * @brief Connect to and authenticate with Spot, and then create the ObjectSynchronizer class member.
    *
    * @param spot_api Connects to Spot and exposes interfaces to request data from it.
+   * @param middleware_handle Publishes the cached world objects and serves listings of them.
    * @param parameter_interface Retrieves runtime configuration settings needed to connect to and communicate with Spot.
    * @param logger_interface Logs info, warning, and error messages to the middleware.
    * @param tf_listener_interface Allows performing transform lookups between frames in the TF tree.
    * @param timer_interface Allows repeatedly requesting the lists of known world objects and known TF frame IDs.
+   * @param detection_timer Polls for detections of fiducials and docks, if enabled.
    * @param clock_interface Gets the current timestamp when looking up transforms.
    *
    * @throw std::runtime_error if the Spot API fails to create a connection to Spot or fails to authenticate with Spot.
    */
-  void initialize(std::unique_ptr<SpotApi> spot_api, std::unique_ptr<ParameterInterfaceBase> parameter_interface,
+  void initialize(std::unique_ptr<SpotApi> spot_api,
+                  std::unique_ptr<ObjectSynchronizer::MiddlewareHandle> middleware_handle,
+                  std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                   std::unique_ptr<LoggerInterfaceBase> logger_interface,
                   std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
                   std::unique_ptr<TfListenerInterfaceBase> tf_listener_interface,
                   std::unique_ptr<TimerInterfaceBase> world_object_update_timer,
                   std::unique_ptr<TimerInterfaceBase> tf_broadcaster_timer,
+                  std::unique_ptr<TimerInterfaceBase> detection_timer,
                   std::unique_ptr<ClockInterfaceBase> clock_interface);
 
   std::unique_ptr<NodeInterfaceBase> node_base_interface_;
@@ -0,0 +1,60 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <bosdyn/api/world_object.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Keeps the latest version of each world object listed by Spot, so that only the objects which changed since
+ * the previous listing need to be requested and processed again.
+ * @details Objects are keyed by their ID. An object counts as changed if it was not in the cache yet, or if its
+ * acquisition time advanced. Listings which are filtered by timestamp never report objects that Spot removed, so the
+ * cache should regularly be updated with a complete listing, which drops the objects that are no longer listed. A
+ * WorldObjectCache is not thread-safe.
+ */
+class WorldObjectCache {
+ public:
+  /**
+   * @brief Limit a request to the objects acquired after the newest object in the cache. A request is left unfiltered
+   * while the cache has no object with an acquisition time.
+   *
+   * @param request Request to list world objects, whose timestamp filter is set.
+   */
+  void applyTimestampFilter(::bosdyn::api::ListWorldObjectRequest& request) const;
+
+  /**
+   * @brief Merge the objects of a listing into the cache.
+   *
+   * @param response Listing of world objects from Spot.
+   * @param is_complete If true, the listing was not filtered by timestamp, and cached objects which it does not contain
+   * are removed.
+   * @return The objects which were added or whose acquisition time advanced. The pointers stay valid until the next
+   * update.
+   */
+  std::vector<const ::bosdyn::api::WorldObject*> update(const ::bosdyn::api::ListWorldObjectResponse& response,
+                                                        bool is_complete);
+
+  /** @brief Get a cached object by ID, or nullptr if it is not in the cache. */
+  const ::bosdyn::api::WorldObject* find(std::int32_t id) const;
+
+  /** @brief Get all cached objects, keyed by ID and in no particular order. */
+  const std::unordered_map<std::int32_t, ::bosdyn::api::WorldObject>& objects() const;
+
+  /** @brief Number of objects in the cache. */
+  std::size_t size() const;
+
+ private:
+  std::unordered_map<std::int32_t, ::bosdyn::api::WorldObject> objects_;
+  /** @brief Newest acquisition time of any object in the cache, which is zero while there is none. */
+  google::protobuf::Timestamp newest_acquisition_time_;
+};
+
+}  // namespace spot_ros2
@@ -0,0 +1,47 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Accumulates the round trip latency of robot state requests and the number of states published, so that the
+ * achieved publishing rate and the latency distribution can be reported periodically.
+ * @details Samples may be added from one thread while a report is produced from another.
+ */
+class PollingStatistics {
+ public:
+  PollingStatistics();
+
+  /**
+   * @brief Record the completion of one robot state request.
+   * @param latency Time between sending the request and receiving its response.
+   * @param succeeded False if the request failed.
+   */
+  void addResponse(std::chrono::nanoseconds latency, bool succeeded);
+
+  /** @brief Record that a robot state was converted and published. */
+  void addPublished();
+
+  /**
+   * @brief Summarize the samples recorded since the previous report, then start a new reporting window.
+   * @return A human-readable summary with the publishing rate and the median, 90th and 99th percentile and maximum
+   * request latency.
+   */
+  std::string report();
+
+ private:
+  std::mutex mutex_;
+  std::chrono::steady_clock::time_point window_start_;
+  std::vector<double> latencies_ms_;
+  std::size_t failures_;
+  std::size_t published_;
+};
+
+}  // namespace spot_ros2
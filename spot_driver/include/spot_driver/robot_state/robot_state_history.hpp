@@ -0,0 +1,161 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <bosdyn/api/robot_state.pb.h>
+#include <google/protobuf/duration.pb.h>
+#include <builtin_interfaces/msg/time.hpp>
+#include <geometry_msgs/msg/pose_stamped.hpp>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <sensor_msgs/msg/joint_state.hpp>
+#include <spot_driver/robot_state/robot_state_sampling.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace spot_ros2 {
+
+/** @brief Maximum number of joints in a RobotStateSample, which is the number of joints Spot with an arm has. */
+constexpr std::size_t kMaxRobotStateSampleJoints = 20;
+
+/**
+ * @brief The parts of one robot state which are kept in a RobotStateHistory.
+ * @details The sample is trivially copyable, so that it can be stored in the history without allocating and copied
+ * out of it without locking.
+ */
+struct RobotStateSample {
+  /** @brief Acquisition time of the robot state, in nanoseconds of the host's clock. */
+  std::int64_t stamp_ns{0};
+
+  /** @brief Number of joints in the sample. */
+  std::size_t joint_count{0};
+  /** @brief Identifies the name of each joint, see RobotStateHistory::getJointName(). */
+  std::array<std::uint8_t, kMaxRobotStateSampleJoints> joint_ids{};
+  std::array<double, kMaxRobotStateSampleJoints> joint_positions{};
+  std::array<double, kMaxRobotStateSampleJoints> joint_velocities{};
+  std::array<double, kMaxRobotStateSampleJoints> joint_efforts{};
+
+  /** @brief True if the robot state contained the pose of the body in the preferred odometry frame. */
+  bool has_body_pose{false};
+  /** @brief Position of the body in the preferred odometry frame, as x, y and z. */
+  std::array<double, 3> body_position{};
+  /** @brief Orientation of the body in the preferred odometry frame, as w, x, y and z. */
+  std::array<double, 4> body_rotation{1., 0., 0., 0.};
+
+  /** @brief True if the robot state contained the velocity of the body in the preferred odometry frame. */
+  bool has_body_twist{false};
+  /** @brief Linear and angular velocity of the body, expressed in the preferred odometry frame. */
+  std::array<double, 3> body_linear_velocity{};
+  std::array<double, 3> body_angular_velocity{};
+
+  /** @brief Position of the sample in the history, used to detect that its slot was reused while it was read. */
+  std::uint64_t index{0};
+};
+
+/**
+ * @brief A fixed-capacity history of recent robot states, which can be queried for the state of the robot at a time.
+ * @details Samples are stored in a ring buffer, in order of acquisition time. Each slot of the buffer is protected by a
+ * sequence counter, so that a reader copies a sample without taking a lock and retries if the writer overwrote the
+ * slot at the same time. Adding a sample never waits for readers, so queries cannot slow down the robot state
+ * publisher.
+ *
+ * add() must only be called from one thread at a time. The query functions can be called from any number of threads.
+ */
+class RobotStateHistory {
+ public:
+  /**
+   * @brief Constructor for RobotStateHistory.
+   *
+   * @param capacity Number of robot states to keep.
+   * @param prefix The prefix to apply to the names of joints and frames, such as the robot name followed by a slash.
+   * @param is_using_vision If true, the body pose is kept in the vision frame instead of the odom frame.
+   */
+  RobotStateHistory(std::size_t capacity, const std::string& prefix, bool is_using_vision);
+
+  /**
+   * @brief Add a robot state to the history.
+   * @details Robot states which were acquired no later than the newest sample in the history are ignored, as are
+   * robot states without an acquisition timestamp. Once the history is full, the oldest sample is replaced.
+   *
+   * @param robot_state Robot state message from Spot.
+   * @param clock_skew The clock skew reported by Spot at the timepoint when the robot state was created.
+   */
+  void add(const ::bosdyn::api::RobotState& robot_state, const google::protobuf::Duration& clock_skew);
+
+  /**
+   * @brief Get the state of the robot at a time, interpolated between the samples acquired just before and just after
+   * it. Joint states are interpolated linearly, and the body orientation spherically.
+   *
+   * @param stamp Time to look up, in the host's clock.
+   * @return The interpolated sample, or an error message if the time is not covered by the history.
+   */
+  tl::expected<RobotStateSample, std::string> getAt(const builtin_interfaces::msg::Time& stamp) const;
+
+  /**
+   * @brief Get the pose of the body at a time after the newest sample, predicted from the pose and velocity of the body
+   * in that sample. Times which are covered by the history are looked up as in getAt().
+   * @details The body is assumed to keep moving at its last velocity, which only holds for short horizons, so the
+   * prediction is limited to a maximum horizon past the newest sample. Joint states are those of the newest sample.
+   *
+   * @param stamp Time to predict the body pose at, in the host's clock.
+   * @param max_horizon How far past the newest sample the body pose may be predicted.
+   * @return The predicted sample, or an error message if the newest sample has no body pose or velocity, or if the time
+   * is too far past it.
+   */
+  tl::expected<RobotStateSample, std::string> getExtrapolated(const builtin_interfaces::msg::Time& stamp,
+                                                              std::chrono::duration<double> max_horizon) const;
+
+  /** @brief Get the newest sample in the history, or nullopt if it is empty. */
+  std::optional<RobotStateSample> getLatest() const;
+
+  /** @brief Get the name of a joint of a sample, as published in the robot state publisher's joint states. */
+  const std::string& getJointName(std::uint8_t joint_id) const;
+
+  /** @brief Create a JointState message from a sample. */
+  sensor_msgs::msg::JointState toJointState(const RobotStateSample& sample) const;
+
+  /** @brief Create a message with the pose of the body in the preferred odometry frame from a sample. */
+  geometry_msgs::msg::PoseStamped toBodyPose(const RobotStateSample& sample) const;
+
+  /**
+   * @brief Create a transform from the preferred odometry frame to a child frame at the body pose of a sample.
+   *
+   * @param sample Sample with a body pose.
+   * @param child_frame_id Name of the child frame, which includes the prefix.
+   */
+  geometry_msgs::msg::TransformStamped toBodyTransform(const RobotStateSample& sample,
+                                                       const std::string& child_frame_id) const;
+
+ private:
+  struct Slot {
+    /** @brief Sequence counter of the sample, see writeSequenced(). */
+    std::atomic<std::uint64_t> sequence{0};
+    RobotStateSample sample;
+  };
+
+  /** @brief Copy the sample at a position in the history. Returns false if it is no longer in the history. */
+  bool read(std::uint64_t index, RobotStateSample& sample) const;
+
+  std::size_t capacity_;
+  bool is_using_vision_;
+  std::string body_pose_frame_id_;
+  /** @brief Joint names of the Spot driver, indexed by joint ID. */
+  std::vector<std::string> joint_names_;
+  std::unique_ptr<Slot[]> slots_;
+  /** @brief Number of samples ever added. The newest sample is at index count_ - 1. */
+  std::atomic<std::uint64_t> count_{0};
+
+  // Only used by the writer.
+  JointIndexCache joint_indices_;
+  std::int64_t newest_stamp_ns_{0};
+};
+
+}  // namespace spot_ros2
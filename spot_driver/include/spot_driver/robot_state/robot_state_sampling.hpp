@@ -0,0 +1,92 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <bosdyn/api/geometry.pb.h>
+#include <bosdyn/api/robot_state.pb.h>
+#include <bosdyn/math/frame_helpers.h>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Looks up the canonical index of each joint of Spot's kinematic state, as returned by getCanonicalJointIndex().
+ * @details Spot reports its joints in the same order every time, so the index of the joint at a position is only
+ * looked up again if its name differs from that of the joint at the same position in the previous robot state.
+ */
+class JointIndexCache {
+ public:
+  /**
+   * @brief Get the canonical index of a joint.
+   *
+   * @param position Position of the joint in the joint states of the kinematic state.
+   * @param name Name of the joint in the Spot API.
+   * @return The canonical index of the joint, or nullopt if the joint is not in kFriendlyJointNames.
+   */
+  std::optional<std::size_t> get(std::size_t position, const std::string& name);
+
+ private:
+  std::vector<std::string> names_;
+  std::vector<std::optional<std::size_t>> indices_;
+};
+
+/**
+ * @brief Copy the pose of the body in the preferred odometry frame out of a kinematic state.
+ *
+ * @param kinematic_state Kinematic state from Spot.
+ * @param is_using_vision If true, get the pose in the vision frame instead of the odom frame.
+ * @param position Set to the position of the body, as x, y and z.
+ * @param rotation Set to the orientation of the body, as w, x, y and z.
+ * @return False, without setting the outputs, if the kinematic state has no body pose in the preferred frame.
+ */
+template <typename PositionT, typename RotationT>
+bool getBodyPose(const ::bosdyn::api::KinematicState& kinematic_state, const bool is_using_vision, PositionT& position,
+                 RotationT& rotation) {
+  ::bosdyn::api::SE3Pose tform_body;
+  if (!kinematic_state.has_transforms_snapshot() ||
+      !(is_using_vision ? ::bosdyn::api::GetWorldTformBody(kinematic_state.transforms_snapshot(), &tform_body)
+                        : ::bosdyn::api::GetOdomTformBody(kinematic_state.transforms_snapshot(), &tform_body))) {
+    return false;
+  }
+  position[0] = tform_body.position().x();
+  position[1] = tform_body.position().y();
+  position[2] = tform_body.position().z();
+  rotation[0] = tform_body.rotation().w();
+  rotation[1] = tform_body.rotation().x();
+  rotation[2] = tform_body.rotation().y();
+  rotation[3] = tform_body.rotation().z();
+  return true;
+}
+
+/**
+ * @brief Copy the velocity of the body in the preferred odometry frame out of a kinematic state.
+ *
+ * @param kinematic_state Kinematic state from Spot.
+ * @param is_using_vision If true, get the velocity in the vision frame instead of the odom frame.
+ * @param linear Set to the linear velocity of the body, as x, y and z.
+ * @param angular Set to the angular velocity of the body, as x, y and z.
+ * @return False, without setting the outputs, if the kinematic state has no body velocity in the preferred frame.
+ */
+template <typename LinearT, typename AngularT>
+bool getBodyVelocity(const ::bosdyn::api::KinematicState& kinematic_state, const bool is_using_vision, LinearT& linear,
+                     AngularT& angular) {
+  if (!(is_using_vision ? kinematic_state.has_velocity_of_body_in_vision()
+                        : kinematic_state.has_velocity_of_body_in_odom())) {
+    return false;
+  }
+  const auto& velocity =
+      is_using_vision ? kinematic_state.velocity_of_body_in_vision() : kinematic_state.velocity_of_body_in_odom();
+  linear[0] = velocity.linear().x();
+  linear[1] = velocity.linear().y();
+  linear[2] = velocity.linear().z();
+  angular[0] = velocity.angular().x();
+  angular[1] = velocity.angular().y();
+  angular[2] = velocity.angular().z();
+  return true;
+}
+
+}  // namespace spot_ros2
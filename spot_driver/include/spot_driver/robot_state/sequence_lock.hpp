@@ -0,0 +1,62 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+
+/**
+ * Sequence lock shared by RobotStateHistory and the shared memory robot state. This header only depends on the standard
+ * library, so that it can be used by SharedRobotStateReader.
+ */
+
+namespace spot_ros2 {
+
+/**
+ * @brief Copy a value into storage which is protected by a sequence counter.
+ * @details The counter is odd while the value is written and even again once the write is complete, so readers which
+ * copy the storage at the same time see that the counter changed and try again. Writing never waits for readers. Only
+ * one thread may write to the same storage at a time.
+ *
+ * @param sequence Sequence counter of the storage.
+ * @param storage Storage to write to.
+ * @param value Value to write. Preparing it before calling this keeps the storage unreadable for as short as possible.
+ */
+template <typename T>
+void writeSequenced(std::atomic<std::uint64_t>& sequence, T& storage, const T& value) {
+  static_assert(std::is_trivially_copyable_v<T>, "The value must be copyable with memcpy.");
+  const auto previous = sequence.load(std::memory_order_relaxed);
+  sequence.store(previous + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(&storage, &value, sizeof(T));
+  sequence.store(previous + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Try once to copy a value out of storage which is protected by a sequence counter.
+ *
+ * @param sequence Sequence counter of the storage.
+ * @param storage Storage to read from.
+ * @param value Set to the value in the storage. Only meaningful if the read succeeded.
+ * @return The sequence counter the value was read at, which is twice the number of completed writes, or nullopt if the
+ * storage was written while it was read.
+ */
+template <typename T>
+std::optional<std::uint64_t> tryReadSequenced(const std::atomic<std::uint64_t>& sequence, const T& storage, T& value) {
+  static_assert(std::is_trivially_copyable_v<T>, "The value must be copyable with memcpy.");
+  const auto before = sequence.load(std::memory_order_acquire);
+  if (before % 2 == 1) {
+    return std::nullopt;
+  }
+  std::memcpy(&value, &storage, sizeof(T));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (sequence.load(std::memory_order_relaxed) != before) {
+    return std::nullopt;
+  }
+  return before;
+}
+
+}  // namespace spot_ros2
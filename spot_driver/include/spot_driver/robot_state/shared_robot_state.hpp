@@ -0,0 +1,97 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Layout of the POSIX shared memory segment which StatePublisher exports the robot state to, when the
+ * shared_memory_state_name parameter is set. This header only depends on the standard library, so that it can be used
+ * by programs which do not use ROS. Such programs should read the segment through SharedRobotStateReader.
+ */
+
+namespace spot_ros2 {
+
+/** @brief Identifies a segment written by SharedRobotStateWriter. */
+constexpr std::uint32_t kSharedRobotStateMagic = 0x53505354;
+/** @brief Incremented whenever the layout of SharedRobotStateSegment changes. */
+constexpr std::uint32_t kSharedRobotStateVersion = 2;
+
+constexpr std::size_t kSharedRobotStateMaxJoints = 20;
+constexpr std::size_t kSharedRobotStateFeet = 4;
+constexpr std::size_t kSharedRobotStateNameLength = 32;
+
+/**
+ * @brief The robot state at one point in time, with a fixed layout.
+ * @details Joints are stored in the order of SharedRobotStateSegment::joint_names. Poses and velocities are expressed
+ * in SharedRobotStateSegment::odom_frame, which is odom or vision depending on the preferred_odom_frame parameter.
+ */
+struct SharedRobotState {
+  /** @brief Number of robot states written to the segment so far, including this one. */
+  std::uint64_t count;
+  /** @brief Acquisition time of the robot state, in nanoseconds since the epoch of the host's system clock. */
+  std::int64_t stamp_ns;
+  /** @brief Time at which the robot state was written, in nanoseconds of the host's CLOCK_MONOTONIC. */
+  std::int64_t write_time_ns;
+
+  /** @brief Nonzero for each joint which was part of the robot state. */
+  std::uint8_t joint_valid[kSharedRobotStateMaxJoints];
+  double joint_positions[kSharedRobotStateMaxJoints];
+  double joint_velocities[kSharedRobotStateMaxJoints];
+  double joint_efforts[kSharedRobotStateMaxJoints];
+
+  /** @brief Nonzero if the body pose was part of the robot state. */
+  std::uint8_t has_body_pose;
+  /** @brief Position of the body, as x, y and z. */
+  double body_position[3];
+  /** @brief Orientation of the body, as w, x, y and z. */
+  double body_rotation[4];
+
+  /** @brief Nonzero if the body velocity was part of the robot state. */
+  std::uint8_t has_body_twist;
+  double body_linear_velocity[3];
+  double body_angular_velocity[3];
+
+  /** @brief Number of feet which were part of the robot state. */
+  std::uint8_t foot_count;
+  /** @brief Contact state of each foot, as the values of bosdyn::api::FootState::Contact. */
+  std::uint8_t foot_contacts[kSharedRobotStateFeet];
+};
+
+/**
+ * @brief The contents of the shared memory segment.
+ * @details The header fields are written once when the segment is created, before the magic number. The state is
+ * protected by a sequence lock: the writer makes the sequence odd while it writes the state and even again once it is
+ * done, so readers copy the state without blocking the writer and retry if the sequence changed meanwhile.
+ */
+struct SharedRobotStateSegment {
+  std::atomic<std::uint32_t> magic;
+  std::uint32_t version;
+  /**
+   * @brief Incremented when the segment is removed, or replaced by a new segment with the same name. A reader which
+   * sees it change maps the segment with that name again, since the one it maps is no longer written.
+   */
+  std::atomic<std::uint64_t> generation;
+  std::uint32_t joint_count;
+  /** @brief Names of the joints, as in the joint states published by the state publisher but without the prefix. */
+  char joint_names[kSharedRobotStateMaxJoints][kSharedRobotStateNameLength];
+  /** @brief Name of the frame the body pose and velocity are expressed in, without the prefix. */
+  char odom_frame[kSharedRobotStateNameLength];
+
+  // The sequence and state start on their own cache line, which the writer is the only one to modify.
+  alignas(64) std::atomic<std::uint64_t> sequence;
+  SharedRobotState state;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "The sequence and generation must not use a lock that cannot be shared between processes.");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free,
+              "The magic number must not be implemented with a lock that cannot be shared between processes.");
+static_assert(std::is_trivially_copyable_v<SharedRobotState>, "The state must be copyable with memcpy.");
+static_assert(std::is_standard_layout_v<SharedRobotStateSegment>,
+              "The segment layout must be the same in all programs.");
+
+}  // namespace spot_ros2
@@ -0,0 +1,98 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <spot_driver/robot_state/shared_robot_state.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Reads the robot state which StatePublisher exports to a POSIX shared memory segment.
+ * @details This class is built into its own library, spot_shared_robot_state_reader, which does not depend on ROS or
+ * on the Spot SDK, so that real-time programs can read the robot state without deserializing ROS messages.
+ *
+ * Reading never blocks the state publisher, and read() can be called from any number of threads and processes. If the
+ * state publisher restarts, it replaces the segment with a new one and retires the old one. read() notices that the
+ * segment it maps was retired, and maps the segment with the same name again.
+ */
+class SharedRobotStateReader {
+ public:
+  /**
+   * @brief Open the shared memory segment with a name.
+   *
+   * @param name Name of the segment, as set in the shared_memory_state_name parameter of the state publisher.
+   * @return The reader, or an error message if the segment does not exist or was not written by the state publisher.
+   */
+  static tl::expected<std::unique_ptr<SharedRobotStateReader>, std::string> open(const std::string& name);
+
+  ~SharedRobotStateReader();
+
+  SharedRobotStateReader(const SharedRobotStateReader&) = delete;
+  SharedRobotStateReader& operator=(const SharedRobotStateReader&) = delete;
+
+  /**
+   * @brief Copy the latest robot state out of the segment.
+   * @details The number of attempts is bounded, so this call has a bounded duration even if it keeps overlapping with
+   * the writer.
+   *
+   * @return The latest robot state, or nullopt if none has been written yet, if it was being written on every
+   * attempt, or if the segment was retired and no new segment with the same name is ready yet.
+   */
+  std::optional<SharedRobotState> read() const;
+
+  /**
+   * @brief Names of the joints of the robot state, in the order of the joint arrays of SharedRobotState.
+   * @details These are the names of the segment which is currently mapped, so they may change when read() maps a new
+   * segment.
+   */
+  const std::vector<std::string>& getJointNames() const;
+
+  /** @brief Name of the frame the body pose and velocity are expressed in, in the segment which is mapped. */
+  const std::string& getOdomFrame() const;
+
+ private:
+  /** @brief A mapping of the segment, with the header fields copied out of it. */
+  struct Mapping {
+    ~Mapping();
+
+    const SharedRobotStateSegment* segment;
+    std::size_t size;
+    /** @brief Generation of the segment when it was mapped. */
+    std::uint64_t generation;
+    std::vector<std::string> joint_names;
+    std::string odom_frame;
+  };
+
+  static tl::expected<std::unique_ptr<Mapping>, std::string> map(const std::string& name);
+
+  SharedRobotStateReader(std::string name, std::unique_ptr<Mapping> mapping);
+
+  /**
+   * @brief Map the segment again after the mapped segment was retired.
+   *
+   * @param retired The mapping of the retired segment.
+   * @return The mapping of the new segment, or nullptr if it cannot be mapped yet.
+   */
+  const Mapping* remap(const Mapping* retired) const;
+
+  std::string name_;
+  mutable std::mutex remap_mutex_;
+  /**
+   * @brief Every mapping made by the reader. Retired mappings are kept until the reader is destroyed, since other
+   * threads may still be reading from them. There is one per restart of the state publisher.
+   */
+  mutable std::vector<std::unique_ptr<Mapping>> mappings_;
+  /** @brief The newest mapping. */
+  mutable std::atomic<const Mapping*> mapping_;
+};
+
+}  // namespace spot_ros2
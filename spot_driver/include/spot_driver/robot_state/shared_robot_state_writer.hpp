@@ -0,0 +1,64 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <bosdyn/api/robot_state.pb.h>
+#include <google/protobuf/duration.pb.h>
+#include <spot_driver/robot_state/robot_state_sampling.hpp>
+#include <spot_driver/robot_state/shared_robot_state.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace spot_ros2 {
+
+/**
+ * @brief Exports robot states to a POSIX shared memory segment, for real-time consumers outside of ROS.
+ * @details The segment is created when the writer is created and removed when it is destroyed, unless another writer
+ * replaced it in the meantime. write() never waits for readers, which copy the state with a SharedRobotStateReader. It
+ * must only be called from one thread at a time.
+ */
+class SharedRobotStateWriter {
+ public:
+  /**
+   * @brief Create the shared memory segment, replacing any segment with the same name.
+   * @details Readers of the replaced segment see it retired through its generation, and map the new segment.
+   *
+   * @param name Name of the segment, which starts with a slash, such as "/spot_robot_state".
+   * @param is_using_vision If true, the body pose and velocity are exported in the vision frame instead of the odom
+   * frame.
+   * @return The writer, or an error message if the segment could not be created.
+   */
+  static tl::expected<std::unique_ptr<SharedRobotStateWriter>, std::string> create(const std::string& name,
+                                                                                   bool is_using_vision);
+
+  ~SharedRobotStateWriter();
+
+  SharedRobotStateWriter(const SharedRobotStateWriter&) = delete;
+  SharedRobotStateWriter& operator=(const SharedRobotStateWriter&) = delete;
+
+  /**
+   * @brief Write a robot state to the segment.
+   *
+   * @param robot_state Robot state message from Spot.
+   * @param clock_skew The clock skew reported by Spot at the timepoint when the robot state was created.
+   */
+  void write(const ::bosdyn::api::RobotState& robot_state, const google::protobuf::Duration& clock_skew);
+
+ private:
+  SharedRobotStateWriter(std::string name, SharedRobotStateSegment* segment, std::uint64_t generation,
+                         bool is_using_vision);
+
+  std::string name_;
+  SharedRobotStateSegment* segment_;
+  /** @brief Generation the segment was created at. */
+  std::uint64_t generation_;
+  bool is_using_vision_;
+  /** @brief The next state to write, which is prepared before the sequence lock is taken. */
+  SharedRobotState state_{};
+  JointIndexCache joint_indices_;
+};
+
+}  // namespace spot_ros2
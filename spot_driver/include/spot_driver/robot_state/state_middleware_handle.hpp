@@ -13,11 +13,14 @@
 #include <spot_driver/types.hpp>
 #include <spot_msgs/msg/battery_state_array.hpp>
 #include <spot_msgs/msg/behavior_fault_state.hpp>
+#include <spot_msgs/msg/compact_joint_state.hpp>
 #include <spot_msgs/msg/e_stop_state_array.hpp>
 #include <spot_msgs/msg/foot_state_array.hpp>
+#include <spot_msgs/msg/joint_name_manifest.hpp>
 #include <spot_msgs/msg/power_state.hpp>
 #include <spot_msgs/msg/system_fault_state.hpp>
 #include <spot_msgs/msg/wi_fi_state.hpp>
+#include <spot_msgs/srv/get_robot_state_at_time.hpp>
 
 namespace spot_ros2 {
 
@@ -48,6 +51,23 @@ class StateMiddlewareHandle : public StatePublisher::MiddlewareHandle {
    */
   void publishRobotState(const RobotStateMessages& robot_state_msgs) override;
 
+  /**
+   * @brief Publish the names of the joints in compact joint state messages, which late subscribers also receive
+   * @details The compact joint state and manifest publishers are created by the first call, so their topics are only
+   * advertised when the compact joint states are enabled.
+   * @param manifest Names of the joints
+   */
+  void publishJointNameManifest(const spot_msgs::msg::JointNameManifest& manifest) override;
+
+  /**
+   * @brief Create the service which looks up the state of the robot at a time
+   * @param callback Called with each request to the service
+   */
+  void createGetRobotStateAtTimeService(
+      std::function<void(const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request>,
+                         std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response>)>
+          callback) override;
+
  private:
   /** @brief Shared instance of an rclcpp node to create publishers */
   std::shared_ptr<rclcpp::Node> node_;
@@ -64,6 +84,9 @@ class StateMiddlewareHandle : public StatePublisher::MiddlewareHandle {
   std::shared_ptr<rclcpp::Publisher<bosdyn_api_msgs::msg::ManipulatorState>> manipulator_state_publisher_;
   std::shared_ptr<rclcpp::Publisher<geometry_msgs::msg::Vector3Stamped>> end_effector_force_publisher_;
   std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::BehaviorFaultState>> behavior_fault_state_publisher_;
+  std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::CompactJointState>> compact_joint_state_publisher_;
+  std::shared_ptr<rclcpp::Publisher<spot_msgs::msg::JointNameManifest>> joint_name_manifest_publisher_;
+  std::shared_ptr<rclcpp::Service<spot_msgs::srv::GetRobotStateAtTime>> robot_state_at_time_service_;
 };
 
 }  // namespace spot_ros2
@@ -2,23 +2,61 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 
+#include <bosdyn/api/robot_state.pb.h>
+#include <builtin_interfaces/msg/time.hpp>
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
 #include <spot_driver/api/middleware_handle_base.hpp>
 #include <spot_driver/api/state_client_interface.hpp>
 #include <spot_driver/api/time_sync_api.hpp>
+#include <spot_driver/conversions/robot_state_converter.hpp>
 #include <spot_driver/interfaces/logger_interface_base.hpp>
 #include <spot_driver/interfaces/parameter_interface_base.hpp>
 #include <spot_driver/interfaces/tf_broadcaster_interface_base.hpp>
 #include <spot_driver/interfaces/timer_interface_base.hpp>
+#include <spot_driver/robot_state/polling_statistics.hpp>
+#include <spot_driver/robot_state/robot_state_history.hpp>
+#include <spot_driver/robot_state/shared_robot_state_writer.hpp>
 #include <spot_driver/types.hpp>
+#include <spot_msgs/msg/joint_name_manifest.hpp>
+#include <spot_msgs/srv/get_robot_state_at_time.hpp>
 
 namespace spot_ros2 {
 
 /**
  * @brief Retrieves robot state from Spot's robot state service client, converts the messages from Protobuf to ROS
  * messages, and publishes them to the appropriate topics
+ * @details By default the robot state is requested from a fixed rate timer, which waits for each response before
+ * publishing it. If asynchronous polling is enabled, a dedicated thread instead keeps one request in flight at all
+ * times and publishes each new robot state as soon as its response arrives, so a slow round trip no longer costs
+ * ticks. The timer is then only used to periodically report the achieved rate and the request latency. Asynchronous
+ * polling is always used when robot state streaming is enabled.
+ *
+ * Each output can be limited to its own rate, in which case it is only converted and published when it is due. The
+ * status outputs (estop, wifi, power, system faults and behavior faults) can additionally be published only when they
+ * change, with a heartbeat that republishes them periodically. Like all outputs, they use transient-local QoS, so late
+ * subscribers still receive the latest status.
+ *
+ * Recent robot states are kept in a RobotStateHistory, so that the joint states and body pose at a past time can be
+ * looked up in process or through a service, without another request to the robot. They can also be exported to a POSIX
+ * shared memory segment for real-time consumers outside of ROS, see SharedRobotStateReader.
+ *
+ * Optionally, a second timer publishes the pose of the body predicted up to the current time from its velocity in the
+ * latest robot state, for consumers that would otherwise have to wait for the next robot state to look up the body
+ * pose. The prediction is published to TF as a separate body_extrapolated frame, so the body frame itself only ever
+ * holds measured poses.
  */
 class StatePublisher {
  public:
@@ -29,6 +67,11 @@ class StatePublisher {
    public:
     virtual ~MiddlewareHandle() = default;
     virtual void publishRobotState(const RobotStateMessages& robot_state_msgs) = 0;
+    virtual void publishJointNameManifest(const spot_msgs::msg::JointNameManifest& manifest) = 0;
+    virtual void createGetRobotStateAtTimeService(
+        std::function<void(const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request>,
+                           std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response>)>
+            callback) = 0;
   };
 
   /**
@@ -36,7 +79,8 @@ class StatePublisher {
    * @details As opposed to other Spot Publishers, initialization takes place inside of the constructor because
    * initialization cannot fail.
    *
-   * @param state_client_interface Requests robot state information from Spot through the Spot API.
+   * @param state_client_interface Requests robot state information from Spot through the Spot API. If it streams robot
+   * state, it is polled asynchronously and as fast as it answers.
    * @param time_sync_api  Converts message timestamps which are relative to Spot's clock to be relative to the host's
    * clock.
    * @param middleware_handle Publishes robot state info to the middleware.
@@ -44,7 +88,9 @@ class StatePublisher {
    * @param logger_interface Logs error messages if requesting, processing, and publishing the robot state info does not
    * succeed.
    * @param tf_broadcaster_interface Publishes the dynamic transforms in Spot's robot state to TF.
-   * @param timer_interface Repeatedly triggers timerCallback() using the middleware's clock.
+   * @param timer_interface Repeatedly triggers timerCallback() using the middleware's clock, or reports polling
+   * statistics if asynchronous polling is enabled.
+   * @param tf_extrapolation_timer_interface Repeatedly triggers publishing the extrapolated body pose, if enabled.
    *
    */
   StatePublisher(const std::shared_ptr<StateClientInterface>& state_client_interface,
@@ -52,7 +98,19 @@ class StatePublisher {
                  std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                  std::unique_ptr<LoggerInterfaceBase> logger_interface,
                  std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
-                 std::unique_ptr<TimerInterfaceBase> timer_interface);
+                 std::unique_ptr<TimerInterfaceBase> timer_interface,
+                 std::unique_ptr<TimerInterfaceBase> tf_extrapolation_timer_interface);
+
+  /**
+   * @brief Stops the asynchronous polling thread, if it was started.
+   */
+  ~StatePublisher();
+
+  /**
+   * @brief Get the history of the robot states this publisher has received, which can be queried for the state of the
+   * robot at a time from any thread.
+   */
+  std::shared_ptr<const RobotStateHistory> getRobotStateHistory() const;
 
  private:
   /**
@@ -60,12 +118,81 @@ class StatePublisher {
    */
   void timerCallback();
 
+  /**
+   * @brief Loop run by the asynchronous polling thread. Sends the next robot state request as soon as the previous
+   * response arrives, then converts and publishes that response while the next request is in flight. Requests are not
+   * sent more often than the polling rate allows.
+   */
+  void pollingLoop();
+
+  /**
+   * @brief Publish a robot state received by the polling thread, unless it repeats the last one published.
+   */
+  void publishPolledRobotState(const bosdyn::api::RobotState& robot_state);
+
+  /**
+   * @brief Convert a robot state to ROS messages and publish them, along with its transforms.
+   */
+  void publishRobotState(const bosdyn::api::RobotState& robot_state, const google::protobuf::Duration& clock_skew);
+
+  /**
+   * @brief Timer callback which publishes the pose of the body, extrapolated from the latest robot state to the current
+   * time, to TF. Nothing is published if the latest robot state is older than the extrapolation horizon.
+   */
+  void publishExtrapolatedBodyTf();
+
+  /**
+   * @brief Service callback which looks up the joint states and body pose at the requested time in the robot state
+   * history.
+   */
+  void getRobotStateAtTime(const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request> request,
+                           std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response> response) const;
+
+  /**
+   * @brief Check whether an output should be published with the current robot state, given its configured rate. If so,
+   * schedule its next publication.
+   */
+  bool isOutputDue(RobotStateOutput output, std::chrono::steady_clock::time_point now);
+
+  /**
+   * @brief If publishing status outputs on change, check whether the source of a status output differs from when it was
+   * last published, or whether its heartbeat period has elapsed. Outputs which are not status outputs always count as
+   * changed.
+   */
+  bool hasStatusChanged(RobotStateOutput output, const bosdyn::api::RobotState& robot_state,
+                        std::chrono::steady_clock::time_point now);
+
+  /**
+   * @brief Check whether an output should be converted and published with the current robot state.
+   */
+  bool shouldPublish(RobotStateOutput output, const bosdyn::api::RobotState& robot_state,
+                     std::chrono::steady_clock::time_point now);
+
+  /**
+   * @brief Block the polling thread for the given duration, or until the publisher is destroyed.
+   */
+  void waitForRetry(std::chrono::duration<double> duration);
+
+  /**
+   * @brief Block the polling thread until the given time, or until the publisher is destroyed.
+   */
+  void waitUntil(std::chrono::steady_clock::time_point time);
+
   std::string full_odom_frame_id_;
 
   std::string frame_prefix_;
 
   bool is_using_vision_;
 
+  // Reused for every robot state, so that the messages it converts reuse the memory of the previous ones.
+  std::unique_ptr<RobotStateConverter> robot_state_converter_;
+
+  // Every robot state is added to the history, whether or not its outputs are published.
+  std::shared_ptr<RobotStateHistory> robot_state_history_;
+
+  // Exports every robot state to shared memory. Only set if the shared_memory_state_name parameter is not empty.
+  std::unique_ptr<SharedRobotStateWriter> shared_robot_state_writer_;
+
   // Interface classes to interact with Spot and the middleware.
   std::shared_ptr<StateClientInterface> state_client_interface_;
   std::shared_ptr<TimeSyncApi> time_sync_interface_;
@@ -74,5 +201,41 @@ class StatePublisher {
   std::unique_ptr<LoggerInterfaceBase> logger_interface_;
   std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface_;
   std::unique_ptr<TimerInterfaceBase> timer_interface_;
+  std::unique_ptr<TimerInterfaceBase> tf_extrapolation_timer_interface_;
+
+  // Frame the extrapolated body pose is published as, and how far it may be extrapolated.
+  std::string extrapolated_body_frame_id_;
+  std::chrono::duration<double> body_tf_extrapolation_horizon_{};
+  // Time of the last extrapolated body pose, so that the same pose is not published twice when no new robot state
+  // arrived and the clock did not advance.
+  std::optional<builtin_interfaces::msg::Time> last_extrapolated_stamp_;
+
+  /** @brief Publication schedule of one output. A zero period publishes the output for every robot state. */
+  struct OutputSchedule {
+    std::chrono::steady_clock::duration period{std::chrono::steady_clock::duration::zero()};
+    std::optional<std::chrono::steady_clock::time_point> next_due;
+    // Fingerprint of the source of a status output and the time it was last published, when publishing on change.
+    std::optional<std::size_t> fingerprint;
+    std::optional<std::chrono::steady_clock::time_point> last_published;
+  };
+  // Indexed by RobotStateOutput.
+  std::array<OutputSchedule, kRobotStateOutputCount> output_schedules_;
+
+  /** @brief Outputs which are published at all. */
+  RobotStateOutputSet enabled_outputs_;
+  bool publish_status_on_change_{false};
+  // Status outputs are republished after this period even if they did not change.
+  std::chrono::steady_clock::duration status_heartbeat_period_{};
+
+  // State of the asynchronous polling thread.
+  PollingStatistics polling_statistics_;
+  // Minimum time between two robot state requests. Zero sends the next request as soon as a response arrives.
+  std::chrono::steady_clock::duration polling_period_{std::chrono::steady_clock::duration::zero()};
+  // Acquisition time of the last robot state published by the polling thread, used to skip responses which repeat it.
+  google::protobuf::Timestamp last_acquisition_timestamp_;
+  std::mutex polling_mutex_;
+  std::condition_variable polling_condition_;
+  std::atomic_bool stop_polling_{false};
+  std::thread polling_thread_;
 };
 }  // namespace spot_ros2
@@ -34,6 +34,7 @@ class StatePublisherNode {
    * succeed.
    * @param tf_broadcaster_interface Publishes the dynamic transforms in Spot's robot state to TF.
    * @param timer_interface Repeatedly triggers timerCallback() using the middleware's clock.
+   * @param tf_extrapolation_timer_interface Repeatedly triggers publishing the extrapolated body pose, if enabled.
    *
    */
   StatePublisherNode(std::unique_ptr<NodeInterfaceBase> node_base_interface, std::unique_ptr<SpotApi> spot_api,
@@ -41,7 +42,8 @@ class StatePublisherNode {
                      std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                      std::unique_ptr<LoggerInterfaceBase> logger_interface,
                      std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
-                     std::unique_ptr<TimerInterfaceBase> timer_interface);
+                     std::unique_ptr<TimerInterfaceBase> timer_interface,
+                     std::unique_ptr<TimerInterfaceBase> tf_extrapolation_timer_interface);
 
   /**
    * @brief Constructor for StatePublisherNode.
@@ -61,6 +63,14 @@ class StatePublisherNode {
    */
   std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> get_node_base_interface();
 
+  /**
+   * @brief Returns the history of robot states received by the state publisher, which other components in the same
+   * process can query directly instead of calling the service.
+   *
+   * @return A shared_ptr to the history, or nullptr if the state publisher has not been created.
+   */
+  std::shared_ptr<const RobotStateHistory> getRobotStateHistory() const;
+
  private:
   /**
    * @brief Connect to and authenticate with Spot, and then create the StatePublisher class member.
@@ -74,6 +84,7 @@ class StatePublisherNode {
    * succeed.
    * @param tf_broadcaster_interface Publishes the dynamic transforms in Spot's robot state to TF.
    * @param timer_interface Repeatedly triggers timerCallback() using the middleware's clock.
+   * @param tf_extrapolation_timer_interface Repeatedly triggers publishing the extrapolated body pose, if enabled.
    *
    * @throw std::runtime_error if the Spot API fails to create a connection to Spot or fails to authenticate with Spot.
    */
@@ -82,7 +93,8 @@ class StatePublisherNode {
                   std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                   std::unique_ptr<LoggerInterfaceBase> logger_interface,
                   std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
-                  std::unique_ptr<TimerInterfaceBase> timer_interface);
+                  std::unique_ptr<TimerInterfaceBase> timer_interface,
+                  std::unique_ptr<TimerInterfaceBase> tf_extrapolation_timer_interface);
 
   std::unique_ptr<NodeInterfaceBase> node_base_interface_;
   std::unique_ptr<SpotApi> spot_api_;
@@ -12,6 +12,7 @@
 #include <sensor_msgs/msg/joint_state.hpp>
 #include <spot_msgs/msg/battery_state_array.hpp>
 #include <spot_msgs/msg/behavior_fault_state.hpp>
+#include <spot_msgs/msg/compact_joint_state.hpp>
 #include <spot_msgs/msg/e_stop_state_array.hpp>
 #include <spot_msgs/msg/foot_state_array.hpp>
 #include <spot_msgs/msg/power_state.hpp>
@@ -19,6 +20,7 @@
 #include <spot_msgs/msg/wi_fi_state.hpp>
 #include <tf2_msgs/msg/tf_message.hpp>
 
+#include <cstddef>
 #include <functional>
 #include <optional>
 #include <string>
@@ -84,6 +86,32 @@ struct CompressedImageWithCameraInfo {
   bool operator==(const CompressedImageWithCameraInfo& e) const { return e.image == image && e.info == info; }
 };
 
+/** @brief Represents each of the outputs that the robot state publisher produces from Spot's robot state. */
+enum class RobotStateOutput {
+  BATTERY_STATES,
+  WIFI_STATE,
+  FOOT_STATE,
+  ESTOP_STATES,
+  JOINT_STATES,
+  TF,
+  ODOM_TWIST,
+  ODOM,
+  POWER_STATE,
+  SYSTEM_FAULT_STATE,
+  MANIPULATOR_STATE,
+  END_EFFECTOR_FORCE,
+  BEHAVIOR_FAULT_STATE,
+  // New outputs go last, so that kRobotStateOutputCount can be derived from the last value
+  COMPACT_JOINT_STATES,
+};
+
+/**
+ * @brief Number of values in RobotStateOutput.
+ * @details Derived from the last value rather than from a trailing count value, which every switch over the outputs
+ * would then have to handle.
+ */
+constexpr std::size_t kRobotStateOutputCount = static_cast<std::size_t>(RobotStateOutput::COMPACT_JOINT_STATES) + 1;
+
 }  // namespace spot_ros2
 
 /**
@@ -104,13 +132,13 @@ struct std::less<spot_ros2::ImageSource> {
 
 /**
  * @brief A struct of ROS message types that define Spot's Robot State
+ * @details Each message is only set if it could be created from the robot state and its output is due to be published.
  */
 struct RobotStateMessages {
-  spot_msgs::msg::BatteryStateArray battery_states;
-  spot_msgs::msg::WiFiState wifi_state;
-  spot_msgs::msg::FootStateArray foot_state;
-  spot_msgs::msg::EStopStateArray estop_states;
-
+  std::optional<spot_msgs::msg::BatteryStateArray> maybe_battery_states;
+  std::optional<spot_msgs::msg::WiFiState> maybe_wifi_state;
+  std::optional<spot_msgs::msg::FootStateArray> maybe_foot_state;
+  std::optional<spot_msgs::msg::EStopStateArray> maybe_estop_states;
   std::optional<sensor_msgs::msg::JointState> maybe_joint_states;
   std::optional<tf2_msgs::msg::TFMessage> maybe_tf;
   std::optional<geometry_msgs::msg::TwistWithCovarianceStamped> maybe_odom_twist;
@@ -120,4 +148,5 @@ struct RobotStateMessages {
   std::optional<bosdyn_api_msgs::msg::ManipulatorState> maybe_manipulator_state;
   std::optional<geometry_msgs::msg::Vector3Stamped> maybe_end_effector_force;
   std::optional<spot_msgs::msg::BehaviorFaultState> maybe_behavior_fault_state;
+  std::optional<spot_msgs::msg::CompactJointState> maybe_compact_joint_states;
 };
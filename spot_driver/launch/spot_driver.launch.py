@@ -145,6 +145,7 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
                 "uncompress_images",
                 "publish_compressed_images",
                 "stitch_front_images",
+                "publish_birds_eye_view",
                 "spot_name",
             ]
         }.items(),
@@ -244,6 +245,16 @@ def generate_launch_description() -> launch.LaunchDescription:
             ),
         )
     )
+    launch_args.append(
+        DeclareLaunchArgument(
+            "publish_birds_eye_view",
+            default_value="False",
+            choices=["True", "true", "False", "false"],
+            description=(
+                "Choose whether to publish a top-down view of the ground around Spot composited from its body cameras."
+            ),
+        )
+    )
     launch_args.append(DeclareLaunchArgument("spot_name", default_value="", description="Name of Spot"))
 
     ld = launch.LaunchDescription(launch_args)
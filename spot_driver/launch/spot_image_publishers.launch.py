@@ -164,10 +164,20 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
     # add the image stitcher node, but only if frontleft and frontright cameras are enabled.
     if "frontleft" in camera_sources and "frontright" in camera_sources:
         virtual_camera_frame = "frontmiddle_virtual"
+        # When full decoding is turned off in the image publisher, stitch straight from the JPEG-compressed images and
+        # publish a compressed stitched image to match.
+        stitch_compressed = not IfCondition(LaunchConfiguration("uncompress_images")).evaluate(context)
+        if stitch_compressed and not IfCondition(LaunchConfiguration("publish_compressed_images")).evaluate(context):
+            print(
+                "Warning: The image stitcher uses compressed images when uncompress_images is false. Set"
+                " publish_compressed_images to true to provide them."
+            )
         stitcher_params = {
             "spot_name": spot_name,
             "body_frame": "body",
             "virtual_camera_frame": virtual_camera_frame,
+            "compressed_input": stitch_compressed,
+            "compressed_output": stitch_compressed,
         }
         cam_prefix = f"/{spot_name}" if spot_name else ""
         image_stitcher_node = launch_ros.actions.Node(
@@ -177,10 +187,13 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
             output="screen",
             remappings=[
                 (f"{cam_prefix}/left/image", f"{cam_prefix}/camera/frontleft/image"),
+                (f"{cam_prefix}/left/compressed", f"{cam_prefix}/camera/frontleft/compressed"),
                 (f"{cam_prefix}/left/camera_info", f"{cam_prefix}/camera/frontleft/camera_info"),
                 (f"{cam_prefix}/right/image", f"{cam_prefix}/camera/frontright/image"),
+                (f"{cam_prefix}/right/compressed", f"{cam_prefix}/camera/frontright/compressed"),
                 (f"{cam_prefix}/right/camera_info", f"{cam_prefix}/camera/frontright/camera_info"),
                 (f"{cam_prefix}/virtual_camera/image", f"{cam_prefix}/camera/{virtual_camera_frame}/image"),
+                (f"{cam_prefix}/virtual_camera/compressed", f"{cam_prefix}/camera/{virtual_camera_frame}/compressed"),
                 (f"{cam_prefix}/virtual_camera/camera_info", f"{cam_prefix}/camera/{virtual_camera_frame}/camera_info"),
             ],
             parameters=[config_file, stitcher_params],
@@ -188,6 +201,24 @@ def launch_setup(context: LaunchContext, ld: LaunchDescription) -> None:
         )
         ld.add_action(image_stitcher_node)
 
+    # add the bird's-eye view node, composited from whichever body cameras are enabled.
+    birds_eye_view_cameras = [
+        camera for camera in ["frontleft", "frontright", "left", "right", "back"] if camera in camera_sources
+    ]
+    if birds_eye_view_cameras:
+        birds_eye_view_node = launch_ros.actions.Node(
+            package="spot_driver",
+            executable="birds_eye_view_node",
+            namespace=spot_name,
+            output="screen",
+            parameters=[
+                config_file,
+                {"spot_name": spot_name, "body_frame": "body", "birds_eye_view_cameras": birds_eye_view_cameras},
+            ],
+            condition=IfCondition(LaunchConfiguration("publish_birds_eye_view")),
+        )
+        ld.add_action(birds_eye_view_node)
+
 
 def generate_launch_description() -> launch.LaunchDescription:
     launch_args = []
@@ -250,6 +281,16 @@ def generate_launch_description() -> launch.LaunchDescription:
             ),
         )
     )
+    launch_args.append(
+        DeclareLaunchArgument(
+            "publish_birds_eye_view",
+            default_value="False",
+            choices=["True", "true", "False", "false"],
+            description=(
+                "Choose whether to publish a top-down view of the ground around Spot composited from its body cameras."
+            ),
+        )
+    )
     launch_args.append(DeclareLaunchArgument("spot_name", default_value="", description="Name of Spot"))
 
     ld = launch.LaunchDescription(launch_args)
@@ -8,6 +8,7 @@
 #include <spot_driver/api/default_spot_api.hpp>
 #include <spot_driver/api/default_state_client.hpp>
 #include <spot_driver/api/default_time_sync_api.hpp>
+#include <spot_driver/api/streaming_state_client.hpp>
 #include <tl_expected/expected.hpp>
 #include "spot_driver/api/default_world_object_client.hpp"
 #include "spot_driver/api/state_client_interface.hpp"
@@ -83,6 +84,17 @@ tl::expected<void, std::string> DefaultSpotApi::authenticate(const std::string&
   }
   state_client_interface_ = std::make_shared<DefaultStateClient>(robot_state_result.response);
 
+#ifdef SPOT_DRIVER_HAS_ROBOT_STATE_STREAMING
+  const auto robot_state_streaming_result = robot_->EnsureServiceClient<::bosdyn::client::RobotStateStreamingClient>(
+      ::bosdyn::client::RobotStateStreamingClient::GetDefaultServiceName());
+  // Failure to create the streaming client is not an error state, since it does not exist in older versions of the
+  // Spot firmware, so don't return here.
+  if (robot_state_streaming_result.status && robot_state_streaming_result.response != nullptr) {
+    streaming_state_client_interface_ =
+        std::make_shared<StreamingStateClient>(robot_state_streaming_result.response, state_client_interface_);
+  }
+#endif
+
   // Kinematic API.
   const auto kinematic_api_result = robot_->EnsureServiceClient<::bosdyn::client::InverseKinematicsClient>(
       ::bosdyn::client::InverseKinematicsClient::GetDefaultServiceName());
@@ -133,6 +145,10 @@ std::shared_ptr<StateClientInterface> DefaultSpotApi::stateClientInterface() con
   return state_client_interface_;
 }
 
+std::shared_ptr<StateClientInterface> DefaultSpotApi::streamingStateClientInterface() const {
+  return streaming_state_client_interface_;
+}
+
 std::shared_ptr<KinematicApi> DefaultSpotApi::kinematicInterface() const {
   return kinematic_interface_;
 }
@@ -1,21 +1,40 @@
 // Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
 #include <bosdyn/api/robot_state.pb.h>
+#include <future>
 #include <spot_driver/api/default_state_client.hpp>
 #include <spot_driver/conversions/robot_state.hpp>
 #include <string>
 #include <tl_expected/expected.hpp>
 
+namespace {
+/**
+ * @brief Unpack the result of a GetRobotState RPC.
+ * @tparam ResultT The SDK's result type, which holds the RPC status and the response.
+ */
+template <typename ResultT>
+tl::expected<bosdyn::api::RobotState, std::string> toExpected(const ResultT& get_robot_state_result) {
+  if (!get_robot_state_result.status || !get_robot_state_result.response.has_robot_state()) {
+    return tl::make_unexpected("Failed to get robot state: " + get_robot_state_result.status.DebugString());
+  }
+  return get_robot_state_result.response.robot_state();
+}
+}  // namespace
+
 namespace spot_ros2 {
 
 DefaultStateClient::DefaultStateClient(::bosdyn::client::RobotStateClient* client) : client_{client} {}
 
 tl::expected<bosdyn::api::RobotState, std::string> DefaultStateClient::getRobotState() {
-  const auto get_robot_state_result = client_->GetRobotStateAsync().get();
-  if (!get_robot_state_result.status || !get_robot_state_result.response.has_robot_state()) {
-    return tl::make_unexpected("Failed to get robot state: " + get_robot_state_result.status.DebugString());
-  }
-  return get_robot_state_result.response.robot_state();
+  return toExpected(client_->GetRobotStateAsync().get());
+}
+
+std::future<tl::expected<bosdyn::api::RobotState, std::string>> DefaultStateClient::getRobotStateAsync() {
+  // The RPC is sent here. Only unpacking the response is deferred until the caller retrieves the result.
+  auto response = client_->GetRobotStateAsync();
+  return std::async(std::launch::deferred, [response = std::move(response)] {
+    return toExpected(response.get());
+  });
 }
 
 }  // namespace spot_ros2
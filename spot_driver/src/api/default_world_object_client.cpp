@@ -6,6 +6,25 @@
 #include <bosdyn/client/world_objects/world_object_client.h>
 #include <tl_expected/expected.hpp>
 
+#include <future>
+#include <string>
+#include <utility>
+
+namespace {
+/**
+ * @brief Unpack the result of a MutateWorldObjects RPC.
+ * @tparam ResultT The SDK's result type, which holds the RPC status and the response.
+ */
+template <typename ResultT>
+tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string> toExpected(const ResultT& result) {
+  if (result) {
+    return result.response;
+  }
+  return tl::make_unexpected("The MutateWorldObjects service returned with error code " +
+                             std::to_string(result.status.code().value()) + ": " + result.status.message());
+}
+}  // namespace
+
 namespace spot_ros2 {
 
 DefaultWorldObjectClient::DefaultWorldObjectClient(bosdyn::client::WorldObjectClient* client) : client_{client} {}
@@ -27,14 +46,33 @@ tl::expected<::bosdyn::api::ListWorldObjectResponse, std::string> DefaultWorldOb
 tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string> DefaultWorldObjectClient::mutateWorldObject(
     ::bosdyn::api::MutateWorldObjectRequest& request) const {
   try {
-    auto result = client_->MutateWorldObjects(request);
-    if (result) {
-      return result.response;
-    }
-    return tl::make_unexpected("The MutateWorldObjects service returned with error code " +
-                               std::to_string(result.status.code().value()) + ": " + result.status.message());
+    return toExpected(client_->MutateWorldObjects(request));
   } catch (const std::exception& ex) {
     return tl::make_unexpected("Failed to query the MutateWorldObjects service: " + std::string{ex.what()});
   }
 }
+
+std::future<tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>>
+DefaultWorldObjectClient::mutateWorldObjectAsync(::bosdyn::api::MutateWorldObjectRequest& request) const {
+  try {
+    // The RPC is sent here. Only unpacking the response is deferred until the caller retrieves the result.
+    auto response = client_->MutateWorldObjectsAsync(request);
+    return std::async(std::launch::deferred,
+                      [response = std::move(response)]() -> tl::expected<::bosdyn::api::MutateWorldObjectResponse,
+                                                                         std::string> {
+                        try {
+                          return toExpected(response.get());
+                        } catch (const std::exception& ex) {
+                          return tl::make_unexpected("Failed to query the MutateWorldObjects service: " +
+                                                     std::string{ex.what()});
+                        }
+                      });
+  } catch (const std::exception& ex) {
+    const auto error = "Failed to query the MutateWorldObjects service: " + std::string{ex.what()};
+    return std::async(std::launch::deferred, [error]() -> tl::expected<::bosdyn::api::MutateWorldObjectResponse,
+                                                                       std::string> {
+      return tl::make_unexpected(error);
+    });
+  }
+}
 }  // namespace spot_ros2
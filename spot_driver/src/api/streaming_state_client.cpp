@@ -0,0 +1,181 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/api/streaming_state_client.hpp>
+
+#ifdef SPOT_DRIVER_HAS_ROBOT_STATE_STREAMING
+
+#include <bosdyn/math/proto_math.h>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+// The slow-changing fields of the robot state are polled at this period.
+constexpr auto kPolledStatePeriod = std::chrono::duration<double>{1.0};
+// Delay before retrying after reading the stream or polling the robot state failed.
+constexpr auto kRetryPeriod = std::chrono::duration<double>{0.1};
+// getRobotState() gives up if no new streamed response arrives within this time.
+constexpr auto kStreamTimeout = std::chrono::duration<double>{1.0};
+
+constexpr auto kBodyFrame = "body";
+constexpr auto kOdomFrame = "odom";
+constexpr auto kVisionFrame = "vision";
+
+// Joints in the order the robot state streaming service reports them, which is the joint order of Spot's joint control
+// API. Unlike the joints of a polled robot state, it does not include the arm's unactuated arm0.hr0 joint.
+constexpr std::array<std::string_view, 19> kStreamedJointNames = {
+    "fl.hx",    "fl.hy",    "fl.kn",    "fr.hx",    "fr.hy",    "fr.kn",    "hl.hx",    "hl.hy",   "hl.kn",   "hr.hx",
+    "hr.hy",    "hr.kn",    "arm0.sh0", "arm0.sh1", "arm0.el0", "arm0.el1", "arm0.wr0", "arm0.wr1", "arm0.f1x",
+};
+
+/** @brief Index of each joint in a streamed response, by the joint's name in the Spot API. */
+const std::unordered_map<std::string_view, int>& getStreamedJointIndices() {
+  static const auto indices = [] {
+    std::unordered_map<std::string_view, int> out;
+    for (std::size_t ndx = 0; ndx < kStreamedJointNames.size(); ++ndx) {
+      out.emplace(kStreamedJointNames[ndx], static_cast<int>(ndx));
+    }
+    return out;
+  }();
+  return indices;
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+void mergeStreamedRobotState(bosdyn::api::RobotState& polled, const bosdyn::api::RobotStateStreamResponse& streamed) {
+  auto* kinematic_state = polled.mutable_kinematic_state();
+
+  const auto& streamed_joints = streamed.joint_states();
+  const auto& streamed_joint_indices = getStreamedJointIndices();
+  for (auto& joint : *kinematic_state->mutable_joint_states()) {
+    const auto streamed_joint = streamed_joint_indices.find(joint.name());
+    if (streamed_joint == streamed_joint_indices.end() || streamed_joint->second >= streamed_joints.position_size()) {
+      continue;
+    }
+    const auto ndx = streamed_joint->second;
+    joint.mutable_position()->set_value(streamed_joints.position(ndx));
+    if (ndx < streamed_joints.velocity_size()) {
+      joint.mutable_velocity()->set_value(streamed_joints.velocity(ndx));
+    }
+    if (ndx < streamed_joints.load_size()) {
+      joint.mutable_load()->set_value(streamed_joints.load(ndx));
+    }
+  }
+  if (streamed_joints.has_acquisition_timestamp()) {
+    *kinematic_state->mutable_acquisition_timestamp() = streamed_joints.acquisition_timestamp();
+  }
+
+  if (!streamed.has_kinematic_state() || !streamed.kinematic_state().has_odom_tform_body()) {
+    return;
+  }
+  const auto& streamed_kinematics = streamed.kinematic_state();
+  // Spot's snapshots are rooted at the body, so odom and vision are children of the body frame.
+  auto& edges = *kinematic_state->mutable_transforms_snapshot()->mutable_child_to_parent_edge_map();
+  const auto odom_edge = edges.find(kOdomFrame);
+  if (odom_edge == edges.end() || odom_edge->second.parent_frame_name() != kBodyFrame) {
+    return;
+  }
+  const auto body_tform_odom = ~streamed_kinematics.odom_tform_body();
+  const auto vision_edge = edges.find(kVisionFrame);
+  if (vision_edge != edges.end() && vision_edge->second.parent_frame_name() == kBodyFrame) {
+    if (streamed_kinematics.has_vision_tform_body()) {
+      *vision_edge->second.mutable_parent_tform_child() = ~streamed_kinematics.vision_tform_body();
+    } else {
+      // Vision drifts slowly with respect to odom, so the polled odom_tform_vision is still accurate at the streamed
+      // rate
+      const auto odom_tform_vision = ~odom_edge->second.parent_tform_child() * vision_edge->second.parent_tform_child();
+      *vision_edge->second.mutable_parent_tform_child() = body_tform_odom * odom_tform_vision;
+    }
+  }
+  *odom_edge->second.mutable_parent_tform_child() = body_tform_odom;
+}
+
+StreamingStateClient::StreamingStateClient(::bosdyn::client::RobotStateStreamingClient* streaming_client,
+                                           const std::shared_ptr<StateClientInterface>& polled_client)
+    : streaming_client_{streaming_client}, polled_client_{polled_client} {}
+
+StreamingStateClient::~StreamingStateClient() {
+  {
+    std::lock_guard lock{mutex_};
+    stop_ = true;
+  }
+  condition_.notify_all();
+  if (stream_thread_.joinable()) {
+    stream_thread_.join();
+  }
+  if (poll_thread_.joinable()) {
+    poll_thread_.join();
+  }
+}
+
+tl::expected<bosdyn::api::RobotState, std::string> StreamingStateClient::getRobotState() {
+  // Only open the stream once someone asks for robot state, so that nodes which never do don't pay for it
+  std::call_once(threads_started_, [this] {
+    stream_thread_ = std::thread{[this] {
+      streamLoop();
+    }};
+    poll_thread_ = std::thread{[this] {
+      pollLoop();
+    }};
+  });
+
+  std::unique_lock lock{mutex_};
+  const auto has_new_response = condition_.wait_for(lock, kStreamTimeout, [this] {
+    return stop_ || (streamed_count_ > last_returned_count_ && latest_polled_.has_value());
+  });
+  if (!has_new_response || stop_) {
+    return tl::make_unexpected("Timed out waiting for streamed robot state" +
+                               (last_error_.empty() ? std::string{} : ": " + last_error_));
+  }
+
+  last_returned_count_ = streamed_count_;
+  auto robot_state = latest_polled_.value();
+  mergeStreamedRobotState(robot_state, latest_streamed_.value());
+  return robot_state;
+}
+
+void StreamingStateClient::streamLoop() {
+  while (!stop_) {
+    // Each call returns the next response of the stream, which the robot sends at its own rate.
+    auto result = streaming_client_->GetRobotStateStream();
+    std::unique_lock lock{mutex_};
+    if (!result.status) {
+      last_error_ = "Failed to read robot state stream: " + result.status.DebugString();
+      condition_.wait_for(lock, kRetryPeriod, [this] {
+        return stop_.load();
+      });
+      continue;
+    }
+    latest_streamed_ = std::move(result.response);
+    ++streamed_count_;
+    last_error_.clear();
+    lock.unlock();
+    condition_.notify_all();
+  }
+}
+
+void StreamingStateClient::pollLoop() {
+  while (!stop_) {
+    auto result = polled_client_->getRobotState();
+    std::unique_lock lock{mutex_};
+    if (result.has_value()) {
+      latest_polled_ = std::move(result).value();
+      // Wake up a caller that was waiting for the first polled robot state
+      condition_.notify_all();
+    } else {
+      last_error_ = result.error();
+    }
+    condition_.wait_for(lock, result.has_value() ? kPolledStatePeriod : kRetryPeriod, [this] {
+      return stop_.load();
+    });
+  }
+}
+
+}  // namespace spot_ros2
+
+#endif  // SPOT_DRIVER_HAS_ROBOT_STATE_STREAMING
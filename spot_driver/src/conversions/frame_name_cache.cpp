@@ -0,0 +1,32 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/frame_name_cache.hpp>
+
+#include <utility>
+
+namespace spot_ros2 {
+
+FrameNameCache::FrameNameCache(const std::string& prefix, const std::set<std::string, std::less<>>& frames_to_ignore)
+    : prefix_{prefix}, frames_to_ignore_{frames_to_ignore} {}
+
+const CachedFrameName& FrameNameCache::get(const std::string& name) {
+  if (const auto it = frame_names_.find(name); it != frame_names_.end()) {
+    return it->second;
+  }
+  CachedFrameName frame_name;
+  frame_name.name = name;
+  // Frame names which already contain a namespace are used as they are.
+  frame_name.frame_id = name.find('/') == std::string::npos ? prefix_ + name : name;
+  // arm0.link_wr1 and link_wr1 are duplicates of arm_link_wr1 (published with robot state) and shouldn't be added to
+  // the TF tree!
+  frame_name.is_ignored =
+      frames_to_ignore_.find(name) != frames_to_ignore_.end() || name == "arm0.link_wr1" || name == "link_wr1";
+  return frame_names_.emplace(name, std::move(frame_name)).first->second;
+}
+
+const CachedFrameName* FrameNameCache::find(const std::string& name) const {
+  const auto it = frame_names_.find(name);
+  return it == frame_names_.end() ? nullptr : &it->second;
+}
+
+}  // namespace spot_ros2
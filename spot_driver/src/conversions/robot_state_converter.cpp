@@ -0,0 +1,388 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/conversions/robot_state_converter.hpp>
+
+#include <bosdyn/math/frame_helpers.h>
+#include <bosdyn/math/proto_math.h>
+#include <spot_driver/conversions/common_conversions.hpp>
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/conversions/time.hpp>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace {
+void setDuration(const google::protobuf::Duration& proto, builtin_interfaces::msg::Duration& ros_msg) {
+  ros_msg.sec = proto.seconds();
+  ros_msg.nanosec = proto.nanos();
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+RobotStateConverter::RobotStateConverter(const std::string& prefix, const std::string& preferred_base_frame_id,
+                                         const bool is_using_vision)
+    : prefix_{prefix},
+      preferred_base_frame_id_{preferred_base_frame_id},
+      is_using_vision_{is_using_vision},
+      odom_frame_id_{prefix + (is_using_vision ? "vision" : "odom")},
+      body_frame_id_{prefix + "body"},
+      hand_frame_id_{prefix + "hand"},
+      frame_names_{prefix} {
+  for (const auto& [name, friendly_name] : kFriendlyJointNames) {
+    joint_names_.emplace(name, prefix_ + friendly_name);
+    canonical_joint_indices_.emplace(name, getCanonicalJointIndex(name).value());
+  }
+}
+
+const RobotStateMessages& RobotStateConverter::convert(const ::bosdyn::api::RobotState& robot_state,
+                                                       const google::protobuf::Duration& clock_skew,
+                                                       const RobotStateOutputSet& outputs) {
+  const auto requested = [&outputs](const RobotStateOutput output) {
+    return outputs.test(static_cast<std::size_t>(output));
+  };
+  // The kinematic outputs all share the acquisition time of the kinematic state.
+  const auto stamp = robotTimeToLocalTime(robot_state.kinematic_state().acquisition_timestamp(), clock_skew);
+
+  if (!(requested(RobotStateOutput::BATTERY_STATES) && convertBatteryStates(robot_state, clock_skew))) {
+    release(&RobotStateMessages::maybe_battery_states);
+  }
+  if (!(requested(RobotStateOutput::WIFI_STATE) && convertWifiState(robot_state))) {
+    release(&RobotStateMessages::maybe_wifi_state);
+  }
+  if (!(requested(RobotStateOutput::FOOT_STATE) && convertFootState(robot_state))) {
+    release(&RobotStateMessages::maybe_foot_state);
+  }
+  if (!(requested(RobotStateOutput::ESTOP_STATES) && convertEstopStates(robot_state, clock_skew))) {
+    release(&RobotStateMessages::maybe_estop_states);
+  }
+  if (!(requested(RobotStateOutput::JOINT_STATES) && convertJointStates(robot_state, stamp))) {
+    release(&RobotStateMessages::maybe_joint_states);
+  }
+  if (!(requested(RobotStateOutput::COMPACT_JOINT_STATES) && convertCompactJointStates(robot_state, stamp))) {
+    release(&RobotStateMessages::maybe_compact_joint_states);
+  }
+  if (!(requested(RobotStateOutput::TF) && convertTf(robot_state, stamp))) {
+    release(&RobotStateMessages::maybe_tf);
+  }
+  // The odometry reuses the twist converted here, so it must be converted after it
+  if (!(requested(RobotStateOutput::ODOM_TWIST) && convertOdomTwist(robot_state, stamp))) {
+    release(&RobotStateMessages::maybe_odom_twist);
+  }
+  if (!(requested(RobotStateOutput::ODOM) && convertOdom(robot_state, stamp))) {
+    release(&RobotStateMessages::maybe_odom);
+  }
+  if (!(requested(RobotStateOutput::POWER_STATE) && convertPowerState(robot_state, clock_skew))) {
+    release(&RobotStateMessages::maybe_power_state);
+  }
+  if (!(requested(RobotStateOutput::SYSTEM_FAULT_STATE) && convertSystemFaultState(robot_state, clock_skew))) {
+    release(&RobotStateMessages::maybe_system_fault_state);
+  }
+  if (!(requested(RobotStateOutput::MANIPULATOR_STATE) && convertManipulatorState(robot_state))) {
+    release(&RobotStateMessages::maybe_manipulator_state);
+  }
+  if (!(requested(RobotStateOutput::END_EFFECTOR_FORCE) && convertEndEffectorForce(robot_state, stamp))) {
+    release(&RobotStateMessages::maybe_end_effector_force);
+  }
+  if (!(requested(RobotStateOutput::BEHAVIOR_FAULT_STATE) && convertBehaviorFaultState(robot_state, clock_skew))) {
+    release(&RobotStateMessages::maybe_behavior_fault_state);
+  }
+  return messages_;
+}
+
+template <typename MessageT>
+MessageT& RobotStateConverter::acquire(std::optional<MessageT> RobotStateMessages::*field) {
+  auto& message = messages_.*field;
+  if (!message.has_value()) {
+    auto& spare = spare_messages_.*field;
+    if (spare.has_value()) {
+      message.emplace(std::move(spare).value());
+      spare.reset();
+    } else {
+      message.emplace();
+    }
+  }
+  return message.value();
+}
+
+template <typename MessageT>
+void RobotStateConverter::release(std::optional<MessageT> RobotStateMessages::*field) {
+  auto& message = messages_.*field;
+  if (message.has_value()) {
+    spare_messages_.*field = std::move(message);
+    message.reset();
+  }
+}
+
+bool RobotStateConverter::convertBatteryStates(const ::bosdyn::api::RobotState& robot_state,
+                                               const google::protobuf::Duration& clock_skew) {
+  auto& battery_states = acquire(&RobotStateMessages::maybe_battery_states).battery_states;
+  battery_states.resize(robot_state.battery_states_size());
+  for (int ndx = 0; ndx < robot_state.battery_states_size(); ++ndx) {
+    const auto& battery = robot_state.battery_states(ndx);
+    auto& battery_state = battery_states[ndx];
+    battery_state.header.stamp = robotTimeToLocalTime(battery.timestamp(), clock_skew);
+    battery_state.identifier = battery.identifier();
+    battery_state.charge_percentage = battery.charge_percentage().value();
+    setDuration(battery.estimated_runtime(), battery_state.estimated_runtime);
+    battery_state.current = battery.current().value();
+    battery_state.voltage = battery.voltage().value();
+    battery_state.temperatures.assign(battery.temperatures().begin(), battery.temperatures().end());
+    battery_state.status = battery.status();
+  }
+  return true;
+}
+
+bool RobotStateConverter::convertWifiState(const ::bosdyn::api::RobotState& robot_state) {
+  auto& wifi_state = acquire(&RobotStateMessages::maybe_wifi_state);
+  wifi_state.current_mode = 0;
+  wifi_state.essid.clear();
+  for (const auto& comm_state : robot_state.comms_states()) {
+    if (comm_state.has_wifi_state()) {
+      wifi_state.current_mode = comm_state.wifi_state().current_mode();
+      wifi_state.essid = comm_state.wifi_state().essid();
+    }
+  }
+  return true;
+}
+
+bool RobotStateConverter::convertFootState(const ::bosdyn::api::RobotState& robot_state) {
+  auto& foot_states = acquire(&RobotStateMessages::maybe_foot_state).states;
+  foot_states.resize(robot_state.foot_state_size());
+  for (int ndx = 0; ndx < robot_state.foot_state_size(); ++ndx) {
+    const auto& foot = robot_state.foot_state(ndx);
+    convertToRos(foot.foot_position_rt_body(), foot_states[ndx].foot_position_rt_body);
+    foot_states[ndx].contact = foot.contact();
+  }
+  return true;
+}
+
+bool RobotStateConverter::convertEstopStates(const ::bosdyn::api::RobotState& robot_state,
+                                             const google::protobuf::Duration& clock_skew) {
+  auto& estop_states = acquire(&RobotStateMessages::maybe_estop_states).estop_states;
+  estop_states.resize(robot_state.estop_states_size());
+  for (int ndx = 0; ndx < robot_state.estop_states_size(); ++ndx) {
+    const auto& estop = robot_state.estop_states(ndx);
+    auto& estop_state = estop_states[ndx];
+    estop_state.header.stamp = robotTimeToLocalTime(estop.timestamp(), clock_skew);
+    estop_state.name = estop.name();
+    estop_state.type = estop.type();
+    estop_state.state = estop.state();
+    estop_state.state_description = estop.state_description();
+  }
+  return true;
+}
+
+bool RobotStateConverter::convertJointStates(const ::bosdyn::api::RobotState& robot_state,
+                                             const builtin_interfaces::msg::Time& stamp) {
+  if (!robot_state.has_kinematic_state()) {
+    return false;
+  }
+  const auto& joints = robot_state.kinematic_state().joint_states();
+
+  auto& joint_states = acquire(&RobotStateMessages::maybe_joint_states);
+  joint_states.header.stamp = stamp;
+  joint_states.name.resize(joints.size());
+  joint_states.position.resize(joints.size());
+  joint_states.velocity.resize(joints.size());
+  joint_states.effort.resize(joints.size());
+  joint_source_names_.resize(joints.size());
+  for (int ndx = 0; ndx < joints.size(); ++ndx) {
+    const auto& joint = joints[ndx];
+    // Spot reports its joints in the same order every time, so the name is usually already in place. A joint with no
+    // friendly name throws std::out_of_range.
+    if (joint_source_names_[ndx] != joint.name()) {
+      joint_states.name[ndx] = joint_names_.at(joint.name());
+      joint_source_names_[ndx] = joint.name();
+    }
+    joint_states.position[ndx] = joint.position().value();
+    joint_states.velocity[ndx] = joint.velocity().value();
+    joint_states.effort[ndx] = joint.load().value();
+  }
+  return true;
+}
+
+bool RobotStateConverter::convertCompactJointStates(const ::bosdyn::api::RobotState& robot_state,
+                                                    const builtin_interfaces::msg::Time& stamp) {
+  if (!robot_state.has_kinematic_state()) {
+    return false;
+  }
+
+  auto& joint_states = acquire(&RobotStateMessages::maybe_compact_joint_states);
+  joint_states.header.stamp = stamp;
+  joint_states.valid.fill(false);
+  joint_states.position.fill(0.);
+  joint_states.velocity.fill(0.);
+  joint_states.effort.fill(0.);
+  for (const auto& joint : robot_state.kinematic_state().joint_states()) {
+    const auto index = canonical_joint_indices_.find(joint.name());
+    if (index == canonical_joint_indices_.end() || index->second >= joint_states.valid.size()) {
+      continue;
+    }
+    joint_states.valid[index->second] = true;
+    joint_states.position[index->second] = joint.position().value();
+    joint_states.velocity[index->second] = joint.velocity().value();
+    joint_states.effort[index->second] = joint.load().value();
+  }
+  return true;
+}
+
+bool RobotStateConverter::convertTf(const ::bosdyn::api::RobotState& robot_state,
+                                    const builtin_interfaces::msg::Time& stamp) {
+  if (!robot_state.has_kinematic_state() || !robot_state.kinematic_state().has_transforms_snapshot()) {
+    return false;
+  }
+  const auto& edges = robot_state.kinematic_state().transforms_snapshot().child_to_parent_edge_map();
+  if (edges.empty()) {
+    return false;
+  }
+
+  convertFrameTreeSnapshot(robot_state.kinematic_state().transforms_snapshot(), stamp, frame_names_,
+                           preferred_base_frame_id_, acquire(&RobotStateMessages::maybe_tf).transforms);
+  return true;
+}
+
+bool RobotStateConverter::convertOdomTwist(const ::bosdyn::api::RobotState& robot_state,
+                                           const builtin_interfaces::msg::Time& stamp) {
+  if (!robot_state.has_kinematic_state() || !robot_state.kinematic_state().has_velocity_of_body_in_odom()) {
+    return false;
+  }
+  auto& odom_twist = acquire(&RobotStateMessages::maybe_odom_twist);
+  odom_twist.header.stamp = stamp;
+  convertToRos(robot_state.kinematic_state().velocity_of_body_in_odom(), odom_twist.twist.twist);
+  return true;
+}
+
+bool RobotStateConverter::convertOdom(const ::bosdyn::api::RobotState& robot_state,
+                                      const builtin_interfaces::msg::Time& stamp) {
+  const auto& kinematic_state = robot_state.kinematic_state();
+  if (!robot_state.has_kinematic_state() || !kinematic_state.has_acquisition_timestamp() ||
+      !kinematic_state.has_transforms_snapshot() || !kinematic_state.has_velocity_of_body_in_odom()) {
+    return false;
+  }
+  const auto found_body_pose =
+      is_using_vision_ ? ::bosdyn::api::GetWorldTformBody(kinematic_state.transforms_snapshot(), &tform_body_)
+                       : ::bosdyn::api::GetOdomTformBody(kinematic_state.transforms_snapshot(), &tform_body_);
+  if (!found_body_pose) {
+    return false;
+  }
+
+  auto& odom = acquire(&RobotStateMessages::maybe_odom);
+  odom.header.stamp = stamp;
+  odom.header.frame_id = odom_frame_id_;
+  odom.child_frame_id = body_frame_id_;
+  convertToRos(tform_body_, odom.pose.pose);
+  if (messages_.maybe_odom_twist.has_value()) {
+    odom.twist.twist = messages_.maybe_odom_twist->twist.twist;
+  } else {
+    convertToRos(kinematic_state.velocity_of_body_in_odom(), odom.twist.twist);
+  }
+  return true;
+}
+
+bool RobotStateConverter::convertPowerState(const ::bosdyn::api::RobotState& robot_state,
+                                            const google::protobuf::Duration& clock_skew) {
+  if (!robot_state.has_power_state()) {
+    return false;
+  }
+  const auto& power_state = robot_state.power_state();
+  auto& power_state_msg = acquire(&RobotStateMessages::maybe_power_state);
+  power_state_msg.header.stamp = robotTimeToLocalTime(power_state.timestamp(), clock_skew);
+  power_state_msg.motor_power_state = power_state.motor_power_state();
+  power_state_msg.shore_power_state = power_state.shore_power_state();
+  power_state_msg.locomotion_charge_percentage = power_state.locomotion_charge_percentage().value();
+  setDuration(power_state.locomotion_estimated_runtime(), power_state_msg.locomotion_estimated_runtime);
+  return true;
+}
+
+bool RobotStateConverter::convertSystemFaultState(const ::bosdyn::api::RobotState& robot_state,
+                                                  const google::protobuf::Duration& clock_skew) {
+  if (!robot_state.has_system_fault_state()) {
+    return false;
+  }
+  const auto convert_faults = [&clock_skew](const auto& faults, std::vector<spot_msgs::msg::SystemFault>& fault_msgs) {
+    fault_msgs.resize(faults.size());
+    for (int ndx = 0; ndx < faults.size(); ++ndx) {
+      const auto& fault = faults[ndx];
+      auto& fault_msg = fault_msgs[ndx];
+      fault_msg.name = fault.name();
+      fault_msg.header.stamp = robotTimeToLocalTime(fault.onset_timestamp(), clock_skew);
+      setDuration(fault.duration(), fault_msg.duration);
+      fault_msg.code = fault.code();
+      fault_msg.uid = fault.uid();
+      fault_msg.error_message = fault.error_message();
+      fault_msg.attributes.assign(fault.attributes().begin(), fault.attributes().end());
+      fault_msg.severity = fault.severity();
+    }
+  };
+
+  auto& system_fault_state = acquire(&RobotStateMessages::maybe_system_fault_state);
+  convert_faults(robot_state.system_fault_state().faults(), system_fault_state.faults);
+  convert_faults(robot_state.system_fault_state().historical_faults(), system_fault_state.historical_faults);
+  return true;
+}
+
+bool RobotStateConverter::convertManipulatorState(const ::bosdyn::api::RobotState& robot_state) {
+  using ManipulatorState = bosdyn_api_msgs::msg::ManipulatorState;
+  if (!robot_state.has_manipulator_state()) {
+    return false;
+  }
+  const auto& manipulator_state = robot_state.manipulator_state();
+
+  // ManipulatorState has no dynamically sized fields, so it is cheapest to start over from a default message, which
+  // also clears the optional fields this robot state does not have
+  auto& manipulator_state_msg = acquire(&RobotStateMessages::maybe_manipulator_state);
+  manipulator_state_msg = ManipulatorState{};
+  manipulator_state_msg.gripper_open_percentage = manipulator_state.gripper_open_percentage();
+  manipulator_state_msg.is_gripper_holding_item = manipulator_state.is_gripper_holding_item();
+  if (manipulator_state.has_estimated_end_effector_force_in_hand()) {
+    convertToRos(manipulator_state.estimated_end_effector_force_in_hand(),
+                 manipulator_state_msg.estimated_end_effector_force_in_hand);
+    manipulator_state_msg.has_field |= ManipulatorState::ESTIMATED_END_EFFECTOR_FORCE_IN_HAND_FIELD_SET;
+  }
+  manipulator_state_msg.stow_state.value = manipulator_state.stow_state();
+  if (manipulator_state.has_velocity_of_hand_in_vision()) {
+    convertToRos(manipulator_state.velocity_of_hand_in_vision(), manipulator_state_msg.velocity_of_hand_in_vision);
+    manipulator_state_msg.has_field |= ManipulatorState::VELOCITY_OF_HAND_IN_VISION_FIELD_SET;
+  }
+  if (manipulator_state.has_velocity_of_hand_in_odom()) {
+    convertToRos(manipulator_state.velocity_of_hand_in_odom(), manipulator_state_msg.velocity_of_hand_in_odom);
+    manipulator_state_msg.has_field |= ManipulatorState::VELOCITY_OF_HAND_IN_ODOM_FIELD_SET;
+  }
+  manipulator_state_msg.carry_state.value = manipulator_state.carry_state();
+  return true;
+}
+
+bool RobotStateConverter::convertEndEffectorForce(const ::bosdyn::api::RobotState& robot_state,
+                                                  const builtin_interfaces::msg::Time& stamp) {
+  if (!robot_state.has_manipulator_state()) {
+    return false;
+  }
+  auto& force = acquire(&RobotStateMessages::maybe_end_effector_force);
+  force.header.stamp = stamp;
+  force.header.frame_id = hand_frame_id_;
+  convertToRos(robot_state.manipulator_state().estimated_end_effector_force_in_hand(), force.vector);
+  return true;
+}
+
+bool RobotStateConverter::convertBehaviorFaultState(const ::bosdyn::api::RobotState& robot_state,
+                                                    const google::protobuf::Duration& clock_skew) {
+  if (!robot_state.has_behavior_fault_state()) {
+    return false;
+  }
+  const auto& faults = robot_state.behavior_fault_state().faults();
+  auto& fault_msgs = acquire(&RobotStateMessages::maybe_behavior_fault_state).faults;
+  fault_msgs.resize(faults.size());
+  for (int ndx = 0; ndx < faults.size(); ++ndx) {
+    const auto& fault = faults[ndx];
+    auto& fault_msg = fault_msgs[ndx];
+    fault_msg.behavior_fault_id = fault.behavior_fault_id();
+    fault_msg.header.stamp = robotTimeToLocalTime(fault.onset_timestamp(), clock_skew);
+    fault_msg.cause = fault.cause();
+    fault_msg.status = fault.status();
+  }
+  return true;
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,132 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/image_stitcher/birds_eye_view.hpp>
+
+#include <opencv2/core.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+// Number of output rows composed by each parallel task.
+constexpr auto kTileRows = 32;
+// Ground points closer than this to the camera's image plane are not projected.
+constexpr auto kMinimumDepth = 0.05;
+// Width of the border, in pixels, over which a camera's blending weight fades to zero at the edge of its image.
+constexpr auto kFeatherWidth = 32.0;
+}  // namespace
+
+namespace spot_ros2 {
+
+BirdsEyeView::BirdsEyeView(const GroundPlaneGrid& grid, const std::vector<GroundPlaneCamera>& cameras)
+    : size_{grid.width, grid.height} {
+  // Body frame coordinates of the center of the top left output pixel.
+  const double x_front = 0.5 * (grid.height - 1) * grid.resolution;
+  const double y_left = 0.5 * (grid.width - 1) * grid.resolution;
+
+  luts_.reserve(cameras.size());
+  for (const auto& camera : cameras) {
+    const cv::Matx44d camera_tform_body = camera.body_tform_camera.inv();
+    const cv::Matx33d R = camera_tform_body.get_minor<3, 3>(0, 0);
+    const cv::Vec3d t{camera_tform_body(0, 3), camera_tform_body(1, 3), camera_tform_body(2, 3)};
+    const auto& K = camera.intrinsics;
+
+    cv::Mat map_x{size_, CV_32FC1, cv::Scalar{-1.f}};
+    cv::Mat map_y{size_, CV_32FC1, cv::Scalar{-1.f}};
+    cv::Mat weights{size_, CV_32FC1, cv::Scalar{0.f}};
+    for (int row = 0; row < size_.height; ++row) {
+      auto* const x_ptr = map_x.ptr<float>(row);
+      auto* const y_ptr = map_y.ptr<float>(row);
+      auto* const w_ptr = weights.ptr<float>(row);
+      for (int col = 0; col < size_.width; ++col) {
+        const cv::Vec3d body_point{x_front - row * grid.resolution, y_left - col * grid.resolution,
+                                   grid.ground_height};
+        const cv::Vec3d camera_point = R * body_point + t;
+        if (camera_point(2) < kMinimumDepth) {
+          continue;
+        }
+        const cv::Vec3d pixel = K * camera_point;
+        const double u = pixel(0) / pixel(2);
+        const double v = pixel(1) / pixel(2);
+        if (u < 0. || v < 0. || u > camera.image_size.width - 1 || v > camera.image_size.height - 1) {
+          continue;
+        }
+        x_ptr[col] = static_cast<float>(u);
+        y_ptr[col] = static_cast<float>(v);
+        // Fade out toward the edges of the image so that overlapping cameras blend smoothly instead of showing a seam.
+        const double edge_distance =
+            std::min({u, v, camera.image_size.width - 1 - u, camera.image_size.height - 1 - v});
+        w_ptr[col] = static_cast<float>(std::min(1.0, (edge_distance + 1.0) / kFeatherWidth));
+      }
+    }
+
+    CameraLut lut;
+    cv::convertMaps(map_x, map_y, lut.map1, lut.map2, CV_16SC2);
+    lut.weights = weights;
+    cv::Mat observed;
+    cv::compare(weights, 0.f, observed, cv::CMP_GT);
+    lut.roi = cv::boundingRect(observed);
+    luts_.push_back(std::move(lut));
+  }
+}
+
+cv::Mat BirdsEyeView::compose(const std::vector<cv::Mat>& images) const {
+  cv::Mat output{size_, CV_8UC3, cv::Scalar::all(0)};
+  const int tile_count = (size_.height + kTileRows - 1) / kTileRows;
+  cv::parallel_for_(cv::Range{0, tile_count}, [&](const cv::Range& range) {
+    for (int tile = range.start; tile < range.end; ++tile) {
+      const int first_row = tile * kTileRows;
+      const cv::Rect tile_rect{0, first_row, size_.width, std::min(kTileRows, size_.height - first_row)};
+      composeTile(images, tile_rect, output);
+    }
+  });
+  return output;
+}
+
+void BirdsEyeView::composeTile(const std::vector<cv::Mat>& images, const cv::Rect& tile, cv::Mat& output) const {
+  cv::Mat accumulator{tile.size(), CV_32FC3, cv::Scalar::all(0)};
+  cv::Mat weight_sum{tile.size(), CV_32FC1, cv::Scalar{0.f}};
+  cv::Mat warped;
+
+  const auto count = std::min(images.size(), luts_.size());
+  for (size_t ndx = 0; ndx < count; ++ndx) {
+    const auto& lut = luts_[ndx];
+    const cv::Rect region = lut.roi & tile;
+    if (images[ndx].empty() || region.empty()) {
+      continue;
+    }
+    cv::remap(images[ndx], warped, lut.map1(region), lut.map2(region), cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+
+    const cv::Point offset = region.tl() - tile.tl();
+    for (int row = 0; row < region.height; ++row) {
+      const auto* const src = warped.ptr<cv::Vec3b>(row);
+      const auto* const w = lut.weights.ptr<float>(region.y + row) + region.x;
+      auto* const acc = accumulator.ptr<cv::Vec3f>(offset.y + row) + offset.x;
+      auto* const sum = weight_sum.ptr<float>(offset.y + row) + offset.x;
+      for (int col = 0; col < region.width; ++col) {
+        if (w[col] > 0.f) {
+          acc[col] += w[col] * static_cast<cv::Vec3f>(src[col]);
+          sum[col] += w[col];
+        }
+      }
+    }
+  }
+
+  cv::Mat output_tile = output(tile);
+  for (int row = 0; row < tile.height; ++row) {
+    const auto* const acc = accumulator.ptr<cv::Vec3f>(row);
+    const auto* const sum = weight_sum.ptr<float>(row);
+    auto* const dst = output_tile.ptr<cv::Vec3b>(row);
+    for (int col = 0; col < tile.width; ++col) {
+      if (sum[col] > 0.f) {
+        const cv::Vec3f pixel = acc[col] / sum[col];
+        dst[col] = cv::Vec3b{cv::saturate_cast<uchar>(pixel[0]), cv::saturate_cast<uchar>(pixel[1]),
+                             cv::saturate_cast<uchar>(pixel[2])};
+      }
+    }
+  }
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,146 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/image_stitcher/birds_eye_view_node.hpp>
+
+#include <cv_bridge/cv_bridge.h>
+#include <chrono>
+#include <opencv2/core/quaternion.hpp>
+#include <rclcpp/qos.hpp>
+#include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
+#include <spot_driver/interfaces/rclcpp_tf_listener_interface.hpp>
+
+namespace {
+constexpr auto kOutputTopic{"birds_eye_view/image"};
+
+cv::Matx44d toCvMatx44d(const geometry_msgs::msg::Transform& tf) {
+  const cv::Quatd q{tf.rotation.w, tf.rotation.x, tf.rotation.y, tf.rotation.z};
+  cv::Matx44d transform = cv::Matx44d::eye();
+  const auto r = q.toRotMat3x3();
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      transform(row, col) = r(row, col);
+    }
+  }
+  transform(0, 3) = tf.translation.x;
+  transform(1, 3) = tf.translation.y;
+  transform(2, 3) = tf.translation.z;
+  return transform;
+}
+}  // namespace
+
+namespace spot_ros2 {
+BirdsEyeViewNode::BirdsEyeViewNode(const rclcpp::NodeOptions& options)
+    : node_{std::make_shared<rclcpp::Node>("birds_eye_view", options)},
+      tf_listener_{std::make_unique<RclcppTfListenerInterface>(node_)},
+      logger_{std::make_unique<RclcppLoggerInterface>(node_->get_logger())},
+      image_transport_{node_},
+      publisher_{image_transport_.advertise(kOutputTopic, 1)} {
+  const auto spot_name = node_->declare_parameter("spot_name", "");
+  const auto frame_prefix = spot_name.empty() ? "" : spot_name + "/";
+  body_frame_ = frame_prefix + node_->declare_parameter("body_frame", "body");
+  const auto cameras = node_->declare_parameter(
+      "birds_eye_view_cameras", std::vector<std::string>{"frontleft", "frontright", "left", "right", "back"});
+  // Size of one output pixel on the ground, in meters
+  grid_.resolution = node_->declare_parameter("birds_eye_view_resolution", 0.02);
+  // Size of the output image, in pixels
+  grid_.width = static_cast<int>(node_->declare_parameter("birds_eye_view_width", 400));
+  grid_.height = static_cast<int>(node_->declare_parameter("birds_eye_view_height", 400));
+  // Height of the ground with respect to the body frame. Spot's body is about half a meter above the ground when
+  // standing.
+  grid_.ground_height = node_->declare_parameter("birds_eye_view_ground_height", -0.5);
+  const auto rate = node_->declare_parameter("birds_eye_view_rate", 10.0);
+
+  // The subscriber callbacks capture indices into inputs_, so it must not be resized after this point.
+  inputs_.resize(cameras.size());
+  for (size_t ndx = 0; ndx < cameras.size(); ++ndx) {
+    inputs_[ndx].name = cameras[ndx];
+    inputs_[ndx].image_subscriber = node_->create_subscription<sensor_msgs::msg::Image>(
+        "camera/" + cameras[ndx] + "/image", rclcpp::SensorDataQoS(),
+        [this, ndx](const sensor_msgs::msg::Image::ConstSharedPtr& msg) {
+          std::lock_guard lock{inputs_mutex_};
+          inputs_[ndx].image = msg;
+        });
+    inputs_[ndx].info_subscriber = node_->create_subscription<sensor_msgs::msg::CameraInfo>(
+        "camera/" + cameras[ndx] + "/camera_info", rclcpp::SensorDataQoS(),
+        [this, ndx](const sensor_msgs::msg::CameraInfo::ConstSharedPtr& msg) {
+          std::lock_guard lock{inputs_mutex_};
+          inputs_[ndx].info = msg;
+        });
+  }
+
+  timer_ = node_->create_wall_timer(std::chrono::duration<double>(1.0 / rate), [this]() {
+    timerCallback();
+  });
+}
+
+std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> BirdsEyeViewNode::get_node_base_interface() {
+  return node_->get_node_base_interface();
+}
+
+bool BirdsEyeViewNode::tryBuildView() {
+  std::vector<sensor_msgs::msg::CameraInfo::ConstSharedPtr> infos;
+  {
+    std::lock_guard lock{inputs_mutex_};
+    for (const auto& input : inputs_) {
+      if (!input.info) {
+        return false;
+      }
+      infos.push_back(input.info);
+    }
+  }
+
+  // The cameras are rigidly attached to the body, so the lookup tables only need to be computed once.
+  std::vector<GroundPlaneCamera> cameras;
+  for (const auto& info : infos) {
+    const auto body_tform_camera = tf_listener_->lookupTransform(info->header.frame_id, body_frame_, rclcpp::Time{});
+    if (!body_tform_camera) {
+      logger_->logWarn("Valid transform for image frame " + info->header.frame_id + " to " + body_frame_ +
+                       " could not be found");
+      return false;
+    }
+    cameras.push_back(GroundPlaneCamera{cv::Matx33d{info->k[0], info->k[1], info->k[2],  //
+                                                    info->k[3], info->k[4], info->k[5],  //
+                                                    info->k[6], info->k[7], info->k[8]},
+                                        cv::Size{static_cast<int>(info->width), static_cast<int>(info->height)},
+                                        toCvMatx44d(body_tform_camera->transform)});
+  }
+  view_.emplace(grid_, cameras);
+  logger_->logInfo("Built bird's-eye view lookup tables for " + std::to_string(cameras.size()) + " cameras");
+  return true;
+}
+
+void BirdsEyeViewNode::timerCallback() {
+  if (!view_.has_value() && !tryBuildView()) {
+    return;
+  }
+
+  std::vector<sensor_msgs::msg::Image::ConstSharedPtr> latest;
+  {
+    std::lock_guard lock{inputs_mutex_};
+    for (const auto& input : inputs_) {
+      latest.push_back(input.image);
+    }
+  }
+
+  std_msgs::msg::Header header;
+  header.frame_id = body_frame_;
+  std::vector<cv::Mat> images(latest.size());
+  for (size_t ndx = 0; ndx < latest.size(); ++ndx) {
+    if (!latest[ndx]) {
+      continue;
+    }
+    // Spot's body cameras are grayscale, so convert everything to a common color encoding before blending.
+    images[ndx] = cv_bridge::toCvShare(latest[ndx], "bgr8")->image;
+    if (rclcpp::Time{latest[ndx]->header.stamp} > rclcpp::Time{header.stamp}) {
+      header.stamp = latest[ndx]->header.stamp;
+    }
+  }
+  if (rclcpp::Time{header.stamp}.nanoseconds() == 0) {
+    // No images received yet
+    return;
+  }
+
+  publisher_.publish(cv_bridge::CvImage(header, "bgr8", view_->compose(images)).toImageMsg());
+}
+
+}  // namespace spot_ros2
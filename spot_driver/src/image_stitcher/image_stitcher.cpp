@@ -3,6 +3,10 @@
 #include <builtin_interfaces/msg/detail/time__struct.hpp>
 #include <geometry_msgs/msg/detail/transform_stamped__struct.hpp>
 #include <image_transport/subscriber_filter.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <memory>
 #include <opencv2/core/types.hpp>
 #include <spot_driver/image_stitcher/image_stitcher.hpp>
@@ -13,9 +17,12 @@
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/matx.hpp>
 #include <opencv2/core/quaternion.hpp>
+#include <opencv2/core/utility.hpp>
 #include <opencv2/highgui.hpp>
+#include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
 #include <opencv2/stitching/detail/camera.hpp>
+#include <sensor_msgs/image_encodings.hpp>
 #include <std_msgs/msg/detail/header__builder.hpp>
 #include <std_msgs/msg/detail/header__struct.hpp>
 #include <stdexcept>
@@ -24,6 +31,103 @@
 #include <vector>
 namespace {
 constexpr auto kHistoryDepth = 10;
+constexpr auto kDefaultJpegQuality = 90;
+// Minimum time between warnings about compressed images which could not be decoded, in milliseconds.
+constexpr auto kDecodeFailureWarningPeriodMs = 5000;
+// How often the camera extrinsics are looked up to check whether the virtual camera needs to be rebuilt
+constexpr auto kCalibrationCheckPeriod = std::chrono::seconds{1};
+// Changes in camera extrinsics smaller than these, in meters and radians respectively, are treated as noise
+constexpr auto kTranslationTolerance = 1e-4;
+constexpr auto kRotationTolerance = 1e-4;
+// Size in pixels of the blocks the gain compensator computes a gain for
+constexpr auto kGainBlockSize = 32;
+// Number of neighbouring blocks the gain compensator smooths each block's gain with, which is one per filtering
+// iteration and there are two by default
+constexpr auto kGainFilterMarginBlocks = 2;
+
+/**
+ * The camera synchronizer and camera handle share the same node and both need some of the same parameters, so whichever
+ * is constructed second must read the value declared by the first instead of declaring it again.
+ */
+template <typename ParameterT>
+ParameterT declareOrGetParameter(rclcpp::Node& node, const std::string& name, const ParameterT& default_value) {
+  if (node.has_parameter(name)) {
+    return node.get_parameter(name).get_value<ParameterT>();
+  }
+  return node.declare_parameter(name, default_value);
+}
+
+/** Read the decode scale parameter, falling back to full scale if it is not a scale that JPEG decoding supports. */
+int getDecodeScale(rclcpp::Node& node) {
+  const auto scale = static_cast<int>(declareOrGetParameter<int64_t>(node, "input_decode_scale", 1));
+  if (scale != 1 && scale != 2 && scale != 4 && scale != 8) {
+    RCLCPP_ERROR(node.get_logger(), "input_decode_scale must be one of 1, 2, 4 or 8. Got %d, using 1 instead.", scale);
+    return 1;
+  }
+  return scale;
+}
+
+int toImreadFlag(int decode_scale) {
+  switch (decode_scale) {
+    case 2:
+      return cv::IMREAD_REDUCED_COLOR_2;
+    case 4:
+      return cv::IMREAD_REDUCED_COLOR_4;
+    case 8:
+      return cv::IMREAD_REDUCED_COLOR_8;
+    default:
+      return cv::IMREAD_COLOR;
+  }
+}
+
+/** Scale virtual camera intrinsics tuned for full resolution images to match images decoded at a reduced scale. */
+cv::Matx33d scaleIntrinsics(cv::Matx33d intrinsics, int decode_scale) {
+  intrinsics(0, 0) /= decode_scale;
+  intrinsics(0, 2) /= decode_scale;
+  intrinsics(1, 1) /= decode_scale;
+  intrinsics(1, 2) /= decode_scale;
+  return intrinsics;
+}
+
+/** Scale a row padding tuned for full resolution images to the nearest one for images decoded at a reduced scale. */
+int scaleRowPadding(int row_padding, int decode_scale) {
+  return static_cast<int>(std::lround(static_cast<double>(row_padding) / decode_scale));
+}
+
+/**
+ * Grow an ROI of the stitched image to whole gain compensator blocks, plus the blocks that are smoothed into them.
+ * The compensator lays its blocks out from the corner of each image it is fed, so this keeps the blocks of a cropped
+ * image where they would be in the full stitched image and the gains match the ones computed without cropping.
+ */
+cv::Rect alignToGainBlocks(const cv::Rect& roi, const cv::Size& image_size) {
+  const auto align_down = [](int value) {
+    return std::max(0, (value / kGainBlockSize - kGainFilterMarginBlocks) * kGainBlockSize);
+  };
+  const auto align_up = [](int value, int limit) {
+    return std::min(limit, ((value + kGainBlockSize - 1) / kGainBlockSize + kGainFilterMarginBlocks) * kGainBlockSize);
+  };
+  const cv::Point top_left{align_down(roi.x), align_down(roi.y)};
+  const cv::Point bottom_right{align_up(roi.br().x, image_size.width), align_up(roi.br().y, image_size.height)};
+  return cv::Rect{top_left, bottom_right};
+}
+
+/** Scale the intrinsics in a CameraInfo to match an image that was decoded at a reduced size. */
+spot_ros2::CameraInfo scaleCameraInfo(const spot_ros2::CameraInfo& info, const cv::Size& decoded_size) {
+  auto scaled = info;
+  const double scale_x = static_cast<double>(decoded_size.width) / info.width;
+  const double scale_y = static_cast<double>(decoded_size.height) / info.height;
+  scaled.width = decoded_size.width;
+  scaled.height = decoded_size.height;
+  scaled.k[0] *= scale_x;  // fx
+  scaled.k[2] *= scale_x;  // cx
+  scaled.k[4] *= scale_y;  // fy
+  scaled.k[5] *= scale_y;  // cy
+  scaled.p[0] *= scale_x;
+  scaled.p[2] *= scale_x;
+  scaled.p[5] *= scale_y;
+  scaled.p[6] *= scale_y;
+  return scaled;
+}
 
 cv::Vec3d toCvVec3d(const std::vector<double>& flattened) {
   if (flattened.size() != 3) {
@@ -170,6 +274,31 @@ cv::Matx44d middle(const cv::Matx44d& T1, const cv::Matx44d& T2) {
   return T3;
 }
 
+bool isSameRotation(const geometry_msgs::msg::Quaternion& a, const geometry_msgs::msg::Quaternion& b) {
+  const cv::Quatd qa = cv::Quatd{a.w, a.x, a.y, a.z}.normalize();
+  const cv::Quatd qb = cv::Quatd{b.w, b.x, b.y, b.z}.normalize();
+  // q and -q are the same rotation, so only the magnitude of the dot product tells how far apart they are
+  const double dot = std::abs(qa.dot(qb));
+  return 2. * std::acos(std::min(dot, 1.)) < kRotationTolerance;
+}
+
+bool isSameTransform(const geometry_msgs::msg::Transform& a, const geometry_msgs::msg::Transform& b) {
+  return std::abs(a.translation.x - b.translation.x) < kTranslationTolerance &&
+         std::abs(a.translation.y - b.translation.y) < kTranslationTolerance &&
+         std::abs(a.translation.z - b.translation.z) < kTranslationTolerance && isSameRotation(a.rotation, b.rotation);
+}
+
+bool isSameIntrinsics(const spot_ros2::CameraInfo& a, const spot_ros2::CameraInfo& b) {
+  return a.width == b.width && a.height == b.height && a.k == b.k;
+}
+
+bool isSameCalibration(const spot_ros2::MiddleCameraInputs& a, const spot_ros2::MiddleCameraInputs& b) {
+  return a.intrinsics == b.intrinsics && a.plane_normal == b.plane_normal && a.plane_distance == b.plane_distance &&
+         a.row_padding == b.row_padding && isSameTransform(a.body_tform_left, b.body_tform_left) &&
+         isSameTransform(a.body_tform_right, b.body_tform_right) && isSameIntrinsics(a.info_left, b.info_left) &&
+         isSameIntrinsics(a.info_right, b.info_right);
+}
+
 // https://docs.opencv.org/4.x/d9/dab/tutorial_homography.html#tutorial_homography_Demo3
 cv::Matx33d computeHomography(const cv::Matx33d& Km, const cv::Matx33d& Kc, const cv::Matx44d& cTm,
                               double plane_distance, const cv::Vec3d& plane_normal) {
@@ -188,28 +317,76 @@ cv::Matx33d computeHomography(const cv::Matx33d& Km, const cv::Matx33d& Kc, cons
 
 namespace spot_ros2 {
 
-RclcppCameraSynchronizer::RclcppCameraSynchronizer(const std::shared_ptr<rclcpp::Node>& node) {
+RclcppCameraSynchronizer::RclcppCameraSynchronizer(const std::shared_ptr<rclcpp::Node>& node)
+    : decode_scale_{getDecodeScale(*node)}, logger_{node->get_logger()}, clock_{node->get_clock()} {
   // These topics are remapped onto the actual Spot camera topics in the launch file
-  subscriber_image1_.subscribe(node.get(), "left/image", "raw");
   subscriber_info1_.subscribe(node, "left/camera_info");
-  subscriber_image2_.subscribe(node.get(), "right/image", "raw");
   subscriber_info2_.subscribe(node, "right/camera_info");
-
-  sync_ = std::make_unique<Synchronizer>(ApproximateTimePolicy(kHistoryDepth), subscriber_image1_, subscriber_info1_,
-                                         subscriber_image2_, subscriber_info2_);
+  if (declareOrGetParameter(*node, "compressed_input", false)) {
+    subscriber_compressed1_.subscribe(node, "left/compressed");
+    subscriber_compressed2_.subscribe(node, "right/compressed");
+    compressed_sync_ = std::make_unique<CompressedSynchronizer>(CompressedApproximateTimePolicy(kHistoryDepth),
+                                                                subscriber_compressed1_, subscriber_info1_,
+                                                                subscriber_compressed2_, subscriber_info2_);
+  } else {
+    subscriber_image1_.subscribe(node.get(), "left/image", "raw");
+    subscriber_image2_.subscribe(node.get(), "right/image", "raw");
+    sync_ = std::make_unique<Synchronizer>(ApproximateTimePolicy(kHistoryDepth), subscriber_image1_, subscriber_info1_,
+                                           subscriber_image2_, subscriber_info2_);
+  }
 }
 
 void RclcppCameraSynchronizer::registerCallback(const DualImageCallbackFn& fn) {
-  // This must be a bind instead of a lambda because of how registerCallback is templated within message_filters.
+  // These must be binds instead of lambdas because of how registerCallback is templated within message_filters.
+  if (compressed_sync_) {
+    callback_ = fn;
+    compressed_sync_->registerCallback(std::bind(&RclcppCameraSynchronizer::compressedCallback, this,
+                                                 std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+                                                 std::placeholders::_4));
+    return;
+  }
   sync_->registerCallback(
       std::bind(fn, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
 }
 
+void RclcppCameraSynchronizer::compressedCallback(const std::shared_ptr<const CompressedImage>& image_left,
+                                                  const std::shared_ptr<const CameraInfo>& info_left,
+                                                  const std::shared_ptr<const CompressedImage>& image_right,
+                                                  const std::shared_ptr<const CameraInfo>& info_right) {
+  // JPEG decoding dominates the cost of the compressed pipeline, so decode both images at the same time. Decoding at a
+  // reduced scale lets libjpeg skip most of the inverse DCT work rather than resizing after a full decode.
+  const std::array<const CompressedImage*, 2> compressed{image_left.get(), image_right.get()};
+  std::array<cv::Mat, 2> decoded;
+  const auto flag = toImreadFlag(decode_scale_);
+  cv::parallel_for_(cv::Range{0, 2}, [&](const cv::Range& range) {
+    for (int ndx = range.start; ndx < range.end; ++ndx) {
+      decoded[ndx] = cv::imdecode(compressed[ndx]->data, flag);
+    }
+  });
+  if (decoded[0].empty() || decoded[1].empty()) {
+    // Both images are named in one message, since a throttled log statement only logs the first of several messages.
+    std::string failures;
+    for (std::size_t ndx = 0; ndx < decoded.size(); ++ndx) {
+      if (decoded[ndx].empty()) {
+        failures += (failures.empty() ? "" : ", ") + compressed[ndx]->header.frame_id + " (format \"" +
+                    compressed[ndx]->format + "\")";
+      }
+    }
+    RCLCPP_WARN_THROTTLE(logger_, *clock_, kDecodeFailureWarningPeriodMs,
+                         "Could not decode the compressed images of camera %s. Dropping the image pair.",
+                         failures.c_str());
+    return;
+  }
+
+  const auto left = cv_bridge::CvImage(image_left->header, "bgr8", decoded[0]).toImageMsg();
+  const auto right = cv_bridge::CvImage(image_right->header, "bgr8", decoded[1]).toImageMsg();
+  const auto scaled_info_left = std::make_shared<const CameraInfo>(scaleCameraInfo(*info_left, decoded[0].size()));
+  const auto scaled_info_right = std::make_shared<const CameraInfo>(scaleCameraInfo(*info_right, decoded[1].size()));
+  callback_(left, scaled_info_left, right, scaled_info_right);
+}
+
 RclcppCameraHandle::RclcppCameraHandle(const std::shared_ptr<rclcpp::Node>& node)
-    : image_transport_{node},
-      camera_publisher_{
-          image_transport_.advertiseCamera("virtual_camera/image", 1)},  // Remap to actual topic in launch file
-      tf_broadcaster_{node} {
+    : node_{node}, image_transport_{node}, tf_broadcaster_{node} {
   const auto spot_name = node->declare_parameter("spot_name", "");
   const auto frame_prefix = spot_name.empty() ? "" : spot_name + "/";
   // Name of the frame to relate the virtual camera with respect to
@@ -238,10 +415,54 @@ RclcppCameraHandle::RclcppCameraHandle(const std::shared_ptr<rclcpp::Node>& node
   plane_distance_ = node->declare_parameter("virtual_camera_plane_distance", 1.);
   // Amount to increase the size of the stitched image rows from the original camera image rows
   row_padding_ = node->declare_parameter("stitched_image_row_padding", 0);
+
+  // The virtual camera parameters are tuned for full resolution images, so scale them down to match the input images
+  // when those are decoded at a reduced scale.
+  decode_scale_ = declareOrGetParameter(*node, "compressed_input", false) ? getDecodeScale(*node) : 1;
+  intrinsics_ = scaleIntrinsics(intrinsics_, decode_scale_);
+  row_padding_ = scaleRowPadding(row_padding_, decode_scale_);
+
+  // Allow the virtual camera to be retuned without restarting the node. New values are validated before they are set
+  // and only applied once the parameter event reports that they were actually set.
+  parameter_callback_handle_ = node->add_on_set_parameters_callback(
+      [this](const std::vector<rclcpp::Parameter>& parameters) { return onSetParameters(parameters); });
+  parameter_event_handler_ = std::make_shared<rclcpp::ParameterEventHandler>(node);
+  parameter_event_callback_handle_ = parameter_event_handler_->add_parameter_event_callback(
+      [this](const rcl_interfaces::msg::ParameterEvent& event) { onParameterEvent(event); });
+
+  // Remap to actual topics in launch file
+  compressed_output_ = node->declare_parameter("compressed_output", false);
+  compressed_output_quality_ = node->declare_parameter("compressed_output_quality", kDefaultJpegQuality);
+  if (compressed_output_) {
+    compressed_publisher_ = node->create_publisher<CompressedImage>("virtual_camera/compressed", 1);
+    info_publisher_ = node->create_publisher<CameraInfo>("virtual_camera/camera_info", 1);
+  } else {
+    camera_publisher_ = image_transport_.advertiseCamera("virtual_camera/image", 1);
+  }
 }
 
 void RclcppCameraHandle::publish(const Image& image, const CameraInfo& info) const {
-  camera_publisher_.publish(image, info);
+  if (!compressed_output_) {
+    camera_publisher_.publish(image, info);
+    return;
+  }
+  // JPEG encoding expects BGR images. The stitched image is shared without copying it if it already is, and converted
+  // otherwise. The image outlives the call, so the shared image does not need to track it.
+  cv_bridge::CvImageConstPtr bgr_image;
+  try {
+    bgr_image = cv_bridge::toCvShare(image, nullptr, sensor_msgs::image_encodings::BGR8);
+  } catch (const cv_bridge::Exception& e) {
+    RCLCPP_ERROR(node_->get_logger(), "Cannot compress stitched image with encoding %s: %s", image.encoding.c_str(),
+                 e.what());
+    return;
+  }
+  CompressedImage compressed;
+  compressed.header = image.header;
+  // Same format as compressed_image_transport, so that its subscribers can decode the image
+  compressed.format = image.encoding + "; jpeg compressed " + sensor_msgs::image_encodings::BGR8;
+  cv::imencode(".jpg", bgr_image->image, compressed.data, {cv::IMWRITE_JPEG_QUALITY, compressed_output_quality_});
+  compressed_publisher_->publish(compressed);
+  info_publisher_->publish(info);
 }
 
 void RclcppCameraHandle::broadcast(const Transform& tf, const Time& stamp) {
@@ -262,21 +483,103 @@ std::string RclcppCameraHandle::getCameraFrame() const {
 }
 
 cv::Matx33d RclcppCameraHandle::getIntrinsics() const {
+  std::lock_guard lock{parameters_mutex_};
   return intrinsics_;
 }
 
 cv::Vec3d RclcppCameraHandle::getPlaneNormal() const {
+  std::lock_guard lock{parameters_mutex_};
   return plane_normal_;
 }
 
 double RclcppCameraHandle::getPlaneDistance() const {
+  std::lock_guard lock{parameters_mutex_};
   return plane_distance_;
 }
 
 int RclcppCameraHandle::getRowPadding() const {
+  std::lock_guard lock{parameters_mutex_};
   return row_padding_;
 }
 
+void RclcppCameraHandle::registerParameterCallback(const std::function<void()>& fn) {
+  std::lock_guard lock{parameters_mutex_};
+  parameter_changed_callback_ = fn;
+}
+
+bool RclcppCameraHandle::parseParameters(const std::vector<rclcpp::Parameter>& parameters, cv::Matx33d& intrinsics,
+                                         cv::Vec3d& plane_normal, double& plane_distance, int& row_padding) const {
+  bool parsed_any = false;
+  for (const auto& parameter : parameters) {
+    const auto& name = parameter.get_name();
+    if (name == "virtual_camera_intrinsics") {
+      intrinsics = scaleIntrinsics(toCvMatx33d(parameter.as_double_array()), decode_scale_);
+    } else if (name == "virtual_camera_projection_plane") {
+      plane_normal = toCvVec3d(parameter.as_double_array());
+    } else if (name == "virtual_camera_plane_distance") {
+      plane_distance = parameter.as_double();
+    } else if (name == "stitched_image_row_padding") {
+      row_padding = scaleRowPadding(static_cast<int>(parameter.as_int()), decode_scale_);
+    } else {
+      continue;
+    }
+    parsed_any = true;
+  }
+  return parsed_any;
+}
+
+rcl_interfaces::msg::SetParametersResult RclcppCameraHandle::onSetParameters(
+    const std::vector<rclcpp::Parameter>& parameters) const {
+  rcl_interfaces::msg::SetParametersResult result;
+  result.successful = true;
+  // Another callback can still reject the update after this one, so only check that the values parse here and leave
+  // applying them to onParameterEvent
+  cv::Matx33d intrinsics;
+  cv::Vec3d plane_normal;
+  double plane_distance{};
+  int row_padding{};
+  try {
+    parseParameters(parameters, intrinsics, plane_normal, plane_distance, row_padding);
+  } catch (const std::exception& e) {
+    // Either a wrong number of elements or a wrong parameter type
+    result.successful = false;
+    result.reason = e.what();
+  }
+  return result;
+}
+
+void RclcppCameraHandle::onParameterEvent(const rcl_interfaces::msg::ParameterEvent& event) {
+  if (event.node != node_->get_fully_qualified_name()) {
+    return;
+  }
+  std::function<void()> parameter_changed_callback;
+  {
+    std::lock_guard lock{parameters_mutex_};
+    // Parse everything before applying anything, so that a value that fails to parse leaves the camera untouched
+    auto intrinsics = intrinsics_;
+    auto plane_normal = plane_normal_;
+    auto plane_distance = plane_distance_;
+    auto row_padding = row_padding_;
+    try {
+      if (!parseParameters(rclcpp::ParameterEventHandler::get_parameters_from_event(event), intrinsics, plane_normal,
+                           plane_distance, row_padding)) {
+        return;
+      }
+    } catch (const std::exception& e) {
+      RCLCPP_ERROR(node_->get_logger(), "Could not apply virtual camera parameters: %s", e.what());
+      return;
+    }
+    intrinsics_ = intrinsics;
+    plane_normal_ = plane_normal;
+    plane_distance_ = plane_distance;
+    row_padding_ = row_padding;
+    parameter_changed_callback = parameter_changed_callback_;
+  }
+  if (parameter_changed_callback) {
+    parameter_changed_callback();
+  }
+}
+
 MiddleCamera::MiddleCamera(const cv::Matx33d& virtual_intrinsics, const cv::Vec3d& plane_normal, double plane_distance,
                            int row_padding, const Transform& body_tform_left, const Transform& body_tform_right,
                            const CameraInfo& info_left, const CameraInfo& info_right)
@@ -284,13 +587,15 @@ MiddleCamera::MiddleCamera(const cv::Matx33d& virtual_intrinsics, const cv::Vec3
       body_tform_right_{toCvMatx44d(body_tform_right)},
       body_tform_virtual_{middle(toCvMatx44d(body_tform_left), toCvMatx44d(body_tform_right))},
       homography_(2),
-      corners_{cv::Point{0, 0}, cv::Point{0, 0}},
+      rois_(2),
+      corners_(2),
       warped_images_(2),
       warped_images_f_(2),
       warped_images_s_(2),
       warped_masks_(2),
       level_masks_(2),
-      result_size_{static_cast<int>(info_left.width), static_cast<int>(info_left.height) + row_padding} {
+      result_size_{static_cast<int>(info_left.width), static_cast<int>(info_left.height) + row_padding},
+      compensator_{kGainBlockSize, kGainBlockSize} {
   /**
    * The math behind these homography computations for the virtual camera can be found here
    * https://docs.opencv.org/4.x/d9/dab/tutorial_homography.html#tutorial_homography_Demo3
@@ -310,11 +615,25 @@ MiddleCamera::MiddleCamera(const cv::Matx33d& virtual_intrinsics, const cv::Vec3
   homography_[1] =
       computeHomography(virtual_intrinsics, right_intrinsics, right_tform_virtual, plane_distance, plane_normal);
 
-  // Warp white masks the size of the image using their homographies
+  // Warp white masks the size of the image using their homographies, then crop each one to the region it covers. The
+  // homographies are offset to warp straight into those regions, so later warps never touch pixels outside them.
   const cv::Size input_size{static_cast<int>(info_left.width), static_cast<int>(info_left.height)};
   for (size_t ndx = 0; ndx < warped_masks_.size(); ++ndx) {
-    cv::warpPerspective(cv::UMat{input_size, CV_8U, 255}, warped_masks_[ndx], homography_[ndx], result_size_);
+    cv::UMat full_mask;
+    cv::warpPerspective(cv::UMat{input_size, CV_8U, 255}, full_mask, homography_[ndx], result_size_);
+    const auto covered = cv::boundingRect(full_mask);
+    // If the image does not project into the stitched image at all, fall back to the full image so that the rest of
+    // the pipeline still has valid (empty) inputs to work with.
+    rois_[ndx] = covered.empty() ? cv::Rect{cv::Point{0, 0}, result_size_} : alignToGainBlocks(covered, result_size_);
+    corners_[ndx] = rois_[ndx].tl();
+    full_mask(rois_[ndx]).copyTo(warped_masks_[ndx]);
+    const cv::Matx33d roi_tform_result{1., 0., -static_cast<double>(corners_[ndx].x),  //
+                                       0., 1., -static_cast<double>(corners_[ndx].y),  //
+                                       0., 0., 1.};
+    homography_[ndx] = roi_tform_result * homography_[ndx];
   }
+  blend_roi_ = rois_[0] | rois_[1];
+  result_ = cv::UMat{result_size_, CV_8UC3, cv::Scalar::all(0)};
   // Prepare level masks for color compensator
   for (size_t ndx = 0; ndx < warped_masks_.size(); ++ndx) {
     level_masks_[ndx] = std::make_pair(warped_masks_[ndx], 255);
@@ -322,7 +641,18 @@ MiddleCamera::MiddleCamera(const cv::Matx33d& virtual_intrinsics, const cv::Vec3
 }
 
 Image::SharedPtr MiddleCamera::stitch(const std::shared_ptr<const Image>& left,
-                                      const std::shared_ptr<const Image>& right) {
+                                      const std::shared_ptr<const Image>& right, StitchTimings* timings) {
+  using Clock = std::chrono::steady_clock;
+  auto stage_start = Clock::now();
+  // Adds the time since the end of the previous stage to one of the timing fields
+  const auto record_stage = [&stage_start, timings](std::chrono::nanoseconds StitchTimings::*stage) {
+    const auto now = Clock::now();
+    if (timings != nullptr) {
+      timings->*stage = now - stage_start;
+    }
+    stage_start = now;
+  };
+
   // Convert the images into a format the can be used by opencv.
   // While the image is coming from the camera on the left of the robot, it sees the right side
   // of the scene and vice versa. This may need to be extracted if this code is to be generalized
@@ -331,14 +661,16 @@ Image::SharedPtr MiddleCamera::stitch(const std::shared_ptr<const Image>& left,
   const auto scene_left = cv_bridge::toCvShare(right);
 
   // Transform the images into the virtual center camera space
-  cv::warpPerspective(scene_left->image, warped_images_[0], homography_[0], result_size_);
-  cv::warpPerspective(scene_right->image, warped_images_[1], homography_[1], result_size_);
+  cv::warpPerspective(scene_left->image, warped_images_[0], homography_[0], rois_[0].size());
+  cv::warpPerspective(scene_right->image, warped_images_[1], homography_[1], rois_[1].size());
+  record_stage(&StitchTimings::warp);
 
   // Color compensate the images so they blend better
   compensator_.feed(corners_, warped_images_, level_masks_);
   for (size_t ndx = 0; ndx < warped_images_.size(); ndx++) {
     compensator_.apply(ndx, corners_[ndx], warped_images_[ndx], warped_masks_);
   }
+  record_stage(&StitchTimings::compensate);
 
   // Create seam masks for the two images to find the best path to blend them
   // Convert images to a different colorspace for seaming
@@ -347,21 +679,24 @@ Image::SharedPtr MiddleCamera::stitch(const std::shared_ptr<const Image>& left,
   }
   // Find optimal seams to cut at
   seamer_.find(warped_images_f_, corners_, warped_masks_);
+  record_stage(&StitchTimings::seam);
 
   // Blend the images together around the seam
-  // Tell the blender to consider the whole warped image for blending
-  blender_.prepare(cv::Rect{cv::Point{0, 0}, result_size_});
+  // Tell the blender to consider only the region covered by the warped images
+  blender_.prepare(blend_roi_);
   // Convert images to a different colorspace for blending
   for (size_t ndx = 0; ndx < warped_images_.size(); ndx++) {
     warped_images_[ndx].convertTo(warped_images_s_[ndx], CV_16S);
   }
   // Feed the warped images and their masks to the blender
-  blender_.feed(warped_images_s_[0], warped_masks_[0], cv::Point{0, 0});
-  blender_.feed(warped_images_s_[1], warped_masks_[1], cv::Point{0, 0});
-  blender_.blend(result_, blend_mask_);
-
-  // Convert the image back to the BGR color space
-  result_.convertTo(result_, CV_8U);
+  blender_.feed(warped_images_s_[0], warped_masks_[0], corners_[0]);
+  blender_.feed(warped_images_s_[1], warped_masks_[1], corners_[1]);
+  blender_.blend(blended_, blend_mask_);
+
+  // Convert the image back to the BGR color space, writing it into its place in the stitched image
+  cv::UMat result_region = result_(blend_roi_);
+  blended_.convertTo(result_region, CV_8U);
+  record_stage(&StitchTimings::blend);
   // Return the image in a format that can be published
   return cv_bridge::CvImage(std_msgs::msg::Header{}, "bgr8", result_.getMat(cv::ACCESS_READ)).toImageMsg();
 }
@@ -379,7 +714,13 @@ ImageStitcher::ImageStitcher(std::unique_ptr<CameraSynchronizerBase> synchronize
     : synchronizer_{std::move(synchronizer)},
       tf_listener_{std::move(tf_listener)},
       camera_handle_{std::move(camera_handle)},
-      logger_{std::move(logger)} {
+      logger_{std::move(logger)},
+      rebuild_thread_{[this]() {
+        rebuildLoop();
+      }} {
+  camera_handle_->registerParameterCallback([this]() {
+    parameters_changed_ = true;
+  });
   synchronizer_->registerCallback(
       [this](const std::shared_ptr<const Image>& image_left, const std::shared_ptr<const CameraInfo>& info_left,
              const std::shared_ptr<const Image>& image_right, const std::shared_ptr<const CameraInfo>& info_right) {
@@ -387,52 +728,133 @@ ImageStitcher::ImageStitcher(std::unique_ptr<CameraSynchronizerBase> synchronize
       });
 }
 
+ImageStitcher::~ImageStitcher() {
+  {
+    std::lock_guard lock{rebuild_mutex_};
+    stop_rebuild_thread_ = true;
+  }
+  rebuild_condition_.notify_one();
+  rebuild_thread_.join();
+}
+
 void ImageStitcher::callback(const std::shared_ptr<const Image>& image_left,
                              const std::shared_ptr<const CameraInfo>& info_left,
                              const std::shared_ptr<const Image>& image_right,
                              const std::shared_ptr<const CameraInfo>& info_right) {
-  // The transforms and camera info are assumed to be static, so we only need to lookup these
-  // things once, and use them to initialize the stitching camera. It cannot stitch without these
-  // parameters so if we can't get them we have to exit the callback.
-  if (!camera_.has_value()) {
-    const auto body_frame = camera_handle_->getBodyFrame();
-    const auto body_tform_left =
-        tf_listener_->lookupTransform(info_left->header.frame_id, body_frame, info_left->header.stamp);
-    const auto body_tform_right =
-        tf_listener_->lookupTransform(info_right->header.frame_id, body_frame, info_right->header.stamp);
-    if (!body_tform_left || !body_tform_right) {
-      if (!body_tform_left) {
-        logger_->logWarn("Valid transform for image frame " + info_left->header.frame_id + " to " + body_frame +
-                         " could not be found");
-      }
-      if (!body_tform_right) {
-        logger_->logWarn("Valid transform for image frame " + info_right->header.frame_id + " to " + body_frame +
-                         " could not be found");
-      }
-      return;
-    }
-    // Build the stitching camera
-    camera_ = MiddleCamera{camera_handle_->getIntrinsics(),
-                           camera_handle_->getPlaneNormal(),
-                           camera_handle_->getPlaneDistance(),
-                           camera_handle_->getRowPadding(),
-                           body_tform_left->transform,
-                           body_tform_right->transform,
-                           *info_left,
-                           *info_right};
-    // Virtual camera transform only has to be broadcast once since it is static wrt the body
-    camera_handle_->broadcast(camera_->getTransform(), info_left->header.stamp);
+  const auto camera = std::atomic_load(&camera_);
+  const rclcpp::Time stamp{info_left->header.stamp};
+  // If the stamps jumped backwards, as when a bag loops or simulated time is reset, check again right away instead of
+  // waiting for the stamps to catch up with the last check
+  if (last_calibration_check_.has_value() && stamp < *last_calibration_check_) {
+    last_calibration_check_.reset();
+  }
+  // The transforms and camera info rarely change, so only check them periodically, or right away if there is no camera
+  // yet or a virtual camera parameter was changed. The camera is built on rebuild_thread_, so this never stalls.
+  if (!camera || parameters_changed_.exchange(false) || !last_calibration_check_.has_value() ||
+      stamp - *last_calibration_check_ >= rclcpp::Duration{kCalibrationCheckPeriod}) {
+    last_calibration_check_ = stamp;
+    checkForCalibrationChange(camera, *info_left, *info_right);
   }
+  // The stitcher cannot run until the first camera has been built
+  if (!camera) {
+    return;
+  }
+
+  // Virtual camera transform only has to be broadcast when the camera changes since it is static wrt the body
+  if (camera != broadcast_camera_) {
+    camera_handle_->broadcast(camera->camera.getTransform(), info_left->header.stamp);
+    broadcast_camera_ = camera;
+  }
+
   const auto& current_stamp = info_left->header.stamp;
   const auto& camera_frame = camera_handle_->getCameraFrame();
   // The rest of the time we should just be stitching and publishing
-  const auto image_stitched = camera_->stitch(image_left, image_right);
+  const auto image_stitched = camera->camera.stitch(image_left, image_right);
   image_stitched->header.stamp = current_stamp;
   image_stitched->header.frame_id = camera_frame;
   // The only reason we have to remake this every time is to update the time stamp
   const auto info_stitched = toCameraInfo(current_stamp, camera_frame, image_stitched->width, image_stitched->height,
-                                          camera_handle_->getIntrinsics());
+                                          camera->inputs.intrinsics);
   camera_handle_->publish(*image_stitched, info_stitched);
 }
 
+void ImageStitcher::checkForCalibrationChange(const std::shared_ptr<const BuiltCamera>& current,
+                                              const CameraInfo& info_left, const CameraInfo& info_right) {
+  const auto body_frame = camera_handle_->getBodyFrame();
+  const auto body_tform_left =
+      tf_listener_->lookupTransform(info_left.header.frame_id, body_frame, info_left.header.stamp);
+  const auto body_tform_right =
+      tf_listener_->lookupTransform(info_right.header.frame_id, body_frame, info_right.header.stamp);
+  if (!body_tform_left || !body_tform_right) {
+    // Once there is a camera, keep stitching with it and try again at the next check
+    if (current) {
+      return;
+    }
+    if (!body_tform_left) {
+      logger_->logWarn("Valid transform for image frame " + info_left.header.frame_id + " to " + body_frame +
+                       " could not be found");
+    }
+    if (!body_tform_right) {
+      logger_->logWarn("Valid transform for image frame " + info_right.header.frame_id + " to " + body_frame +
+                       " could not be found");
+    }
+    return;
+  }
+
+  MiddleCameraInputs inputs{camera_handle_->getIntrinsics(),
+                            camera_handle_->getPlaneNormal(),
+                            camera_handle_->getPlaneDistance(),
+                            camera_handle_->getRowPadding(),
+                            body_tform_left->transform,
+                            body_tform_right->transform,
+                            info_left,
+                            info_right};
+  if (current && isSameCalibration(current->inputs, inputs)) {
+    return;
+  }
+  if (requested_inputs_.has_value() && isSameCalibration(*requested_inputs_, inputs)) {
+    // This rebuild is already queued or in progress
+    return;
+  }
+  requested_inputs_ = inputs;
+  {
+    std::lock_guard lock{rebuild_mutex_};
+    pending_rebuild_ = std::move(inputs);
+  }
+  rebuild_condition_.notify_one();
+}
+
+void ImageStitcher::rebuildLoop() {
+  while (true) {
+    MiddleCameraInputs inputs;
+    {
+      std::unique_lock lock{rebuild_mutex_};
+      rebuild_condition_.wait(lock, [this]() {
+        return stop_rebuild_thread_ || pending_rebuild_.has_value();
+      });
+      if (stop_rebuild_thread_) {
+        return;
+      }
+      inputs = std::move(*pending_rebuild_);
+      pending_rebuild_.reset();
+    }
+
+    // Building the camera warps its masks over the whole output, which is too slow to do between two frames
+    std::shared_ptr<BuiltCamera> camera;
+    try {
+      camera = std::make_shared<BuiltCamera>(BuiltCamera{
+          inputs, MiddleCamera{inputs.intrinsics, inputs.plane_normal, inputs.plane_distance, inputs.row_padding,
+                               inputs.body_tform_left, inputs.body_tform_right, inputs.info_left, inputs.info_right}});
+    } catch (const std::exception& e) {
+      // An exception escaping this thread would terminate the node. Keep stitching with the current camera, if any,
+      // until the inputs change again.
+      logger_->logError(std::string{"Could not build virtual camera: "} + e.what());
+      continue;
+    }
+    const bool is_first_camera = std::atomic_load(&camera_) == nullptr;
+    std::atomic_store(&camera_, std::move(camera));
+    logger_->logInfo(is_first_camera ? "Built virtual camera" : "Rebuilt virtual camera with updated calibration");
+  }
+}
+
 }  // namespace spot_ros2
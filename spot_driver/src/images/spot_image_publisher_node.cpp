@@ -1,11 +1,13 @@
 // Copyright (c) 2023-2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
+#include <chrono>
 #include <memory>
 #include <spot_driver/images/spot_image_publisher_node.hpp>
 
 #include <spot_driver/api/default_spot_api.hpp>
 #include <spot_driver/images/images_middleware_handle.hpp>
 #include <spot_driver/images/spot_image_publisher.hpp>
+#include <spot_driver/interfaces/coalescing_tf_broadcaster_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_node_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_parameter_interface.hpp>
@@ -36,7 +38,12 @@ SpotImagePublisherNode::SpotImagePublisherNode(const rclcpp::NodeOptions& node_o
   auto mw_handle = std::make_unique<ImagesMiddlewareHandle>(node);
   auto parameters = std::make_unique<RclcppParameterInterface>(node);
   auto logger = std::make_unique<RclcppLoggerInterface>(node->get_logger());
-  auto tf_broadcaster = std::make_unique<RclcppTfBroadcasterInterface>(node);
+  std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster = std::make_unique<RclcppTfBroadcasterInterface>(node);
+  if (const auto tf_coalescing_rate = parameters->getTfCoalescingRate(); tf_coalescing_rate > 0.) {
+    tf_broadcaster = std::make_unique<CoalescingTfBroadcasterInterface>(
+        std::move(tf_broadcaster), std::make_unique<RclcppWallTimerInterface>(node),
+        std::chrono::duration<double>{1.0 / tf_coalescing_rate});
+  }
   auto timer = std::make_unique<RclcppWallTimerInterface>(node);
 
   auto spot_api = std::make_unique<DefaultSpotApi>(kSDKClientName, parameters->getCertificate());
@@ -0,0 +1,64 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/interfaces/coalescing_tf_broadcaster_interface.hpp>
+
+#include <rclcpp/time.hpp>
+
+#include <utility>
+
+namespace spot_ros2 {
+CoalescingTfBroadcasterInterface::CoalescingTfBroadcasterInterface(
+    std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
+    std::unique_ptr<TimerInterfaceBase> timer_interface, const std::chrono::duration<double> period)
+    : tf_broadcaster_interface_{std::move(tf_broadcaster_interface)}, timer_interface_{std::move(timer_interface)} {
+  timer_interface_->setTimer(period, [this]() {
+    flush();
+  });
+}
+
+void CoalescingTfBroadcasterInterface::updateStaticTransforms(
+    const std::vector<geometry_msgs::msg::TransformStamped>& transforms) {
+  std::lock_guard lock{mutex_};
+  collect(transforms, static_transforms_);
+}
+
+void CoalescingTfBroadcasterInterface::sendDynamicTransforms(
+    const std::vector<geometry_msgs::msg::TransformStamped>& transforms) {
+  std::lock_guard lock{mutex_};
+  collect(transforms, dynamic_transforms_);
+}
+
+void CoalescingTfBroadcasterInterface::collect(const std::vector<geometry_msgs::msg::TransformStamped>& transforms,
+                                               TransformsByChildFrame& collected) {
+  for (const auto& transform : transforms) {
+    const auto [it, inserted] = collected.try_emplace(transform.child_frame_id, transform);
+    // Transforms with equal stamps replace each other, so the transform submitted last wins
+    if (!inserted && rclcpp::Time{it->second.header.stamp} <= rclcpp::Time{transform.header.stamp}) {
+      it->second = transform;
+    }
+  }
+}
+
+void CoalescingTfBroadcasterInterface::flush() {
+  static_batch_.clear();
+  dynamic_batch_.clear();
+  {
+    // Only move the transforms out while holding the lock, so that publishing does not block submitters
+    std::lock_guard lock{mutex_};
+    for (auto& entry : static_transforms_) {
+      static_batch_.push_back(std::move(entry.second));
+    }
+    for (auto& entry : dynamic_transforms_) {
+      dynamic_batch_.push_back(std::move(entry.second));
+    }
+    static_transforms_.clear();
+    dynamic_transforms_.clear();
+  }
+  if (!static_batch_.empty()) {
+    tf_broadcaster_interface_->updateStaticTransforms(static_batch_);
+  }
+  if (!dynamic_batch_.empty()) {
+    tf_broadcaster_interface_->sendDynamicTransforms(dynamic_batch_);
+  }
+}
+}  // namespace spot_ros2
@@ -26,6 +26,59 @@ constexpr auto kParameterNamePublishCompressedImages = "publish_compressed_image
 constexpr auto kParameterNamePublishDepthImages = "publish_depth";
 constexpr auto kParameterNamePublishDepthRegisteredImages = "publish_depth_registered";
 constexpr auto kParameterPreferredOdomFrame = "preferred_odom_frame";
+constexpr auto kParameterNameAsyncRobotStatePolling = "async_robot_state_polling";
+constexpr auto kParameterNameAsyncRobotStatePollingRate = "async_robot_state_polling_rate";
+constexpr auto kParameterNameStreamRobotState = "stream_robot_state";
+constexpr auto kParameterNamePublishStatusOnChange = "publish_status_on_change";
+constexpr auto kParameterNameStatusHeartbeatPeriod = "status_heartbeat_period";
+constexpr auto kParameterNameSharedMemoryStateName = "shared_memory_state_name";
+constexpr auto kParameterNamePublishCompactJointStates = "publish_compact_joint_states";
+constexpr auto kParameterNameBodyTfExtrapolationRate = "body_tf_extrapolation_rate";
+constexpr auto kParameterNameBodyTfExtrapolationHorizon = "body_tf_extrapolation_horizon";
+constexpr auto kParameterNameWorldObjectSyncTranslationThreshold = "world_object_sync_translation_threshold";
+constexpr auto kParameterNameWorldObjectSyncRotationThreshold = "world_object_sync_rotation_threshold";
+constexpr auto kParameterNameWorldObjectSyncOnTfUpdates = "world_object_sync_on_tf_updates";
+constexpr auto kParameterNameTfCoalescingRate = "tf_coalescing_rate";
+constexpr auto kParameterNameWorldObjectDetectionRate = "world_object_detection_rate";
+
+/**
+ * @brief Get the name of the parameter that sets the publish rate of a robot state output. The names follow the topic
+ * each output is published on.
+ */
+std::string getRobotStatePublishRateParameterName(const spot_ros2::RobotStateOutput output) {
+  using spot_ros2::RobotStateOutput;
+  switch (output) {
+    case RobotStateOutput::BATTERY_STATES:
+      return "battery_states_publish_rate";
+    case RobotStateOutput::WIFI_STATE:
+      return "wifi_publish_rate";
+    case RobotStateOutput::FOOT_STATE:
+      return "feet_publish_rate";
+    case RobotStateOutput::ESTOP_STATES:
+      return "estop_publish_rate";
+    case RobotStateOutput::JOINT_STATES:
+      return "joint_states_publish_rate";
+    case RobotStateOutput::TF:
+      return "tf_publish_rate";
+    case RobotStateOutput::ODOM_TWIST:
+      return "odometry_twist_publish_rate";
+    case RobotStateOutput::ODOM:
+      return "odometry_publish_rate";
+    case RobotStateOutput::POWER_STATE:
+      return "power_states_publish_rate";
+    case RobotStateOutput::SYSTEM_FAULT_STATE:
+      return "system_faults_publish_rate";
+    case RobotStateOutput::MANIPULATOR_STATE:
+      return "manipulation_state_publish_rate";
+    case RobotStateOutput::END_EFFECTOR_FORCE:
+      return "end_effector_force_publish_rate";
+    case RobotStateOutput::BEHAVIOR_FAULT_STATE:
+      return "behavior_faults_publish_rate";
+    case RobotStateOutput::COMPACT_JOINT_STATES:
+      return "compact_joint_states_publish_rate";
+  }
+  return {};
+}
 
 /**
  * @brief Get a rclcpp parameter. If the parameter has not been declared, declare it with the provided default value and
@@ -186,6 +239,75 @@ std::string RclcppParameterInterface::getPreferredOdomFrame() const {
   return declareAndGetParameter<std::string>(node_, kParameterPreferredOdomFrame, kDefaultPreferredOdomFrame);
 }
 
+bool RclcppParameterInterface::getAsyncRobotStatePolling() const {
+  return declareAndGetParameter<bool>(node_, kParameterNameAsyncRobotStatePolling, kDefaultAsyncRobotStatePolling);
+}
+
+double RclcppParameterInterface::getAsyncRobotStatePollingRate() const {
+  return declareAndGetParameter<double>(node_, kParameterNameAsyncRobotStatePollingRate,
+                                        kDefaultAsyncRobotStatePollingRate);
+}
+
+bool RclcppParameterInterface::getStreamRobotState() const {
+  return declareAndGetParameter<bool>(node_, kParameterNameStreamRobotState, kDefaultStreamRobotState);
+}
+
+double RclcppParameterInterface::getRobotStatePublishRate(const RobotStateOutput output) const {
+  return declareAndGetParameter<double>(node_, getRobotStatePublishRateParameterName(output),
+                                        kDefaultRobotStatePublishRate);
+}
+
+bool RclcppParameterInterface::getPublishStatusOnChange() const {
+  return declareAndGetParameter<bool>(node_, kParameterNamePublishStatusOnChange, kDefaultPublishStatusOnChange);
+}
+
+double RclcppParameterInterface::getStatusHeartbeatPeriod() const {
+  return declareAndGetParameter<double>(node_, kParameterNameStatusHeartbeatPeriod, kDefaultStatusHeartbeatPeriod);
+}
+
+bool RclcppParameterInterface::getPublishCompactJointStates() const {
+  return declareAndGetParameter<bool>(node_, kParameterNamePublishCompactJointStates,
+                                      kDefaultPublishCompactJointStates);
+}
+
+std::string RclcppParameterInterface::getSharedMemoryStateName() const {
+  return declareAndGetParameter<std::string>(node_, kParameterNameSharedMemoryStateName,
+                                             kDefaultSharedMemoryStateName);
+}
+
+double RclcppParameterInterface::getBodyTfExtrapolationRate() const {
+  return declareAndGetParameter<double>(node_, kParameterNameBodyTfExtrapolationRate, kDefaultBodyTfExtrapolationRate);
+}
+
+double RclcppParameterInterface::getBodyTfExtrapolationHorizon() const {
+  return declareAndGetParameter<double>(node_, kParameterNameBodyTfExtrapolationHorizon,
+                                        kDefaultBodyTfExtrapolationHorizon);
+}
+
+double RclcppParameterInterface::getWorldObjectSyncTranslationThreshold() const {
+  return declareAndGetParameter<double>(node_, kParameterNameWorldObjectSyncTranslationThreshold,
+                                        kDefaultWorldObjectSyncTranslationThreshold);
+}
+
+double RclcppParameterInterface::getWorldObjectSyncRotationThreshold() const {
+  return declareAndGetParameter<double>(node_, kParameterNameWorldObjectSyncRotationThreshold,
+                                        kDefaultWorldObjectSyncRotationThreshold);
+}
+
+bool RclcppParameterInterface::getWorldObjectSyncOnTfUpdates() const {
+  return declareAndGetParameter<bool>(node_, kParameterNameWorldObjectSyncOnTfUpdates,
+                                      kDefaultWorldObjectSyncOnTfUpdates);
+}
+
+double RclcppParameterInterface::getTfCoalescingRate() const {
+  return declareAndGetParameter<double>(node_, kParameterNameTfCoalescingRate, kDefaultTfCoalescingRate);
+}
+
+double RclcppParameterInterface::getWorldObjectDetectionRate() const {
+  return declareAndGetParameter<double>(node_, kParameterNameWorldObjectDetectionRate,
+                                        kDefaultWorldObjectDetectionRate);
+}
+
 std::set<spot_ros2::SpotCamera> RclcppParameterInterface::getDefaultCamerasUsed(const bool has_arm) const {
   const auto kDefaultCamerasUsed = has_arm ? kDefaultCamerasUsedWithArm : kDefaultCamerasUsedWithoutArm;
   std::set<spot_ros2::SpotCamera> spot_cameras_used;
@@ -2,27 +2,89 @@
 
 #include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
 
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/** @brief Static transforms whose translations differ by less than this many meters are considered equal. */
+constexpr auto kStaticTranslationTolerance = 1e-6;
+/** @brief Static transforms whose rotations differ by less than this many radians are considered equal. */
+constexpr auto kStaticRotationTolerance = 1e-6;
+/**
+ * @brief How far the absolute dot product of two unit quaternions may be below 1 for their rotations to be considered
+ * equal. A rotation by a small angle theta gives 1 - cos(theta / 2), which is about theta^2 / 8.
+ */
+constexpr auto kStaticRotationDotTolerance = kStaticRotationTolerance * kStaticRotationTolerance / 8.0;
+
+/**
+ * @brief Check whether two quaternions represent the same rotation within tolerance. The quaternions do not need to be
+ * normalized, since messages often carry quaternions which were rounded or never normalized.
+ */
+bool isSameRotation(const geometry_msgs::msg::Quaternion& lhs, const geometry_msgs::msg::Quaternion& rhs) {
+  // Repeated transforms usually carry exactly the same rotation
+  if (lhs.w == rhs.w && lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z) {
+    return true;
+  }
+  const auto lhs_norm = std::sqrt(lhs.w * lhs.w + lhs.x * lhs.x + lhs.y * lhs.y + lhs.z * lhs.z);
+  const auto rhs_norm = std::sqrt(rhs.w * rhs.w + rhs.x * rhs.x + rhs.y * rhs.y + rhs.z * rhs.z);
+  if (lhs_norm == 0.0 || rhs_norm == 0.0) {
+    return false;
+  }
+  // q and -q represent the same rotation, so compare the absolute value of the dot product of the quaternions. Unlike
+  // the angle between them, which would take acos(), this stays accurate for nearly equal rotations.
+  const auto dot = std::abs(lhs.w * rhs.w + lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z) / (lhs_norm * rhs_norm);
+  return 1.0 - dot <= kStaticRotationDotTolerance;
+}
+
+/**
+ * @brief Check whether two transforms to the same child frame have the same parent frame, and poses which are equal
+ * within tolerance. Timestamps are not compared, since static transforms apply at all times.
+ */
+bool isSameStaticTransform(const geometry_msgs::msg::TransformStamped& lhs,
+                           const geometry_msgs::msg::TransformStamped& rhs) {
+  if (lhs.header.frame_id != rhs.header.frame_id) {
+    return false;
+  }
+  const auto& lhs_translation = lhs.transform.translation;
+  const auto& rhs_translation = rhs.transform.translation;
+  const auto translation_distance =
+      std::hypot(lhs_translation.x - rhs_translation.x, lhs_translation.y - rhs_translation.y,
+                 lhs_translation.z - rhs_translation.z);
+  if (translation_distance > kStaticTranslationTolerance) {
+    return false;
+  }
+  return isSameRotation(lhs.transform.rotation, rhs.transform.rotation);
+}
+}  // namespace
+
 namespace spot_ros2 {
 RclcppTfBroadcasterInterface::RclcppTfBroadcasterInterface(const std::shared_ptr<rclcpp::Node>& node)
     : static_tf_broadcaster_{node}, dynamic_tf_broadcaster_{node} {}
 
 void RclcppTfBroadcasterInterface::updateStaticTransforms(
     const std::vector<geometry_msgs::msg::TransformStamped>& transforms) {
-  bool has_new_frame = false;
-  for (const auto& transform : transforms) {
-    // If one of the transforms is to a new child frame, flag that a new transform needs to be published and add the
-    // child frame to the set of currently-published frames.
-    if (current_static_child_frames_.count(transform.child_frame_id) == 0) {
-      has_new_frame = true;
-      current_static_child_frames_.insert(current_static_child_frames_.end(), transform.child_frame_id);
-    }
+  // Most calls repeat the transforms which were last published, so check for that first without copying anything.
+  const auto is_unchanged = [this](const geometry_msgs::msg::TransformStamped& transform) {
+    const auto it = current_static_transforms_.find(transform.child_frame_id);
+    return it != current_static_transforms_.end() && isSameStaticTransform(it->second, transform);
+  };
+  const auto first_changed = std::find_if_not(transforms.cbegin(), transforms.cend(), is_unchanged);
+  if (first_changed == transforms.cend()) {
+    return;
   }
 
-  // Only publish if there is a new transform.
-  // Note that unlike in Python, the rclcpp StaticTransformPublisher will correctly re-publish all previous transforms.
-  if (has_new_frame) {
-    static_tf_broadcaster_.sendTransform(transforms);
+  static_transforms_to_publish_.clear();
+  for (auto it = first_changed; it != transforms.cend(); ++it) {
+    if (it != first_changed && is_unchanged(*it)) {
+      continue;
+    }
+    current_static_transforms_[it->child_frame_id] = *it;
+    static_transforms_to_publish_.push_back(*it);
   }
+
+  // Only the new and changed transforms are passed on. The StaticTransformBroadcaster merges them with the transforms
+  // it published before, and republishes all of them.
+  static_tf_broadcaster_.sendTransform(static_transforms_to_publish_);
 }
 
 void RclcppTfBroadcasterInterface::sendDynamicTransforms(
@@ -2,16 +2,41 @@
 
 #include <tf2/exceptions.h>
 #include <tf2/time.h>
+#include <tf2_eigen/tf2_eigen.hpp>
 #include <tf2_ros/buffer.h>
-#include <tf2_ros/transform_listener.h>
+#include <tf2_ros/qos.hpp>
+#include <algorithm>
+#include <cstddef>
 #include <memory>
+#include <rclcpp/logging.hpp>
 #include <spot_driver/interfaces/rclcpp_tf_listener_interface.hpp>
 #include <tl_expected/expected.hpp>
+#include <utility>
+
+namespace {
+// TF messages do not say which node published them, so every transform is added with the same authority.
+constexpr auto kTransformAuthority = "Authority undetectable";
+// Same as the maximum depth of a TF tree in tf2, which guards against loops.
+constexpr std::size_t kMaxTreeDepth = 1000;
+
+/** @brief Strip the leading slash from a frame ID, as tf2 does when adding a transform to the buffer. */
+std::string stripLeadingSlash(const std::string& frame_id) {
+  return !frame_id.empty() && frame_id.front() == '/' ? frame_id.substr(1) : frame_id;
+}
+}  // namespace
 
 namespace spot_ros2 {
 RclcppTfListenerInterface::RclcppTfListenerInterface(const std::shared_ptr<rclcpp::Node>& node)
-    : buffer_{node->get_clock()}, listener_{buffer_, node, false} {
+    : node_{node}, buffer_{node->get_clock()} {
   buffer_.setUsingDedicatedThread(true);
+  tf_subscription_ = node_->create_subscription<tf2_msgs::msg::TFMessage>(
+      "/tf", tf2_ros::DynamicListenerQoS(), [this](const tf2_msgs::msg::TFMessage::ConstSharedPtr message) {
+        addTransforms(*message, false);
+      });
+  tf_static_subscription_ = node_->create_subscription<tf2_msgs::msg::TFMessage>(
+      "/tf_static", tf2_ros::StaticListenerQoS(), [this](const tf2_msgs::msg::TFMessage::ConstSharedPtr message) {
+        addTransforms(*message, true);
+      });
 }
 
 std::vector<std::string> RclcppTfListenerInterface::getAllFrameNames() const {
@@ -34,4 +59,118 @@ tl::expected<geometry_msgs::msg::TransformStamped, std::string> RclcppTfListener
     return tl::make_unexpected(e.what());
   }
 }
+
+std::vector<tl::expected<geometry_msgs::msg::TransformStamped, std::string>>
+RclcppTfListenerInterface::lookupTransforms(const std::string& parent, const std::vector<std::string>& children,
+                                            const rclcpp::Time& timepoint) const {
+  // At an all-zero timepoint, the transforms of a chain are taken at the latest time common to the whole chain, so
+  // splitting it could change the result
+  if (timepoint.nanoseconds() == 0 || children.size() < 2) {
+    return TfListenerInterfaceBase::lookupTransforms(parent, children, timepoint);
+  }
+  const auto ancestor = findCommonAncestor(children);
+  if (!ancestor || *ancestor == parent) {
+    return TfListenerInterfaceBase::lookupTransforms(parent, children, timepoint);
+  }
+  Eigen::Isometry3d ancestor_tform_parent;
+  try {
+    ancestor_tform_parent = tf2::transformToEigen(buffer_.lookupTransform(*ancestor, parent, timepoint));
+  } catch (const tf2::TransformException&) {
+    return TfListenerInterfaceBase::lookupTransforms(parent, children, timepoint);
+  }
+
+  std::vector<tl::expected<geometry_msgs::msg::TransformStamped, std::string>> transforms;
+  transforms.reserve(children.size());
+  for (const auto& child : children) {
+    try {
+      // Match lookupTransform(), which asks the buffer for the transform with the child as the target frame
+      auto transform = tf2::eigenToTransform(
+          tf2::transformToEigen(buffer_.lookupTransform(child, *ancestor, timepoint)) * ancestor_tform_parent);
+      transform.header.frame_id = child;
+      transform.child_frame_id = parent;
+      transform.header.stamp = timepoint;
+      transforms.push_back(std::move(transform));
+    } catch (const tf2::TransformException&) {
+      transforms.push_back(lookupTransform(parent, child, timepoint));
+    }
+  }
+  return transforms;
+}
+
+void RclcppTfListenerInterface::startTrackingUpdatedFrames() {
+  is_tracking_updated_frames_ = true;
+}
+
+std::map<std::string, rclcpp::Time> RclcppTfListenerInterface::takeUpdatedFrames() {
+  std::map<std::string, rclcpp::Time> updated_frames;
+  std::lock_guard lock{updated_frames_mutex_};
+  std::swap(updated_frames, updated_frames_);
+  return updated_frames;
+}
+
+void RclcppTfListenerInterface::addTransforms(const tf2_msgs::msg::TFMessage& message, const bool is_static) {
+  {
+    std::lock_guard lock{parents_mutex_};
+    for (const auto& transform : message.transforms) {
+      parents_[stripLeadingSlash(transform.child_frame_id)] = stripLeadingSlash(transform.header.frame_id);
+    }
+  }
+  for (const auto& transform : message.transforms) {
+    try {
+      buffer_.setTransform(transform, kTransformAuthority, is_static);
+    } catch (const tf2::TransformException& e) {
+      RCLCPP_ERROR(node_->get_logger(), "Failed to add the transform from %s to %s to the TF buffer: %s",
+                   transform.header.frame_id.c_str(), transform.child_frame_id.c_str(), e.what());
+    }
+  }
+  if (is_tracking_updated_frames_) {
+    recordUpdatedFrames(message, is_static);
+  }
+}
+
+void RclcppTfListenerInterface::recordUpdatedFrames(const tf2_msgs::msg::TFMessage& message, const bool is_static) {
+  std::lock_guard lock{updated_frames_mutex_};
+  for (const auto& transform : message.transforms) {
+    const rclcpp::Time stamp = is_static ? rclcpp::Time{0, 0, RCL_ROS_TIME} : rclcpp::Time{transform.header.stamp};
+    const auto [it, inserted] = updated_frames_.try_emplace(transform.child_frame_id, stamp);
+    if (!inserted && it->second < stamp) {
+      it->second = stamp;
+    }
+  }
+}
+
+std::optional<std::string> RclcppTfListenerInterface::findCommonAncestor(const std::vector<std::string>& frames) const {
+  if (frames.empty()) {
+    return std::nullopt;
+  }
+  std::lock_guard lock{parents_mutex_};
+  // The first frame and its ancestors, from the frame up. Every other frame narrows the candidates down to those at or
+  // above the first of them it reaches on its own way up.
+  std::vector<const std::string*> candidates{&frames.front()};
+  std::unordered_map<std::string, std::size_t> candidate_depths{{frames.front(), 0}};
+  for (auto it = parents_.find(frames.front()); it != parents_.end() && candidates.size() < kMaxTreeDepth;
+       it = parents_.find(it->second)) {
+    if (!candidate_depths.emplace(it->second, candidates.size()).second) {
+      break;
+    }
+    candidates.push_back(&it->second);
+  }
+
+  std::size_t lowest_candidate = 0;
+  for (auto frame = std::next(frames.begin()); frame != frames.end(); ++frame) {
+    const std::string* ancestor = &*frame;
+    std::size_t depth = 0;
+    auto candidate = candidate_depths.find(*ancestor);
+    while (candidate == candidate_depths.end()) {
+      const auto parent = parents_.find(*ancestor);
+      if (parent == parents_.end() || ++depth >= kMaxTreeDepth) {
+        return std::nullopt;
+      }
+      ancestor = &parent->second;
+      candidate = candidate_depths.find(*ancestor);
+    }
+    lowest_candidate = std::max(lowest_candidate, candidate->second);
+  }
+  return *candidates[lowest_candidate];
+}
 }  // namespace spot_ros2
@@ -0,0 +1,83 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/object_sync/frame_classification_table.hpp>
+
+namespace spot_ros2 {
+
+FrameClassificationTable::FrameClassificationTable(const std::string& prefix,
+                                                   const std::set<std::string, std::less<>>& internal_frames)
+    : prefix_{prefix}, frame_names_{prefix, internal_frames} {}
+
+FrameClassificationTable::FrameIndex FrameClassificationTable::internName(const std::string& name) {
+  const auto& cached_name = frame_names_.get(name);
+  const auto [it, inserted] = indices_by_name_.try_emplace(&cached_name, frames_.size());
+  if (inserted) {
+    frames_.push_back({&cached_name, {}, {}});
+    if (cached_name.is_ignored) {
+      addMember(it->second, FrameClass::INTERNAL);
+    }
+  }
+  return it->second;
+}
+
+FrameClassificationTable::FrameIndex FrameClassificationTable::internFrameId(const std::string& frame_id) {
+  if (const auto it = indices_by_frame_id_.find(frame_id); it != indices_by_frame_id_.end()) {
+    return it->second;
+  }
+  // Only a prefix at the start of the frame ID is stripped.
+  const auto has_prefix = !prefix_.empty() && frame_id.compare(0, prefix_.size(), prefix_) == 0;
+  const auto index = internName(has_prefix ? frame_id.substr(prefix_.size()) : frame_id);
+  if (frames_[index].frame_id.empty()) {
+    frames_[index].frame_id = frame_id;
+  }
+  indices_by_frame_id_.emplace(frame_id, index);
+  return index;
+}
+
+std::optional<FrameClassificationTable::FrameIndex> FrameClassificationTable::findName(const std::string& name) const {
+  // Every name in the cache was interned when it was resolved.
+  const auto* cached_name = frame_names_.find(name);
+  if (cached_name == nullptr) {
+    return std::nullopt;
+  }
+  return indices_by_name_.at(cached_name);
+}
+
+const std::string& FrameClassificationTable::getName(const FrameIndex index) const {
+  return frames_[index].cached_name->name;
+}
+
+const std::string& FrameClassificationTable::getFrameId(const FrameIndex index) const {
+  const auto& frame = frames_[index];
+  return frame.frame_id.empty() ? frame.cached_name->frame_id : frame.frame_id;
+}
+
+bool FrameClassificationTable::isMember(const FrameIndex index, const FrameClass frame_class) const {
+  return frames_[index].classes.test(static_cast<std::size_t>(frame_class));
+}
+
+void FrameClassificationTable::addMember(const FrameIndex index, const FrameClass frame_class) {
+  const auto bit = static_cast<std::size_t>(frame_class);
+  if (!frames_[index].classes.test(bit)) {
+    frames_[index].classes.set(bit);
+    members_[bit].push_back(index);
+  }
+}
+
+void FrameClassificationTable::assignMembers(const FrameClass frame_class, const std::vector<FrameIndex>& indices) {
+  const auto bit = static_cast<std::size_t>(frame_class);
+  for (const auto index : members_[bit]) {
+    frames_[index].classes.reset(bit);
+  }
+  members_[bit].clear();
+  for (const auto index : indices) {
+    addMember(index, frame_class);
+  }
+}
+
+const std::vector<FrameClassificationTable::FrameIndex>& FrameClassificationTable::getMembers(
+    const FrameClass frame_class) const {
+  return members_[static_cast<std::size_t>(frame_class)];
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,46 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/object_sync/object_sync_middleware_handle.hpp>
+
+#include <spot_msgs/msg/world_object_array.hpp>
+#include <spot_msgs/msg/world_object_detection_array.hpp>
+#include <spot_msgs/srv/list_cached_world_objects.hpp>
+
+namespace {
+constexpr auto kPublisherHistoryDepth = 1;
+
+// ROS topic names for Spot's object synchronizer
+constexpr auto kWorldObjectsTopic{"world_objects"};
+constexpr auto kWorldObjectDetectionsTopic{"world_objects/detections"};
+
+// ROS service names for Spot's object synchronizer
+constexpr auto kListCachedWorldObjectsService{"list_cached_world_objects"};
+}  // namespace
+
+namespace spot_ros2 {
+
+ObjectSyncMiddlewareHandle::ObjectSyncMiddlewareHandle(const std::shared_ptr<rclcpp::Node>& node)
+    : node_{node},
+      world_objects_publisher_{node_->create_publisher<spot_msgs::msg::WorldObjectArray>(
+          kWorldObjectsTopic, makePublisherQoS(kPublisherHistoryDepth))},
+      world_object_detections_publisher_{node_->create_publisher<spot_msgs::msg::WorldObjectDetectionArray>(
+          kWorldObjectDetectionsTopic, makePublisherQoS(kPublisherHistoryDepth))} {}
+
+void ObjectSyncMiddlewareHandle::publishWorldObjects(const spot_msgs::msg::WorldObjectArray& world_objects) {
+  world_objects_publisher_->publish(world_objects);
+}
+
+void ObjectSyncMiddlewareHandle::publishWorldObjectDetections(
+    const spot_msgs::msg::WorldObjectDetectionArray& detections) {
+  world_object_detections_publisher_->publish(detections);
+}
+
+void ObjectSyncMiddlewareHandle::createListCachedWorldObjectsService(
+    std::function<void(const std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Request>,
+                       std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Response>)>
+        callback) {
+  list_cached_world_objects_service_ =
+      node_->create_service<spot_msgs::srv::ListCachedWorldObjects>(kListCachedWorldObjectsService, callback);
+}
+
+}  // namespace spot_ros2
@@ -7,10 +7,18 @@
 #include <google/protobuf/timestamp.pb.h>
 #include <rcl/time.h>
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <eigen3/Eigen/Geometry>
+#include <future>
 #include <geometry_msgs/msg/detail/transform_stamped__struct.hpp>
 #include <iterator>
+#include <map>
+#include <optional>
 #include <rclcpp/duration.hpp>
 #include <rclcpp/time.hpp>
 #include <spot_driver/api/state_client_interface.hpp>
@@ -20,21 +28,78 @@
 #include <spot_driver/conversions/time.hpp>
 #include <spot_driver/interfaces/rclcpp_wall_timer_interface.hpp>
 #include <spot_driver/types.hpp>
+#include <spot_msgs/msg/world_object.hpp>
+#include <spot_msgs/msg/world_object_array.hpp>
+#include <spot_msgs/msg/world_object_detection.hpp>
+#include <spot_msgs/msg/world_object_detection_array.hpp>
+#include <spot_msgs/srv/list_cached_world_objects.hpp>
 #include <std_msgs/msg/header.hpp>
 #include <stdexcept>
 #include <string>
 #include <tl_expected/expected.hpp>
 #include <utility>
+#include <vector>
 
 namespace {
 constexpr auto kWorldObjectSyncPeriod = std::chrono::duration<double>{1.0};  // 1 Hz
 constexpr auto kTfBroadcasterPeriod = std::chrono::duration<double>{0.1};    // 10 Hz
+// Updates to the same TF frame within this window are coalesced into a single world object mutation.
+constexpr auto kTfUpdateCoalescingWindow = std::chrono::duration<double>{0.2};
+// Number of TF broadcaster ticks between listings of all world objects, which drop removed objects from the cache.
+constexpr std::size_t kCompleteWorldObjectListingInterval = 50;  // Every 5 seconds
 inline const rclcpp::Duration kStaleTransformDuration{10, 0};
+// Maximum number of requests to mutate world objects which are in flight at the same time while syncing.
+constexpr std::size_t kMaxMutationsInFlight = 8;
 
 constexpr double kMutableObjectLifetime = 5.0;
+// World objects which did not move are refreshed once they are this old, which leaves a few sync periods to refresh
+// them before they expire.
+inline const rclcpp::Duration kMutableObjectRefreshAge = rclcpp::Duration::from_seconds(kMutableObjectLifetime - 2.0);
 constexpr double kDrawableArrowLength = 0.1;
 constexpr double kDrawableArrowRadius = 0.01;
 
+/** @brief TF frames which are looked up together, at the same timepoint. */
+struct FrameLookupGroup {
+  rclcpp::Time timepoint;
+  std::vector<std::string> child_frame_ids;
+  // Names of the frames without the robot's prefix, which are owned by the FrameClassificationTable.
+  std::vector<const std::string*> child_frame_names;
+};
+
+/** @brief The result of looking up the transform from the preferred base frame to a TF frame. */
+struct FrameLookupResult {
+  std::string child_frame_id;
+  const std::string* child_frame_name;
+  tl::expected<geometry_msgs::msg::TransformStamped, std::string> base_tform_child;
+};
+
+/** @brief A request to mutate the world object of a TF frame, whose response has not been collected yet. */
+struct PendingMutation {
+  std::string child_frame_id;
+  spot_ros2::ObjectSynchronizer::SyncedTransform synced_transform;
+  std::future<tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>> response;
+};
+
+/**
+ * @brief Get the distance between the translations of two transforms.
+ */
+double getTranslationDistance(const geometry_msgs::msg::Transform& lhs, const geometry_msgs::msg::Transform& rhs) {
+  const auto dx = lhs.translation.x - rhs.translation.x;
+  const auto dy = lhs.translation.y - rhs.translation.y;
+  const auto dz = lhs.translation.z - rhs.translation.z;
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * @brief Get the angle of the rotation between the rotations of two transforms, in radians.
+ */
+double getRotationAngle(const geometry_msgs::msg::Transform& lhs, const geometry_msgs::msg::Transform& rhs) {
+  const auto dot = lhs.rotation.w * rhs.rotation.w + lhs.rotation.x * rhs.rotation.x +
+                   lhs.rotation.y * rhs.rotation.y + lhs.rotation.z * rhs.rotation.z;
+  // q and -q are the same rotation, and rounding can push the dot product of unit quaternions slightly past one.
+  return 2.0 * std::acos(std::min(std::abs(dot), 1.0));
+}
+
 /**
  * @brief All frame names which are considered internal to Spot.
  * @details It is surprisingly challenging to automatically generate a comprehensive list of Spot's internal frames,
@@ -175,6 +240,19 @@ std::string toString(const ::bosdyn::api::MutateWorldObjectResponse_Status& stat
   return request;
 }
 
+/**
+ * @brief Create a ListWorldObjectRequest that requests the types of world objects whose detections are published on
+ * their own, which are fiducials and docks.
+ * @return Request for info about fiducials and docks.
+ */
+::bosdyn::api::ListWorldObjectRequest createDetectionObjectsRequest() {
+  using Type = ::bosdyn::api::WorldObjectType;
+  ::bosdyn::api::ListWorldObjectRequest request;
+  request.add_object_type(Type::WORLD_OBJECT_APRILTAG);
+  request.add_object_type(Type::WORLD_OBJECT_DOCK);
+  return request;
+}
+
 /**
  * @brief Create a ListWorldObjectRequest that requests all types of world objects.
  * @return A request to list all WorldObject types.
@@ -186,27 +264,6 @@ std::string toString(const ::bosdyn::api::MutateWorldObjectResponse_Status& stat
   return request;
 }
 
-/**
- * @brief Given a ListWorldObjectResponse message, create a list of all the frames listed in the transform snapshots
- * those objects.
- *
- * @param list_objects_response Input message to parse.
- * @return A set of all frame IDs which are listed in the transform snapshots of the input objects.
- */
-std::set<std::string, std::less<>> getObjectFrames(
-    const ::bosdyn::api::ListWorldObjectResponse& list_objects_response) {
-  std::set<std::string, std::less<>> frames;
-  for (const auto& object : list_objects_response.world_objects()) {
-    if (!object.has_transforms_snapshot()) {
-      continue;
-    }
-    for (const auto& subframe : object.transforms_snapshot().child_to_parent_edge_map()) {
-      frames.insert(subframe.first);
-    }
-  }
-  return frames;
-}
-
 /**
  * @brief Given a ListWorldObjectResponse message, create a map between the names and the IDs of these objects.
  *
@@ -307,27 +364,169 @@ std::map<std::string, int> getObjectNamesAndIDs(const ::bosdyn::api::ListWorldOb
       ::bosdyn::api::MutateWorldObjectRequest_Action::MutateWorldObjectRequest_Action_ACTION_CHANGE);
   return request;
 }
+
+/**
+ * @brief Get the type of a world object from the properties it has, as one of the TYPE_ constants of
+ * spot_msgs::msg::WorldObject.
+ */
+std::uint8_t getWorldObjectType(const ::bosdyn::api::WorldObject& object) {
+  using WorldObjectMsg = spot_msgs::msg::WorldObject;
+  if (object.has_apriltag_properties()) {
+    return WorldObjectMsg::TYPE_APRILTAG;
+  }
+  if (object.has_dock_properties()) {
+    return WorldObjectMsg::TYPE_DOCK;
+  }
+  if (object.has_image_properties()) {
+    return WorldObjectMsg::TYPE_IMAGE_COORDINATES;
+  }
+  if (object.drawable_properties_size() > 0) {
+    return WorldObjectMsg::TYPE_DRAWABLE;
+  }
+  return WorldObjectMsg::TYPE_UNKNOWN;
+}
+
+/**
+ * @brief Prepend a prefix to a frame name reported by Spot, leaving empty frame names empty.
+ */
+std::string prefixFrameName(const std::string& prefix, const std::string& frame_name) {
+  return frame_name.empty() ? frame_name : prefix + frame_name;
+}
+
+/**
+ * @brief Get the covariance of the detection of a fiducial, rotated from the frame Spot reports it in into a base
+ * frame.
+ *
+ * @param object World object of a fiducial.
+ * @param base_frame Name of the base frame in the object's frame tree snapshot.
+ * @return The covariance in the order of geometry_msgs::msg::PoseWithCovariance, or nullopt if Spot did not report a
+ * covariance or its frame is not in the snapshot.
+ */
+std::optional<std::array<double, 36>> getDetectionCovariance(const ::bosdyn::api::WorldObject& object,
+                                                             const std::string& base_frame) {
+  const auto& properties = object.apriltag_properties();
+  const auto& matrix = properties.detection_covariance().matrix();
+  if (matrix.rows() != 6 || matrix.cols() != 6 || matrix.values_size() != 36) {
+    return std::nullopt;
+  }
+  ::bosdyn::api::SE3Pose base_tform_reference;
+  if (!::bosdyn::api::GetATformB(object.transforms_snapshot(), base_frame,
+                                 properties.detection_covariance_reference_frame(), &base_tform_reference)) {
+    return std::nullopt;
+  }
+
+  // Both Spot and ROS order the covariance as translation then rotation, row-major. Rotating the frame rotates the
+  // translational and rotational blocks alike.
+  const auto& rotation = base_tform_reference.rotation();
+  Eigen::Matrix<double, 6, 6> base_rotation_reference = Eigen::Matrix<double, 6, 6>::Zero();
+  const Eigen::Matrix3d rotation_matrix =
+      Eigen::Quaterniond{rotation.w(), rotation.x(), rotation.y(), rotation.z()}.normalized().toRotationMatrix();
+  base_rotation_reference.topLeftCorner<3, 3>() = rotation_matrix;
+  base_rotation_reference.bottomRightCorner<3, 3>() = rotation_matrix;
+  const Eigen::Map<const Eigen::Matrix<double, 6, 6, Eigen::RowMajor>> covariance{matrix.values().data()};
+
+  std::array<double, 36> covariance_in_base{};
+  Eigen::Map<Eigen::Matrix<double, 6, 6, Eigen::RowMajor>>{covariance_in_base.data()} =
+      base_rotation_reference * covariance * base_rotation_reference.transpose();
+  return covariance_in_base;
+}
+
+/**
+ * @brief Convert a world object of a fiducial or a dock to a ROS message of its detection.
+ *
+ * @param object World object of a fiducial or a dock.
+ * @param clock_skew The difference between the host's clock and Spot's clock.
+ * @param base_frame Name of the base frame in the object's frame tree snapshot, which the pose is expressed in.
+ * @param base_frame_id TF frame ID of the base frame.
+ * @return The detection, or nullopt if the object is neither a fiducial nor a dock, or the pose of its frame is not in
+ * its frame tree snapshot.
+ */
+std::optional<spot_msgs::msg::WorldObjectDetection> createDetectionMsg(const ::bosdyn::api::WorldObject& object,
+                                                                       const google::protobuf::Duration& clock_skew,
+                                                                       const std::string& base_frame,
+                                                                       const std::string& base_frame_id) {
+  spot_msgs::msg::WorldObjectDetection msg;
+  msg.type = getWorldObjectType(object);
+  msg.object_id = object.id();
+  std::string object_frame;
+  if (msg.type == spot_msgs::msg::WorldObject::TYPE_APRILTAG) {
+    msg.id = object.apriltag_properties().tag_id();
+    object_frame = object.apriltag_properties().frame_name_fiducial();
+    if (const auto covariance = getDetectionCovariance(object, base_frame)) {
+      msg.pose.covariance = covariance.value();
+    }
+  } else if (msg.type == spot_msgs::msg::WorldObject::TYPE_DOCK) {
+    msg.id = static_cast<std::int32_t>(object.dock_properties().dock_id());
+    object_frame = object.dock_properties().frame_name_dock();
+  } else {
+    return std::nullopt;
+  }
+
+  ::bosdyn::api::SE3Pose base_tform_object;
+  if (object_frame.empty() ||
+      !::bosdyn::api::GetATformB(object.transforms_snapshot(), base_frame, object_frame, &base_tform_object)) {
+    return std::nullopt;
+  }
+  convertToRos(base_tform_object, msg.pose.pose);
+  msg.header.stamp = robotTimeToLocalTime(object.acquisition_time(), clock_skew);
+  msg.header.frame_id = base_frame_id;
+  return msg;
+}
+
+/**
+ * @brief Convert a world object listed by Spot to a ROS message.
+ *
+ * @param object World object from Spot's world model.
+ * @param clock_skew The difference between the host's clock and Spot's clock.
+ * @param frame_prefix Prefix of the frames the driver publishes to TF.
+ * @return The world object as a ROS message.
+ */
+spot_msgs::msg::WorldObject createWorldObjectMsg(const ::bosdyn::api::WorldObject& object,
+                                                 const google::protobuf::Duration& clock_skew,
+                                                 const std::string& frame_prefix) {
+  spot_msgs::msg::WorldObject msg;
+  msg.id = object.id();
+  msg.name = object.name();
+  msg.type = getWorldObjectType(object);
+  msg.acquisition_time = robotTimeToLocalTime(object.acquisition_time(), clock_skew);
+  if (object.has_apriltag_properties()) {
+    const auto& properties = object.apriltag_properties();
+    msg.tag_id = properties.tag_id();
+    msg.frame_name_fiducial = prefixFrameName(frame_prefix, properties.frame_name_fiducial());
+    msg.frame_name_fiducial_filtered = prefixFrameName(frame_prefix, properties.frame_name_fiducial_filtered());
+  }
+  if (object.has_dock_properties()) {
+    const auto& properties = object.dock_properties();
+    msg.dock_id = properties.dock_id();
+    msg.frame_name_dock = prefixFrameName(frame_prefix, properties.frame_name_dock());
+  }
+  return msg;
+}
 }  // namespace
 
 namespace spot_ros2 {
 
 ObjectSynchronizer::ObjectSynchronizer(const std::shared_ptr<WorldObjectClientInterface>& world_object_client_interface,
                                        const std::shared_ptr<TimeSyncApi>& time_sync_api,
+                                       std::unique_ptr<MiddlewareHandle> middleware_handle,
                                        std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                                        std::unique_ptr<LoggerInterfaceBase> logger_interface,
                                        std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
                                        std::unique_ptr<TfListenerInterfaceBase> tf_listener_interface,
                                        std::unique_ptr<TimerInterfaceBase> world_object_update_timer,
                                        std::unique_ptr<TimerInterfaceBase> tf_broadcaster_timer,
+                                       std::unique_ptr<TimerInterfaceBase> detection_timer,
                                        std::unique_ptr<ClockInterfaceBase> clock_interface)
     : world_object_client_interface_{world_object_client_interface},
       time_sync_interface_{time_sync_api},
+      middleware_handle_{std::move(middleware_handle)},
       parameter_interface_{std::move(parameter_interface)},
       logger_interface_{std::move(logger_interface)},
       tf_broadcaster_interface_{std::move(tf_broadcaster_interface)},
       tf_listener_interface_{std::move(tf_listener_interface)},
       world_object_update_timer_{std::move(world_object_update_timer)},
       tf_broadcaster_timer_{std::move(tf_broadcaster_timer)},
+      detection_timer_{std::move(detection_timer)},
       clock_interface_{std::move(clock_interface)} {
   const auto spot_name = parameter_interface_->getSpotName();
   frame_prefix_ = spot_name.empty() ? "" : spot_name + "/";
@@ -336,7 +535,19 @@ ObjectSynchronizer::ObjectSynchronizer(const std::shared_ptr<WorldObjectClientIn
   preferred_base_frame_with_prefix_ = preferred_base_frame_.find('/') == std::string::npos
                                           ? spot_name + "/" + preferred_base_frame_
                                           : preferred_base_frame_;
-
+  frame_name_cache_ = std::make_unique<FrameNameCache>(frame_prefix_, kSpotInternalFrames);
+  frame_classes_ = std::make_unique<FrameClassificationTable>(frame_prefix_, kSpotInternalFrames);
+  sync_translation_threshold_ = parameter_interface_->getWorldObjectSyncTranslationThreshold();
+  sync_rotation_threshold_ = parameter_interface_->getWorldObjectSyncRotationThreshold();
+
+  // Syncing only the frames which received new transforms looks each one up at its own stamp, which does not cause the
+  // TF extrapolation errors that polling the whole TF tree does.
+  if (parameter_interface_->getWorldObjectSyncOnTfUpdates()) {
+    tf_listener_interface_->startTrackingUpdatedFrames();
+    world_object_update_timer_->setTimer(kTfUpdateCoalescingWindow, [this]() {
+      syncUpdatedWorldObjects();
+    });
+  }
   // TODO(khughes): This is temporarily disabled to reduce driver's spew about TF extrapolation.
   // world_object_update_timer_->setTimer(kWorldObjectSyncPeriod, [this]() {
   //   syncWorldObjects();
@@ -345,27 +556,91 @@ ObjectSynchronizer::ObjectSynchronizer(const std::shared_ptr<WorldObjectClientIn
   tf_broadcaster_timer_->setTimer(kTfBroadcasterPeriod, [this]() {
     broadcastWorldObjectTransforms();
   });
+
+  if (const auto detection_rate = parameter_interface_->getWorldObjectDetectionRate(); detection_rate > 0.0) {
+    detection_timer_->setTimer(std::chrono::duration<double>{1.0 / detection_rate}, [this]() {
+      publishWorldObjectDetections();
+    });
+  }
+
+  middleware_handle_->createListCachedWorldObjectsService(
+      [this](const std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Request> request,
+             std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Response> response) {
+        listCachedWorldObjects(request, response);
+      });
 }
 
 void ObjectSynchronizer::addManagedFrame(const std::string& frame_id) {
-  std::lock_guard lock{managed_frames_mutex_};
-  managed_frames_.insert(frame_id);
+  std::lock_guard lock{frame_classes_mutex_};
+  frame_classes_->addMember(frame_classes_->internFrameId(frame_id), FrameClass::MANAGED);
+}
+
+bool ObjectSynchronizer::isManagedFrame(const std::string& name) const {
+  std::lock_guard lock{frame_classes_mutex_};
+  // Names which were never interned cannot be managed.
+  const auto frame = frame_classes_->findName(name);
+  return frame.has_value() && frame_classes_->isMember(frame.value(), FrameClass::MANAGED);
 }
 
 std::set<std::string, std::less<>> ObjectSynchronizer::getManagedFrames() const {
-  std::lock_guard lock{managed_frames_mutex_};
-  return managed_frames_;
+  std::lock_guard lock{frame_classes_mutex_};
+  std::set<std::string, std::less<>> managed_frames;
+  for (const auto index : frame_classes_->getMembers(FrameClass::MANAGED)) {
+    managed_frames.insert(frame_classes_->getFrameId(index));
+  }
+  return managed_frames;
 }
 
 void ObjectSynchronizer::syncWorldObjects() {
+  // Get the current timestamp at which this function was triggered
+  const auto timepoint_now = clock_interface_->now();
+
+  // Look up every frame in the TF tree. We set the lookup timestamp to timepoint zero, which tells the TF buffer to
+  // give us the earliest-available transform to this frame.
+  std::map<std::string, rclcpp::Time> frames;
+  for (const auto& child_frame_id : tf_listener_interface_->getAllFrameNames()) {
+    frames.emplace(child_frame_id, rclcpp::Time{0, 0});
+  }
+  syncFrames(frames, timepoint_now);
+}
+
+void ObjectSynchronizer::syncUpdatedWorldObjects() {
+  const auto timepoint_now = clock_interface_->now();
+
+  // Every transform a frame received during the coalescing window is covered by looking it up once at its latest stamp
+  auto frames = tf_listener_interface_->takeUpdatedFrames();
+  for (const auto& [child_frame_id, stamp] : frames) {
+    tf_frame_stamps_.insert_or_assign(child_frame_id, stamp);
+  }
+
+  // Frames which stopped receiving transforms, such as static frames, are refreshed before their world objects expire
+  for (const auto& [child_frame_id, synced_transform] : synced_transforms_) {
+    const auto stamp = tf_frame_stamps_.find(child_frame_id);
+    if (stamp != tf_frame_stamps_.end() && timepoint_now - synced_transform.synced_at >= kMutableObjectRefreshAge) {
+      frames.emplace(child_frame_id, stamp->second);
+    }
+  }
+
+  // Listing world objects is only worth a round trip if there is something to sync
+  if (frames.empty()) {
+    return;
+  }
+  syncFrames(frames, timepoint_now);
+
+  // Only the stamps of frames with world objects are needed later, so the stamps of other frames, such as Spot's own,
+  // do not accumulate.
+  for (auto it = tf_frame_stamps_.begin(); it != tf_frame_stamps_.end();) {
+    it = synced_transforms_.count(it->first) == 0 ? tf_frame_stamps_.erase(it) : std::next(it);
+  }
+}
+
+void ObjectSynchronizer::syncFrames(const std::map<std::string, rclcpp::Time>& frames,
+                                    const rclcpp::Time& timepoint_now) {
   if (!world_object_client_interface_) {
     logger_interface_->logError("World object interface not initialized.");
     return;
   }
 
-  // Get the current timestamp at which this function was triggered
-  const auto timepoint_now = clock_interface_->now();
-
   // Get a list of all world objects which are managed by Spot itself or through other Spot operator tools.
   // The TF tree may contain frames from these objects, and we should not attempt to modify these objects. The Spot API
   // allows us to attempt to modify them but it will fail if we try
@@ -376,11 +651,18 @@ void ObjectSynchronizer::syncWorldObjects() {
     logger_interface_->logError("Failed to list non-mutable objects: " + non_mutable_objects_response.error());
     return;
   }
-  const auto non_mutable_frames_unfiltered = getObjectFrames(non_mutable_objects_response.value());
-  std::set<std::string> non_mutable_frames;
-  std::set_difference(non_mutable_frames_unfiltered.cbegin(), non_mutable_frames_unfiltered.cend(),
-                      kSpotInternalFrames.cbegin(), kSpotInternalFrames.cend(),
-                      std::inserter(non_mutable_frames, non_mutable_frames.end()));
+  // Flag the frames in the transform snapshots of these objects as non-mutable, replacing the frames flagged by the
+  // previous sync.
+  std::vector<FrameClassificationTable::FrameIndex> non_mutable_frames;
+  {
+    std::lock_guard lock{frame_classes_mutex_};
+    for (const auto& object : non_mutable_objects_response->world_objects()) {
+      for (const auto& subframe : object.transforms_snapshot().child_to_parent_edge_map()) {
+        non_mutable_frames.push_back(frame_classes_->internName(subframe.first));
+      }
+    }
+    frame_classes_->assignMembers(FrameClass::NON_MUTABLE, non_mutable_frames);
+  }
 
   // Get the names and IDs of all existing world objects that ObjectSynchronizer can add or modify.
   ::bosdyn::api::ListWorldObjectRequest request_mutable_frames = createMutableObjectsRequest();
@@ -397,21 +679,44 @@ void ObjectSynchronizer::syncWorldObjects() {
     return;
   }
 
-  // Get a list of all frame IDs in the TF tree
-  for (const auto& child_frame_id : tf_listener_interface_->getAllFrameNames()) {
-    const auto child_frame_id_no_prefix = stripPrefix(child_frame_id, frame_prefix_);
+  // Group the frames by the timepoint at which they are looked up, skipping frames which are internal to Spot or which
+  // are from objects which we cannot mutate. The frames of a group are looked up together, so at a fixed timepoint the
+  // chain of transforms they share with the preferred base frame is only resolved once.
+  std::map<rcl_time_point_value_t, FrameLookupGroup> frames_by_timepoint;
+  {
+    std::lock_guard lock{frame_classes_mutex_};
+    for (const auto& [child_frame_id, lookup_timepoint] : frames) {
+      const auto frame = frame_classes_->internFrameId(child_frame_id);
+      if (frame_classes_->isMember(frame, FrameClass::INTERNAL) ||
+          frame_classes_->isMember(frame, FrameClass::NON_MUTABLE)) {
+        continue;
+      }
+      auto& group = frames_by_timepoint[lookup_timepoint.nanoseconds()];
+      group.timepoint = lookup_timepoint;
+      group.child_frame_ids.push_back(child_frame_id);
+      group.child_frame_names.push_back(&frame_classes_->getName(frame));
+    }
+  }
 
-    // Skip frames which are internal to Spot or which are from objects which we cannot mutate
-    if (kSpotInternalFrames.count(child_frame_id_no_prefix) > 0 ||
-        non_mutable_frames.count(child_frame_id_no_prefix) > 0) {
-      continue;
+  // Get the transforms from the preferred base frame to the TF frames.
+  std::vector<FrameLookupResult> base_tform_children;
+  for (const auto& entry : frames_by_timepoint) {
+    const auto& group = entry.second;
+    auto transforms = tf_listener_interface_->lookupTransforms(preferred_base_frame_with_prefix_,
+                                                               group.child_frame_ids, group.timepoint);
+    for (std::size_t ndx = 0; ndx < group.child_frame_ids.size(); ++ndx) {
+      base_tform_children.push_back(
+          {group.child_frame_ids[ndx], group.child_frame_names[ndx], std::move(transforms[ndx])});
     }
+  }
+
+  // Requests to mutate world objects which were sent but whose responses were not collected yet, oldest first.
+  std::deque<PendingMutation> pending_mutations;
 
-    // Get the transform from the preferred base frame to the current TF frame.
-    // We set the lookup timestamp to timepoint zero, which tells the TF buffer to give us the earliest-available
-    // transform to this frame.
-    const auto base_tform_child =
-        tf_listener_interface_->lookupTransform(preferred_base_frame_with_prefix_, child_frame_id, rclcpp::Time{0, 0});
+  for (const auto& result : base_tform_children) {
+    const auto& child_frame_id = result.child_frame_id;
+    const auto& child_frame_id_no_prefix = *result.child_frame_name;
+    const auto& base_tform_child = result.base_tform_child;
     if (!base_tform_child) {
       logger_interface_->logWarn(base_tform_child.error());
       continue;
@@ -431,6 +736,12 @@ void ObjectSynchronizer::syncWorldObjects() {
       continue;
     }
 
+    // Skip frames which barely moved since their world object was last updated, unless it is about to expire.
+    if (mutable_object_names_and_ids.count(child_frame_id_no_prefix) > 0 &&
+        !isSyncDue(child_frame_id, base_tform_child->transform, timepoint_now)) {
+      continue;
+    }
+
     // The transform's timestamp is reported relative to the host's clock. Apply the clock skew to get a timetamp
     // relative to Spot's clock.
     const auto transform_timestamp_robot_clock =
@@ -454,21 +765,54 @@ void ObjectSynchronizer::syncWorldObjects() {
       logger_interface_->logInfo("Adding new object for frame " + child_frame_id_no_prefix);
     }
 
-    // Send the request to the API's client interface to add the object in Spot's environment.
-    const auto response = world_object_client_interface_->mutateWorldObject(request);
-    if (!response) {
-      logger_interface_->logWarn(std::string("Failed to modify world object: ").append(response.error()));
-      continue;
-    }
-    if (response->status() != ::bosdyn::api::MutateWorldObjectResponse::STATUS_OK) {
-      logger_interface_->logWarn(std::string("Failed to modify world object: ").append(toString(response->status())));
-      continue;
+    // Send the request to the API's client interface to add the object in Spot's environment, without waiting for the
+    // response. If too many requests are already in flight, first wait for the oldest one to complete.
+    if (pending_mutations.size() >= kMaxMutationsInFlight) {
+      auto& oldest = pending_mutations.front();
+      completeMutation(oldest.child_frame_id, oldest.synced_transform, oldest.response.get());
+      pending_mutations.pop_front();
     }
+    pending_mutations.push_back({child_frame_id,
+                                 {base_tform_child->transform, timepoint_now},
+                                 world_object_client_interface_->mutateWorldObjectAsync(request)});
+  }
+
+  // Collect the responses to the requests which are still in flight.
+  for (auto& pending_mutation : pending_mutations) {
+    completeMutation(pending_mutation.child_frame_id, pending_mutation.synced_transform,
+                     pending_mutation.response.get());
+  }
+}
 
-    // After successfully adding new WorldObject, add the frame ID for this object to the list of frames whose
-    // corresponding world objects originate in this node.
-    addManagedFrame(child_frame_id);
+bool ObjectSynchronizer::isSyncDue(const std::string& child_frame_id,
+                                   const geometry_msgs::msg::Transform& base_tform_child,
+                                   const rclcpp::Time& timepoint_now) const {
+  const auto synced_transform = synced_transforms_.find(child_frame_id);
+  if (synced_transform == synced_transforms_.end()) {
+    return true;
   }
+  const auto& [transform, synced_at] = synced_transform->second;
+  return timepoint_now - synced_at >= kMutableObjectRefreshAge ||
+         getTranslationDistance(transform, base_tform_child) >= sync_translation_threshold_ ||
+         getRotationAngle(transform, base_tform_child) >= sync_rotation_threshold_;
+}
+
+void ObjectSynchronizer::completeMutation(
+    const std::string& child_frame_id, const SyncedTransform& synced_transform,
+    const tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>& response) {
+  if (!response) {
+    logger_interface_->logWarn(std::string("Failed to modify world object: ").append(response.error()));
+    return;
+  }
+  if (response->status() != ::bosdyn::api::MutateWorldObjectResponse::STATUS_OK) {
+    logger_interface_->logWarn(std::string("Failed to modify world object: ").append(toString(response->status())));
+    return;
+  }
+
+  // After successfully adding new WorldObject, add the frame ID for this object to the list of frames whose
+  // corresponding world objects originate in this node.
+  addManagedFrame(child_frame_id);
+  synced_transforms_.insert_or_assign(child_frame_id, synced_transform);
 }
 
 void ObjectSynchronizer::broadcastWorldObjectTransforms() {
@@ -478,42 +822,143 @@ void ObjectSynchronizer::broadcastWorldObjectTransforms() {
     return;
   }
 
+  // Most ticks only list the objects acquired since the newest object in the cache, which is usually none of them.
   auto request = createAllObjectsRequest();
+  const auto is_complete_listing = world_object_listings_ % kCompleteWorldObjectListingInterval == 0;
+  if (!is_complete_listing) {
+    world_object_cache_.applyTimestampFilter(request);
+  }
   const auto response = world_object_client_interface_->listWorldObjects(request);
   if (!response) {
     logger_interface_->logError("Failed to list world objects: " + response.error());
     return;
   }
+  ++world_object_listings_;
+
+  // Only objects which are new or whose acquisition time advanced have new transforms to convert
+  const auto cached_object_count = world_object_cache_.size();
+  const auto changed_objects = world_object_cache_.update(response.value(), is_complete_listing);
+  const auto is_cache_changed = !changed_objects.empty() || world_object_cache_.size() != cached_object_count;
+  // Objects which Spot removed only change the number of cached objects. The first listing is always published, so
+  // that subscribers to the latched topic receive the cache even if it is empty.
+  if (is_cache_changed || world_object_listings_ == 1) {
+    publishCachedWorldObjects(clock_skew_result.value());
+  }
 
-  const auto objects = getObjectNamesAndIDs(response.value());
-  std::set<std::string, std::less<>> all_object_names;
-  std::transform(objects.cbegin(), objects.cend(), std::inserter(all_object_names, all_object_names.end()),
-                 [](const std::pair<std::string, int>& pair) {
-                   return pair.first;
-                 });
+  if (is_cache_changed) {
+    for (const auto* object : changed_objects) {
+      // Skip objects which this node added to Spot's world model, since their frames are already published to TF by
+      // another source.
+      if (isManagedFrame(object->name())) {
+        object_transforms_.erase(object->id());
+        continue;
+      }
 
-  // Create a set of names of objects which are not managed by this node
-  const auto managed_frames = getManagedFrames();
-  std::set<std::string, std::less<>> non_managed_objects;
-  std::set_difference(all_object_names.cbegin(), all_object_names.cend(), managed_frames.cbegin(),
-                      managed_frames.cend(), std::inserter(non_managed_objects, non_managed_objects.end()));
+      // Convert the object's frame tree snapshot into ROS TF frames
+      auto transforms = getTf(object->transforms_snapshot(), object->acquisition_time(), clock_skew_result.value(),
+                              *frame_name_cache_, preferred_base_frame_with_prefix_);
+      if (!transforms) {
+        logger_interface_->logWarn("Failed to get TF tree for object `" + object->name() + "`.");
+        object_transforms_.erase(object->id());
+        continue;
+      }
+      object_transforms_.insert_or_assign(object->id(), std::move(transforms->transforms));
+    }
+    // Forget the transforms of objects which Spot removed
+    for (auto it = object_transforms_.begin(); it != object_transforms_.end();) {
+      it = world_object_cache_.find(it->first) == nullptr ? object_transforms_.erase(it) : std::next(it);
+    }
+
+    broadcast_transforms_.clear();
+    for (const auto& [id, transforms] : object_transforms_) {
+      broadcast_transforms_.insert(broadcast_transforms_.end(), transforms.begin(), transforms.end());
+    }
+  }
 
-  for (const auto& object : response->world_objects()) {
-    // Skip publishing TF for objects this node does not manage, since the TF data for these objects is assumed to be
-    // published by a different source.
-    if (non_managed_objects.count(object.name()) == 0) {
+  // Broadcast TF frames for all cached objects in one message, even if none of them changed. The transforms are not
+  // static, so TF listeners which join later or buffer only a short history would otherwise lose the frames.
+  if (!broadcast_transforms_.empty()) {
+    tf_broadcaster_interface_->sendDynamicTransforms(broadcast_transforms_);
+  }
+}
+
+void ObjectSynchronizer::publishCachedWorldObjects(const google::protobuf::Duration& clock_skew) {
+  spot_msgs::msg::WorldObjectArray world_objects;
+  world_objects.header.stamp = clock_interface_->now();
+  world_objects.world_objects.reserve(world_object_cache_.size());
+  for (const auto& entry : world_object_cache_.objects()) {
+    world_objects.world_objects.push_back(createWorldObjectMsg(entry.second, clock_skew, frame_prefix_));
+  }
+  // Sort the objects by ID, so that listings do not depend on the order of the cache.
+  std::sort(world_objects.world_objects.begin(), world_objects.world_objects.end(),
+            [](const spot_msgs::msg::WorldObject& lhs, const spot_msgs::msg::WorldObject& rhs) {
+              return lhs.id < rhs.id;
+            });
+
+  middleware_handle_->publishWorldObjects(world_objects);
+  std::lock_guard lock{world_object_msgs_mutex_};
+  world_object_msgs_ = std::move(world_objects);
+}
+
+void ObjectSynchronizer::listCachedWorldObjects(
+    const std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Request> request,
+    std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Response> response) const {
+  const auto& object_types = request->object_types;
+  const rclcpp::Time timestamp_filter{request->timestamp_filter, RCL_ROS_TIME};
+  const auto is_timestamp_filter_set = timestamp_filter.nanoseconds() > 0;
+
+  std::lock_guard lock{world_object_msgs_mutex_};
+  response->world_objects.header = world_object_msgs_.header;
+  for (const auto& object : world_object_msgs_.world_objects) {
+    if (!object_types.empty() &&
+        std::find(object_types.cbegin(), object_types.cend(), object.type) == object_types.cend()) {
+      continue;
+    }
+    if (is_timestamp_filter_set && rclcpp::Time{object.acquisition_time, RCL_ROS_TIME} <= timestamp_filter) {
       continue;
     }
+    response->world_objects.world_objects.push_back(object);
+  }
+}
+
+void ObjectSynchronizer::publishWorldObjectDetections() {
+  const auto clock_skew_result = time_sync_interface_->getClockSkew();
+  if (!clock_skew_result) {
+    logger_interface_->logError(std::string{"Failed to get latest clock skew: "}.append(clock_skew_result.error()));
+    return;
+  }
+
+  // Only the fiducials and docks acquired after the newest one seen so far are listed, which is usually none of them.
+  // The first listing is not filtered, and fills the cache with every fiducial and dock Spot knows about.
+  auto request = createDetectionObjectsRequest();
+  detection_cache_.applyTimestampFilter(request);
+  const auto response = world_object_client_interface_->listWorldObjects(request);
+  if (!response) {
+    logger_interface_->logError("Failed to list fiducials and docks: " + response.error());
+    return;
+  }
+  const auto detected_objects = detection_cache_.update(response.value(), !request.has_timestamp_filter());
+  if (detected_objects.empty()) {
+    return;
+  }
 
-    // Convert the object's frame tree snapshot into ROS TF frames
-    const auto transforms = getTf(object.transforms_snapshot(), object.acquisition_time(), clock_skew_result.value(),
-                                  frame_prefix_, preferred_base_frame_with_prefix_, kSpotInternalFrames);
-    if (!transforms) {
-      logger_interface_->logWarn("Failed to get TF tree for object `" + object.name() + "`.");
+  spot_msgs::msg::WorldObjectDetectionArray detections;
+  detections.header.stamp = clock_interface_->now();
+  detections.header.frame_id = preferred_base_frame_with_prefix_;
+  detections.detections.reserve(detected_objects.size());
+  for (const auto* object : detected_objects) {
+    auto detection = createDetectionMsg(*object, clock_skew_result.value(), preferred_base_frame_,
+                                        preferred_base_frame_with_prefix_);
+    if (!detection) {
+      logger_interface_->logWarn("Failed to get pose of object `" + object->name() + "` in " + preferred_base_frame_ +
+                                 ".");
       continue;
     }
-    // Broadcast TF frames for this object
-    tf_broadcaster_interface_->sendDynamicTransforms(transforms->transforms);
+    detections.detections.push_back(std::move(detection.value()));
+  }
+
+  if (!detections.detections.empty()) {
+    middleware_handle_->publishWorldObjectDetections(detections);
   }
 }
 }  // namespace spot_ros2
@@ -2,8 +2,10 @@
 
 #include <spot_driver/object_sync/object_synchronizer_node.hpp>
 
+#include <chrono>
 #include <memory>
 #include <spot_driver/api/default_spot_api.hpp>
+#include <spot_driver/interfaces/coalescing_tf_broadcaster_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_clock_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_node_interface.hpp>
@@ -11,8 +13,8 @@
 #include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_tf_listener_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_wall_timer_interface.hpp>
+#include <spot_driver/object_sync/object_sync_middleware_handle.hpp>
 #include <spot_driver/object_sync/object_synchronizer.hpp>
-#include <spot_driver/robot_state/state_middleware_handle.hpp>
 
 namespace {
 constexpr auto kDefaultSDKName{"object_sync"};
@@ -22,46 +24,59 @@ namespace spot_ros2 {
 
 ObjectSynchronizerNode::ObjectSynchronizerNode(std::unique_ptr<NodeInterfaceBase> node_base_interface,
                                                std::unique_ptr<SpotApi> spot_api,
+                                               std::unique_ptr<ObjectSynchronizer::MiddlewareHandle> middleware_handle,
                                                std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                                                std::unique_ptr<LoggerInterfaceBase> logger_interface,
                                                std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
                                                std::unique_ptr<TfListenerInterfaceBase> tf_listener_interface,
                                                std::unique_ptr<TimerInterfaceBase> world_object_update_timer,
                                                std::unique_ptr<TimerInterfaceBase> tf_broadcaster_timer,
+                                               std::unique_ptr<TimerInterfaceBase> detection_timer,
                                                std::unique_ptr<ClockInterfaceBase> clock_interface)
     : node_base_interface_{std::move(node_base_interface)} {
-  initialize(std::move(spot_api), std::move(parameter_interface), std::move(logger_interface),
-             std::move(tf_broadcaster_interface), std::move(tf_listener_interface),
-             std::move(world_object_update_timer), std::move(tf_broadcaster_timer), std::move(clock_interface));
+  initialize(std::move(spot_api), std::move(middleware_handle), std::move(parameter_interface),
+             std::move(logger_interface), std::move(tf_broadcaster_interface), std::move(tf_listener_interface),
+             std::move(world_object_update_timer), std::move(tf_broadcaster_timer), std::move(detection_timer),
+             std::move(clock_interface));
 }
 
 ObjectSynchronizerNode::ObjectSynchronizerNode(const rclcpp::NodeOptions& node_options) {
   const auto node = std::make_shared<rclcpp::Node>("object_sync", node_options);
   node_base_interface_ = std::make_unique<RclcppNodeInterface>(node->get_node_base_interface());
 
-  auto mw_handle = std::make_unique<StateMiddlewareHandle>(node);
+  auto middleware_handle = std::make_unique<ObjectSyncMiddlewareHandle>(node);
   auto parameter_interface = std::make_unique<RclcppParameterInterface>(node);
   auto logger_interface = std::make_unique<RclcppLoggerInterface>(node->get_logger());
-  auto tf_broadcaster_interface = std::make_unique<RclcppTfBroadcasterInterface>(node);
+  std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface =
+      std::make_unique<RclcppTfBroadcasterInterface>(node);
+  if (const auto tf_coalescing_rate = parameter_interface->getTfCoalescingRate(); tf_coalescing_rate > 0.) {
+    tf_broadcaster_interface = std::make_unique<CoalescingTfBroadcasterInterface>(
+        std::move(tf_broadcaster_interface), std::make_unique<RclcppWallTimerInterface>(node),
+        std::chrono::duration<double>{1.0 / tf_coalescing_rate});
+  }
   auto tf_listener_interface = std::make_unique<RclcppTfListenerInterface>(node);
   auto world_object_update_timer = std::make_unique<RclcppWallTimerInterface>(node);
   auto tf_broadcaster_timer = std::make_unique<RclcppWallTimerInterface>(node);
+  auto detection_timer = std::make_unique<RclcppWallTimerInterface>(node);
   auto clock_interface = std::make_unique<RclcppClockInterface>(node->get_node_clock_interface());
 
   auto spot_api = std::make_unique<DefaultSpotApi>(kDefaultSDKName, parameter_interface->getCertificate());
 
-  initialize(std::move(spot_api), std::move(parameter_interface), std::move(logger_interface),
-             std::move(tf_broadcaster_interface), std::move(tf_listener_interface),
-             std::move(world_object_update_timer), std::move(tf_broadcaster_timer), std::move(clock_interface));
+  initialize(std::move(spot_api), std::move(middleware_handle), std::move(parameter_interface),
+             std::move(logger_interface), std::move(tf_broadcaster_interface), std::move(tf_listener_interface),
+             std::move(world_object_update_timer), std::move(tf_broadcaster_timer), std::move(detection_timer),
+             std::move(clock_interface));
 }
 
 void ObjectSynchronizerNode::initialize(std::unique_ptr<SpotApi> spot_api,
+                                        std::unique_ptr<ObjectSynchronizer::MiddlewareHandle> middleware_handle,
                                         std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                                         std::unique_ptr<LoggerInterfaceBase> logger_interface,
                                         std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
                                         std::unique_ptr<TfListenerInterfaceBase> tf_listener_interface,
                                         std::unique_ptr<TimerInterfaceBase> world_object_update_timer,
                                         std::unique_ptr<TimerInterfaceBase> tf_broadcaster_timer,
+                                        std::unique_ptr<TimerInterfaceBase> detection_timer,
                                         std::unique_ptr<ClockInterfaceBase> clock_interface) {
   spot_api_ = std::move(spot_api);
 
@@ -85,9 +100,10 @@ void ObjectSynchronizerNode::initialize(std::unique_ptr<SpotApi> spot_api,
   }
 
   internal_ = std::make_unique<ObjectSynchronizer>(
-      spot_api_->worldObjectClientInterface(), spot_api_->timeSyncInterface(), std::move(parameter_interface),
-      std::move(logger_interface), std::move(tf_broadcaster_interface), std::move(tf_listener_interface),
-      std::move(world_object_update_timer), std::move(tf_broadcaster_timer), std::move(clock_interface));
+      spot_api_->worldObjectClientInterface(), spot_api_->timeSyncInterface(), std::move(middleware_handle),
+      std::move(parameter_interface), std::move(logger_interface), std::move(tf_broadcaster_interface),
+      std::move(tf_listener_interface), std::move(world_object_update_timer), std::move(tf_broadcaster_timer),
+      std::move(detection_timer), std::move(clock_interface));
 }
 
 std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> ObjectSynchronizerNode::get_node_base_interface() {
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/object_sync/world_object_cache.hpp>
+
+#include <unordered_set>
+
+namespace {
+bool isAfter(const google::protobuf::Timestamp& lhs, const google::protobuf::Timestamp& rhs) {
+  return lhs.seconds() > rhs.seconds() || (lhs.seconds() == rhs.seconds() && lhs.nanos() > rhs.nanos());
+}
+
+bool isZero(const google::protobuf::Timestamp& timestamp) {
+  return timestamp.seconds() == 0 && timestamp.nanos() == 0;
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+void WorldObjectCache::applyTimestampFilter(::bosdyn::api::ListWorldObjectRequest& request) const {
+  if (isZero(newest_acquisition_time_)) {
+    request.clear_timestamp_filter();
+    return;
+  }
+  request.mutable_timestamp_filter()->CopyFrom(newest_acquisition_time_);
+}
+
+std::vector<const ::bosdyn::api::WorldObject*> WorldObjectCache::update(
+    const ::bosdyn::api::ListWorldObjectResponse& response, const bool is_complete) {
+  std::vector<std::int32_t> changed_ids;
+  for (const auto& object : response.world_objects()) {
+    const auto [it, inserted] = objects_.try_emplace(object.id());
+    if (!inserted && !isAfter(object.acquisition_time(), it->second.acquisition_time())) {
+      continue;
+    }
+    it->second = object;
+    changed_ids.push_back(object.id());
+  }
+
+  if (is_complete) {
+    // Objects which Spot removed, for example because their lifetime expired, are only noticed by their absence from a
+    // complete listing.
+    std::unordered_set<std::int32_t> listed;
+    for (const auto& object : response.world_objects()) {
+      listed.insert(object.id());
+    }
+    newest_acquisition_time_.Clear();
+    for (auto it = objects_.begin(); it != objects_.end();) {
+      if (listed.count(it->first) == 0) {
+        it = objects_.erase(it);
+        continue;
+      }
+      if (isAfter(it->second.acquisition_time(), newest_acquisition_time_)) {
+        newest_acquisition_time_ = it->second.acquisition_time();
+      }
+      ++it;
+    }
+  } else {
+    for (const auto id : changed_ids) {
+      const auto& acquisition_time = objects_.at(id).acquisition_time();
+      if (isAfter(acquisition_time, newest_acquisition_time_)) {
+        newest_acquisition_time_ = acquisition_time;
+      }
+    }
+  }
+
+  std::vector<const ::bosdyn::api::WorldObject*> changed;
+  changed.reserve(changed_ids.size());
+  for (const auto id : changed_ids) {
+    changed.push_back(&objects_.at(id));
+  }
+  return changed;
+}
+
+const ::bosdyn::api::WorldObject* WorldObjectCache::find(const std::int32_t id) const {
+  const auto it = objects_.find(id);
+  return it == objects_.end() ? nullptr : &it->second;
+}
+
+const std::unordered_map<std::int32_t, ::bosdyn::api::WorldObject>& WorldObjectCache::objects() const {
+  return objects_;
+}
+
+std::size_t WorldObjectCache::size() const {
+  return objects_.size();
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,60 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/robot_state/polling_statistics.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+namespace spot_ros2 {
+
+PollingStatistics::PollingStatistics()
+    : window_start_{std::chrono::steady_clock::now()}, failures_{0}, published_{0} {}
+
+void PollingStatistics::addResponse(const std::chrono::nanoseconds latency, const bool succeeded) {
+  std::lock_guard lock{mutex_};
+  latencies_ms_.push_back(std::chrono::duration<double, std::milli>(latency).count());
+  if (!succeeded) {
+    ++failures_;
+  }
+}
+
+void PollingStatistics::addPublished() {
+  std::lock_guard lock{mutex_};
+  ++published_;
+}
+
+std::string PollingStatistics::report() {
+  std::vector<double> latencies_ms;
+  std::size_t failures;
+  std::size_t published;
+  std::chrono::duration<double> window;
+  {
+    std::lock_guard lock{mutex_};
+    const auto now = std::chrono::steady_clock::now();
+    window = now - window_start_;
+    window_start_ = now;
+    latencies_ms.swap(latencies_ms_);
+    failures = std::exchange(failures_, 0);
+    published = std::exchange(published_, 0);
+  }
+
+  const auto rate = window.count() > 0. ? published / window.count() : 0.;
+  if (latencies_ms.empty()) {
+    return "Published robot state at " + std::to_string(rate) + " Hz, no robot state responses received";
+  }
+
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  const auto percentile = [&latencies_ms](double p) {
+    return latencies_ms[static_cast<std::size_t>(p * (latencies_ms.size() - 1))];
+  };
+  char buffer[256];
+  std::snprintf(buffer, sizeof(buffer),
+                "Published robot state at %.1f Hz from %zu responses (%zu failed). Request latency p50 %.1f ms, p90 "
+                "%.1f ms, p99 %.1f ms, max %.1f ms",
+                rate, latencies_ms.size(), failures, percentile(0.5), percentile(0.9), percentile(0.99),
+                latencies_ms.back());
+  return buffer;
+}
+
+}  // namespace spot_ros2
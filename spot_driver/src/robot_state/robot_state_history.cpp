@@ -0,0 +1,315 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/robot_state/robot_state_history.hpp>
+
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/conversions/time.hpp>
+#include <spot_driver/robot_state/sequence_lock.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+constexpr std::int64_t kNanosecondsPerSecond = 1000000000;
+
+std::int64_t toNanoseconds(const builtin_interfaces::msg::Time& stamp) {
+  return static_cast<std::int64_t>(stamp.sec) * kNanosecondsPerSecond + stamp.nanosec;
+}
+
+builtin_interfaces::msg::Time toTime(const std::int64_t stamp_ns) {
+  builtin_interfaces::msg::Time stamp;
+  stamp.sec = static_cast<std::int32_t>(stamp_ns / kNanosecondsPerSecond);
+  stamp.nanosec = static_cast<std::uint32_t>(stamp_ns % kNanosecondsPerSecond);
+  return stamp;
+}
+
+/**
+ * @brief Spherical linear interpolation between two unit quaternions given as w, x, y and z.
+ */
+std::array<double, 4> slerp(const std::array<double, 4>& from, std::array<double, 4> to, const double fraction) {
+  double cos_angle = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+  // q and -q are the same rotation. Interpolate along the shorter arc.
+  if (cos_angle < 0.) {
+    cos_angle = -cos_angle;
+    for (auto& component : to) {
+      component = -component;
+    }
+  }
+  double from_weight = 1. - fraction;
+  double to_weight = fraction;
+  // Nearly identical rotations are interpolated linearly, which avoids dividing by a vanishing sine
+  if (cos_angle < 0.9995) {
+    const auto angle = std::acos(cos_angle);
+    const auto sin_angle = std::sin(angle);
+    from_weight = std::sin((1. - fraction) * angle) / sin_angle;
+    to_weight = std::sin(fraction * angle) / sin_angle;
+  }
+  std::array<double, 4> out;
+  double norm = 0.;
+  for (std::size_t ndx = 0; ndx < out.size(); ++ndx) {
+    out[ndx] = from_weight * from[ndx] + to_weight * to[ndx];
+    norm += out[ndx] * out[ndx];
+  }
+  norm = std::sqrt(norm);
+  for (auto& component : out) {
+    component /= norm;
+  }
+  return out;
+}
+
+double lerp(const double from, const double to, const double fraction) {
+  return from + fraction * (to - from);
+}
+
+/**
+ * @brief Interpolate between two samples which were acquired before and after a time.
+ */
+spot_ros2::RobotStateSample interpolate(const spot_ros2::RobotStateSample& before,
+                                        const spot_ros2::RobotStateSample& after, const std::int64_t stamp_ns) {
+  const auto fraction =
+      static_cast<double>(stamp_ns - before.stamp_ns) / static_cast<double>(after.stamp_ns - before.stamp_ns);
+  // Joints can only be interpolated if both samples have the same joints, which is always the case unless the robot
+  // changed between them. Otherwise, use the joints of the nearer sample.
+  const auto same_joints = before.joint_count == after.joint_count &&
+                           std::equal(before.joint_ids.begin(), before.joint_ids.begin() + before.joint_count,
+                                      after.joint_ids.begin());
+  auto out = fraction < 0.5 ? before : after;
+  out.stamp_ns = stamp_ns;
+  if (same_joints) {
+    for (std::size_t ndx = 0; ndx < out.joint_count; ++ndx) {
+      out.joint_positions[ndx] = lerp(before.joint_positions[ndx], after.joint_positions[ndx], fraction);
+      out.joint_velocities[ndx] = lerp(before.joint_velocities[ndx], after.joint_velocities[ndx], fraction);
+      out.joint_efforts[ndx] = lerp(before.joint_efforts[ndx], after.joint_efforts[ndx], fraction);
+    }
+  }
+  if (before.has_body_pose && after.has_body_pose) {
+    for (std::size_t ndx = 0; ndx < out.body_position.size(); ++ndx) {
+      out.body_position[ndx] = lerp(before.body_position[ndx], after.body_position[ndx], fraction);
+    }
+    out.body_rotation = slerp(before.body_rotation, after.body_rotation, fraction);
+  }
+  if (before.has_body_twist && after.has_body_twist) {
+    for (std::size_t ndx = 0; ndx < out.body_linear_velocity.size(); ++ndx) {
+      out.body_linear_velocity[ndx] = lerp(before.body_linear_velocity[ndx], after.body_linear_velocity[ndx], fraction);
+      out.body_angular_velocity[ndx] =
+          lerp(before.body_angular_velocity[ndx], after.body_angular_velocity[ndx], fraction);
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Move the body of a sample forward in time, at its constant linear and angular velocity.
+ */
+spot_ros2::RobotStateSample extrapolate(const spot_ros2::RobotStateSample& newest, const std::int64_t stamp_ns) {
+  const auto seconds = static_cast<double>(stamp_ns - newest.stamp_ns) / static_cast<double>(kNanosecondsPerSecond);
+  auto out = newest;
+  out.stamp_ns = stamp_ns;
+  for (std::size_t ndx = 0; ndx < out.body_position.size(); ++ndx) {
+    out.body_position[ndx] += newest.body_linear_velocity[ndx] * seconds;
+  }
+
+  // The angular velocity is expressed in the odometry frame, so the rotation it causes is applied before the body
+  // rotation.
+  const auto& angular = newest.body_angular_velocity;
+  const auto speed = std::sqrt(angular[0] * angular[0] + angular[1] * angular[1] + angular[2] * angular[2]);
+  if (speed * seconds < 1e-12) {
+    return out;
+  }
+  const auto half_angle = speed * seconds / 2.;
+  const auto scale = std::sin(half_angle) / speed;
+  const std::array<double, 4> delta{std::cos(half_angle), angular[0] * scale, angular[1] * scale, angular[2] * scale};
+  const auto& rotation = newest.body_rotation;
+  out.body_rotation = {
+      delta[0] * rotation[0] - delta[1] * rotation[1] - delta[2] * rotation[2] - delta[3] * rotation[3],
+      delta[0] * rotation[1] + delta[1] * rotation[0] + delta[2] * rotation[3] - delta[3] * rotation[2],
+      delta[0] * rotation[2] - delta[1] * rotation[3] + delta[2] * rotation[0] + delta[3] * rotation[1],
+      delta[0] * rotation[3] + delta[1] * rotation[2] - delta[2] * rotation[1] + delta[3] * rotation[0],
+  };
+  return out;
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+RobotStateHistory::RobotStateHistory(const std::size_t capacity, const std::string& prefix, const bool is_using_vision)
+    : capacity_{std::max<std::size_t>(capacity, 2)},
+      is_using_vision_{is_using_vision},
+      body_pose_frame_id_{prefix + (is_using_vision ? "vision" : "odom")},
+      slots_{std::make_unique<Slot[]>(capacity_)} {
+  for (const auto& [spot_name, friendly_name] : kFriendlyJointNames) {
+    joint_names_.push_back(prefix + friendly_name);
+  }
+}
+
+void RobotStateHistory::add(const ::bosdyn::api::RobotState& robot_state,
+                            const google::protobuf::Duration& clock_skew) {
+  const auto& kinematic_state = robot_state.kinematic_state();
+  if (!kinematic_state.has_acquisition_timestamp()) {
+    return;
+  }
+  const auto stamp_ns = toNanoseconds(robotTimeToLocalTime(kinematic_state.acquisition_timestamp(), clock_skew));
+  const auto index = count_.load(std::memory_order_relaxed);
+  if (index > 0 && stamp_ns <= newest_stamp_ns_) {
+    return;
+  }
+
+  RobotStateSample sample;
+  sample.index = index;
+  sample.stamp_ns = stamp_ns;
+  const auto joint_count = std::min<std::size_t>(kinematic_state.joint_states_size(), kMaxRobotStateSampleJoints);
+  for (std::size_t ndx = 0; ndx < joint_count; ++ndx) {
+    const auto& joint = kinematic_state.joint_states(static_cast<int>(ndx));
+    const auto joint_index = joint_indices_.get(ndx, joint.name());
+    // A joint without a name in the Spot driver is left out, so the joints after it move up
+    if (!joint_index) {
+      continue;
+    }
+    const auto out = sample.joint_count++;
+    sample.joint_ids[out] = static_cast<std::uint8_t>(joint_index.value());
+    sample.joint_positions[out] = joint.position().value();
+    sample.joint_velocities[out] = joint.velocity().value();
+    sample.joint_efforts[out] = joint.load().value();
+  }
+
+  sample.has_body_pose = getBodyPose(kinematic_state, is_using_vision_, sample.body_position, sample.body_rotation);
+  sample.has_body_twist =
+      getBodyVelocity(kinematic_state, is_using_vision_, sample.body_linear_velocity, sample.body_angular_velocity);
+
+  auto& slot = slots_[index % capacity_];
+  writeSequenced(slot.sequence, slot.sample, sample);
+  count_.store(index + 1, std::memory_order_release);
+  newest_stamp_ns_ = stamp_ns;
+}
+
+bool RobotStateHistory::read(const std::uint64_t index, RobotStateSample& sample) const {
+  const auto& slot = slots_[index % capacity_];
+  // The writer never blocks while it fills a slot, so a read which overlapped with it succeeds momentarily.
+  while (!tryReadSequenced(slot.sequence, slot.sample, sample)) {
+    std::this_thread::yield();
+  }
+  return sample.index == index;
+}
+
+tl::expected<RobotStateSample, std::string> RobotStateHistory::getAt(const builtin_interfaces::msg::Time& stamp) const {
+  const auto stamp_ns = toNanoseconds(stamp);
+  const auto count = count_.load(std::memory_order_acquire);
+  if (count == 0) {
+    return tl::make_unexpected("No robot state has been received yet.");
+  }
+
+  RobotStateSample newest;
+  if (!read(count - 1, newest)) {
+    return tl::make_unexpected("The robot state history changed while it was read.");
+  }
+  if (stamp_ns > newest.stamp_ns) {
+    return tl::make_unexpected("Requested time is newer than the latest robot state.");
+  }
+  if (stamp_ns == newest.stamp_ns) {
+    return newest;
+  }
+
+  // Binary search for the first sample acquired at or after the requested time. Samples which were overwritten while
+  // searching are older than any sample still in the history, so they count as acquired before it.
+  auto low = count > capacity_ ? count - capacity_ : 0;
+  auto high = count - 1;
+  RobotStateSample sample;
+  while (low < high) {
+    const auto middle = low + (high - low) / 2;
+    if (read(middle, sample) && sample.stamp_ns >= stamp_ns) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+
+  RobotStateSample after;
+  RobotStateSample before;
+  if (!read(high, after) || high == 0 || !read(high - 1, before) || before.stamp_ns > stamp_ns) {
+    return tl::make_unexpected("Requested time is older than the oldest robot state in the history.");
+  }
+  if (after.stamp_ns == stamp_ns) {
+    return after;
+  }
+  return interpolate(before, after, stamp_ns);
+}
+
+tl::expected<RobotStateSample, std::string> RobotStateHistory::getExtrapolated(
+    const builtin_interfaces::msg::Time& stamp, const std::chrono::duration<double> max_horizon) const {
+  const auto newest = getLatest();
+  if (!newest) {
+    return tl::make_unexpected("No robot state has been received yet.");
+  }
+  const auto stamp_ns = toNanoseconds(stamp);
+  if (stamp_ns <= newest->stamp_ns) {
+    return getAt(stamp);
+  }
+  if (!newest->has_body_pose || !newest->has_body_twist) {
+    return tl::make_unexpected("The latest robot state has no body pose and velocity to extrapolate from.");
+  }
+  if (std::chrono::nanoseconds{stamp_ns - newest->stamp_ns} > max_horizon) {
+    return tl::make_unexpected("Requested time is too far past the latest robot state to extrapolate to.");
+  }
+  return extrapolate(newest.value(), stamp_ns);
+}
+
+std::optional<RobotStateSample> RobotStateHistory::getLatest() const {
+  const auto count = count_.load(std::memory_order_acquire);
+  if (count == 0) {
+    return std::nullopt;
+  }
+  RobotStateSample sample;
+  if (!read(count - 1, sample)) {
+    return std::nullopt;
+  }
+  return sample;
+}
+
+const std::string& RobotStateHistory::getJointName(const std::uint8_t joint_id) const {
+  return joint_names_.at(joint_id);
+}
+
+sensor_msgs::msg::JointState RobotStateHistory::toJointState(const RobotStateSample& sample) const {
+  sensor_msgs::msg::JointState joint_state;
+  joint_state.header.stamp = toTime(sample.stamp_ns);
+  for (std::size_t ndx = 0; ndx < sample.joint_count; ++ndx) {
+    joint_state.name.push_back(getJointName(sample.joint_ids[ndx]));
+    joint_state.position.push_back(sample.joint_positions[ndx]);
+    joint_state.velocity.push_back(sample.joint_velocities[ndx]);
+    joint_state.effort.push_back(sample.joint_efforts[ndx]);
+  }
+  return joint_state;
+}
+
+geometry_msgs::msg::PoseStamped RobotStateHistory::toBodyPose(const RobotStateSample& sample) const {
+  geometry_msgs::msg::PoseStamped body_pose;
+  body_pose.header.stamp = toTime(sample.stamp_ns);
+  body_pose.header.frame_id = body_pose_frame_id_;
+  body_pose.pose.position.x = sample.body_position[0];
+  body_pose.pose.position.y = sample.body_position[1];
+  body_pose.pose.position.z = sample.body_position[2];
+  body_pose.pose.orientation.w = sample.body_rotation[0];
+  body_pose.pose.orientation.x = sample.body_rotation[1];
+  body_pose.pose.orientation.y = sample.body_rotation[2];
+  body_pose.pose.orientation.z = sample.body_rotation[3];
+  return body_pose;
+}
+
+geometry_msgs::msg::TransformStamped RobotStateHistory::toBodyTransform(const RobotStateSample& sample,
+                                                                     const std::string& child_frame_id) const {
+  geometry_msgs::msg::TransformStamped transform;
+  transform.header.stamp = toTime(sample.stamp_ns);
+  transform.header.frame_id = body_pose_frame_id_;
+  transform.child_frame_id = child_frame_id;
+  transform.transform.translation.x = sample.body_position[0];
+  transform.transform.translation.y = sample.body_position[1];
+  transform.transform.translation.z = sample.body_position[2];
+  transform.transform.rotation.w = sample.body_rotation[0];
+  transform.transform.rotation.x = sample.body_rotation[1];
+  transform.transform.rotation.y = sample.body_rotation[2];
+  transform.transform.rotation.z = sample.body_rotation[3];
+  return transform;
+}
+
+}  // namespace spot_ros2
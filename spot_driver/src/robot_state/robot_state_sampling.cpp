@@ -0,0 +1,21 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/robot_state/robot_state_sampling.hpp>
+
+#include <spot_driver/conversions/robot_state.hpp>
+
+namespace spot_ros2 {
+
+std::optional<std::size_t> JointIndexCache::get(const std::size_t position, const std::string& name) {
+  if (position >= names_.size()) {
+    names_.resize(position + 1);
+    indices_.resize(position + 1);
+  }
+  if (names_[position] != name) {
+    names_[position] = name;
+    indices_[position] = getCanonicalJointIndex(name);
+  }
+  return indices_[position];
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,140 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/robot_state/shared_robot_state_reader.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <spot_driver/robot_state/sequence_lock.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+namespace {
+// A write takes well under a microsecond, so a reader which overlaps with this many writes in a row is being starved by
+// a writer which is much faster than the robot state rate.
+constexpr int kMaxReadAttempts = 1000;
+
+std::string toString(const char* name, const std::size_t max_length) {
+  return std::string(name, strnlen(name, max_length));
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+tl::expected<std::unique_ptr<SharedRobotStateReader>, std::string> SharedRobotStateReader::open(
+    const std::string& name) {
+  auto mapping = map(name);
+  if (!mapping) {
+    return tl::make_unexpected(mapping.error());
+  }
+  return std::unique_ptr<SharedRobotStateReader>(new SharedRobotStateReader(name, std::move(mapping).value()));
+}
+
+tl::expected<std::unique_ptr<SharedRobotStateReader::Mapping>, std::string> SharedRobotStateReader::map(
+    const std::string& name) {
+  const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return tl::make_unexpected("Failed to open shared memory segment " + name + ": " + std::strerror(errno));
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0) {
+    const auto error = std::string{std::strerror(errno)};
+    close(fd);
+    return tl::make_unexpected("Failed to get the size of shared memory segment " + name + ": " + error);
+  }
+  const auto size = static_cast<std::size_t>(status.st_size);
+  if (size < sizeof(SharedRobotStateSegment)) {
+    close(fd);
+    return tl::make_unexpected("Shared memory segment " + name + " is too small to hold the robot state.");
+  }
+  void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the file descriptor is closed.
+  close(fd);
+  if (address == MAP_FAILED) {
+    return tl::make_unexpected("Failed to map shared memory segment " + name + ": " + std::strerror(errno));
+  }
+
+  auto mapping = std::make_unique<Mapping>();
+  mapping->segment = static_cast<const SharedRobotStateSegment*>(address);
+  mapping->size = size;
+  const auto* segment = mapping->segment;
+  if (segment->magic.load(std::memory_order_acquire) != kSharedRobotStateMagic) {
+    return tl::make_unexpected("Shared memory segment " + name + " was not created by the state publisher.");
+  }
+  if (segment->version != kSharedRobotStateVersion || segment->joint_count > kSharedRobotStateMaxJoints) {
+    return tl::make_unexpected("Shared memory segment " + name + " has layout version " +
+                               std::to_string(segment->version) + ", but this reader expects version " +
+                               std::to_string(kSharedRobotStateVersion) + ".");
+  }
+  mapping->generation = segment->generation.load(std::memory_order_acquire);
+  for (std::size_t ndx = 0; ndx < segment->joint_count; ++ndx) {
+    mapping->joint_names.push_back(toString(segment->joint_names[ndx], kSharedRobotStateNameLength));
+  }
+  mapping->odom_frame = toString(segment->odom_frame, kSharedRobotStateNameLength);
+  return mapping;
+}
+
+SharedRobotStateReader::Mapping::~Mapping() {
+  munmap(const_cast<SharedRobotStateSegment*>(segment), size);
+}
+
+SharedRobotStateReader::SharedRobotStateReader(std::string name, std::unique_ptr<Mapping> mapping)
+    : name_{std::move(name)}, mapping_{mapping.get()} {
+  mappings_.push_back(std::move(mapping));
+}
+
+SharedRobotStateReader::~SharedRobotStateReader() = default;
+
+std::optional<SharedRobotState> SharedRobotStateReader::read() const {
+  const auto* mapping = mapping_.load(std::memory_order_acquire);
+  if (mapping->segment->generation.load(std::memory_order_acquire) != mapping->generation) {
+    mapping = remap(mapping);
+    if (mapping == nullptr) {
+      return std::nullopt;
+    }
+  }
+
+  SharedRobotState state;
+  for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+    const auto sequence = tryReadSequenced(mapping->segment->sequence, mapping->segment->state, state);
+    if (!sequence) {
+      continue;
+    }
+    // The sequence is incremented twice per robot state, so it is zero until the first one is written.
+    if (sequence.value() == 0) {
+      return std::nullopt;
+    }
+    return state;
+  }
+  return std::nullopt;
+}
+
+const SharedRobotStateReader::Mapping* SharedRobotStateReader::remap(const Mapping* retired) const {
+  std::lock_guard<std::mutex> lock{remap_mutex_};
+  const auto* current = mapping_.load(std::memory_order_acquire);
+  if (current != retired) {
+    // Another thread mapped the new segment first.
+    return current;
+  }
+  auto mapping = map(name_);
+  if (!mapping) {
+    return nullptr;
+  }
+  current = mapping.value().get();
+  mappings_.push_back(std::move(mapping).value());
+  mapping_.store(current, std::memory_order_release);
+  return current;
+}
+
+const std::vector<std::string>& SharedRobotStateReader::getJointNames() const {
+  return mapping_.load(std::memory_order_acquire)->joint_names;
+}
+
+const std::string& SharedRobotStateReader::getOdomFrame() const {
+  return mapping_.load(std::memory_order_acquire)->odom_frame;
+}
+
+}  // namespace spot_ros2
@@ -0,0 +1,165 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <spot_driver/robot_state/shared_robot_state_writer.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/conversions/time.hpp>
+#include <spot_driver/robot_state/sequence_lock.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <utility>
+
+namespace {
+constexpr std::int64_t kNanosecondsPerSecond = 1000000000;
+
+void copyName(const std::string& name, char (&out)[spot_ros2::kSharedRobotStateNameLength]) {
+  // The name is truncated if it is too long, and always left null-terminated.
+  std::strncpy(out, name.c_str(), spot_ros2::kSharedRobotStateNameLength - 1);
+}
+
+/**
+ * @brief Retire the segment with a name, if it was created by a writer with the same layout version.
+ * @details The generation of the segment is incremented, so that its readers map the segment with the name again.
+ *
+ * @return The generation to create the next segment with the name at.
+ */
+std::uint64_t retireSegment(const std::string& name) {
+  const int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    return 0;
+  }
+  struct stat status;
+  const auto has_segment_size =
+      fstat(fd, &status) == 0 && static_cast<std::size_t>(status.st_size) >= sizeof(spot_ros2::SharedRobotStateSegment);
+  void* address = has_segment_size ? mmap(nullptr, sizeof(spot_ros2::SharedRobotStateSegment), PROT_READ | PROT_WRITE,
+                                          MAP_SHARED, fd, 0)
+                                   : MAP_FAILED;
+  close(fd);
+  if (address == MAP_FAILED) {
+    return 0;
+  }
+  auto* segment = static_cast<spot_ros2::SharedRobotStateSegment*>(address);
+  std::uint64_t generation = 0;
+  if (segment->magic.load(std::memory_order_acquire) == spot_ros2::kSharedRobotStateMagic &&
+      segment->version == spot_ros2::kSharedRobotStateVersion) {
+    generation = segment->generation.fetch_add(1, std::memory_order_release) + 1;
+  }
+  munmap(address, sizeof(spot_ros2::SharedRobotStateSegment));
+  return generation;
+}
+}  // namespace
+
+namespace spot_ros2 {
+
+tl::expected<std::unique_ptr<SharedRobotStateWriter>, std::string> SharedRobotStateWriter::create(
+    const std::string& name, const bool is_using_vision) {
+  // A segment left behind by a previous state publisher which did not shut down cleanly is replaced, so that readers
+  // which open the segment by name never see a mix of both. Its readers see it retired, and map the new segment once it
+  // is ready.
+  const auto generation = retireSegment(name);
+  shm_unlink(name.c_str());
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    return tl::make_unexpected("Failed to create shared memory segment " + name + ": " + std::strerror(errno));
+  }
+  if (ftruncate(fd, sizeof(SharedRobotStateSegment)) != 0) {
+    const auto error = std::string{std::strerror(errno)};
+    close(fd);
+    shm_unlink(name.c_str());
+    return tl::make_unexpected("Failed to resize shared memory segment " + name + ": " + error);
+  }
+  void* address = mmap(nullptr, sizeof(SharedRobotStateSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the file descriptor is closed.
+  close(fd);
+  if (address == MAP_FAILED) {
+    const auto error = std::string{std::strerror(errno)};
+    shm_unlink(name.c_str());
+    return tl::make_unexpected("Failed to map shared memory segment " + name + ": " + error);
+  }
+  auto* segment = new (address) SharedRobotStateSegment{};
+  return std::unique_ptr<SharedRobotStateWriter>(
+      new SharedRobotStateWriter(name, segment, generation, is_using_vision));
+}
+
+SharedRobotStateWriter::SharedRobotStateWriter(std::string name, SharedRobotStateSegment* segment,
+                                               const std::uint64_t generation, const bool is_using_vision)
+    : name_{std::move(name)}, segment_{segment}, generation_{generation}, is_using_vision_{is_using_vision} {
+  // Joints are stored at their canonical index, which is their position in kFriendlyJointNames.
+  std::uint32_t joint_count = 0;
+  for (const auto& [spot_name, friendly_name] : kFriendlyJointNames) {
+    if (joint_count == kSharedRobotStateMaxJoints) {
+      break;
+    }
+    copyName(friendly_name, segment_->joint_names[joint_count++]);
+  }
+  segment_->joint_count = joint_count;
+  copyName(is_using_vision_ ? "vision" : "odom", segment_->odom_frame);
+  segment_->version = kSharedRobotStateVersion;
+  segment_->generation.store(generation_, std::memory_order_relaxed);
+  // Readers check the magic number first, so it is written last to make the rest of the header visible to them.
+  segment_->magic.store(kSharedRobotStateMagic, std::memory_order_release);
+}
+
+SharedRobotStateWriter::~SharedRobotStateWriter() {
+  // If another writer already replaced the segment, the name belongs to its segment, which must be left in place.
+  // Otherwise, the segment is retired so that its readers stop reading the last robot state written to it.
+  const auto replaced = segment_->generation.fetch_add(1, std::memory_order_release) != generation_;
+  munmap(segment_, sizeof(SharedRobotStateSegment));
+  if (!replaced) {
+    shm_unlink(name_.c_str());
+  }
+}
+
+void SharedRobotStateWriter::write(const ::bosdyn::api::RobotState& robot_state,
+                                   const google::protobuf::Duration& clock_skew) {
+  const auto& kinematic_state = robot_state.kinematic_state();
+  ++state_.count;
+  if (kinematic_state.has_acquisition_timestamp()) {
+    const auto stamp = robotTimeToLocalTime(kinematic_state.acquisition_timestamp(), clock_skew);
+    state_.stamp_ns = static_cast<std::int64_t>(stamp.sec) * kNanosecondsPerSecond + stamp.nanosec;
+  } else {
+    state_.stamp_ns = 0;
+  }
+
+  std::fill(std::begin(state_.joint_valid), std::end(state_.joint_valid), 0);
+  for (int ndx = 0; ndx < kinematic_state.joint_states_size(); ++ndx) {
+    const auto& joint = kinematic_state.joint_states(ndx);
+    const auto out = joint_indices_.get(static_cast<std::size_t>(ndx), joint.name());
+    if (!out || out.value() >= kSharedRobotStateMaxJoints) {
+      continue;
+    }
+    state_.joint_valid[out.value()] = 1;
+    state_.joint_positions[out.value()] = joint.position().value();
+    state_.joint_velocities[out.value()] = joint.velocity().value();
+    state_.joint_efforts[out.value()] = joint.load().value();
+  }
+
+  state_.has_body_pose =
+      getBodyPose(kinematic_state, is_using_vision_, state_.body_position, state_.body_rotation) ? 1 : 0;
+  state_.has_body_twist =
+      getBodyVelocity(kinematic_state, is_using_vision_, state_.body_linear_velocity, state_.body_angular_velocity)
+          ? 1
+          : 0;
+
+  state_.foot_count = static_cast<std::uint8_t>(
+      std::min<std::size_t>(static_cast<std::size_t>(robot_state.foot_state_size()), kSharedRobotStateFeet));
+  for (std::size_t ndx = 0; ndx < state_.foot_count; ++ndx) {
+    state_.foot_contacts[ndx] = static_cast<std::uint8_t>(robot_state.foot_state(static_cast<int>(ndx)).contact());
+  }
+
+  state_.write_time_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+  writeSequenced(segment_->sequence, segment_->state, state_);
+}
+
+}  // namespace spot_ros2
@@ -10,11 +10,14 @@
 #include <spot_driver/types.hpp>
 #include <spot_msgs/msg/battery_state_array.hpp>
 #include <spot_msgs/msg/behavior_fault_state.hpp>
+#include <spot_msgs/msg/compact_joint_state.hpp>
 #include <spot_msgs/msg/e_stop_state_array.hpp>
 #include <spot_msgs/msg/foot_state_array.hpp>
+#include <spot_msgs/msg/joint_name_manifest.hpp>
 #include <spot_msgs/msg/power_state.hpp>
 #include <spot_msgs/msg/system_fault_state.hpp>
 #include <spot_msgs/msg/wi_fi_state.hpp>
+#include <spot_msgs/srv/get_robot_state_at_time.hpp>
 
 namespace {
 constexpr auto kPublisherHistoryDepth = 1;
@@ -22,6 +25,8 @@ constexpr auto kNodeName{"spot_state_publisher"};
 
 // ROS topic names for Spot's robot state publisher
 constexpr auto kJointStatesTopic{"joint_states"};
+constexpr auto kCompactJointStatesTopic{"joint_states/compact"};
+constexpr auto kJointNameManifestTopic{"joint_states/manifest"};
 constexpr auto kOdomTwistTopic{"odometry/twist"};
 constexpr auto kOdomTopic{"odometry"};
 constexpr auto kFeetTopic{"status/feet"};
@@ -34,6 +39,9 @@ constexpr auto kBehaviorFaultsTopic{"status/behavior_faults"};
 constexpr auto kEndEffectorForceTopic{"status/end_effector_force"};
 constexpr auto kManipulatorTopic{"manipulation_state"};
 
+// ROS service names for Spot's robot state publisher
+constexpr auto kGetRobotStateAtTimeService{"get_robot_state_at_time"};
+
 }  // namespace
 
 namespace spot_ros2 {
@@ -69,11 +77,18 @@ StateMiddlewareHandle::StateMiddlewareHandle(const rclcpp::NodeOptions& node_opt
     : StateMiddlewareHandle(std::make_shared<rclcpp::Node>(kNodeName, node_options)) {}
 
 void StateMiddlewareHandle::publishRobotState(const RobotStateMessages& robot_state_msgs) {
-  battery_states_publisher_->publish(robot_state_msgs.battery_states);
-  wifi_state_publisher_->publish(robot_state_msgs.wifi_state);
-  foot_states_publisher_->publish(robot_state_msgs.foot_state);
-  estop_states_publisher_->publish(robot_state_msgs.estop_states);
-
+  if (robot_state_msgs.maybe_battery_states) {
+    battery_states_publisher_->publish(robot_state_msgs.maybe_battery_states.value());
+  }
+  if (robot_state_msgs.maybe_wifi_state) {
+    wifi_state_publisher_->publish(robot_state_msgs.maybe_wifi_state.value());
+  }
+  if (robot_state_msgs.maybe_foot_state) {
+    foot_states_publisher_->publish(robot_state_msgs.maybe_foot_state.value());
+  }
+  if (robot_state_msgs.maybe_estop_states) {
+    estop_states_publisher_->publish(robot_state_msgs.maybe_estop_states.value());
+  }
   if (robot_state_msgs.maybe_joint_states) {
     joint_state_publisher_->publish(robot_state_msgs.maybe_joint_states.value());
   }
@@ -98,6 +113,29 @@ void StateMiddlewareHandle::publishRobotState(const RobotStateMessages& robot_st
   if (robot_state_msgs.maybe_behavior_fault_state) {
     behavior_fault_state_publisher_->publish(robot_state_msgs.maybe_behavior_fault_state.value());
   }
+  if (robot_state_msgs.maybe_compact_joint_states && compact_joint_state_publisher_) {
+    compact_joint_state_publisher_->publish(robot_state_msgs.maybe_compact_joint_states.value());
+  }
+}
+
+void StateMiddlewareHandle::publishJointNameManifest(const spot_msgs::msg::JointNameManifest& manifest) {
+  // The compact joint state topics only exist if the compact joint states are enabled, which is when the manifest is
+  // published.
+  if (!joint_name_manifest_publisher_) {
+    compact_joint_state_publisher_ = node_->create_publisher<spot_msgs::msg::CompactJointState>(
+        kCompactJointStatesTopic, makePublisherQoS(kPublisherHistoryDepth));
+    joint_name_manifest_publisher_ = node_->create_publisher<spot_msgs::msg::JointNameManifest>(
+        kJointNameManifestTopic, makePublisherQoS(kPublisherHistoryDepth));
+  }
+  joint_name_manifest_publisher_->publish(manifest);
+}
+
+void StateMiddlewareHandle::createGetRobotStateAtTimeService(
+    std::function<void(const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request>,
+                       std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response>)>
+        callback) {
+  robot_state_at_time_service_ =
+      node_->create_service<spot_msgs::srv::GetRobotStateAtTime>(kGetRobotStateAtTimeService, callback);
 }
 
 }  // namespace spot_ros2
@@ -1,18 +1,185 @@
 // Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <spot_driver/api/state_client_interface.hpp>
 #include <spot_driver/conversions/geometry.hpp>
 #include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/conversions/robot_state_converter.hpp>
 #include <spot_driver/interfaces/rclcpp_wall_timer_interface.hpp>
 #include <spot_driver/robot_state/state_publisher.hpp>
 #include <spot_driver/types.hpp>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 namespace {
 constexpr auto kRobotStateCallbackPeriod = std::chrono::duration<double>{1.0 / 50.0};  // 50 Hz
+// How often the achieved rate and request latency are logged when polling asynchronously.
+constexpr auto kPollingStatisticsReportPeriod = std::chrono::duration<double>{10.0};
+// Number of robot states kept in the history, which covers about 20 seconds at the default polling rate.
+constexpr std::size_t kRobotStateHistoryCapacity = 1024;
+
+/**
+ * @brief Mix a value into a hash, the same way boost::hash_combine does.
+ */
+void hashCombine(std::size_t& seed, const std::size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+void hashFields(const google::protobuf::Message& message, std::string_view ignored_field, std::size_t& seed);
+
+/**
+ * @brief Mix the value of a field into a hash. The index is only used for repeated fields.
+ */
+void hashFieldValue(const google::protobuf::Message& message, const google::protobuf::FieldDescriptor* field,
+                    const int index, std::string_view ignored_field, std::size_t& seed) {
+  using google::protobuf::FieldDescriptor;
+  const auto* reflection = message.GetReflection();
+  const bool repeated = field->is_repeated();
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      hashCombine(seed, std::hash<std::int32_t>{}(repeated ? reflection->GetRepeatedInt32(message, field, index)
+                                                           : reflection->GetInt32(message, field)));
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      hashCombine(seed, std::hash<std::int64_t>{}(repeated ? reflection->GetRepeatedInt64(message, field, index)
+                                                           : reflection->GetInt64(message, field)));
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      hashCombine(seed, std::hash<std::uint32_t>{}(repeated ? reflection->GetRepeatedUInt32(message, field, index)
+                                                            : reflection->GetUInt32(message, field)));
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      hashCombine(seed, std::hash<std::uint64_t>{}(repeated ? reflection->GetRepeatedUInt64(message, field, index)
+                                                            : reflection->GetUInt64(message, field)));
+      break;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      hashCombine(seed, std::hash<double>{}(repeated ? reflection->GetRepeatedDouble(message, field, index)
+                                                     : reflection->GetDouble(message, field)));
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      hashCombine(seed, std::hash<float>{}(repeated ? reflection->GetRepeatedFloat(message, field, index)
+                                                    : reflection->GetFloat(message, field)));
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      hashCombine(seed, std::hash<bool>{}(repeated ? reflection->GetRepeatedBool(message, field, index)
+                                                   : reflection->GetBool(message, field)));
+      break;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      hashCombine(seed, std::hash<int>{}(repeated ? reflection->GetRepeatedEnumValue(message, field, index)
+                                                  : reflection->GetEnumValue(message, field)));
+      break;
+    case FieldDescriptor::CPPTYPE_STRING: {
+      // Only used if the string is not stored as a std::string, which is never the case for these messages
+      std::string scratch;
+      const auto& value = repeated ? reflection->GetRepeatedStringReference(message, field, index, &scratch)
+                                   : reflection->GetStringReference(message, field, &scratch);
+      hashCombine(seed, std::hash<std::string_view>{}(value));
+      break;
+    }
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      hashFields(
+          repeated ? reflection->GetRepeatedMessage(message, field, index) : reflection->GetMessage(message, field),
+          ignored_field, seed);
+      break;
+  }
+}
+
+/**
+ * @brief Mix every set field of a protobuf message into a hash, reading them in place through reflection.
+ * @param ignored_field Name of a field that is left out, in this message and in every message nested in it.
+ */
+void hashFields(const google::protobuf::Message& message, std::string_view ignored_field, std::size_t& seed) {
+  const auto* reflection = message.GetReflection();
+  std::vector<const google::protobuf::FieldDescriptor*> fields;
+  // Lists the fields in field number order, so equal messages always hash the same
+  reflection->ListFields(message, &fields);
+  for (const auto* field : fields) {
+    if (field->name() == ignored_field) {
+      continue;
+    }
+    hashCombine(seed, static_cast<std::size_t>(field->number()));
+    if (!field->is_repeated()) {
+      hashFieldValue(message, field, -1, ignored_field, seed);
+      continue;
+    }
+    const auto size = reflection->FieldSize(message, field);
+    hashCombine(seed, static_cast<std::size_t>(size));
+    for (int ndx = 0; ndx < size; ++ndx) {
+      hashFieldValue(message, field, ndx, ignored_field, seed);
+    }
+  }
+}
+
+/**
+ * @brief Mix a repeated field of protobuf messages into a hash, leaving out one field of each.
+ */
+template <typename MessageT>
+void hashRepeatedFields(const google::protobuf::RepeatedPtrField<MessageT>& messages, std::string_view ignored_field,
+                        std::size_t& seed) {
+  hashCombine(seed, static_cast<std::size_t>(messages.size()));
+  for (const auto& message : messages) {
+    hashFields(message, ignored_field, seed);
+  }
 }
 
+/**
+ * @brief Compute a fingerprint of the part of the robot state that an output is converted from, leaving out fields
+ * such as timestamps and fault durations that change on every robot state even if the status itself does not. The
+ * fields are hashed where they are, without copying or serializing the robot state.
+ * @return The fingerprint, or nullopt if the output is not a status output and should always be published.
+ */
+std::optional<std::size_t> getStatusFingerprint(const spot_ros2::RobotStateOutput output,
+                                                const bosdyn::api::RobotState& robot_state) {
+  using spot_ros2::RobotStateOutput;
+  std::size_t fingerprint = 0;
+  switch (output) {
+    case RobotStateOutput::ESTOP_STATES:
+      hashRepeatedFields(robot_state.estop_states(), "timestamp", fingerprint);
+      break;
+    case RobotStateOutput::WIFI_STATE:
+      hashRepeatedFields(robot_state.comms_states(), "timestamp", fingerprint);
+      break;
+    case RobotStateOutput::POWER_STATE:
+      hashFields(robot_state.power_state(), "timestamp", fingerprint);
+      break;
+    case RobotStateOutput::SYSTEM_FAULT_STATE:
+      hashFields(robot_state.system_fault_state(), "duration", fingerprint);
+      break;
+    case RobotStateOutput::BEHAVIOR_FAULT_STATE:
+      hashFields(robot_state.behavior_fault_state(), {}, fingerprint);
+      break;
+    default:
+      return std::nullopt;
+  }
+  return fingerprint;
+}
+
+/**
+ * @brief Get the current time of the host's clock, which robot timestamps are converted to.
+ */
+builtin_interfaces::msg::Time getLocalTime() {
+  const auto now_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  builtin_interfaces::msg::Time stamp;
+  stamp.sec = static_cast<std::int32_t>(now_ns / 1000000000);
+  stamp.nanosec = static_cast<std::uint32_t>(now_ns % 1000000000);
+  return stamp;
+}
+
+bool isSameTimestamp(const google::protobuf::Timestamp& lhs, const google::protobuf::Timestamp& rhs) {
+  return lhs.seconds() == rhs.seconds() && lhs.nanos() == rhs.nanos();
+}
+}  // namespace
+
 namespace spot_ros2 {
 
 StatePublisher::StatePublisher(const std::shared_ptr<StateClientInterface>& state_client_interface,
@@ -21,7 +188,8 @@ StatePublisher::StatePublisher(const std::shared_ptr<StateClientInterface>& stat
                                std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                                std::unique_ptr<LoggerInterfaceBase> logger_interface,
                                std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
-                               std::unique_ptr<TimerInterfaceBase> timer_interface)
+                               std::unique_ptr<TimerInterfaceBase> timer_interface,
+                               std::unique_ptr<TimerInterfaceBase> tf_extrapolation_timer_interface)
     : is_using_vision_{false},
       state_client_interface_{state_client_interface},
       time_sync_interface_{time_sync_api},
@@ -29,14 +197,89 @@ StatePublisher::StatePublisher(const std::shared_ptr<StateClientInterface>& stat
       parameter_interface_{std::move(parameter_interface)},
       logger_interface_{std::move(logger_interface)},
       tf_broadcaster_interface_{std::move(tf_broadcaster_interface)},
-      timer_interface_{std::move(timer_interface)} {
+      timer_interface_{std::move(timer_interface)},
+      tf_extrapolation_timer_interface_{std::move(tf_extrapolation_timer_interface)} {
   const auto spot_name = parameter_interface_->getSpotName();
   frame_prefix_ = spot_name.empty() ? "" : spot_name + "/";
 
+  for (std::size_t ndx = 0; ndx < kRobotStateOutputCount; ++ndx) {
+    const auto rate = parameter_interface_->getRobotStatePublishRate(static_cast<RobotStateOutput>(ndx));
+    if (rate > 0.) {
+      output_schedules_.at(ndx).period =
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>{1.0 / rate});
+    }
+  }
+
+  // The compact joint states duplicate the joint states, so they are only published if requested
+  enabled_outputs_.set();
+  if (!parameter_interface_->getPublishCompactJointStates()) {
+    enabled_outputs_.reset(static_cast<std::size_t>(RobotStateOutput::COMPACT_JOINT_STATES));
+  }
+
+  publish_status_on_change_ = parameter_interface_->getPublishStatusOnChange();
+  status_heartbeat_period_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>{parameter_interface_->getStatusHeartbeatPeriod()});
+
   const auto preferred_odom_frame = parameter_interface_->getPreferredOdomFrame();
   is_using_vision_ = preferred_odom_frame == "vision";
   full_odom_frame_id_ =
       preferred_odom_frame.find('/') == std::string::npos ? frame_prefix_ + preferred_odom_frame : preferred_odom_frame;
+  robot_state_converter_ = std::make_unique<RobotStateConverter>(frame_prefix_, full_odom_frame_id_, is_using_vision_);
+  robot_state_history_ =
+      std::make_shared<RobotStateHistory>(kRobotStateHistoryCapacity, frame_prefix_, is_using_vision_);
+  if (const auto shared_memory_state_name = parameter_interface_->getSharedMemoryStateName();
+      !shared_memory_state_name.empty()) {
+    auto writer = SharedRobotStateWriter::create(shared_memory_state_name, is_using_vision_);
+    if (writer) {
+      shared_robot_state_writer_ = std::move(writer.value());
+    } else {
+      logger_interface_->logError(
+          std::string{"Failed to export the robot state to shared memory: "}.append(writer.error()));
+    }
+  }
+  if (enabled_outputs_.test(static_cast<std::size_t>(RobotStateOutput::COMPACT_JOINT_STATES))) {
+    middleware_handle_->publishJointNameManifest(getJointNameManifest(frame_prefix_));
+  }
+  middleware_handle_->createGetRobotStateAtTimeService(
+      [this](const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request> request,
+             std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response> response) {
+        getRobotStateAtTime(request, response);
+      });
+
+  const bool is_streaming = state_client_interface_->isStreaming();
+  // The stream carries the body pose but not its velocity, which stays at the rate of the polled robot state. The
+  // streamed poses are recent enough on their own, and extrapolating them with a stale velocity would only add error.
+  if (const auto extrapolation_rate = parameter_interface_->getBodyTfExtrapolationRate();
+      extrapolation_rate > 0. && is_streaming) {
+    logger_interface_->logWarn("Body TF extrapolation is not supported while streaming robot state, and is disabled.");
+  } else if (extrapolation_rate > 0.) {
+    extrapolated_body_frame_id_ = frame_prefix_ + "body_extrapolated";
+    body_tf_extrapolation_horizon_ =
+        std::chrono::duration<double>{parameter_interface_->getBodyTfExtrapolationHorizon()};
+    tf_extrapolation_timer_interface_->setTimer(std::chrono::duration<double>{1.0 / extrapolation_rate}, [this] {
+      publishExtrapolatedBodyTf();
+    });
+  }
+
+  // A streaming state client produces states faster than the timer could publish them, so it is always polled
+  // asynchronously. This depends on the client itself rather than on the stream_robot_state parameter, since the
+  // node falls back to a polled client if the robot cannot stream.
+  if (parameter_interface_->getAsyncRobotStatePolling() || is_streaming) {
+    // The streaming state client paces the requests itself, by answering each one with the next streamed state
+    if (const auto polling_rate = parameter_interface_->getAsyncRobotStatePollingRate();
+        polling_rate > 0. && !is_streaming) {
+      polling_period_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>{1.0 / polling_rate});
+    }
+    // Request and publish robot state as fast as responses arrive, and periodically report how fast that is
+    timer_interface_->setTimer(kPollingStatisticsReportPeriod, [this] {
+      logger_interface_->logInfo(polling_statistics_.report());
+    });
+    polling_thread_ = std::thread{[this] {
+      pollingLoop();
+    }};
+    return;
+  }
 
   // Create a timer to request and publish robot state at a fixed rate
   timer_interface_->setTimer(kRobotStateCallbackPeriod, [this] {
@@ -44,6 +287,21 @@ StatePublisher::StatePublisher(const std::shared_ptr<StateClientInterface>& stat
   });
 }
 
+StatePublisher::~StatePublisher() {
+  if (polling_thread_.joinable()) {
+    {
+      std::lock_guard lock{polling_mutex_};
+      stop_polling_ = true;
+    }
+    polling_condition_.notify_all();
+    polling_thread_.join();
+  }
+}
+
+std::shared_ptr<const RobotStateHistory> StatePublisher::getRobotStateHistory() const {
+  return robot_state_history_;
+}
+
 void StatePublisher::timerCallback() {
   // Get latest clock skew each time we request a robot state
   const auto clock_skew_result = time_sync_interface_->getClockSkew();
@@ -58,23 +316,173 @@ void StatePublisher::timerCallback() {
     return;
   }
 
-  const auto& clock_skew = clock_skew_result.value();
-  const auto& robot_state = robot_state_result.value();
-
-  const auto robot_state_messages =
-      RobotStateMessages{getBatteryStates(robot_state, clock_skew),
-                         getWifiState(robot_state),
-                         getFootState(robot_state),
-                         getEstopStates(robot_state, clock_skew),
-                         getJointStates(robot_state, clock_skew, frame_prefix_),
-                         getTf(robot_state, clock_skew, frame_prefix_, full_odom_frame_id_),
-                         getOdomTwist(robot_state, clock_skew),
-                         getOdom(robot_state, clock_skew, frame_prefix_, is_using_vision_),
-                         getPowerState(robot_state, clock_skew),
-                         getSystemFaultState(robot_state, clock_skew),
-                         getManipulatorState(robot_state),
-                         getEndEffectorForce(robot_state, clock_skew, frame_prefix_),
-                         getBehaviorFaultState(robot_state, clock_skew)};
+  publishRobotState(robot_state_result.value(), clock_skew_result.value());
+}
+
+void StatePublisher::pollingLoop() {
+  auto request_time = std::chrono::steady_clock::now();
+  auto pending_request = state_client_interface_->getRobotStateAsync();
+  while (!stop_polling_) {
+    const auto robot_state_result = pending_request.get();
+    const auto response_time = std::chrono::steady_clock::now();
+    polling_statistics_.addResponse(response_time - request_time, robot_state_result.has_value());
+
+    if (!robot_state_result.has_value()) {
+      logger_interface_->logError(std::string{"Failed to get robot_state: "}.append(robot_state_result.error()));
+      waitForRetry(kRobotStateCallbackPeriod);
+      request_time = std::chrono::steady_clock::now();
+      pending_request = state_client_interface_->getRobotStateAsync();
+      continue;
+    }
+
+    // Send the next request before processing this response, so that there is always a request in flight. If that
+    // would exceed the polling rate, send it once the rate allows instead, after this response has been published.
+    const auto next_request_time = request_time + polling_period_;
+    const bool is_throttled = response_time < next_request_time;
+    if (!is_throttled) {
+      request_time = response_time;
+      pending_request = state_client_interface_->getRobotStateAsync();
+    }
+
+    publishPolledRobotState(robot_state_result.value());
+
+    if (is_throttled) {
+      waitUntil(next_request_time);
+      request_time = std::chrono::steady_clock::now();
+      pending_request = state_client_interface_->getRobotStateAsync();
+    }
+  }
+}
+
+void StatePublisher::publishPolledRobotState(const bosdyn::api::RobotState& robot_state) {
+  // The robot may answer several requests with the same state, which has already been published
+  const auto& acquisition_timestamp = robot_state.kinematic_state().acquisition_timestamp();
+  if (robot_state.kinematic_state().has_acquisition_timestamp() &&
+      isSameTimestamp(acquisition_timestamp, last_acquisition_timestamp_)) {
+    return;
+  }
+
+  // Get latest clock skew each time we receive a robot state
+  const auto clock_skew_result = time_sync_interface_->getClockSkew();
+  if (!clock_skew_result) {
+    logger_interface_->logError(std::string{"Failed to get latest clock skew: "}.append(clock_skew_result.error()));
+    waitForRetry(kRobotStateCallbackPeriod);
+    return;
+  }
+
+  publishRobotState(robot_state, clock_skew_result.value());
+  last_acquisition_timestamp_ = acquisition_timestamp;
+  polling_statistics_.addPublished();
+}
+
+bool StatePublisher::isOutputDue(const RobotStateOutput output, const std::chrono::steady_clock::time_point now) {
+  auto& schedule = output_schedules_.at(static_cast<std::size_t>(output));
+  if (schedule.period <= std::chrono::steady_clock::duration::zero()) {
+    return true;
+  }
+  if (schedule.next_due.has_value() && now < schedule.next_due.value()) {
+    return false;
+  }
+  // Advance from the previous deadline rather than from now, so that jitter in when robot states arrive does not lower
+  // the average rate. If the output fell more than a period behind, start over from now instead of catching up.
+  if (!schedule.next_due.has_value() || now - schedule.next_due.value() > schedule.period) {
+    schedule.next_due = now;
+  }
+  schedule.next_due.value() += schedule.period;
+  return true;
+}
+
+bool StatePublisher::hasStatusChanged(const RobotStateOutput output, const bosdyn::api::RobotState& robot_state,
+                                      const std::chrono::steady_clock::time_point now) {
+  if (!publish_status_on_change_) {
+    return true;
+  }
+  const auto fingerprint = getStatusFingerprint(output, robot_state);
+  if (!fingerprint.has_value()) {
+    return true;
+  }
+
+  auto& schedule = output_schedules_.at(static_cast<std::size_t>(output));
+  const auto heartbeat_due =
+      !schedule.last_published.has_value() || now - schedule.last_published.value() >= status_heartbeat_period_;
+  if (!heartbeat_due && schedule.fingerprint == fingerprint) {
+    return false;
+  }
+  schedule.fingerprint = fingerprint;
+  schedule.last_published = now;
+  return true;
+}
+
+bool StatePublisher::shouldPublish(const RobotStateOutput output, const bosdyn::api::RobotState& robot_state,
+                                   const std::chrono::steady_clock::time_point now) {
+  return isOutputDue(output, now) && hasStatusChanged(output, robot_state, now);
+}
+
+void StatePublisher::getRobotStateAtTime(
+    const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request> request,
+    std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response> response) const {
+  const auto sample = robot_state_history_->getAt(request->stamp);
+  if (!sample) {
+    response->success = false;
+    response->message = sample.error();
+    return;
+  }
+  response->success = true;
+  response->joint_states = robot_state_history_->toJointState(sample.value());
+  if (sample->has_body_pose) {
+    response->body_pose = robot_state_history_->toBodyPose(sample.value());
+  } else {
+    response->message = "The robot states around the requested time have no body pose.";
+  }
+}
+
+void StatePublisher::publishExtrapolatedBodyTf() {
+  // The history can be read while the polling thread adds to it, so this never waits for a robot state to be published
+  const auto sample = robot_state_history_->getExtrapolated(getLocalTime(), body_tf_extrapolation_horizon_);
+  if (!sample || !sample->has_body_pose) {
+    return;
+  }
+  auto transform = robot_state_history_->toBodyTransform(sample.value(), extrapolated_body_frame_id_);
+  if (last_extrapolated_stamp_ == transform.header.stamp) {
+    return;
+  }
+  last_extrapolated_stamp_ = transform.header.stamp;
+  tf_broadcaster_interface_->sendDynamicTransforms({std::move(transform)});
+}
+
+void StatePublisher::waitForRetry(const std::chrono::duration<double> duration) {
+  std::unique_lock lock{polling_mutex_};
+  polling_condition_.wait_for(lock, duration, [this] {
+    return stop_polling_.load();
+  });
+}
+
+void StatePublisher::waitUntil(const std::chrono::steady_clock::time_point time) {
+  std::unique_lock lock{polling_mutex_};
+  polling_condition_.wait_until(lock, time, [this] {
+    return stop_polling_.load();
+  });
+}
+
+void StatePublisher::publishRobotState(const bosdyn::api::RobotState& robot_state,
+                                       const google::protobuf::Duration& clock_skew) {
+  // Real-time consumers of the shared memory segment are the most sensitive to latency, so it is written first.
+  if (shared_robot_state_writer_) {
+    shared_robot_state_writer_->write(robot_state, clock_skew);
+  }
+
+  // Record every robot state, published or not, so that the history services can look up and extrapolate from it.
+  robot_state_history_->add(robot_state, clock_skew);
+
+  // Only convert the outputs which are enabled and due to be published, and whose source has changed if publishing on
+  // change. All message timestamps are derived from the acquisition time reported by the robot, shifted into the host's
+  // clock.
+  const auto now = std::chrono::steady_clock::now();
+  RobotStateOutputSet outputs;
+  for (std::size_t ndx = 0; ndx < kRobotStateOutputCount; ++ndx) {
+    outputs.set(ndx, enabled_outputs_.test(ndx) && shouldPublish(static_cast<RobotStateOutput>(ndx), robot_state, now));
+  }
+  const auto& robot_state_messages = robot_state_converter_->convert(robot_state, clock_skew, outputs);
 
   middleware_handle_->publishRobotState(robot_state_messages);
 
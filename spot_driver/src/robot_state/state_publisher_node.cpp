@@ -1,5 +1,6 @@
 // Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
+#include <chrono>
 #include <memory>
 #include <spot_driver/robot_state/state_publisher.hpp>
 #include <spot_driver/robot_state/state_publisher_node.hpp>
@@ -7,6 +8,7 @@
 
 #include <spot_driver/api/default_spot_api.hpp>
 
+#include <spot_driver/interfaces/coalescing_tf_broadcaster_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_logger_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_node_interface.hpp>
 #include <spot_driver/interfaces/rclcpp_parameter_interface.hpp>
@@ -26,10 +28,12 @@ StatePublisherNode::StatePublisherNode(std::unique_ptr<NodeInterfaceBase> node_b
                                        std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                                        std::unique_ptr<LoggerInterfaceBase> logger_interface,
                                        std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
-                                       std::unique_ptr<TimerInterfaceBase> timer_interface)
+                                       std::unique_ptr<TimerInterfaceBase> timer_interface,
+                                       std::unique_ptr<TimerInterfaceBase> tf_extrapolation_timer_interface)
     : node_base_interface_{std::move(node_base_interface)} {
   initialize(std::move(spot_api), std::move(middleware_handle), std::move(parameter_interface),
-             std::move(logger_interface), std::move(tf_broadcaster_interface), std::move(timer_interface));
+             std::move(logger_interface), std::move(tf_broadcaster_interface), std::move(timer_interface),
+             std::move(tf_extrapolation_timer_interface));
 }
 
 StatePublisherNode::StatePublisherNode(const rclcpp::NodeOptions& node_options) {
@@ -39,13 +43,21 @@ StatePublisherNode::StatePublisherNode(const rclcpp::NodeOptions& node_options)
   auto mw_handle = std::make_unique<StateMiddlewareHandle>(node);
   auto parameter_interface = std::make_unique<RclcppParameterInterface>(node);
   auto logger_interface = std::make_unique<RclcppLoggerInterface>(node->get_logger());
-  auto tf_broadcaster_interface = std::make_unique<RclcppTfBroadcasterInterface>(node);
+  std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface =
+      std::make_unique<RclcppTfBroadcasterInterface>(node);
+  if (const auto tf_coalescing_rate = parameter_interface->getTfCoalescingRate(); tf_coalescing_rate > 0.) {
+    tf_broadcaster_interface = std::make_unique<CoalescingTfBroadcasterInterface>(
+        std::move(tf_broadcaster_interface), std::make_unique<RclcppWallTimerInterface>(node),
+        std::chrono::duration<double>{1.0 / tf_coalescing_rate});
+  }
   auto timer_interface = std::make_unique<RclcppWallTimerInterface>(node);
+  auto tf_extrapolation_timer_interface = std::make_unique<RclcppWallTimerInterface>(node);
 
   auto spot_api = std::make_unique<DefaultSpotApi>(kDefaultSDKName, parameter_interface->getCertificate());
 
   initialize(std::move(spot_api), std::move(mw_handle), std::move(parameter_interface), std::move(logger_interface),
-             std::move(tf_broadcaster_interface), std::move(timer_interface));
+             std::move(tf_broadcaster_interface), std::move(timer_interface),
+             std::move(tf_extrapolation_timer_interface));
 }
 
 void StatePublisherNode::initialize(std::unique_ptr<SpotApi> spot_api,
@@ -53,7 +65,8 @@ void StatePublisherNode::initialize(std::unique_ptr<SpotApi> spot_api,
                                     std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                                     std::unique_ptr<LoggerInterfaceBase> logger_interface,
                                     std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
-                                    std::unique_ptr<TimerInterfaceBase> timer_interface) {
+                                    std::unique_ptr<TimerInterfaceBase> timer_interface,
+                                    std::unique_ptr<TimerInterfaceBase> tf_extrapolation_timer_interface) {
   spot_api_ = std::move(spot_api);
 
   const auto hostname = parameter_interface->getHostname();
@@ -75,14 +88,31 @@ void StatePublisherNode::initialize(std::unique_ptr<SpotApi> spot_api,
     throw std::runtime_error(error_msg);
   }
 
-  internal_ = std::make_unique<StatePublisher>(spot_api_->stateClientInterface(), spot_api_->timeSyncInterface(),
+  std::shared_ptr<StateClientInterface> state_client_interface;
+  if (parameter_interface->getStreamRobotState()) {
+    state_client_interface = spot_api_->streamingStateClientInterface();
+    if (!state_client_interface) {
+      logger_interface->logWarn(
+          "Robot state streaming was requested, but the streaming service is not available. Polling robot state "
+          "instead.");
+    }
+  }
+  if (!state_client_interface) {
+    state_client_interface = spot_api_->stateClientInterface();
+  }
+
+  internal_ = std::make_unique<StatePublisher>(state_client_interface, spot_api_->timeSyncInterface(),
                                                std::move(middleware_handle), std::move(parameter_interface),
                                                std::move(logger_interface), std::move(tf_broadcaster_interface),
-                                               std::move(timer_interface));
+                                               std::move(timer_interface), std::move(tf_extrapolation_timer_interface));
 }
 
 std::shared_ptr<rclcpp::node_interfaces::NodeBaseInterface> StatePublisherNode::get_node_base_interface() {
   return node_base_interface_->getNodeBaseInterface();
 }
 
+std::shared_ptr<const RobotStateHistory> StatePublisherNode::getRobotStateHistory() const {
+  return internal_ ? internal_->getRobotStateHistory() : nullptr;
+}
+
 }  // namespace spot_ros2
@@ -4,6 +4,7 @@
 
 #include <spot_driver/interfaces/parameter_interface_base.hpp>
 
+#include <map>
 #include <optional>
 #include <set>
 #include <string>
@@ -38,6 +39,39 @@ class FakeParameterInterface : public ParameterInterfaceBase {
 
   std::string getPreferredOdomFrame() const override { return "odom"; }
 
+  bool getAsyncRobotStatePolling() const override { return async_robot_state_polling; }
+
+  double getAsyncRobotStatePollingRate() const override { return async_robot_state_polling_rate; }
+
+  bool getStreamRobotState() const override { return stream_robot_state; }
+
+  double getRobotStatePublishRate(const RobotStateOutput output) const override {
+    const auto rate = robot_state_publish_rates.find(output);
+    return rate != robot_state_publish_rates.end() ? rate->second : kDefaultRobotStatePublishRate;
+  }
+
+  bool getPublishStatusOnChange() const override { return publish_status_on_change; }
+
+  double getStatusHeartbeatPeriod() const override { return status_heartbeat_period; }
+
+  bool getPublishCompactJointStates() const override { return publish_compact_joint_states; }
+
+  std::string getSharedMemoryStateName() const override { return shared_memory_state_name; }
+
+  double getBodyTfExtrapolationRate() const override { return body_tf_extrapolation_rate; }
+
+  double getBodyTfExtrapolationHorizon() const override { return body_tf_extrapolation_horizon; }
+
+  double getWorldObjectSyncTranslationThreshold() const override { return world_object_sync_translation_threshold; }
+
+  double getWorldObjectSyncRotationThreshold() const override { return world_object_sync_rotation_threshold; }
+
+  bool getWorldObjectSyncOnTfUpdates() const override { return world_object_sync_on_tf_updates; }
+
+  double getTfCoalescingRate() const override { return tf_coalescing_rate; }
+
+  double getWorldObjectDetectionRate() const override { return world_object_detection_rate; }
+
   std::string getSpotName() const override { return spot_name; }
 
   std::set<spot_ros2::SpotCamera> getDefaultCamerasUsed(const bool has_arm) const override {
@@ -64,6 +98,21 @@ class FakeParameterInterface : public ParameterInterfaceBase {
   bool publish_rgb_images = ParameterInterfaceBase::kDefaultPublishRGBImages;
   bool publish_depth_images = ParameterInterfaceBase::kDefaultPublishDepthImages;
   bool publish_depth_registered_images = ParameterInterfaceBase::kDefaultPublishDepthRegisteredImages;
+  bool async_robot_state_polling = ParameterInterfaceBase::kDefaultAsyncRobotStatePolling;
+  double async_robot_state_polling_rate = ParameterInterfaceBase::kDefaultAsyncRobotStatePollingRate;
+  bool stream_robot_state = ParameterInterfaceBase::kDefaultStreamRobotState;
+  std::map<RobotStateOutput, double> robot_state_publish_rates;
+  bool publish_status_on_change = ParameterInterfaceBase::kDefaultPublishStatusOnChange;
+  double status_heartbeat_period = ParameterInterfaceBase::kDefaultStatusHeartbeatPeriod;
+  bool publish_compact_joint_states = ParameterInterfaceBase::kDefaultPublishCompactJointStates;
+  std::string shared_memory_state_name = ParameterInterfaceBase::kDefaultSharedMemoryStateName;
+  double body_tf_extrapolation_rate = ParameterInterfaceBase::kDefaultBodyTfExtrapolationRate;
+  double body_tf_extrapolation_horizon = ParameterInterfaceBase::kDefaultBodyTfExtrapolationHorizon;
+  double world_object_sync_translation_threshold = ParameterInterfaceBase::kDefaultWorldObjectSyncTranslationThreshold;
+  double world_object_sync_rotation_threshold = ParameterInterfaceBase::kDefaultWorldObjectSyncRotationThreshold;
+  bool world_object_sync_on_tf_updates = ParameterInterfaceBase::kDefaultWorldObjectSyncOnTfUpdates;
+  double tf_coalescing_rate = ParameterInterfaceBase::kDefaultTfCoalescingRate;
+  double world_object_detection_rate = ParameterInterfaceBase::kDefaultWorldObjectDetectionRate;
   std::string spot_name;
 };
 }  // namespace spot_ros2::test
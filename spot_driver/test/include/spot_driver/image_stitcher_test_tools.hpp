@@ -0,0 +1,130 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <cv_bridge/cv_bridge.h>
+#include <geometry_msgs/msg/transform.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/core/quaternion.hpp>
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <spot_driver/image_stitcher/image_stitcher.hpp>
+#include <std_msgs/msg/header.hpp>
+
+#include <cmath>
+#include <memory>
+#include <string>
+
+/**
+ * Fixtures for testing the image stitcher. The transforms and camera infos of the front cameras are hand-written values
+ * which approximate those of a standing robot. They were not recorded from a robot, so they only exercise the stitcher
+ * with a realistic geometry, and do not reproduce the calibration of any particular robot.
+ */
+
+namespace spot_ros2::test {
+// Virtual camera parameters, matching the defaults in spot_ros_example.yaml
+inline const cv::Matx33d kVirtualCameraIntrinsics{385., 0., 315., 0., 385., 844., 0., 0., 1.};
+inline const cv::Vec3d kVirtualCameraProjectionPlane{-0.15916, 0., 0.987253};
+constexpr auto kVirtualCameraPlaneDistance = 0.5;
+constexpr auto kStitchedImageRowPadding = 1182;
+
+inline geometry_msgs::msg::Transform createTransform(double x, double y, double z, double qw, double qx, double qy,
+                                                     double qz) {
+  geometry_msgs::msg::Transform out;
+  out.translation.x = x;
+  out.translation.y = y;
+  out.translation.z = z;
+  out.rotation.w = qw;
+  out.rotation.x = qx;
+  out.rotation.y = qy;
+  out.rotation.z = qz;
+  return out;
+}
+
+/** @brief Representative body_tform_frontleft_fisheye transform of a standing robot. */
+inline geometry_msgs::msg::Transform frontLeftTransform() {
+  return createTransform(0.415, 0.037, 0.023, 0.529093, 0.146841, 0.830510, -0.093548);
+}
+
+/** @brief Representative body_tform_frontright_fisheye transform of a standing robot. */
+inline geometry_msgs::msg::Transform frontRightTransform() {
+  return createTransform(0.415, -0.037, 0.023, 0.529093, -0.146841, 0.830510, 0.093548);
+}
+
+inline sensor_msgs::msg::CameraInfo createCameraInfo(const std::string& frame_id, double fx, double fy, double cx,
+                                                     double cy) {
+  sensor_msgs::msg::CameraInfo info;
+  info.header.frame_id = frame_id;
+  info.width = 640;
+  info.height = 480;
+  info.distortion_model = "plumb_bob";
+  info.d = std::vector<double>(5, 0.);
+  info.k = {fx, 0., cx, 0., fy, cy, 0., 0., 1.};
+  info.p = {fx, 0., cx, 0., 0., fy, cy, 0., 0., 0., 1., 0.};
+  return info;
+}
+
+/** @brief Representative camera_info of the front left camera. */
+inline sensor_msgs::msg::CameraInfo frontLeftCameraInfo() {
+  return createCameraInfo("frontleft_fisheye", 330.91, 329.58, 318.62, 243.17);
+}
+
+/** @brief Representative camera_info of the front right camera. */
+inline sensor_msgs::msg::CameraInfo frontRightCameraInfo() {
+  return createCameraInfo("frontright_fisheye", 331.27, 330.12, 322.04, 238.85);
+}
+
+/** @brief Build the front middle virtual camera from the fixtures above. */
+inline MiddleCamera createFrontMiddleCamera() {
+  return MiddleCamera{kVirtualCameraIntrinsics,
+                      kVirtualCameraProjectionPlane,
+                      kVirtualCameraPlaneDistance,
+                      kStitchedImageRowPadding,
+                      frontLeftTransform(),
+                      frontRightTransform(),
+                      frontLeftCameraInfo(),
+                      frontRightCameraInfo()};
+}
+
+/**
+ * @brief Render what a camera sees of a textured wall two meters in front of the robot.
+ * @details Both front cameras see the same wall, so their images overlap consistently the way real images do. The
+ * texture mixes a checkerboard with smooth color gradients so that the seam finder and the blender both have work.
+ */
+inline std::shared_ptr<const sensor_msgs::msg::Image> renderSyntheticScene(
+    const geometry_msgs::msg::Transform& body_tform_camera, const sensor_msgs::msg::CameraInfo& info) {
+  constexpr auto kWallDistance = 2.0;
+  constexpr auto kCheckerSize = 0.1;
+
+  const cv::Quatd q{body_tform_camera.rotation.w, body_tform_camera.rotation.x, body_tform_camera.rotation.y,
+                    body_tform_camera.rotation.z};
+  const cv::Matx33d R = q.toRotMat3x3();
+  const cv::Vec3d t{body_tform_camera.translation.x, body_tform_camera.translation.y, body_tform_camera.translation.z};
+  const cv::Matx33d K_inv =
+      cv::Matx33d{info.k[0], info.k[1], info.k[2], info.k[3], info.k[4], info.k[5], info.k[6], info.k[7], info.k[8]}
+          .inv();
+
+  cv::Mat image{static_cast<int>(info.height), static_cast<int>(info.width), CV_8UC3, cv::Scalar::all(0)};
+  for (int v = 0; v < image.rows; ++v) {
+    auto* const row = image.ptr<cv::Vec3b>(v);
+    for (int u = 0; u < image.cols; ++u) {
+      const cv::Vec3d ray = R * (K_inv * cv::Vec3d{static_cast<double>(u), static_cast<double>(v), 1.});
+      if (ray(0) <= 0.) {
+        continue;
+      }
+      const double scale = (kWallDistance - t(0)) / ray(0);
+      const double y = t(1) + scale * ray(1);
+      const double z = t(2) + scale * ray(2);
+      const bool checker = (static_cast<int>(std::floor(y / kCheckerSize)) +
+                            static_cast<int>(std::floor(z / kCheckerSize))) % 2 == 0;
+      row[u] = cv::Vec3b{cv::saturate_cast<uchar>(checker ? 220 : 40),
+                         cv::saturate_cast<uchar>(128. + 100. * std::sin(3. * y)),
+                         cv::saturate_cast<uchar>(128. + 100. * std::cos(3. * z))};
+    }
+  }
+
+  std_msgs::msg::Header header;
+  header.frame_id = info.header.frame_id;
+  return cv_bridge::CvImage(header, "bgr8", image).toImageMsg();
+}
+}  // namespace spot_ros2::test
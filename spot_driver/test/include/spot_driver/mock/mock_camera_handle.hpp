@@ -0,0 +1,26 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <gmock/gmock.h>
+
+#include <opencv2/core/matx.hpp>
+#include <spot_driver/image_stitcher/image_stitcher.hpp>
+
+#include <functional>
+#include <string>
+
+namespace spot_ros2::test {
+class MockCameraHandle : public CameraHandleBase {
+ public:
+  MOCK_METHOD(void, publish, (const Image& image, const CameraInfo& info), (const, override));
+  MOCK_METHOD(void, broadcast, (const Transform& tf, const Time& stamp), (override));
+  MOCK_METHOD(std::string, getBodyFrame, (), (const, override));
+  MOCK_METHOD(std::string, getCameraFrame, (), (const, override));
+  MOCK_METHOD(cv::Matx33d, getIntrinsics, (), (const, override));
+  MOCK_METHOD(cv::Vec3d, getPlaneNormal, (), (const, override));
+  MOCK_METHOD(double, getPlaneDistance, (), (const, override));
+  MOCK_METHOD(int, getRowPadding, (), (const, override));
+  MOCK_METHOD(void, registerParameterCallback, (const std::function<void()>& fn), (override));
+};
+}  // namespace spot_ros2::test
@@ -0,0 +1,14 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <gmock/gmock.h>
+
+#include <spot_driver/image_stitcher/image_stitcher.hpp>
+
+namespace spot_ros2::test {
+class MockCameraSynchronizer : public CameraSynchronizerBase {
+ public:
+  MOCK_METHOD(void, registerCallback, (const DualImageCallbackFn& fn), (override));
+};
+}  // namespace spot_ros2::test
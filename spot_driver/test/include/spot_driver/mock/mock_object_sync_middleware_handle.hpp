@@ -0,0 +1,20 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <gmock/gmock.h>
+#include <spot_driver/object_sync/object_synchronizer.hpp>
+
+namespace spot_ros2::test {
+class MockObjectSyncMiddlewareHandle : public ObjectSynchronizer::MiddlewareHandle {
+ public:
+  MOCK_METHOD(void, publishWorldObjects, (const spot_msgs::msg::WorldObjectArray& world_objects), (override));
+  MOCK_METHOD(void, publishWorldObjectDetections, (const spot_msgs::msg::WorldObjectDetectionArray& detections),
+              (override));
+  MOCK_METHOD(void, createListCachedWorldObjectsService,
+              (std::function<void(const std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Request>,
+                                  std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Response>)>
+                   callback),
+              (override));
+};
+}  // namespace spot_ros2::test
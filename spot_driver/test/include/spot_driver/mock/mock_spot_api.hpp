@@ -25,6 +25,7 @@ class MockSpotApi : public SpotApi {
   MOCK_METHOD(std::shared_ptr<KinematicApi>, kinematicInterface, (), (const, override));
   MOCK_METHOD(std::shared_ptr<ImageClientInterface>, image_client_interface, (), (const, override));
   MOCK_METHOD(std::shared_ptr<StateClientInterface>, stateClientInterface, (), (const, override));
+  MOCK_METHOD(std::shared_ptr<StateClientInterface>, streamingStateClientInterface, (), (const, override));
   MOCK_METHOD(std::shared_ptr<TimeSyncApi>, timeSyncInterface, (), (const, override));
   MOCK_METHOD(std::shared_ptr<WorldObjectClientInterface>, worldObjectClientInterface, (), (const, override));
 };
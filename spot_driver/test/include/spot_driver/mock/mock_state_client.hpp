@@ -12,5 +12,6 @@ namespace spot_ros2::test {
 class MockStateClient : public StateClientInterface {
  public:
   MOCK_METHOD((tl::expected<bosdyn::api::RobotState, std::string>), getRobotState, (), (override));
+  MOCK_METHOD(bool, isStreaming, (), (const, override));
 };
 }  // namespace spot_ros2::test
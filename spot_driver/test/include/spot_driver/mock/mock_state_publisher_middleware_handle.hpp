@@ -8,5 +8,11 @@ namespace spot_ros2::test {
 class MockStateMiddlewareHandle : public StatePublisher::MiddlewareHandle {
  public:
   MOCK_METHOD(void, publishRobotState, (const RobotStateMessages& robot_state), (override));
+  MOCK_METHOD(void, publishJointNameManifest, (const spot_msgs::msg::JointNameManifest& manifest), (override));
+  MOCK_METHOD(void, createGetRobotStateAtTimeService,
+              (std::function<void(const std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Request>,
+                                  std::shared_ptr<spot_msgs::srv::GetRobotStateAtTime::Response>)>
+                   callback),
+              (override));
 };
 }  // namespace spot_ros2::test
@@ -5,6 +5,7 @@
 #include <gmock/gmock.h>
 
 #include <geometry_msgs/msg/transform_stamped.hpp>
+#include <map>
 #include <spot_driver/interfaces/tf_listener_interface_base.hpp>
 #include <string>
 #include <vector>
@@ -12,9 +13,29 @@
 namespace spot_ros2::test {
 class MockTfListenerInterface : public TfListenerInterfaceBase {
  public:
+  /**
+   * @brief By default, batched lookups delegate to lookupTransform() for each child frame, so tests can set
+   * expectations on single lookups no matter which of the two the code under test calls.
+   */
+  MockTfListenerInterface() {
+    ON_CALL(*this, lookupTransforms)
+        .WillByDefault([this](const std::string& parent, const std::vector<std::string>& children,
+                              const rclcpp::Time& timepoint) {
+          return TfListenerInterfaceBase::lookupTransforms(parent, children, timepoint);
+        });
+  }
+
   MOCK_METHOD((std::vector<std::string>), getAllFrameNames, (), (const, override));
 
   MOCK_METHOD((tl::expected<geometry_msgs::msg::TransformStamped, std::string>), lookupTransform,
               (const std::string& parent, const std::string& child, const rclcpp::Time& timepoint), (const, override));
+
+  MOCK_METHOD((std::vector<tl::expected<geometry_msgs::msg::TransformStamped, std::string>>), lookupTransforms,
+              (const std::string& parent, const std::vector<std::string>& children, const rclcpp::Time& timepoint),
+              (const, override));
+
+  MOCK_METHOD(void, startTrackingUpdatedFrames, (), (override));
+
+  MOCK_METHOD((std::map<std::string, rclcpp::Time>), takeUpdatedFrames, (), (override));
 };
 }  // namespace spot_ros2::test
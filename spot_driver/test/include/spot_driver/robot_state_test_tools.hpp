@@ -120,4 +120,69 @@ inline void addAcquisitionTimestamp(::bosdyn::api::KinematicState* mutable_kinem
                                     const google::protobuf::Timestamp& timestamp) {
   mutable_kinematic_state->mutable_acquisition_timestamp()->CopyFrom(timestamp);
 }
+
+/**
+ * @brief Create a robot state that every robot state output can be converted from, resembling the state of a standing
+ * robot with an arm.
+ */
+inline ::bosdyn::api::RobotState createRobotStateWithAllOutputs() {
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(100);
+  google::protobuf::Duration duration;
+  duration.set_seconds(5);
+
+  ::bosdyn::api::RobotState robot_state;
+  *robot_state.add_battery_states() =
+      createBatteryState("battery", timestamp, 80, 2, 55, 30.0,
+                         ::bosdyn::api::BatteryState_Status::BatteryState_Status_STATUS_DISCHARGING);
+  *robot_state.add_comms_states()->mutable_wifi_state() =
+      createWifiState(::bosdyn::api::WiFiState_Mode::WiFiState_Mode_MODE_CLIENT, "network");
+  for (int ndx = 0; ndx < 4; ++ndx) {
+    setFootState(robot_state.add_foot_state(), 0.3 * ndx, 0.2, -0.5, ::bosdyn::api::FootState::CONTACT_MADE);
+  }
+  auto* estop_state = robot_state.add_estop_states();
+  estop_state->set_name("hardware_estop");
+  estop_state->set_type(::bosdyn::api::EStopState_Type::EStopState_Type_TYPE_HARDWARE);
+  estop_state->set_state(::bosdyn::api::EStopState_State::EStopState_State_STATE_NOT_ESTOPPED);
+  estop_state->mutable_timestamp()->CopyFrom(timestamp);
+
+  auto* kinematic_state = robot_state.mutable_kinematic_state();
+  double position = 0.;
+  for (const auto& [name, friendly_name] : kFriendlyJointNames) {
+    setJointState(kinematic_state->add_joint_states(), name, position, 0.1, 0.2, 0.3);
+    position += 0.1;
+  }
+  addAcquisitionTimestamp(kinematic_state, timestamp);
+  addBodyVelocityOdom(kinematic_state, 0.5, 0.1, 0.0, 0.0, 0.0, 0.2);
+  auto* snapshot = kinematic_state->mutable_transforms_snapshot();
+  addRootFrame(snapshot, "body");
+  addTransform(snapshot, "odom", "body", -1.0, -2.0, -0.5, 1.0, 0.0, 0.0, 0.0);
+  addTransform(snapshot, "vision", "body", -1.5, -2.5, -0.5, 1.0, 0.0, 0.0, 0.0);
+  addTransform(snapshot, "gpe", "odom", 0.0, 0.0, -0.5, 1.0, 0.0, 0.0, 0.0);
+  addTransform(snapshot, "flat_body", "body", 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+  addTransform(snapshot, "hand", "body", 0.6, 0.0, 0.3, 1.0, 0.0, 0.0, 0.0);
+  addTransform(snapshot, "arm0.link_wr1", "body", 0.5, 0.0, 0.3, 1.0, 0.0, 0.0, 0.0);
+
+  auto* power_state = robot_state.mutable_power_state();
+  power_state->mutable_timestamp()->CopyFrom(timestamp);
+  power_state->set_motor_power_state(
+      ::bosdyn::api::PowerState_MotorPowerState::PowerState_MotorPowerState_MOTOR_POWER_STATE_ON);
+  power_state->mutable_locomotion_charge_percentage()->set_value(80.0);
+  power_state->mutable_locomotion_estimated_runtime()->CopyFrom(duration);
+  appendSystemFault(robot_state.mutable_system_fault_state(), timestamp, duration, "fault", 1, 2, "battery is low",
+                    {"robot", "battery"}, ::bosdyn::api::SystemFault_Severity::SystemFault_Severity_SEVERITY_WARN);
+
+  auto* manipulator_state = robot_state.mutable_manipulator_state();
+  manipulator_state->set_gripper_open_percentage(50.0);
+  manipulator_state->mutable_estimated_end_effector_force_in_hand()->set_x(1.0);
+  manipulator_state->set_stow_state(
+      ::bosdyn::api::ManipulatorState_StowState::ManipulatorState_StowState_STOWSTATE_STOWED);
+
+  auto* behavior_fault = robot_state.mutable_behavior_fault_state()->add_faults();
+  behavior_fault->set_behavior_fault_id(1);
+  behavior_fault->set_cause(::bosdyn::api::BehaviorFault_Cause::BehaviorFault_Cause_CAUSE_FALL);
+  behavior_fault->set_status(::bosdyn::api::BehaviorFault_Status::BehaviorFault_Status_STATUS_CLEARABLE);
+  behavior_fault->mutable_onset_timestamp()->CopyFrom(timestamp);
+  return robot_state;
+}
 }  // namespace spot_ros2::test
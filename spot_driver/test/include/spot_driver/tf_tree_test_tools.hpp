@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#pragma once
+
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <rclcpp/executors.hpp>
+#include <rclcpp/node.hpp>
+#include <spot_driver/interfaces/tf_listener_interface_base.hpp>
+#include <tf2_ros/static_transform_broadcaster.h>
+#include <tf2_ros/transform_broadcaster.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spot_ros2::test {
+/** @brief Root of the tree created by createTfTree(). */
+constexpr auto kTfTreeRootFrame = "odom";
+/** @brief Frame created by createTfTree() to which all leaf frames are attached. */
+constexpr auto kTfTreeBodyFrame = "body";
+
+/** @brief Create a transform with a nonzero translation and a rotation about the z axis. */
+inline geometry_msgs::msg::TransformStamped createTfTreeTransform(const std::string& parent, const std::string& child,
+                                                                  const double offset) {
+  geometry_msgs::msg::TransformStamped transform;
+  transform.header.frame_id = parent;
+  transform.child_frame_id = child;
+  transform.transform.translation.x = offset;
+  transform.transform.translation.y = 2.0 * offset;
+  transform.transform.translation.z = 0.1;
+  transform.transform.rotation.w = std::cos(offset / 2.0);
+  transform.transform.rotation.z = std::sin(offset / 2.0);
+  return transform;
+}
+
+/**
+ * @brief Create the transforms of a TF tree which resembles a robot with many external frames: a chain of frames from
+ * kTfTreeRootFrame down to kTfTreeBodyFrame, and leaf frames named leaf_<index> which are all children of the body.
+ *
+ * @param chain_length Number of frames between the root and the body.
+ * @param leaf_count Number of leaf frames.
+ */
+inline std::vector<geometry_msgs::msg::TransformStamped> createTfTree(const std::size_t chain_length,
+                                                                     const std::size_t leaf_count) {
+  std::vector<geometry_msgs::msg::TransformStamped> transforms;
+  std::string parent = kTfTreeRootFrame;
+  for (std::size_t ndx = 0; ndx < chain_length; ++ndx) {
+    const auto child = "chain_" + std::to_string(ndx);
+    transforms.push_back(createTfTreeTransform(parent, child, 0.1 * static_cast<double>(ndx + 1)));
+    parent = child;
+  }
+  transforms.push_back(createTfTreeTransform(parent, kTfTreeBodyFrame, 0.3));
+  for (std::size_t ndx = 0; ndx < leaf_count; ++ndx) {
+    transforms.push_back(
+        createTfTreeTransform(kTfTreeBodyFrame, "leaf_" + std::to_string(ndx), 0.01 * static_cast<double>(ndx)));
+  }
+  return transforms;
+}
+
+/**
+ * @brief Publish transforms as static transforms, and spin the node until a TF listener on it knows all their frames.
+ * @return True if the listener received the transforms before the timeout.
+ */
+inline bool publishStaticTransforms(const std::shared_ptr<rclcpp::Node>& node, const TfListenerInterfaceBase& listener,
+                                    const std::vector<geometry_msgs::msg::TransformStamped>& transforms,
+                                    const std::chrono::seconds timeout = std::chrono::seconds{10}) {
+  tf2_ros::StaticTransformBroadcaster broadcaster{node};
+  broadcaster.sendTransform(transforms);
+  // The root frame has no transform of its own
+  const auto expected_frame_count = transforms.size() + 1;
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (listener.getAllFrameNames().size() < expected_frame_count) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    rclcpp::spin_some(node);
+  }
+  return true;
+}
+
+/**
+ * @brief Publish transforms as dynamic transforms, and spin the node until a TF listener on it can look up each of them
+ * at its own stamp.
+ * @return True if the listener received the transforms before the timeout.
+ */
+inline bool publishDynamicTransforms(const std::shared_ptr<rclcpp::Node>& node, const TfListenerInterfaceBase& listener,
+                                     const std::vector<geometry_msgs::msg::TransformStamped>& transforms,
+                                     const std::chrono::seconds timeout = std::chrono::seconds{10}) {
+  tf2_ros::TransformBroadcaster broadcaster{node};
+  broadcaster.sendTransform(transforms);
+  const auto is_received = [&listener](const geometry_msgs::msg::TransformStamped& transform) {
+    return listener.lookupTransform(transform.header.frame_id, transform.child_frame_id, transform.header.stamp)
+        .has_value();
+  };
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!std::all_of(transforms.begin(), transforms.end(), is_received)) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    rclcpp::spin_some(node);
+  }
+  return true;
+}
+}  // namespace spot_ros2::test
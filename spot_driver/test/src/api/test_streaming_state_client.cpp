@@ -0,0 +1,171 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+#include <spot_driver/api/streaming_state_client.hpp>
+
+#ifdef SPOT_DRIVER_HAS_ROBOT_STATE_STREAMING
+
+#include <bosdyn/api/geometry.pb.h>
+#include <bosdyn/api/robot_state.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <spot_driver/robot_state_test_tools.hpp>
+
+namespace {
+using ::testing::DoubleNear;
+using ::testing::Eq;
+
+constexpr auto kTolerance = 1e-6;
+
+/**
+ * @brief Create a polled robot state of two joints, with the body one meter from odom and one and a half from vision.
+ */
+::bosdyn::api::RobotState makePolledRobotState() {
+  ::bosdyn::api::RobotState robot_state;
+  auto* kinematic_state = robot_state.mutable_kinematic_state();
+  spot_ros2::test::setJointState(kinematic_state->add_joint_states(), "fl.hx", 0.1, 0.2, 0.3, 0.4);
+  spot_ros2::test::setJointState(kinematic_state->add_joint_states(), "fl.hy", 0.5, 0.6, 0.7, 0.8);
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(100);
+  spot_ros2::test::addAcquisitionTimestamp(kinematic_state, timestamp);
+  auto* snapshot = kinematic_state->mutable_transforms_snapshot();
+  spot_ros2::test::addRootFrame(snapshot, "body");
+  spot_ros2::test::addTransform(snapshot, "odom", "body", -1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+  spot_ros2::test::addTransform(snapshot, "vision", "body", -1.5, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+  spot_ros2::test::addTransform(snapshot, "hand", "body", 0.6, 0.0, 0.3, 1.0, 0.0, 0.0, 0.0);
+  return robot_state;
+}
+
+void setPose(::bosdyn::api::SE3Pose* pose, const double x, const double y, const double z) {
+  pose->mutable_position()->set_x(x);
+  pose->mutable_position()->set_y(y);
+  pose->mutable_position()->set_z(z);
+  pose->mutable_rotation()->set_w(1.0);
+}
+
+/**
+ * @brief Create a streamed response with new joint states, acquired a second after the polled robot state.
+ */
+::bosdyn::api::RobotStateStreamResponse makeStreamedResponse() {
+  ::bosdyn::api::RobotStateStreamResponse streamed;
+  auto* joint_states = streamed.mutable_joint_states();
+  joint_states->add_position(1.1);
+  joint_states->add_position(1.5);
+  joint_states->add_velocity(1.2);
+  joint_states->add_velocity(1.6);
+  joint_states->add_load(1.4);
+  joint_states->add_load(1.8);
+  joint_states->mutable_acquisition_timestamp()->set_seconds(101);
+  return streamed;
+}
+
+const ::bosdyn::api::SE3Pose& getBodyTformChild(const ::bosdyn::api::RobotState& robot_state, const char* child) {
+  return robot_state.kinematic_state().transforms_snapshot().child_to_parent_edge_map().at(child).parent_tform_child();
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(MergeStreamedRobotState, CopiesJointStatesAndAcquisitionTime) {
+  // GIVEN a polled robot state and a streamed response without kinematics
+  auto robot_state = makePolledRobotState();
+  const auto streamed = makeStreamedResponse();
+
+  // WHEN the streamed response is merged into the polled robot state
+  mergeStreamedRobotState(robot_state, streamed);
+
+  // THEN the joint positions, velocities and loads are streamed, and everything else is polled
+  const auto& joints = robot_state.kinematic_state().joint_states();
+  ASSERT_THAT(joints.size(), Eq(2));
+  EXPECT_THAT(joints[0].name(), Eq("fl.hx"));
+  EXPECT_THAT(joints[0].position().value(), DoubleNear(1.1, kTolerance));
+  EXPECT_THAT(joints[0].velocity().value(), DoubleNear(1.2, kTolerance));
+  EXPECT_THAT(joints[0].acceleration().value(), DoubleNear(0.3, kTolerance));
+  EXPECT_THAT(joints[0].load().value(), DoubleNear(1.4, kTolerance));
+  EXPECT_THAT(joints[1].name(), Eq("fl.hy"));
+  EXPECT_THAT(joints[1].position().value(), DoubleNear(1.5, kTolerance));
+  EXPECT_THAT(joints[1].velocity().value(), DoubleNear(1.6, kTolerance));
+  EXPECT_THAT(joints[1].acceleration().value(), DoubleNear(0.7, kTolerance));
+  EXPECT_THAT(joints[1].load().value(), DoubleNear(1.8, kTolerance));
+  EXPECT_THAT(robot_state.kinematic_state().acquisition_timestamp().seconds(), Eq(101));
+  EXPECT_THAT(getBodyTformChild(robot_state, "odom").position().x(), DoubleNear(-1.0, kTolerance));
+  EXPECT_THAT(getBodyTformChild(robot_state, "vision").position().x(), DoubleNear(-1.5, kTolerance));
+}
+
+TEST(MergeStreamedRobotState, MatchesJointsByName) {
+  // GIVEN a polled robot state of some leg and arm joints, including arm0.hr0, which the stream does not report
+  ::bosdyn::api::RobotState robot_state;
+  auto* kinematic_state = robot_state.mutable_kinematic_state();
+  setJointState(kinematic_state->add_joint_states(), "fr.kn", 0.1, 0.2, 0.3, 0.4);
+  setJointState(kinematic_state->add_joint_states(), "arm0.sh1", 0.1, 0.2, 0.3, 0.4);
+  setJointState(kinematic_state->add_joint_states(), "arm0.hr0", 0.1, 0.2, 0.3, 0.4);
+  setJointState(kinematic_state->add_joint_states(), "arm0.el0", 0.1, 0.2, 0.3, 0.4);
+  setJointState(kinematic_state->add_joint_states(), "arm0.f1x", 0.1, 0.2, 0.3, 0.4);
+
+  // GIVEN a streamed response of all 19 streamed joints, where each joint's position is its index in the stream
+  ::bosdyn::api::RobotStateStreamResponse streamed;
+  for (int ndx = 0; ndx < 19; ++ndx) {
+    streamed.mutable_joint_states()->add_position(ndx);
+    streamed.mutable_joint_states()->add_velocity(10 * ndx);
+  }
+
+  // WHEN the streamed response is merged into the polled robot state
+  mergeStreamedRobotState(robot_state, streamed);
+
+  // THEN each joint takes the streamed values of the joint with the same name, even after arm0.hr0
+  const auto& joints = robot_state.kinematic_state().joint_states();
+  ASSERT_THAT(joints.size(), Eq(5));
+  EXPECT_THAT(joints[0].position().value(), DoubleNear(5.0, kTolerance));
+  EXPECT_THAT(joints[0].velocity().value(), DoubleNear(50.0, kTolerance));
+  EXPECT_THAT(joints[1].position().value(), DoubleNear(13.0, kTolerance));
+  EXPECT_THAT(joints[3].position().value(), DoubleNear(14.0, kTolerance));
+  EXPECT_THAT(joints[4].position().value(), DoubleNear(18.0, kTolerance));
+  EXPECT_THAT(joints[4].velocity().value(), DoubleNear(180.0, kTolerance));
+
+  // THEN arm0.hr0 is left as polled
+  EXPECT_THAT(joints[2].position().value(), DoubleNear(0.1, kTolerance));
+  EXPECT_THAT(joints[2].velocity().value(), DoubleNear(0.2, kTolerance));
+  EXPECT_THAT(joints[2].load().value(), DoubleNear(0.4, kTolerance));
+}
+
+TEST(MergeStreamedRobotState, TakesOdomAndVisionPosesFromStream) {
+  // GIVEN a polled robot state and a streamed response with the body pose in both odom and vision
+  auto robot_state = makePolledRobotState();
+  auto streamed = makeStreamedResponse();
+  setPose(streamed.mutable_kinematic_state()->mutable_odom_tform_body(), 3.0, 1.0, 0.0);
+  setPose(streamed.mutable_kinematic_state()->mutable_vision_tform_body(), 4.0, 2.0, 0.5);
+
+  // WHEN the streamed response is merged into the polled robot state
+  mergeStreamedRobotState(robot_state, streamed);
+
+  // THEN the odom and vision frames are placed with the streamed body poses
+  const auto& body_tform_odom = getBodyTformChild(robot_state, "odom");
+  EXPECT_THAT(body_tform_odom.position().x(), DoubleNear(-3.0, kTolerance));
+  EXPECT_THAT(body_tform_odom.position().y(), DoubleNear(-1.0, kTolerance));
+  EXPECT_THAT(body_tform_odom.position().z(), DoubleNear(0.0, kTolerance));
+  const auto& body_tform_vision = getBodyTformChild(robot_state, "vision");
+  EXPECT_THAT(body_tform_vision.position().x(), DoubleNear(-4.0, kTolerance));
+  EXPECT_THAT(body_tform_vision.position().y(), DoubleNear(-2.0, kTolerance));
+  EXPECT_THAT(body_tform_vision.position().z(), DoubleNear(-0.5, kTolerance));
+
+  // THEN frames the stream does not report are left as polled
+  EXPECT_THAT(getBodyTformChild(robot_state, "hand").position().x(), DoubleNear(0.6, kTolerance));
+}
+
+TEST(MergeStreamedRobotState, KeepsPolledVisionToOdomWithoutStreamedVisionPose) {
+  // GIVEN a polled robot state, where vision is half a meter behind odom, and a streamed response with the body pose in
+  // odom only
+  auto robot_state = makePolledRobotState();
+  auto streamed = makeStreamedResponse();
+  setPose(streamed.mutable_kinematic_state()->mutable_odom_tform_body(), 3.0, 1.0, 0.0);
+
+  // WHEN the streamed response is merged into the polled robot state
+  mergeStreamedRobotState(robot_state, streamed);
+
+  // THEN odom is placed with the streamed body pose, and vision stays half a meter behind it
+  EXPECT_THAT(getBodyTformChild(robot_state, "odom").position().x(), DoubleNear(-3.0, kTolerance));
+  const auto& body_tform_vision = getBodyTformChild(robot_state, "vision");
+  EXPECT_THAT(body_tform_vision.position().x(), DoubleNear(-3.5, kTolerance));
+  EXPECT_THAT(body_tform_vision.position().y(), DoubleNear(-1.0, kTolerance));
+}
+}  // namespace spot_ros2::test
+
+#endif  // SPOT_DRIVER_HAS_ROBOT_STATE_STREAMING
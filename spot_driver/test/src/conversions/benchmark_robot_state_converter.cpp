@@ -0,0 +1,129 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+/**
+ * Compares the heap allocations and time per robot state of converting every robot state output with the get*
+ * functions in robot_state.hpp, as StatePublisher used to, and with a reused RobotStateConverter.
+ *
+ * It is built alongside the tests but not run by them:
+ *   <build directory>/test/benchmark_robot_state_converter [iterations]
+ */
+
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/conversions/robot_state_converter.hpp>
+#include <spot_driver/robot_state_test_tools.hpp>
+#include <spot_driver/types.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr auto kDefaultIterations = 10000;
+constexpr auto kWarmupIterations = 10;
+constexpr auto kPrefix = "spot/";
+constexpr auto kPreferredOdomFrame = "spot/odom";
+
+// Number of calls to operator new since the program started.
+std::atomic<std::size_t> allocation_count{0};
+
+struct Sample {
+  double time_us;
+  std::size_t allocations;
+};
+
+void printSamples(const std::string& name, std::vector<Sample> samples) {
+  double total_time_us = 0.;
+  std::size_t total_allocations = 0;
+  for (const auto& sample : samples) {
+    total_time_us += sample.time_us;
+    total_allocations += sample.allocations;
+  }
+  std::sort(samples.begin(), samples.end(), [](const Sample& lhs, const Sample& rhs) {
+    return lhs.time_us < rhs.time_us;
+  });
+  const auto percentile = [&samples](double p) {
+    return samples[static_cast<size_t>(p * (samples.size() - 1))].time_us;
+  };
+  std::printf("%-20s allocations/tick %7.1f  mean %8.2f us  p50 %8.2f us  p99 %8.2f us  max %8.2f us\n", name.c_str(),
+              static_cast<double>(total_allocations) / samples.size(), total_time_us / samples.size(), percentile(0.5),
+              percentile(0.99), samples.back().time_us);
+}
+
+template <typename ConvertT>
+std::vector<Sample> measure(const int iterations, ConvertT&& convert) {
+  for (int ndx = 0; ndx < kWarmupIterations; ++ndx) {
+    convert();
+  }
+  std::vector<Sample> samples;
+  samples.reserve(iterations);
+  for (int ndx = 0; ndx < iterations; ++ndx) {
+    const auto allocations_before = allocation_count.load();
+    const auto start = std::chrono::steady_clock::now();
+    convert();
+    const auto time = std::chrono::steady_clock::now() - start;
+    samples.push_back({std::chrono::duration<double, std::micro>(time).count(), allocation_count - allocations_before});
+  }
+  return samples;
+}
+}  // namespace
+
+// Count every heap allocation of the program. The array and aligned forms are left to their default implementations,
+// which the converted messages do not use.
+void* operator new(std::size_t size) {
+  ++allocation_count;
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+int main(int argc, char* argv[]) {
+  using namespace spot_ros2;
+  const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : kDefaultIterations;
+
+  const auto robot_state = test::createRobotStateWithAllOutputs();
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+
+  const auto get_functions = measure(iterations, [&] {
+    RobotStateMessages messages;
+    messages.maybe_battery_states = getBatteryStates(robot_state, clock_skew);
+    messages.maybe_wifi_state = getWifiState(robot_state);
+    messages.maybe_foot_state = getFootState(robot_state);
+    messages.maybe_estop_states = getEstopStates(robot_state, clock_skew);
+    messages.maybe_joint_states = getJointStates(robot_state, clock_skew, kPrefix);
+    messages.maybe_tf = getTf(robot_state, clock_skew, kPrefix, kPreferredOdomFrame);
+    messages.maybe_odom_twist = getOdomTwist(robot_state, clock_skew);
+    messages.maybe_odom = getOdom(robot_state, clock_skew, kPrefix, false);
+    messages.maybe_power_state = getPowerState(robot_state, clock_skew);
+    messages.maybe_system_fault_state = getSystemFaultState(robot_state, clock_skew);
+    messages.maybe_manipulator_state = getManipulatorState(robot_state);
+    messages.maybe_end_effector_force = getEndEffectorForce(robot_state, clock_skew, kPrefix);
+    messages.maybe_behavior_fault_state = getBehaviorFaultState(robot_state, clock_skew);
+    messages.maybe_compact_joint_states = getCompactJointStates(robot_state, clock_skew);
+  });
+
+  RobotStateConverter converter{kPrefix, kPreferredOdomFrame, false};
+  const auto all_outputs = RobotStateOutputSet{}.set();
+  const auto converter_samples = measure(iterations, [&] {
+    converter.convert(robot_state, clock_skew, all_outputs);
+  });
+
+  std::printf("Converting every robot state output over %d iterations\n", iterations);
+  printSamples("get* functions", get_functions);
+  printSamples("RobotStateConverter", converter_samples);
+  return 0;
+}
@@ -14,8 +14,10 @@
 #include <builtin_interfaces/msg/time.hpp>
 #include <geometry_msgs/msg/quaternion.hpp>
 #include <geometry_msgs/msg/transform.hpp>
+#include <geometry_msgs/msg/transform_stamped.hpp>
 #include <geometry_msgs/msg/twist.hpp>
 #include <geometry_msgs/msg/vector3.hpp>
+#include <algorithm>
 #include <iterator>
 #include <spot_driver/conversions/robot_state.hpp>
 #include <spot_driver/matchers.hpp>
@@ -263,6 +265,66 @@ TEST(RobotStateConversions, TestGetJointStatesNoKinematicState) {
   ASSERT_THAT(out.has_value(), IsFalse());
 }
 
+TEST(RobotStateConversions, TestGetCompactJointStates) {
+  // GIVEN a RobotState containing two unique joint states
+  ::bosdyn::api::RobotState robot_state;
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(15);
+  timestamp.set_nanos(0);
+  robot_state.mutable_kinematic_state()->mutable_acquisition_timestamp()->CopyFrom(timestamp);
+  setJointState(robot_state.mutable_kinematic_state()->add_joint_states(), "fl.hx", 0.1, 0.2, 0.3, 0.4);
+  setJointState(robot_state.mutable_kinematic_state()->add_joint_states(), "arm0.wr0", 0.5, 0.6, 0.7, 0.8);
+
+  // GIVEN some nominal clock skew
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+
+  // WHEN we create a CompactJointState ROS message from the RobotState, and the manifest which names its joints
+  const auto out = getCompactJointStates(robot_state, clock_skew);
+  const auto manifest = getJointNameManifest("my_prefix/");
+
+  // THEN a message is created
+  ASSERT_THAT(out.has_value(), IsTrue());
+  EXPECT_THAT(out->header, ClockSkewIsAppliedToHeader(timestamp, clock_skew));
+
+  // THEN the manifest names every joint with a friendly name, in the canonical joint order
+  ASSERT_THAT(manifest.name, SizeIs(out->valid.size()));
+  const auto index1 = getCanonicalJointIndex("fl.hx");
+  ASSERT_THAT(index1.has_value(), IsTrue());
+  EXPECT_THAT(manifest.name.at(index1.value()), StrEq("my_prefix/front_left_hip_x"));
+  const auto index2 = getCanonicalJointIndex("arm0.wr0");
+  ASSERT_THAT(index2.has_value(), IsTrue());
+  EXPECT_THAT(manifest.name.at(index2.value()), StrEq("my_prefix/arm_wr0"));
+  EXPECT_THAT(getCanonicalJointIndex("not_a_joint").has_value(), IsFalse());
+
+  // THEN the position, velocity, and effort of each joint are at the index of the joint, and only these joints are
+  // valid
+  EXPECT_THAT(out->valid.at(index1.value()), IsTrue());
+  EXPECT_THAT(out->position.at(index1.value()), DoubleEq(0.1));
+  EXPECT_THAT(out->velocity.at(index1.value()), DoubleEq(0.2));
+  EXPECT_THAT(out->effort.at(index1.value()), DoubleEq(0.4));
+  EXPECT_THAT(out->valid.at(index2.value()), IsTrue());
+  EXPECT_THAT(out->position.at(index2.value()), DoubleEq(0.5));
+  EXPECT_THAT(out->velocity.at(index2.value()), DoubleEq(0.6));
+  EXPECT_THAT(out->effort.at(index2.value()), DoubleEq(0.8));
+  EXPECT_THAT(std::count(out->valid.begin(), out->valid.end(), true), Eq(2));
+}
+
+TEST(RobotStateConversions, TestGetCompactJointStatesNoKinematicState) {
+  // GIVEN a RobotState that does not contain any kinematic state data whatsoever
+  ::bosdyn::api::RobotState robot_state;
+
+  // GIVEN some nominal clock skew
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+
+  // WHEN we attempt to create a CompactJointState ROS message from the RobotState
+  const auto out = getCompactJointStates(robot_state, clock_skew);
+
+  // THEN no ROS message is output
+  ASSERT_THAT(out.has_value(), IsFalse());
+}
+
 TEST(RobotStateConversions, TestGetTf) {
   // GIVEN a RobotState containing a valid transform snapshot
   ::bosdyn::api::RobotState robot_state;
@@ -335,6 +397,50 @@ TEST(RobotStateConversions, TestGetTfInverted) {
   EXPECT_THAT(transform.transform, GeometryMsgsTransformEq(-1.0, -2.0, -3.0, 1.0, 0.0, 0.0, 0.0));
 }
 
+TEST(RobotStateConversions, TestGetTfWithFrameNameCache) {
+  // GIVEN a RobotState whose transform snapshot has a root frame, a prefixed frame, an ignored frame, and a duplicate
+  // of the wrist frame
+  ::bosdyn::api::RobotState robot_state;
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(99);
+  addAcquisitionTimestamp(robot_state.mutable_kinematic_state(), timestamp);
+  auto* snapshot = robot_state.mutable_kinematic_state()->mutable_transforms_snapshot();
+  addRootFrame(snapshot, "odom");
+  addTransform(snapshot, "body", "odom", 1.0, 2.0, 3.0, 1.0, 0.0, 0.0, 0.0);
+  addTransform(snapshot, "other_robot/hand", "body", 0.5, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+  addTransform(snapshot, "ignored", "body", 0.0, 0.0, 1.0, 1.0, 0.0, 0.0, 0.0);
+  addTransform(snapshot, "arm0.link_wr1", "body", 0.0, 1.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+
+  // GIVEN some nominal clock skew
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+
+  // GIVEN a frame name cache which ignores one of the frames
+  FrameNameCache frame_names{"prefix/", {"ignored"}};
+
+  // WHEN we create a TF tree from the RobotState twice using the cache
+  const auto first = getTf(robot_state, clock_skew, frame_names, "prefix/odom");
+  const auto second = getTf(robot_state, clock_skew, frame_names, "prefix/odom");
+
+  // THEN this succeeds, and the tree is the same as without the cache
+  ASSERT_THAT(first.has_value(), IsTrue());
+  EXPECT_THAT(first, Eq(getTf(robot_state.kinematic_state().transforms_snapshot(), timestamp, clock_skew, "prefix/",
+                              "prefix/odom", {"ignored"})));
+  // THEN the cached frame names give the same tree the second time
+  EXPECT_THAT(second, Eq(first));
+
+  // THEN the tree contains the body frame and the frame which already had a prefix, but not the ignored frames
+  EXPECT_THAT(first->transforms,
+              UnorderedElementsAre(Field(&geometry_msgs::msg::TransformStamped::child_frame_id, StrEq("prefix/body")),
+                                   Field(&geometry_msgs::msg::TransformStamped::child_frame_id,
+                                         StrEq("other_robot/hand"))));
+  // THEN the frames of the tree are the ones the cache resolved
+  EXPECT_THAT(frame_names.get("body").frame_id, StrEq("prefix/body"));
+  EXPECT_THAT(frame_names.get("ignored").is_ignored, IsTrue());
+  EXPECT_THAT(frame_names.get("link_wr1").is_ignored, IsTrue());
+  EXPECT_THAT(frame_names.get("odom").is_ignored, IsFalse());
+}
+
 TEST(RobotStateConversions, TestGetOdomTwist) {
   // GIVEN a RobotState that contains info about the velocity of the body in the odom frame
   ::bosdyn::api::RobotState robot_state;
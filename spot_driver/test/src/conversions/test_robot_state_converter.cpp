@@ -0,0 +1,145 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <bosdyn/api/robot_state.pb.h>
+#include <gmock/gmock.h>
+#include <google/protobuf/duration.pb.h>
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/conversions/robot_state_converter.hpp>
+#include <spot_driver/robot_state_test_tools.hpp>
+#include <spot_driver/types.hpp>
+
+namespace {
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::Optional;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+constexpr auto kPrefix = "prefix/";
+constexpr auto kPreferredOdomFrame = "prefix/odom";
+
+spot_ros2::RobotStateOutputSet allOutputs() {
+  return spot_ros2::RobotStateOutputSet{}.set();
+}
+
+/**
+ * @brief Check that the messages of a converter are exactly the ones created by the get* functions.
+ */
+void expectSameAsGetFunctions(const RobotStateMessages& messages, const ::bosdyn::api::RobotState& robot_state,
+                              const google::protobuf::Duration& clock_skew) {
+  EXPECT_THAT(messages.maybe_battery_states, Optional(Eq(spot_ros2::getBatteryStates(robot_state, clock_skew))));
+  EXPECT_THAT(messages.maybe_wifi_state, Optional(Eq(spot_ros2::getWifiState(robot_state))));
+  EXPECT_THAT(messages.maybe_foot_state, Optional(Eq(spot_ros2::getFootState(robot_state))));
+  EXPECT_THAT(messages.maybe_estop_states, Optional(Eq(spot_ros2::getEstopStates(robot_state, clock_skew))));
+  EXPECT_THAT(messages.maybe_joint_states, Eq(spot_ros2::getJointStates(robot_state, clock_skew, kPrefix)));
+  EXPECT_THAT(messages.maybe_tf, Eq(spot_ros2::getTf(robot_state, clock_skew, kPrefix, kPreferredOdomFrame)));
+  EXPECT_THAT(messages.maybe_odom_twist, Eq(spot_ros2::getOdomTwist(robot_state, clock_skew)));
+  EXPECT_THAT(messages.maybe_odom, Eq(spot_ros2::getOdom(robot_state, clock_skew, kPrefix, false)));
+  EXPECT_THAT(messages.maybe_power_state, Eq(spot_ros2::getPowerState(robot_state, clock_skew)));
+  EXPECT_THAT(messages.maybe_system_fault_state, Eq(spot_ros2::getSystemFaultState(robot_state, clock_skew)));
+  EXPECT_THAT(messages.maybe_manipulator_state, Eq(spot_ros2::getManipulatorState(robot_state)));
+  EXPECT_THAT(messages.maybe_end_effector_force, Eq(spot_ros2::getEndEffectorForce(robot_state, clock_skew, kPrefix)));
+  EXPECT_THAT(messages.maybe_behavior_fault_state, Eq(spot_ros2::getBehaviorFaultState(robot_state, clock_skew)));
+  EXPECT_THAT(messages.maybe_compact_joint_states, Eq(spot_ros2::getCompactJointStates(robot_state, clock_skew)));
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(RobotStateConverter, ConvertsSameMessagesAsGetFunctions) {
+  // GIVEN a robot state that contains every output, and some nominal clock skew
+  const auto robot_state = createRobotStateWithAllOutputs();
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+
+  // WHEN a converter converts every output of the robot state
+  RobotStateConverter converter{kPrefix, kPreferredOdomFrame, false};
+  const auto& messages = converter.convert(robot_state, clock_skew, allOutputs());
+
+  // THEN every message is the same as the one created by the corresponding get* function
+  expectSameAsGetFunctions(messages, robot_state, clock_skew);
+  // THEN the duplicate wrist frame is left out of TF
+  ASSERT_THAT(messages.maybe_tf.has_value(), IsTrue());
+  EXPECT_THAT(messages.maybe_tf->transforms, SizeIs(5));
+}
+
+TEST(RobotStateConverter, OnlyConvertsRequestedOutputs) {
+  // GIVEN a robot state that contains every output, and some nominal clock skew
+  const auto robot_state = createRobotStateWithAllOutputs();
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+
+  // GIVEN a converter which has already converted every output once
+  RobotStateConverter converter{kPrefix, kPreferredOdomFrame, false};
+  converter.convert(robot_state, clock_skew, allOutputs());
+
+  // WHEN only the joint states and the odometry are requested
+  RobotStateOutputSet outputs;
+  outputs.set(static_cast<std::size_t>(RobotStateOutput::JOINT_STATES));
+  outputs.set(static_cast<std::size_t>(RobotStateOutput::ODOM));
+  const auto& messages = converter.convert(robot_state, clock_skew, outputs);
+
+  // THEN only those messages are set
+  EXPECT_THAT(messages.maybe_joint_states.has_value(), IsTrue());
+  EXPECT_THAT(messages.maybe_odom.has_value(), IsTrue());
+  EXPECT_THAT(messages.maybe_battery_states.has_value(), IsFalse());
+  EXPECT_THAT(messages.maybe_tf.has_value(), IsFalse());
+  EXPECT_THAT(messages.maybe_odom_twist.has_value(), IsFalse());
+  EXPECT_THAT(messages.maybe_system_fault_state.has_value(), IsFalse());
+  EXPECT_THAT(messages.maybe_end_effector_force.has_value(), IsFalse());
+  EXPECT_THAT(messages.maybe_compact_joint_states.has_value(), IsFalse());
+  // THEN the odometry still has the body velocity, even though the odometry twist was not converted
+  EXPECT_THAT(messages.maybe_odom, Eq(getOdom(robot_state, clock_skew, kPrefix, false)));
+
+  // WHEN every output is requested again
+  const auto& all_messages = converter.convert(robot_state, clock_skew, allOutputs());
+
+  // THEN every message is converted again
+  expectSameAsGetFunctions(all_messages, robot_state, clock_skew);
+}
+
+TEST(RobotStateConverter, ReusedMessagesDoNotKeepStaleData) {
+  // GIVEN a converter which has converted a robot state that contains every output
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+  RobotStateConverter converter{kPrefix, kPreferredOdomFrame, false};
+  converter.convert(createRobotStateWithAllOutputs(), clock_skew, allOutputs());
+
+  // GIVEN a smaller robot state, with fewer feet, joints, frames and faults, no wifi, and a manipulator state without
+  // the end effector force
+  auto robot_state = createRobotStateWithAllOutputs();
+  robot_state.mutable_foot_state()->RemoveLast();
+  robot_state.clear_comms_states();
+  robot_state.mutable_kinematic_state()->mutable_joint_states()->SwapElements(0, 1);
+  robot_state.mutable_kinematic_state()->mutable_joint_states()->RemoveLast();
+  auto* kinematic_state = robot_state.mutable_kinematic_state();
+  kinematic_state->mutable_transforms_snapshot()->mutable_child_to_parent_edge_map()->erase("gpe");
+  robot_state.mutable_system_fault_state()->clear_faults();
+  robot_state.mutable_manipulator_state()->clear_estimated_end_effector_force_in_hand();
+  robot_state.mutable_kinematic_state()->mutable_acquisition_timestamp()->set_seconds(101);
+
+  // WHEN the converter converts the smaller robot state
+  const auto& messages = converter.convert(robot_state, clock_skew, allOutputs());
+
+  // THEN none of the data of the previous robot state is left over
+  expectSameAsGetFunctions(messages, robot_state, clock_skew);
+  ASSERT_THAT(messages.maybe_wifi_state.has_value(), IsTrue());
+  EXPECT_THAT(messages.maybe_wifi_state->essid, StrEq(""));
+}
+
+TEST(RobotStateConverter, OmitsOutputsMissingFromRobotState) {
+  // GIVEN an empty robot state
+  const ::bosdyn::api::RobotState robot_state;
+  google::protobuf::Duration clock_skew;
+
+  // WHEN a converter converts every output of the robot state
+  RobotStateConverter converter{kPrefix, kPreferredOdomFrame, false};
+  const auto& messages = converter.convert(robot_state, clock_skew, allOutputs());
+
+  // THEN the outputs that need data which is missing from the robot state are not set, as with the get* functions
+  expectSameAsGetFunctions(messages, robot_state, clock_skew);
+  EXPECT_THAT(messages.maybe_joint_states.has_value(), IsFalse());
+  EXPECT_THAT(messages.maybe_tf.has_value(), IsFalse());
+  EXPECT_THAT(messages.maybe_odom.has_value(), IsFalse());
+}
+}  // namespace spot_ros2::test
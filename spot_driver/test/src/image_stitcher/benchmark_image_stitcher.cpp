@@ -0,0 +1,75 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+/**
+ * Times MiddleCamera::stitch end to end and per stage on a synthetic scene built from the front camera fixtures.
+ *
+ * It is built alongside the tests but not run by them:
+ *   <build directory>/test/benchmark_image_stitcher [iterations]
+ */
+
+#include <spot_driver/image_stitcher/image_stitcher.hpp>
+#include <spot_driver/image_stitcher_test_tools.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr auto kDefaultIterations = 200;
+constexpr auto kWarmupIterations = 10;
+
+void printStage(const std::string& name, std::vector<double> samples_ms) {
+  std::sort(samples_ms.begin(), samples_ms.end());
+  double total = 0.;
+  for (const auto sample : samples_ms) {
+    total += sample;
+  }
+  const auto percentile = [&samples_ms](double p) {
+    return samples_ms[static_cast<size_t>(p * (samples_ms.size() - 1))];
+  };
+  std::printf("%-12s mean %8.3f ms  p50 %8.3f ms  p90 %8.3f ms  p99 %8.3f ms  max %8.3f ms\n", name.c_str(),
+              total / samples_ms.size(), percentile(0.5), percentile(0.9), percentile(0.99), samples_ms.back());
+}
+
+double toMilliseconds(std::chrono::nanoseconds duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : kDefaultIterations;
+
+  // A single camera is reused for every iteration, the same way the stitcher node reuses it for every frame pair.
+  auto camera = spot_ros2::test::createFrontMiddleCamera();
+  const auto left = spot_ros2::test::renderSyntheticScene(spot_ros2::test::frontLeftTransform(),
+                                                          spot_ros2::test::frontLeftCameraInfo());
+  const auto right = spot_ros2::test::renderSyntheticScene(spot_ros2::test::frontRightTransform(),
+                                                           spot_ros2::test::frontRightCameraInfo());
+
+  for (int ndx = 0; ndx < kWarmupIterations; ++ndx) {
+    camera.stitch(left, right);
+  }
+
+  std::vector<double> warp, compensate, seam, blend, total;
+  for (int ndx = 0; ndx < iterations; ++ndx) {
+    spot_ros2::StitchTimings timings;
+    const auto start = std::chrono::steady_clock::now();
+    camera.stitch(left, right, &timings);
+    total.push_back(toMilliseconds(std::chrono::steady_clock::now() - start));
+    warp.push_back(toMilliseconds(timings.warp));
+    compensate.push_back(toMilliseconds(timings.compensate));
+    seam.push_back(toMilliseconds(timings.seam));
+    blend.push_back(toMilliseconds(timings.blend));
+  }
+
+  std::printf("stitch() over %d iterations\n", iterations);
+  printStage("warp", warp);
+  printStage("compensate", compensate);
+  printStage("seam", seam);
+  printStage("blend", blend);
+  printStage("total", total);
+  return 0;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <opencv2/core.hpp>
+#include <spot_driver/image_stitcher/birds_eye_view.hpp>
+
+#include <vector>
+
+namespace {
+// A 64 x 48 pixel grid of 1 cm pixels, one meter below the body frame.
+constexpr auto kGridResolution = 0.01;
+constexpr auto kGridWidth = 64;
+constexpr auto kGridHeight = 48;
+constexpr auto kGroundHeight = -1.0;
+// With this focal length, one pixel of a camera at the body frame origin covers one pixel of the grid.
+constexpr auto kFocalLength = 1.0 / kGridResolution;
+
+spot_ros2::GroundPlaneGrid createGrid() {
+  return spot_ros2::GroundPlaneGrid{kGridResolution, kGridWidth, kGridHeight, kGroundHeight};
+}
+
+/**
+ * @brief Create a camera at the body frame origin which looks straight down at the ground.
+ * @details The camera's x axis points to the right of the robot and its y axis to the back, so image columns and rows
+ * run the same way as the columns and rows of the grid. The output pixel at (col, row) is then observed at pixel
+ * (col + cx - 31.5, row + cy - 23.5) of the camera image, since the grid is centered on the body frame origin.
+ */
+spot_ros2::GroundPlaneCamera createDownwardCamera(const cv::Size& image_size, const double cx, const double cy) {
+  cv::Matx44d body_tform_camera = cv::Matx44d::eye();
+  // The columns are the axes of the camera in the body frame.
+  body_tform_camera(0, 0) = 0.;
+  body_tform_camera(1, 0) = -1.;
+  body_tform_camera(0, 1) = -1.;
+  body_tform_camera(1, 1) = 0.;
+  body_tform_camera(2, 2) = -1.;
+  return spot_ros2::GroundPlaneCamera{cv::Matx33d{kFocalLength, 0., cx, 0., kFocalLength, cy, 0., 0., 1.}, image_size,
+                                      body_tform_camera};
+}
+
+bool isUniform(const cv::Mat& image, const cv::Scalar& color) {
+  return cv::norm(image, cv::Mat{image.size(), image.type(), color}, cv::NORM_INF) == 0.;
+}
+
+cv::Mat createRandomImage(const cv::Size& size) {
+  cv::Mat image{size, CV_8UC3};
+  cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(256));
+  return image;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(BirdsEyeView, ComposesGroundPlaneSeenFromAbove) {
+  // GIVEN a view built from one downward camera whose image covers the whole grid with a one pixel margin
+  const cv::Size image_size{kGridWidth + 2, kGridHeight + 2};
+  const BirdsEyeView view{createGrid(), {createDownwardCamera(image_size, 32.5, 24.5)}};
+
+  // THEN the output has the size of the grid, all of which the camera observes
+  EXPECT_EQ(view.size(), cv::Size(kGridWidth, kGridHeight));
+  EXPECT_EQ(view.observedRegion(0), cv::Rect(0, 0, kGridWidth, kGridHeight));
+
+  // WHEN composing an image of the ground
+  const auto image = createRandomImage(image_size);
+  const auto output = view.compose({image});
+
+  // THEN the output is the part of the image which covers the grid
+  ASSERT_EQ(output.size(), view.size());
+  ASSERT_EQ(output.type(), CV_8UC3);
+  EXPECT_EQ(cv::norm(output, image(cv::Rect{1, 1, kGridWidth, kGridHeight}), cv::NORM_INF), 0.);
+}
+
+TEST(BirdsEyeView, LimitsEachCameraToTheRegionItObserves) {
+  // GIVEN a view built from two downward cameras which each see one side of the grid, with a two column gap between
+  // them, and a camera which looks up
+  const cv::Size image_size{32, kGridHeight + 2};
+  auto upward_camera = createDownwardCamera(image_size, 32.5, 24.5);
+  upward_camera.body_tform_camera(2, 2) = 1.;
+  upward_camera.body_tform_camera(0, 1) = 1.;
+  const BirdsEyeView view{createGrid(),
+                          {createDownwardCamera(image_size, 32., 24.5), createDownwardCamera(image_size, -1., 24.5),
+                           upward_camera}};
+
+  // THEN the left camera observes the columns left of the gap, the right camera the columns right of it, and the
+  // camera which looks up observes nothing
+  EXPECT_EQ(view.observedRegion(0), cv::Rect(0, 0, 31, kGridHeight));
+  EXPECT_EQ(view.observedRegion(1), cv::Rect(33, 0, 31, kGridHeight));
+  EXPECT_TRUE(view.observedRegion(2).empty());
+
+  // WHEN composing uniformly colored images from all cameras
+  const cv::Mat left_image{image_size, CV_8UC3, cv::Scalar{255, 0, 0}};
+  const cv::Mat right_image{image_size, CV_8UC3, cv::Scalar{0, 0, 255}};
+  const cv::Mat upward_image{image_size, CV_8UC3, cv::Scalar{0, 255, 0}};
+  const auto output = view.compose({left_image, right_image, upward_image});
+
+  // THEN each side has the color of its camera, and the gap is black
+  EXPECT_TRUE(isUniform(output(view.observedRegion(0)), cv::Scalar{255, 0, 0}));
+  EXPECT_TRUE(isUniform(output(view.observedRegion(1)), cv::Scalar{0, 0, 255}));
+  EXPECT_TRUE(isUniform(output(cv::Rect{31, 0, 2, kGridHeight}), cv::Scalar::all(0)));
+
+  // WHEN the image of the right camera is missing
+  const auto partial_output = view.compose({left_image, cv::Mat{}, upward_image});
+
+  // THEN the left side is unchanged, and the right side is black
+  EXPECT_TRUE(isUniform(partial_output(view.observedRegion(0)), cv::Scalar{255, 0, 0}));
+  EXPECT_TRUE(isUniform(partial_output(view.observedRegion(1)), cv::Scalar::all(0)));
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,304 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <cv_bridge/cv_bridge.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <spot_driver/image_stitcher/image_stitcher.hpp>
+#include <spot_driver/image_stitcher_test_tools.hpp>
+#include <spot_driver/mock/mock_camera_handle.hpp>
+#include <spot_driver/mock/mock_camera_synchronizer.hpp>
+#include <spot_driver/mock/mock_logger_interface.hpp>
+#include <spot_driver/mock/mock_tf_listener_interface.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace {
+// Set this environment variable to write the current output of the stitcher as the new golden images.
+constexpr auto kUpdateGoldenImagesEnvVar = "SPOT_DRIVER_UPDATE_GOLDEN_IMAGES";
+// Small differences are expected between OpenCV versions and hardware, so the comparison allows for some noise.
+constexpr auto kPixelTolerance = 8;
+constexpr auto kMaxDifferingPixelFraction = 0.005;
+constexpr auto kMaxMeanAbsoluteError = 0.5;
+// Building a virtual camera takes well under a second, so this only guards against a rebuild that never happens.
+constexpr auto kRebuildTimeout = std::chrono::seconds{30};
+constexpr auto kBodyFrame = "body";
+constexpr auto kVirtualCameraFrame = "virtual_camera";
+
+std::filesystem::path goldenImagePath(const std::string& name) {
+  return std::filesystem::path{SPOT_DRIVER_TEST_DATA_DIR} / "image_stitcher" / (name + ".png");
+}
+
+cv::Mat stitchSyntheticScene(spot_ros2::StitchTimings* timings = nullptr) {
+  auto camera = spot_ros2::test::createFrontMiddleCamera();
+  const auto left = spot_ros2::test::renderSyntheticScene(spot_ros2::test::frontLeftTransform(),
+                                                          spot_ros2::test::frontLeftCameraInfo());
+  const auto right = spot_ros2::test::renderSyntheticScene(spot_ros2::test::frontRightTransform(),
+                                                           spot_ros2::test::frontRightCameraInfo());
+  const auto stitched = camera.stitch(left, right, timings);
+  return cv_bridge::toCvCopy(stitched, "bgr8")->image;
+}
+
+geometry_msgs::msg::TransformStamped createTransformStamped(const geometry_msgs::msg::Transform& transform) {
+  geometry_msgs::msg::TransformStamped out;
+  out.transform = transform;
+  return out;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(ImageStitcher, StitchedImageIncludesRowPadding) {
+  // GIVEN a virtual camera built from the front camera fixtures
+
+  // WHEN stitching a synthetic scene
+  const auto stitched = stitchSyntheticScene();
+
+  // THEN the stitched image is as wide as the input images and taller by the row padding
+  const auto info = frontLeftCameraInfo();
+  EXPECT_EQ(stitched.cols, static_cast<int>(info.width));
+  EXPECT_EQ(stitched.rows, static_cast<int>(info.height) + kStitchedImageRowPadding);
+  EXPECT_EQ(stitched.type(), CV_8UC3);
+}
+
+TEST(ImageStitcher, StitchIsDeterministic) {
+  // GIVEN two virtual cameras built from the same fixtures
+
+  // WHEN each one stitches the same synthetic scene
+  const auto first = stitchSyntheticScene();
+  const auto second = stitchSyntheticScene();
+
+  // THEN the outputs are identical
+  ASSERT_EQ(first.size(), second.size());
+  EXPECT_EQ(cv::norm(first, second, cv::NORM_INF), 0.);
+}
+
+TEST(ImageStitcher, ReportsStageTimings) {
+  // GIVEN a virtual camera built from the front camera fixtures
+  StitchTimings timings;
+
+  // WHEN stitching a synthetic scene while collecting timings
+  stitchSyntheticScene(&timings);
+
+  // THEN every stage reports the time it took
+  EXPECT_GT(timings.warp.count(), 0);
+  EXPECT_GT(timings.compensate.count(), 0);
+  EXPECT_GT(timings.seam.count(), 0);
+  EXPECT_GT(timings.blend.count(), 0);
+}
+
+TEST(ImageStitcher, MatchesGoldenImage) {
+  // GIVEN the golden image of a synthetic scene stitched from the front camera fixtures
+  const auto golden_path = goldenImagePath("front_middle_synthetic_scene");
+
+  // WHEN stitching the same synthetic scene
+  const auto stitched = stitchSyntheticScene();
+
+  if (std::getenv(kUpdateGoldenImagesEnvVar) != nullptr) {
+    std::filesystem::create_directories(golden_path.parent_path());
+    ASSERT_TRUE(cv::imwrite(golden_path.string(), stitched));
+    GTEST_SKIP() << "Updated golden image " << golden_path;
+  }
+  const auto golden = cv::imread(golden_path.string(), cv::IMREAD_COLOR);
+  ASSERT_FALSE(golden.empty()) << "No golden image at " << golden_path << ". Run with " << kUpdateGoldenImagesEnvVar
+                               << "=1 to create it.";
+
+  // THEN the stitched image matches the golden image within tolerance
+  ASSERT_EQ(stitched.size(), golden.size());
+  cv::Mat difference;
+  cv::absdiff(stitched, golden, difference);
+  const auto mean_absolute_error = cv::mean(difference);
+  for (int channel = 0; channel < 3; ++channel) {
+    EXPECT_LE(mean_absolute_error[channel], kMaxMeanAbsoluteError);
+  }
+  cv::Mat differing_pixels;
+  cv::compare(difference.reshape(1), kPixelTolerance, differing_pixels, cv::CMP_GT);
+  const auto differing_fraction = static_cast<double>(cv::countNonZero(differing_pixels)) / differing_pixels.total();
+  EXPECT_LE(differing_fraction, kMaxDifferingPixelFraction);
+}
+
+/**
+ * Runs an ImageStitcher whose inputs are all mocked. Stitching is driven by calling the synchronizer callback directly,
+ * while the virtual camera is rebuilt on the stitcher's own thread.
+ */
+class ImageStitcherRebuildTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto synchronizer = std::make_unique<MockCameraSynchronizer>();
+    EXPECT_CALL(*synchronizer, registerCallback).WillOnce(::testing::SaveArg<0>(&image_callback_));
+
+    auto tf_listener = std::make_unique<::testing::NiceMock<MockTfListenerInterface>>();
+    ON_CALL(*tf_listener, lookupTransform)
+        .WillByDefault([this](const std::string& parent, const std::string&, const rclcpp::Time&) {
+          return createTransformStamped(parent == info_left_.header.frame_id ? body_tform_left_ : body_tform_right_);
+        });
+
+    auto camera_handle = std::make_unique<::testing::NiceMock<MockCameraHandle>>();
+    ON_CALL(*camera_handle, getBodyFrame).WillByDefault(::testing::Return(kBodyFrame));
+    ON_CALL(*camera_handle, getCameraFrame).WillByDefault(::testing::Return(kVirtualCameraFrame));
+    ON_CALL(*camera_handle, getIntrinsics).WillByDefault(::testing::Return(kVirtualCameraIntrinsics));
+    ON_CALL(*camera_handle, getPlaneNormal).WillByDefault(::testing::Return(kVirtualCameraProjectionPlane));
+    ON_CALL(*camera_handle, getPlaneDistance).WillByDefault(::testing::Return(kVirtualCameraPlaneDistance));
+    ON_CALL(*camera_handle, getRowPadding).WillByDefault(::testing::ReturnPointee(&row_padding_));
+    EXPECT_CALL(*camera_handle, registerParameterCallback).WillOnce(::testing::SaveArg<0>(&parameter_callback_));
+    camera_handle_ = camera_handle.get();
+
+    // The stitcher logs once for every camera it builds, from its rebuild thread
+    auto logger = std::make_unique<::testing::NiceMock<MockLoggerInterface>>();
+    ON_CALL(*logger, logInfo).WillByDefault([this](const std::string&) {
+      {
+        std::lock_guard lock{built_cameras_mutex_};
+        ++built_cameras_;
+      }
+      built_cameras_condition_.notify_all();
+    });
+
+    stitcher_ = std::make_unique<ImageStitcher>(std::move(synchronizer), std::move(tf_listener),
+                                                std::move(camera_handle), std::move(logger));
+  }
+
+  /** Pass the synthetic scene to the stitcher, with the current camera infos stamped at @p seconds. */
+  void receiveImages(const std::int32_t seconds) {
+    auto info_left = std::make_shared<CameraInfo>(info_left_);
+    auto info_right = std::make_shared<CameraInfo>(info_right_);
+    info_left->header.stamp.sec = seconds;
+    info_right->header.stamp.sec = seconds;
+    image_callback_(image_left_, info_left, image_right_, info_right);
+  }
+
+  /** Wait until the stitcher has built @p count cameras in total. */
+  bool waitForBuiltCameras(const int count) {
+    std::unique_lock lock{built_cameras_mutex_};
+    return built_cameras_condition_.wait_for(lock, kRebuildTimeout, [this, count]() {
+      return built_cameras_ >= count;
+    });
+  }
+
+  /** Receive images until the first camera has been built and broadcast. */
+  void buildFirstCamera(const std::int32_t seconds) {
+    EXPECT_CALL(*camera_handle_, broadcast).Times(0);
+    receiveImages(seconds);
+    ASSERT_TRUE(waitForBuiltCameras(1));
+    EXPECT_CALL(*camera_handle_, broadcast).Times(1);
+    receiveImages(seconds);
+  }
+
+  geometry_msgs::msg::Transform body_tform_left_ = frontLeftTransform();
+  geometry_msgs::msg::Transform body_tform_right_ = frontRightTransform();
+  CameraInfo info_left_ = frontLeftCameraInfo();
+  CameraInfo info_right_ = frontRightCameraInfo();
+  int row_padding_ = kStitchedImageRowPadding;
+  std::shared_ptr<const Image> image_left_ = renderSyntheticScene(frontLeftTransform(), frontLeftCameraInfo());
+  std::shared_ptr<const Image> image_right_ = renderSyntheticScene(frontRightTransform(), frontRightCameraInfo());
+
+  DualImageCallbackFn image_callback_;
+  std::function<void()> parameter_callback_;
+  MockCameraHandle* camera_handle_ = nullptr;
+
+  std::mutex built_cameras_mutex_;
+  std::condition_variable built_cameras_condition_;
+  int built_cameras_ = 0;
+
+  // Declared last so that it is destroyed, and its rebuild thread joined, before everything it uses
+  std::unique_ptr<ImageStitcher> stitcher_;
+};
+
+TEST_F(ImageStitcherRebuildTest, BuildsCameraInBackgroundBeforeStitching) {
+  // GIVEN a stitcher which has not built its camera yet
+  // THEN nothing is published until the camera has been built
+  EXPECT_CALL(*camera_handle_, publish).Times(0);
+  EXPECT_CALL(*camera_handle_, broadcast).Times(0);
+
+  // WHEN the first images arrive
+  receiveImages(0);
+
+  // THEN the camera is built in the background
+  ASSERT_TRUE(waitForBuiltCameras(1));
+
+  // AND THEN the next images are stitched with it, after its transform is broadcast
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*camera_handle_, broadcast).Times(1);
+  EXPECT_CALL(*camera_handle_, publish(::testing::Field(&Image::height, info_left_.height + kStitchedImageRowPadding),
+                                       ::testing::Field(&CameraInfo::header,
+                                                        ::testing::Field(&std_msgs::msg::Header::frame_id,
+                                                                         kVirtualCameraFrame))))
+      .Times(1);
+  receiveImages(0);
+}
+
+TEST_F(ImageStitcherRebuildTest, SwapsInCameraRebuiltForChangedExtrinsics) {
+  // GIVEN a stitcher with a camera built from the initial transforms
+  buildFirstCamera(0);
+
+  // WHEN both cameras move forward, and the next images arrive after the calibration check period
+  body_tform_left_.translation.x += 0.02;
+  body_tform_right_.translation.x += 0.02;
+  receiveImages(1);
+
+  // THEN a new camera is built
+  ASSERT_TRUE(waitForBuiltCameras(2));
+
+  // AND THEN the next images are stitched with it, and its transform, which moved forward as well, is broadcast
+  EXPECT_CALL(*camera_handle_,
+              broadcast(::testing::Field(&Transform::translation,
+                                         ::testing::Field(&geometry_msgs::msg::Vector3::x,
+                                                          ::testing::DoubleNear(0.415 + 0.02, 1e-9))),
+                        ::testing::_))
+      .Times(1);
+  receiveImages(1);
+}
+
+TEST_F(ImageStitcherRebuildTest, SwapsInCameraRebuiltForChangedCameraInfo) {
+  // GIVEN a stitcher with a camera built from the initial camera infos
+  buildFirstCamera(0);
+
+  // WHEN the intrinsics of the left camera change, and the next images arrive after the calibration check period
+  info_left_.k[0] += 10.;
+  info_left_.p[0] += 10.;
+  receiveImages(1);
+
+  // THEN a new camera is built and its transform is broadcast with the next images
+  ASSERT_TRUE(waitForBuiltCameras(2));
+  EXPECT_CALL(*camera_handle_, broadcast).Times(1);
+  receiveImages(1);
+}
+
+TEST_F(ImageStitcherRebuildTest, SwapsInCameraRebuiltForChangedParameters) {
+  // GIVEN a stitcher with a camera built from the initial parameters
+  buildFirstCamera(0);
+
+  // WHEN the row padding parameter changes, and the next images arrive with the same stamp
+  row_padding_ = kStitchedImageRowPadding / 2;
+  parameter_callback_();
+  receiveImages(0);
+
+  // THEN a new camera is built right away, without waiting for the calibration check period
+  ASSERT_TRUE(waitForBuiltCameras(2));
+
+  // AND THEN the next images are stitched with the new row padding
+  EXPECT_CALL(*camera_handle_, broadcast).Times(1);
+  EXPECT_CALL(*camera_handle_,
+              publish(::testing::Field(&Image::height, info_left_.height + row_padding_), ::testing::_))
+      .Times(1);
+  receiveImages(0);
+}
+
+TEST_F(ImageStitcherRebuildTest, ChecksCalibrationAgainWhenStampsJumpBackwards) {
+  // GIVEN a stitcher which last checked the calibration at a late stamp
+  buildFirstCamera(100);
+
+  // WHEN the extrinsics change and the stamps jump backwards, as when a bag loops
+  body_tform_right_.translation.x += 0.02;
+  receiveImages(1);
+
+  // THEN the calibration is checked right away, and a new camera is built
+  EXPECT_TRUE(waitForBuiltCameras(2));
+}
+}  // namespace spot_ros2::test
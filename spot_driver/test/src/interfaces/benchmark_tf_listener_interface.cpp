@@ -0,0 +1,101 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+/**
+ * Compares the time to look up 200 frames which share a chain of ancestors, such as the external frames which
+ * ObjectSynchronizer syncs to Spot's world model, one at a time with lookupTransform() and at once with
+ * lookupTransforms(). The frames are looked up at a fixed time, as ObjectSynchronizer does, which is when
+ * RclcppTfListenerInterface resolves the shared chain only once.
+ *
+ * It is built alongside the tests but not run by them:
+ *   <build directory>/test/benchmark_tf_listener_interface [iterations]
+ */
+
+#include <rclcpp/rclcpp.hpp>
+#include <spot_driver/interfaces/rclcpp_tf_listener_interface.hpp>
+#include <spot_driver/tf_tree_test_tools.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr auto kDefaultIterations = 1000;
+constexpr auto kWarmupIterations = 10;
+constexpr std::size_t kLeafCount = 200;
+constexpr std::size_t kChainLength = 5;
+// The tree is static, so its transforms are valid at any time
+const rclcpp::Time kLookupTime{1, 0, RCL_ROS_TIME};
+
+void printTimes(const std::string& name, std::vector<double> times_us) {
+  double total_us = 0.;
+  for (const auto time_us : times_us) {
+    total_us += time_us;
+  }
+  std::sort(times_us.begin(), times_us.end());
+  const auto percentile = [&times_us](double p) {
+    return times_us[static_cast<size_t>(p * (times_us.size() - 1))];
+  };
+  std::printf("%-20s mean %9.2f us  p50 %9.2f us  p99 %9.2f us  max %9.2f us\n", name.c_str(),
+              total_us / times_us.size(), percentile(0.5), percentile(0.99), times_us.back());
+}
+
+template <typename LookupT>
+std::vector<double> measure(const int iterations, LookupT&& lookup) {
+  for (int ndx = 0; ndx < kWarmupIterations; ++ndx) {
+    lookup();
+  }
+  std::vector<double> times_us;
+  times_us.reserve(iterations);
+  for (int ndx = 0; ndx < iterations; ++ndx) {
+    const auto start = std::chrono::steady_clock::now();
+    lookup();
+    times_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+  }
+  return times_us;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  using namespace spot_ros2;
+  const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : kDefaultIterations;
+
+  rclcpp::init(argc, argv);
+  const auto node = std::make_shared<rclcpp::Node>("benchmark_tf_listener_interface");
+  RclcppTfListenerInterface tf_listener{node};
+  if (!test::publishStaticTransforms(node, tf_listener, test::createTfTree(kChainLength, kLeafCount))) {
+    std::fprintf(stderr, "Timed out waiting for the TF tree\n");
+    rclcpp::shutdown();
+    return 1;
+  }
+
+  std::vector<std::string> children;
+  for (std::size_t ndx = 0; ndx < kLeafCount; ++ndx) {
+    children.push_back("leaf_" + std::to_string(ndx));
+  }
+
+  std::size_t failures = 0;
+  const auto single_times = measure(iterations, [&] {
+    for (const auto& child : children) {
+      failures += tf_listener.lookupTransform(test::kTfTreeRootFrame, child, kLookupTime).has_value() ? 0 : 1;
+    }
+  });
+  const auto batched_times = measure(iterations, [&] {
+    for (const auto& transform : tf_listener.lookupTransforms(test::kTfTreeRootFrame, children, kLookupTime)) {
+      failures += transform.has_value() ? 0 : 1;
+    }
+  });
+
+  std::printf("Looking up %zu frames below a chain of %zu frames over %d iterations\n", kLeafCount, kChainLength + 1,
+              iterations);
+  printTimes("lookupTransform", single_times);
+  printTimes("lookupTransforms", batched_times);
+  if (failures > 0) {
+    std::printf("%zu lookups failed\n", failures);
+  }
+  rclcpp::shutdown();
+  return failures > 0 ? 1 : 0;
+}
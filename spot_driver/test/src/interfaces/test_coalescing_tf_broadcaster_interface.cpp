@@ -0,0 +1,103 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <spot_driver/interfaces/coalescing_tf_broadcaster_interface.hpp>
+#include <spot_driver/mock/mock_tf_broadcaster_interface.hpp>
+#include <spot_driver/mock/mock_timer_interface.hpp>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace {
+using ::testing::_;
+using ::testing::AllOf;
+using ::testing::Field;
+using ::testing::StrEq;
+using ::testing::UnorderedElementsAre;
+
+geometry_msgs::msg::TransformStamped createTransform(const std::string& child_frame_id, const int32_t stamp_sec,
+                                                     const double x) {
+  geometry_msgs::msg::TransformStamped transform;
+  transform.header.frame_id = "odom";
+  transform.header.stamp.sec = stamp_sec;
+  transform.child_frame_id = child_frame_id;
+  transform.transform.translation.x = x;
+  return transform;
+}
+
+auto TransformIs(const std::string& child_frame_id, const double x) {
+  return AllOf(Field("child_frame_id", &geometry_msgs::msg::TransformStamped::child_frame_id, StrEq(child_frame_id)),
+               Field("transform", &geometry_msgs::msg::TransformStamped::transform,
+                     Field("translation", &geometry_msgs::msg::Transform::translation,
+                           Field("x", &geometry_msgs::msg::Vector3::x, x))));
+}
+}  // namespace
+
+namespace spot_ros2::test {
+class CoalescingTfBroadcasterInterfaceTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    auto mock_tf_broadcaster = std::make_unique<MockTfBroadcasterInterface>();
+    auto mock_timer = std::make_unique<MockTimerInterface>();
+    mock_tf_broadcaster_ptr = mock_tf_broadcaster.get();
+    mock_timer_ptr = mock_timer.get();
+
+    // THEN the timer is set to the coalescing period
+    EXPECT_CALL(*mock_timer_ptr, setTimer(std::chrono::duration<double>{0.02}, _))
+        .WillOnce([this](auto, const std::function<void()>& callback) {
+          mock_timer_ptr->onSetTimer(callback);
+        });
+    tf_broadcaster = std::make_unique<CoalescingTfBroadcasterInterface>(
+        std::move(mock_tf_broadcaster), std::move(mock_timer), std::chrono::duration<double>{0.02});
+  }
+
+  MockTfBroadcasterInterface* mock_tf_broadcaster_ptr = nullptr;
+  MockTimerInterface* mock_timer_ptr = nullptr;
+  std::unique_ptr<CoalescingTfBroadcasterInterface> tf_broadcaster;
+};
+
+TEST_F(CoalescingTfBroadcasterInterfaceTest, PublishesNothingBeforeTick) {
+  // THEN no transforms are passed on
+  EXPECT_CALL(*mock_tf_broadcaster_ptr, sendDynamicTransforms).Times(0);
+  EXPECT_CALL(*mock_tf_broadcaster_ptr, updateStaticTransforms).Times(0);
+
+  // WHEN transforms are submitted, but the timer does not tick
+  tf_broadcaster->sendDynamicTransforms({createTransform("body", 1, 1.0)});
+  tf_broadcaster->updateStaticTransforms({createTransform("camera", 1, 1.0)});
+}
+
+TEST_F(CoalescingTfBroadcasterInterfaceTest, MergesTransformsWithinTick) {
+  // THEN the dynamic transforms submitted in separate calls are passed on in a single call, with the newest transform
+  // to each child frame
+  EXPECT_CALL(*mock_tf_broadcaster_ptr,
+              sendDynamicTransforms(UnorderedElementsAre(TransformIs("body", 3.0), TransformIs("dock", 2.0))))
+      .Times(1);
+  // THEN the static transforms are passed on separately
+  EXPECT_CALL(*mock_tf_broadcaster_ptr, updateStaticTransforms(UnorderedElementsAre(TransformIs("camera", 1.0))))
+      .Times(1);
+
+  // WHEN several components submit transforms to the same and to different child frames within a tick, including a
+  // transform which is older than the one already submitted
+  tf_broadcaster->sendDynamicTransforms({createTransform("body", 1, 1.0)});
+  tf_broadcaster->sendDynamicTransforms({createTransform("dock", 1, 2.0), createTransform("body", 3, 3.0)});
+  tf_broadcaster->sendDynamicTransforms({createTransform("body", 2, 4.0)});
+  tf_broadcaster->updateStaticTransforms({createTransform("camera", 1, 1.0)});
+  // WHEN the timer ticks
+  mock_timer_ptr->trigger();
+}
+
+TEST_F(CoalescingTfBroadcasterInterfaceTest, PublishesEachTransformOnce) {
+  // THEN transforms are passed on once, at the first tick after they were submitted
+  EXPECT_CALL(*mock_tf_broadcaster_ptr, sendDynamicTransforms(UnorderedElementsAre(TransformIs("body", 1.0))))
+      .Times(1);
+
+  // WHEN a transform is submitted, and the timer ticks twice
+  tf_broadcaster->sendDynamicTransforms({createTransform("body", 1, 1.0)});
+  mock_timer_ptr->trigger();
+  mock_timer_ptr->trigger();
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,130 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <rclcpp/executors.hpp>
+#include <rclcpp/node.hpp>
+#include <spot_driver/interfaces/rclcpp_tf_broadcaster_interface.hpp>
+#include <spot_driver/rclcpp_test.hpp>
+#include <spot_driver/tf_tree_test_tools.hpp>
+#include <tf2_msgs/msg/tf_message.hpp>
+#include <tf2_ros/qos.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace {
+using ::testing::DoubleEq;
+using ::testing::SizeIs;
+
+/** @brief How long to spin while waiting for messages on /tf_static. */
+constexpr auto kSpinDuration = std::chrono::milliseconds{500};
+
+void spinFor(const std::shared_ptr<rclcpp::Node>& node, const std::chrono::milliseconds duration) {
+  const auto deadline = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < deadline) {
+    rclcpp::spin_some(node);
+  }
+}
+}  // namespace
+
+namespace spot_ros2::test {
+class RclcppTfBroadcasterInterfaceTest : public RclcppTest {
+ public:
+  void SetUp() override {
+    RclcppTest::SetUp();
+    node = std::make_shared<rclcpp::Node>("tf_broadcaster_test_node");
+    subscription = node->create_subscription<tf2_msgs::msg::TFMessage>(
+        "/tf_static", tf2_ros::StaticListenerQoS(),
+        [this](const tf2_msgs::msg::TFMessage& message) { received_messages.push_back(message); });
+  }
+
+  void TearDown() override {
+    subscription.reset();
+    node.reset();
+    RclcppTest::TearDown();
+  }
+
+  std::shared_ptr<rclcpp::Node> node;
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr subscription;
+  std::vector<tf2_msgs::msg::TFMessage> received_messages;
+};
+
+TEST_F(RclcppTfBroadcasterInterfaceTest, PublishesStaticTransformsOnlyWhenAddedOrChanged) {
+  // GIVEN a TF broadcaster which published a set of static transforms
+  RclcppTfBroadcasterInterface tf_broadcaster{node};
+  auto transforms = createTfTree(1, 3);
+  tf_broadcaster.updateStaticTransforms(transforms);
+  spinFor(node, kSpinDuration);
+  ASSERT_THAT(received_messages, SizeIs(1));
+  EXPECT_THAT(received_messages.back().transforms, SizeIs(transforms.size()));
+
+  // WHEN the same transforms are passed in again, with new timestamps and a difference within tolerance
+  for (auto& transform : transforms) {
+    transform.header.stamp.sec += 1;
+  }
+  transforms.back().transform.translation.x += 1e-9;
+  tf_broadcaster.updateStaticTransforms(transforms);
+  spinFor(node, kSpinDuration);
+  // THEN nothing is published
+  EXPECT_THAT(received_messages, SizeIs(1));
+
+  // WHEN the pose of one of the transforms changes
+  transforms.front().transform.translation.x += 0.5;
+  const auto changed_x = transforms.front().transform.translation.x;
+  tf_broadcaster.updateStaticTransforms(transforms);
+  spinFor(node, kSpinDuration);
+  // THEN all transforms are published again, with the new value of the changed transform
+  ASSERT_THAT(received_messages, SizeIs(2));
+  const auto& republished = received_messages.back().transforms;
+  ASSERT_THAT(republished, SizeIs(transforms.size()));
+  for (const auto& transform : republished) {
+    if (transform.child_frame_id == transforms.front().child_frame_id) {
+      EXPECT_THAT(transform.transform.translation.x, DoubleEq(changed_x));
+    }
+  }
+
+  // WHEN a transform to a new child frame is passed in along with the existing transforms
+  transforms.push_back(createTfTreeTransform(kTfTreeBodyFrame, "new_leaf", 0.2));
+  tf_broadcaster.updateStaticTransforms(transforms);
+  spinFor(node, kSpinDuration);
+  // THEN all transforms, including the new one, are published
+  ASSERT_THAT(received_messages, SizeIs(3));
+  EXPECT_THAT(received_messages.back().transforms, SizeIs(transforms.size()));
+}
+
+TEST_F(RclcppTfBroadcasterInterfaceTest, ComparesRotationsOfStaticTransformsWithoutNormalizing) {
+  // GIVEN a TF broadcaster which published a static transform
+  RclcppTfBroadcasterInterface tf_broadcaster{node};
+  auto transforms = createTfTree(0, 1);
+  tf_broadcaster.updateStaticTransforms(transforms);
+  spinFor(node, kSpinDuration);
+  ASSERT_THAT(received_messages, SizeIs(1));
+
+  // WHEN the same rotation is passed in again as a negated quaternion which is slightly shorter than a unit quaternion
+  auto& rotation = transforms.back().transform.rotation;
+  const auto original_rotation = rotation;
+  rotation.w *= -0.999;
+  rotation.x *= -0.999;
+  rotation.y *= -0.999;
+  rotation.z *= -0.999;
+  tf_broadcaster.updateStaticTransforms(transforms);
+  spinFor(node, kSpinDuration);
+  // THEN nothing is published
+  EXPECT_THAT(received_messages, SizeIs(1));
+
+  // WHEN the rotation changes by a small angle, as a quaternion which is slightly longer than a unit quaternion
+  const auto half_angle = 0.005;
+  rotation.w = 1.001 * (original_rotation.w * std::cos(half_angle) - original_rotation.z * std::sin(half_angle));
+  rotation.z = 1.001 * (original_rotation.z * std::cos(half_angle) + original_rotation.w * std::sin(half_angle));
+  rotation.x = 0.0;
+  rotation.y = 0.0;
+  tf_broadcaster.updateStaticTransforms(transforms);
+  spinFor(node, kSpinDuration);
+  // THEN the changed transform is published
+  EXPECT_THAT(received_messages, SizeIs(2));
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,185 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+
+#include <rclcpp/node.hpp>
+#include <rclcpp/time.hpp>
+#include <spot_driver/interfaces/rclcpp_tf_listener_interface.hpp>
+#include <spot_driver/rclcpp_test.hpp>
+#include <spot_driver/tf_tree_test_tools.hpp>
+#include <tl_expected/expected.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+using ::testing::DoubleNear;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+constexpr auto kTolerance = 1e-9;
+
+geometry_msgs::msg::TransformStamped createStampedTransform(const std::string& parent, const std::string& child,
+                                                            const double offset, const double stamp_seconds) {
+  auto transform = spot_ros2::test::createTfTreeTransform(parent, child, offset);
+  transform.header.stamp = rclcpp::Time{static_cast<std::int64_t>(std::llround(stamp_seconds * 1e9)), RCL_ROS_TIME};
+  return transform;
+}
+
+using TransformResults = std::vector<tl::expected<geometry_msgs::msg::TransformStamped, std::string>>;
+
+void expectSameTransforms(const TransformResults& actual, const TransformResults& expected) {
+  ASSERT_THAT(actual, SizeIs(expected.size()));
+  for (std::size_t ndx = 0; ndx < expected.size(); ++ndx) {
+    ASSERT_TRUE(expected[ndx].has_value()) << expected[ndx].error();
+    ASSERT_TRUE(actual[ndx].has_value()) << actual[ndx].error();
+    EXPECT_THAT(actual[ndx]->header.frame_id, StrEq(expected[ndx]->header.frame_id));
+    EXPECT_THAT(actual[ndx]->child_frame_id, StrEq(expected[ndx]->child_frame_id));
+    EXPECT_EQ(actual[ndx]->header.stamp, expected[ndx]->header.stamp);
+    const auto& actual_transform = actual[ndx]->transform;
+    const auto& expected_transform = expected[ndx]->transform;
+    EXPECT_THAT(actual_transform.translation.x, DoubleNear(expected_transform.translation.x, kTolerance));
+    EXPECT_THAT(actual_transform.translation.y, DoubleNear(expected_transform.translation.y, kTolerance));
+    EXPECT_THAT(actual_transform.translation.z, DoubleNear(expected_transform.translation.z, kTolerance));
+    EXPECT_THAT(actual_transform.rotation.w, DoubleNear(expected_transform.rotation.w, kTolerance));
+    EXPECT_THAT(actual_transform.rotation.x, DoubleNear(expected_transform.rotation.x, kTolerance));
+    EXPECT_THAT(actual_transform.rotation.y, DoubleNear(expected_transform.rotation.y, kTolerance));
+    EXPECT_THAT(actual_transform.rotation.z, DoubleNear(expected_transform.rotation.z, kTolerance));
+  }
+}
+}  // namespace
+
+namespace spot_ros2::test {
+class RclcppTfListenerInterfaceTest : public RclcppTest {};
+
+TEST_F(RclcppTfListenerInterfaceTest, LookupTransformsMatchesLookupTransform) {
+  // GIVEN a TF listener which received a tree with a chain of frames above the body and several frames below it
+  const auto node = std::make_shared<rclcpp::Node>("tf_listener_test_node");
+  RclcppTfListenerInterface tf_listener{node};
+  ASSERT_TRUE(publishStaticTransforms(node, tf_listener, createTfTree(3, 5)));
+
+  // WHEN we look up the leaf frames, an intermediate frame, and the body from a frame in the middle of the chain at
+  // once
+  const std::vector<std::string> children{"leaf_0", "leaf_1", "leaf_4", "chain_2", kTfTreeBodyFrame, kTfTreeRootFrame};
+  const auto transforms = tf_listener.lookupTransforms("chain_0", children, rclcpp::Time{0, 0});
+
+  // THEN every transform matches the transform looked up on its own
+  TransformResults expected;
+  for (const auto& child : children) {
+    expected.push_back(tf_listener.lookupTransform("chain_0", child, rclcpp::Time{0, 0}));
+  }
+  expectSameTransforms(transforms, expected);
+}
+
+TEST_F(RclcppTfListenerInterfaceTest, LookupTransformsMatchesLookupTransformWithDynamicTransforms) {
+  // GIVEN a TF listener which received dynamic transforms from the root to a chain frame, to the body, and to two leaf
+  // frames, where the newest transform of each differs
+  const auto node = std::make_shared<rclcpp::Node>("tf_listener_test_node");
+  RclcppTfListenerInterface tf_listener{node};
+  ASSERT_TRUE(publishDynamicTransforms(node, tf_listener,
+                                       {
+                                           createStampedTransform(kTfTreeRootFrame, "chain_0", 0.1, 1.0),
+                                           createStampedTransform(kTfTreeRootFrame, "chain_0", 0.5, 2.0),
+                                           createStampedTransform("chain_0", kTfTreeBodyFrame, 0.2, 1.0),
+                                           createStampedTransform("chain_0", kTfTreeBodyFrame, 0.4, 1.5),
+                                           createStampedTransform(kTfTreeBodyFrame, "leaf_0", 0.3, 1.0),
+                                           createStampedTransform(kTfTreeBodyFrame, "leaf_0", 0.6, 1.8),
+                                           createStampedTransform(kTfTreeBodyFrame, "leaf_1", 0.7, 1.0),
+                                           createStampedTransform(kTfTreeBodyFrame, "leaf_1", 0.8, 1.2),
+                                       }));
+
+  // WHEN we look up the frames from the root both at the latest time and at a time between the stamps at once
+  const std::vector<std::string> children{"leaf_0", "leaf_1", kTfTreeBodyFrame, "chain_0"};
+  for (const auto& timepoint : {rclcpp::Time{0, 0}, rclcpp::Time{1, 100'000'000, RCL_ROS_TIME}}) {
+    const auto transforms = tf_listener.lookupTransforms(kTfTreeRootFrame, children, timepoint);
+
+    // THEN every transform matches the transform looked up on its own, which interpolates each chain of transforms at
+    // their latest common time rather than combining the newest transform of each
+    TransformResults expected;
+    for (const auto& child : children) {
+      expected.push_back(tf_listener.lookupTransform(kTfTreeRootFrame, child, timepoint));
+    }
+    expectSameTransforms(transforms, expected);
+  }
+}
+
+TEST_F(RclcppTfListenerInterfaceTest, LookupTransformsMatchesLookupTransformAtFixedTime) {
+  // GIVEN a TF listener which received a tree with a chain of frames above the body and several frames below it
+  const auto node = std::make_shared<rclcpp::Node>("tf_listener_test_node");
+  RclcppTfListenerInterface tf_listener{node};
+  ASSERT_TRUE(publishStaticTransforms(node, tf_listener, createTfTree(3, 5)));
+
+  // WHEN we look up sets of frames at once at a fixed time, from the root, from a frame in the chain, and from a leaf
+  const rclcpp::Time timepoint{5, 0, RCL_ROS_TIME};
+  const std::vector<std::pair<std::string, std::vector<std::string>>> lookups{
+      {kTfTreeRootFrame, {"leaf_0", "leaf_1", "leaf_4"}},
+      {"chain_0", {"leaf_0", "leaf_4", "chain_2", kTfTreeBodyFrame}},
+      {"leaf_2", {"leaf_0", "leaf_1", kTfTreeRootFrame}},
+  };
+  for (const auto& [parent, children] : lookups) {
+    const auto transforms = tf_listener.lookupTransforms(parent, children, timepoint);
+
+    // THEN every transform matches the transform looked up on its own
+    TransformResults expected;
+    for (const auto& child : children) {
+      expected.push_back(tf_listener.lookupTransform(parent, child, timepoint));
+    }
+    expectSameTransforms(transforms, expected);
+  }
+}
+
+TEST_F(RclcppTfListenerInterfaceTest, LookupTransformsReportsUnknownFrames) {
+  // GIVEN a TF listener which received a tree of frames
+  const auto node = std::make_shared<rclcpp::Node>("tf_listener_test_node");
+  RclcppTfListenerInterface tf_listener{node};
+  ASSERT_TRUE(publishStaticTransforms(node, tf_listener, createTfTree(1, 2)));
+
+  // WHEN we look up known frames and a frame which is not in the tree at once, at the latest time and at a fixed time
+  for (const auto& timepoint : {rclcpp::Time{0, 0}, rclcpp::Time{5, 0, RCL_ROS_TIME}}) {
+    const auto transforms =
+        tf_listener.lookupTransforms(kTfTreeRootFrame, {"leaf_0", "leaf_1", "not_a_frame"}, timepoint);
+
+    // THEN the known frames are found, and the unknown frame has the same error as when looked up on its own
+    ASSERT_THAT(transforms, SizeIs(3));
+    EXPECT_TRUE(transforms[0].has_value());
+    EXPECT_TRUE(transforms[1].has_value());
+    ASSERT_FALSE(transforms[2].has_value());
+    const auto expected = tf_listener.lookupTransform(kTfTreeRootFrame, "not_a_frame", timepoint);
+    ASSERT_FALSE(expected.has_value());
+    EXPECT_THAT(transforms[2].error(), StrEq(expected.error()));
+  }
+}
+
+TEST_F(RclcppTfListenerInterfaceTest, LookupTransformsReportsFramesWithoutTransformsAtTime) {
+  // GIVEN a TF listener which received dynamic transforms to two leaf frames below the body, where the transforms to
+  // one of them end before the others
+  const auto node = std::make_shared<rclcpp::Node>("tf_listener_test_node");
+  RclcppTfListenerInterface tf_listener{node};
+  ASSERT_TRUE(publishDynamicTransforms(node, tf_listener,
+                                       {
+                                           createStampedTransform(kTfTreeRootFrame, kTfTreeBodyFrame, 0.2, 1.0),
+                                           createStampedTransform(kTfTreeRootFrame, kTfTreeBodyFrame, 0.4, 2.0),
+                                           createStampedTransform(kTfTreeBodyFrame, "leaf_0", 0.3, 1.0),
+                                           createStampedTransform(kTfTreeBodyFrame, "leaf_0", 0.6, 2.0),
+                                           createStampedTransform(kTfTreeBodyFrame, "leaf_1", 0.7, 1.0),
+                                           createStampedTransform(kTfTreeBodyFrame, "leaf_1", 0.8, 1.2),
+                                       }));
+
+  // WHEN we look up both leaf frames at once at a time after the transforms to one of them end
+  const rclcpp::Time timepoint{1, 500'000'000, RCL_ROS_TIME};
+  const auto transforms = tf_listener.lookupTransforms(kTfTreeRootFrame, {"leaf_0", "leaf_1"}, timepoint);
+
+  // THEN the first leaf frame matches the transform looked up on its own, and the second has the same error as when
+  // looked up on its own
+  ASSERT_THAT(transforms, SizeIs(2));
+  expectSameTransforms({transforms[0]}, {tf_listener.lookupTransform(kTfTreeRootFrame, "leaf_0", timepoint)});
+  ASSERT_FALSE(transforms[1].has_value());
+  const auto expected = tf_listener.lookupTransform(kTfTreeRootFrame, "leaf_1", timepoint);
+  ASSERT_FALSE(expected.has_value());
+  EXPECT_THAT(transforms[1].error(), StrEq(expected.error()));
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,101 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <gmock/gmock.h>
+#include <spot_driver/object_sync/frame_classification_table.hpp>
+
+#include <optional>
+#include <string>
+
+namespace {
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::Optional;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+using ::testing::UnorderedElementsAre;
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(FrameClassificationTable, ResolvesFrameIdsToNames) {
+  // GIVEN a table for a robot with a prefix
+  FrameClassificationTable table{"MyRobot/", {"body"}};
+
+  // WHEN a frame is interned by its TF frame ID with and without the prefix, and by its name
+  const auto prefixed = table.internFrameId("MyRobot/body");
+  const auto unprefixed = table.internFrameId("body");
+  const auto by_name = table.internName("body");
+
+  // THEN all of them refer to the same frame, whose name does not have the prefix
+  EXPECT_THAT(prefixed, Eq(by_name));
+  EXPECT_THAT(unprefixed, Eq(by_name));
+  EXPECT_THAT(table.getName(prefixed), StrEq("body"));
+
+  // THEN a prefix which is not at the start of the frame ID is kept
+  EXPECT_THAT(table.getName(table.internFrameId("other/MyRobot/body")), StrEq("other/MyRobot/body"));
+
+  // THEN only interned names can be found
+  EXPECT_THAT(table.findName("body"), Optional(by_name));
+  EXPECT_THAT(table.findName("not_a_frame"), Eq(std::nullopt));
+}
+
+TEST(FrameClassificationTable, KeepsFrameIdsOfFrames) {
+  // GIVEN a table for a robot with a prefix
+  FrameClassificationTable table{"MyRobot/", {}};
+
+  // WHEN frames are interned by their TF frame IDs, with and without the prefix
+  const auto prefixed = table.internFrameId("MyRobot/arm_target");
+  const auto unprefixed = table.internFrameId("external");
+
+  // THEN their frame IDs are the ones they were interned by
+  EXPECT_THAT(table.getFrameId(prefixed), StrEq("MyRobot/arm_target"));
+  EXPECT_THAT(table.getFrameId(unprefixed), StrEq("external"));
+
+  // WHEN a frame is only interned by its name
+  const auto by_name = table.internName("fiducial_3");
+
+  // THEN its frame ID has the prefix, like the frames of world objects broadcast to TF
+  EXPECT_THAT(table.getFrameId(by_name), StrEq("MyRobot/fiducial_3"));
+
+  // WHEN that frame is later interned by a TF frame ID
+  table.internFrameId("fiducial_3");
+
+  // THEN its frame ID is the one it was interned by
+  EXPECT_THAT(table.getFrameId(by_name), StrEq("fiducial_3"));
+}
+
+TEST(FrameClassificationTable, TracksClassesOfFrames) {
+  // GIVEN a table with an internal frame
+  FrameClassificationTable table{"MyRobot/", {"body"}};
+  const auto body = table.internFrameId("MyRobot/body");
+  const auto fiducial = table.internName("fiducial_3");
+  const auto external = table.internFrameId("external");
+
+  // THEN only the internal frame and the duplicates of arm_link_wr1 are internal
+  EXPECT_THAT(table.isMember(body, FrameClass::INTERNAL), IsTrue());
+  EXPECT_THAT(table.isMember(table.internName("arm0.link_wr1"), FrameClass::INTERNAL), IsTrue());
+  EXPECT_THAT(table.isMember(fiducial, FrameClass::INTERNAL), IsFalse());
+  EXPECT_THAT(table.isMember(external, FrameClass::INTERNAL), IsFalse());
+
+  // WHEN frames are added to classes
+  table.addMember(external, FrameClass::MANAGED);
+  table.addMember(external, FrameClass::MANAGED);
+  table.assignMembers(FrameClass::NON_MUTABLE, {fiducial, body});
+
+  // THEN they are members of those classes only, and each is listed once
+  EXPECT_THAT(table.isMember(external, FrameClass::MANAGED), IsTrue());
+  EXPECT_THAT(table.isMember(external, FrameClass::NON_MUTABLE), IsFalse());
+  EXPECT_THAT(table.getMembers(FrameClass::MANAGED), SizeIs(1));
+  EXPECT_THAT(table.getMembers(FrameClass::NON_MUTABLE), UnorderedElementsAre(fiducial, body));
+  EXPECT_THAT(table.isMember(body, FrameClass::INTERNAL), IsTrue());
+
+  // WHEN the members of a class are replaced
+  table.assignMembers(FrameClass::NON_MUTABLE, {body});
+
+  // THEN frames which are no longer listed are no longer members, and other classes are unaffected
+  EXPECT_THAT(table.isMember(fiducial, FrameClass::NON_MUTABLE), IsFalse());
+  EXPECT_THAT(table.isMember(body, FrameClass::NON_MUTABLE), IsTrue());
+  EXPECT_THAT(table.isMember(body, FrameClass::INTERNAL), IsTrue());
+  EXPECT_THAT(table.getMembers(FrameClass::NON_MUTABLE), UnorderedElementsAre(body));
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <bosdyn/api/world_object.pb.h>
+#include <gmock/gmock.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <spot_driver/object_sync/world_object_cache.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace {
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsEmpty;
+using ::testing::IsFalse;
+using ::testing::IsNull;
+using ::testing::IsTrue;
+using ::testing::NotNull;
+using ::testing::Pointee;
+using ::testing::Property;
+using ::testing::StrEq;
+
+void addObject(::bosdyn::api::ListWorldObjectResponse& response, const std::int32_t id, const std::string& name,
+               const std::int64_t acquisition_seconds) {
+  auto* object = response.add_world_objects();
+  object->set_id(id);
+  object->set_name(name);
+  object->mutable_acquisition_time()->set_seconds(acquisition_seconds);
+}
+
+auto objectNamed(const std::string& name) {
+  return Pointee(Property(&::bosdyn::api::WorldObject::name, StrEq(name)));
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(WorldObjectCache, ReportsOnlyNewAndUpdatedObjects) {
+  // GIVEN a cache with two objects
+  WorldObjectCache cache;
+  ::bosdyn::api::ListWorldObjectResponse first_response;
+  addObject(first_response, 1, "dock", 100);
+  addObject(first_response, 2, "fiducial_1", 100);
+  EXPECT_THAT(cache.update(first_response, true), ElementsAre(objectNamed("dock"), objectNamed("fiducial_1")));
+
+  // WHEN the same objects are listed again, one of them with a newer acquisition time, along with a new object
+  ::bosdyn::api::ListWorldObjectResponse second_response;
+  addObject(second_response, 1, "dock", 100);
+  addObject(second_response, 2, "fiducial_1", 101);
+  addObject(second_response, 3, "fiducial_2", 101);
+  const auto changed = cache.update(second_response, false);
+
+  // THEN only the updated and the new object are reported as changed
+  EXPECT_THAT(changed, ElementsAre(objectNamed("fiducial_1"), objectNamed("fiducial_2")));
+  EXPECT_THAT(cache.size(), Eq(3U));
+  ASSERT_THAT(cache.find(2), NotNull());
+  EXPECT_THAT(cache.find(2)->acquisition_time().seconds(), Eq(101));
+}
+
+TEST(WorldObjectCache, FiltersRequestsByNewestAcquisitionTime) {
+  // GIVEN an empty cache
+  WorldObjectCache cache;
+
+  // WHEN a request is filtered by it
+  ::bosdyn::api::ListWorldObjectRequest request;
+  cache.applyTimestampFilter(request);
+  // THEN the request lists all objects
+  EXPECT_THAT(request.has_timestamp_filter(), IsFalse());
+
+  // GIVEN the cache holds objects acquired at different times
+  ::bosdyn::api::ListWorldObjectResponse response;
+  addObject(response, 1, "dock", 100);
+  addObject(response, 2, "fiducial_1", 105);
+  cache.update(response, false);
+
+  // WHEN a request is filtered by it
+  cache.applyTimestampFilter(request);
+  // THEN the request only lists objects acquired after the newest object in the cache
+  ASSERT_THAT(request.has_timestamp_filter(), IsTrue());
+  EXPECT_THAT(request.timestamp_filter().seconds(), Eq(105));
+}
+
+TEST(WorldObjectCache, CompleteListingRemovesObjects) {
+  // GIVEN a cache with two objects
+  WorldObjectCache cache;
+  ::bosdyn::api::ListWorldObjectResponse first_response;
+  addObject(first_response, 1, "dock", 100);
+  addObject(first_response, 2, "fiducial_1", 105);
+  cache.update(first_response, true);
+
+  // WHEN a listing filtered by timestamp does not contain one of them
+  cache.update(::bosdyn::api::ListWorldObjectResponse{}, false);
+  // THEN it is kept
+  EXPECT_THAT(cache.size(), Eq(2U));
+
+  // WHEN a complete listing does not contain one of them
+  ::bosdyn::api::ListWorldObjectResponse complete_response;
+  addObject(complete_response, 1, "dock", 100);
+  EXPECT_THAT(cache.update(complete_response, true), IsEmpty());
+
+  // THEN it is removed, and no longer counts towards the timestamp filter
+  EXPECT_THAT(cache.find(2), IsNull());
+  ::bosdyn::api::ListWorldObjectRequest request;
+  cache.applyTimestampFilter(request);
+  EXPECT_THAT(request.timestamp_filter().seconds(), Eq(100));
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,116 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+/**
+ * Measures the latency from writing a robot state to shared memory until a reader polling the segment from another
+ * thread sees it, as well as the time each write and read takes.
+ *
+ * It is built alongside the tests but not run by them:
+ *   <build directory>/test/benchmark_shared_robot_state [iterations]
+ */
+
+#include <spot_driver/robot_state/shared_robot_state_reader.hpp>
+#include <spot_driver/robot_state/shared_robot_state_writer.hpp>
+#include <spot_driver/robot_state_test_tools.hpp>
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr auto kDefaultIterations = 10000;
+// Spot streams robot state at up to about 333 Hz, and a low-level controller usually runs at 1 kHz or faster.
+constexpr auto kWritePeriod = std::chrono::microseconds{1000};
+
+std::int64_t nowNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void printTimes(const std::string& name, std::vector<double> times_us) {
+  if (times_us.empty()) {
+    std::printf("%-16s no samples\n", name.c_str());
+    return;
+  }
+  double total_us = 0.;
+  for (const auto time_us : times_us) {
+    total_us += time_us;
+  }
+  std::sort(times_us.begin(), times_us.end());
+  const auto percentile = [&times_us](double p) {
+    return times_us[static_cast<size_t>(p * (times_us.size() - 1))];
+  };
+  std::printf("%-16s mean %8.2f us  p50 %8.2f us  p99 %8.2f us  max %8.2f us\n", name.c_str(),
+              total_us / times_us.size(), percentile(0.5), percentile(0.99), times_us.back());
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  using namespace spot_ros2;
+  const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : kDefaultIterations;
+  const auto name = "/spot_ros2_benchmark_" + std::to_string(getpid());
+
+  auto writer = SharedRobotStateWriter::create(name, false);
+  if (!writer) {
+    std::fprintf(stderr, "%s\n", writer.error().c_str());
+    return 1;
+  }
+  auto reader = SharedRobotStateReader::open(name);
+  if (!reader) {
+    std::fprintf(stderr, "%s\n", reader.error().c_str());
+    return 1;
+  }
+
+  std::atomic<bool> done{false};
+  std::vector<double> latencies_us;
+  std::vector<double> read_times_us;
+  latencies_us.reserve(iterations);
+  read_times_us.reserve(iterations);
+  std::thread reader_thread{[&] {
+    std::uint64_t last_count = 0;
+    while (!done.load()) {
+      const auto start = nowNanoseconds();
+      const auto state = reader.value()->read();
+      const auto end = nowNanoseconds();
+      if (!state || state->count == last_count) {
+        continue;
+      }
+      read_times_us.push_back((end - start) / 1e3);
+      // A robot state which the reader missed entirely is not counted, since its latency cannot be measured
+      if (state->count == last_count + 1) {
+        latencies_us.push_back((end - state->write_time_ns) / 1e3);
+      }
+      last_count = state->count;
+    }
+  }};
+
+  const auto robot_state = test::createRobotStateWithAllOutputs();
+  const google::protobuf::Duration clock_skew;
+  std::vector<double> write_times_us;
+  write_times_us.reserve(iterations);
+  auto next_write = std::chrono::steady_clock::now();
+  for (int ndx = 0; ndx < iterations; ++ndx) {
+    std::this_thread::sleep_until(next_write);
+    next_write += kWritePeriod;
+    const auto start = nowNanoseconds();
+    writer.value()->write(robot_state, clock_skew);
+    write_times_us.push_back((nowNanoseconds() - start) / 1e3);
+  }
+  // Give the reader time to see the last robot state
+  std::this_thread::sleep_for(kWritePeriod);
+  done = true;
+  reader_thread.join();
+
+  std::printf("Writing %d robot states to shared memory, one every %ld us, with a reader polling in another thread\n",
+              iterations, static_cast<long>(kWritePeriod.count()));
+  printTimes("write", write_times_us);
+  printTimes("read", read_times_us);
+  printTimes("write to read", latencies_us);
+  std::printf("%zu of %d robot states were read\n", latencies_us.size(), iterations);
+  return 0;
+}
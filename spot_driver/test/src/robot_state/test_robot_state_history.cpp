@@ -0,0 +1,223 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <bosdyn/api/robot_state.pb.h>
+#include <gmock/gmock.h>
+#include <google/protobuf/duration.pb.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <builtin_interfaces/msg/time.hpp>
+#include <spot_driver/robot_state/robot_state_history.hpp>
+#include <spot_driver/robot_state_test_tools.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+constexpr auto kPrefix = "prefix/";
+constexpr auto kTolerance = 1e-9;
+
+builtin_interfaces::msg::Time makeTime(const std::int32_t sec, const std::uint32_t nanosec = 0) {
+  builtin_interfaces::msg::Time stamp;
+  stamp.sec = sec;
+  stamp.nanosec = nanosec;
+  return stamp;
+}
+
+/**
+ * @brief Create a robot state acquired at a time, with the body at a position along the x axis of the odom frame and
+ * rotated around its z axis, and with every joint at its index plus an offset.
+ */
+::bosdyn::api::RobotState makeRobotState(const std::int64_t seconds, const double body_x, const double body_yaw = 0.,
+                                         const double joint_offset = 0.) {
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(seconds);
+  ::bosdyn::api::RobotState robot_state;
+  auto* kinematic_state = robot_state.mutable_kinematic_state();
+  spot_ros2::test::addAcquisitionTimestamp(kinematic_state, timestamp);
+  double position = joint_offset;
+  for (const auto& [name, friendly_name] : spot_ros2::kFriendlyJointNames) {
+    spot_ros2::test::setJointState(kinematic_state->add_joint_states(), name, position, 0.1, 0.2, 0.3);
+    position += 1.;
+  }
+  // Edges of the snapshot are the pose of the parent in the child, so the odom edge holds the inverse body pose.
+  auto* snapshot = kinematic_state->mutable_transforms_snapshot();
+  spot_ros2::test::addRootFrame(snapshot, "body");
+  const auto half_yaw = body_yaw / 2.;
+  spot_ros2::test::addTransform(snapshot, "odom", "body", -body_x * std::cos(body_yaw), body_x * std::sin(body_yaw),
+                                0., std::cos(half_yaw), 0., 0., -std::sin(half_yaw));
+  return robot_state;
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(RobotStateHistory, EmptyHistoryReturnsError) {
+  // GIVEN an empty history
+  const RobotStateHistory history{8, kPrefix, false};
+
+  // WHEN the state at some time is requested
+  const auto result = history.getAt(makeTime(100));
+
+  // THEN an error is returned
+  ASSERT_THAT(result.has_value(), IsFalse());
+  EXPECT_THAT(result.error(), HasSubstr("No robot state"));
+  EXPECT_THAT(history.getLatest().has_value(), IsFalse());
+}
+
+TEST(RobotStateHistory, InterpolatesBetweenSamples) {
+  // GIVEN a history with robot states one second apart, during which the body and the joints move
+  RobotStateHistory history{8, kPrefix, false};
+  const google::protobuf::Duration clock_skew;
+  history.add(makeRobotState(100, 1.), clock_skew);
+  history.add(makeRobotState(101, 3., M_PI / 2., 1.), clock_skew);
+
+  // WHEN the state a quarter of the way between them is requested
+  const auto result = history.getAt(makeTime(100, 250000000));
+
+  // THEN the joint states and body position are interpolated linearly
+  ASSERT_THAT(result.has_value(), IsTrue());
+  const auto joint_state = history.toJointState(result.value());
+  ASSERT_THAT(joint_state.name, SizeIs(kFriendlyJointNames.size()));
+  EXPECT_THAT(joint_state.header.stamp, Eq(makeTime(100, 250000000)));
+  EXPECT_THAT(joint_state.position[0], DoubleNear(0.25, kTolerance));
+  EXPECT_THAT(joint_state.position[1], DoubleNear(1.25, kTolerance));
+  EXPECT_THAT(joint_state.velocity[0], DoubleNear(0.1, kTolerance));
+
+  const auto body_pose = history.toBodyPose(result.value());
+  EXPECT_THAT(body_pose.header.frame_id, StrEq("prefix/odom"));
+  EXPECT_THAT(body_pose.pose.position.x, DoubleNear(1.5, kTolerance));
+  EXPECT_THAT(body_pose.pose.position.y, DoubleNear(0., kTolerance));
+  // THEN the body orientation is interpolated along the arc between them, so that it is a quarter of the way to the
+  // final yaw
+  EXPECT_THAT(body_pose.pose.orientation.w, DoubleNear(std::cos(M_PI / 16.), kTolerance));
+  EXPECT_THAT(body_pose.pose.orientation.z, DoubleNear(std::sin(M_PI / 16.), kTolerance));
+}
+
+TEST(RobotStateHistory, ReturnsSampleAtExactTime) {
+  // GIVEN a history with a few robot states
+  RobotStateHistory history{8, kPrefix, false};
+  const google::protobuf::Duration clock_skew;
+  for (int ndx = 0; ndx < 3; ++ndx) {
+    history.add(makeRobotState(100 + ndx, ndx), clock_skew);
+  }
+
+  // WHEN the state at the time of one of them is requested
+  const auto result = history.getAt(makeTime(101));
+
+  // THEN that robot state is returned as it is
+  ASSERT_THAT(result.has_value(), IsTrue());
+  EXPECT_THAT(result->body_position, ElementsAre(DoubleNear(1., kTolerance), DoubleNear(0., kTolerance), 0.));
+  // THEN the latest robot state is the last one added
+  ASSERT_THAT(history.getLatest().has_value(), IsTrue());
+  EXPECT_THAT(history.getLatest()->stamp_ns, Eq(102000000000));
+}
+
+TEST(RobotStateHistory, RejectsTimesOutsideOfHistory) {
+  // GIVEN a history which has wrapped around after more robot states than it can hold were added
+  RobotStateHistory history{4, kPrefix, false};
+  const google::protobuf::Duration clock_skew;
+  for (int ndx = 0; ndx < 10; ++ndx) {
+    history.add(makeRobotState(100 + ndx, ndx), clock_skew);
+  }
+
+  // WHEN the state is requested after the newest robot state
+  const auto too_new = history.getAt(makeTime(110));
+  // THEN an error is returned
+  ASSERT_THAT(too_new.has_value(), IsFalse());
+  EXPECT_THAT(too_new.error(), HasSubstr("newer"));
+
+  // WHEN the state is requested before the oldest robot state which is still kept
+  const auto too_old = history.getAt(makeTime(105, 500000000));
+  // THEN an error is returned
+  ASSERT_THAT(too_old.has_value(), IsFalse());
+  EXPECT_THAT(too_old.error(), HasSubstr("older"));
+
+  // WHEN the state is requested between the oldest robot states which are still kept
+  const auto oldest = history.getAt(makeTime(106, 500000000));
+  // THEN it is interpolated between them
+  ASSERT_THAT(oldest.has_value(), IsTrue());
+  EXPECT_THAT(oldest->body_position[0], DoubleNear(6.5, kTolerance));
+}
+
+TEST(RobotStateHistory, IgnoresOutOfOrderRobotStates) {
+  // GIVEN a history with a robot state
+  RobotStateHistory history{8, kPrefix, false};
+  const google::protobuf::Duration clock_skew;
+  history.add(makeRobotState(101, 1.), clock_skew);
+
+  // WHEN a robot state which was acquired earlier is added, as well as one without an acquisition timestamp
+  history.add(makeRobotState(100, 0.), clock_skew);
+  history.add(::bosdyn::api::RobotState{}, clock_skew);
+
+  // THEN neither of them is kept
+  EXPECT_THAT(history.getAt(makeTime(100, 500000000)).has_value(), IsFalse());
+  ASSERT_THAT(history.getLatest().has_value(), IsTrue());
+  EXPECT_THAT(history.getLatest()->index, Eq(0U));
+}
+
+TEST(RobotStateHistory, NamesJointsWithPrefix) {
+  // GIVEN a history with a robot state
+  RobotStateHistory history{8, kPrefix, false};
+  history.add(makeRobotState(100, 0.), google::protobuf::Duration{});
+
+  // WHEN the joint states of the robot state are created
+  const auto joint_state = history.toJointState(history.getLatest().value());
+
+  // THEN the joints have the same prefixed names as in the joint states published by the robot state publisher
+  ASSERT_THAT(joint_state.name, SizeIs(kFriendlyJointNames.size()));
+  EXPECT_THAT(joint_state.name[0], StrEq(kPrefix + kFriendlyJointNames.begin()->second));
+}
+
+TEST(RobotStateHistory, ExtrapolatesBodyPoseFromVelocity) {
+  // GIVEN a history with a robot state in which the body moves forward and turns
+  RobotStateHistory history{8, kPrefix, false};
+  auto robot_state = makeRobotState(100, 1.);
+  addBodyVelocityOdom(robot_state.mutable_kinematic_state(), 0.5, 0., 0., 0., 0., 0.2);
+  history.add(robot_state, google::protobuf::Duration{});
+
+  // WHEN the body pose half a second after the robot state is requested, within the horizon
+  const auto result = history.getExtrapolated(makeTime(100, 500000000), std::chrono::duration<double>{1.0});
+
+  // THEN the body has kept moving and turning at its velocity
+  ASSERT_THAT(result.has_value(), IsTrue()) << result.error();
+  const auto transform = history.toBodyTransform(result.value(), "prefix/body_extrapolated");
+  EXPECT_THAT(transform.header.stamp, Eq(makeTime(100, 500000000)));
+  EXPECT_THAT(transform.header.frame_id, StrEq("prefix/odom"));
+  EXPECT_THAT(transform.child_frame_id, StrEq("prefix/body_extrapolated"));
+  EXPECT_THAT(transform.transform.translation.x, DoubleNear(1.25, kTolerance));
+  EXPECT_THAT(transform.transform.translation.y, DoubleNear(0., kTolerance));
+  EXPECT_THAT(transform.transform.rotation.w, DoubleNear(std::cos(0.05), kTolerance));
+  EXPECT_THAT(transform.transform.rotation.z, DoubleNear(std::sin(0.05), kTolerance));
+}
+
+TEST(RobotStateHistory, RejectsExtrapolationPastHorizon) {
+  // GIVEN a history with a robot state with a body velocity, and one without
+  RobotStateHistory history{8, kPrefix, false};
+  auto robot_state = makeRobotState(100, 1.);
+  addBodyVelocityOdom(robot_state.mutable_kinematic_state(), 0.5, 0., 0., 0., 0., 0.);
+  history.add(robot_state, google::protobuf::Duration{});
+  RobotStateHistory history_without_velocity{8, kPrefix, false};
+  history_without_velocity.add(makeRobotState(100, 1.), google::protobuf::Duration{});
+
+  // WHEN the body pose is requested further past the robot state than the horizon
+  const auto too_far = history.getExtrapolated(makeTime(101), std::chrono::duration<double>{0.5});
+  // THEN an error is returned
+  ASSERT_THAT(too_far.has_value(), IsFalse());
+  EXPECT_THAT(too_far.error(), HasSubstr("too far"));
+
+  // WHEN the body pose is requested past a robot state without body velocity
+  const auto without_velocity =
+      history_without_velocity.getExtrapolated(makeTime(100, 100000000), std::chrono::duration<double>{0.5});
+  // THEN an error is returned
+  ASSERT_THAT(without_velocity.has_value(), IsFalse());
+  EXPECT_THAT(without_velocity.error(), HasSubstr("velocity"));
+}
+}  // namespace spot_ros2::test
@@ -0,0 +1,157 @@
+// Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
+
+#include <bosdyn/api/robot_state.pb.h>
+#include <gmock/gmock.h>
+#include <google/protobuf/duration.pb.h>
+#include <unistd.h>
+#include <spot_driver/conversions/robot_state.hpp>
+#include <spot_driver/robot_state/shared_robot_state_reader.hpp>
+#include <spot_driver/robot_state/shared_robot_state_writer.hpp>
+#include <spot_driver/robot_state_test_tools.hpp>
+
+#include <string>
+
+namespace {
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::SizeIs;
+using ::testing::StrEq;
+
+/** @brief Name of a segment which is not used by any other test running at the same time. */
+std::string makeSegmentName(const std::string& test_name) {
+  return "/spot_ros2_test_" + test_name + "_" + std::to_string(getpid());
+}
+}  // namespace
+
+namespace spot_ros2::test {
+TEST(SharedRobotState, ReaderReadsWrittenRobotState) {
+  // GIVEN a writer and a reader of the same segment
+  const auto name = makeSegmentName("round_trip");
+  auto writer = SharedRobotStateWriter::create(name, false);
+  ASSERT_THAT(writer.has_value(), IsTrue()) << writer.error();
+  const auto reader = SharedRobotStateReader::open(name);
+  ASSERT_THAT(reader.has_value(), IsTrue()) << reader.error();
+
+  // THEN the reader knows the joint names and the frame of the body pose before any robot state is written
+  EXPECT_THAT(reader.value()->getJointNames(), SizeIs(kFriendlyJointNames.size()));
+  EXPECT_THAT(reader.value()->getJointNames().front(), StrEq(kFriendlyJointNames.begin()->second));
+  EXPECT_THAT(reader.value()->getOdomFrame(), StrEq("odom"));
+  // THEN there is no robot state to read yet
+  EXPECT_THAT(reader.value()->read().has_value(), IsFalse());
+
+  // WHEN a robot state is written
+  const auto robot_state = createRobotStateWithAllOutputs();
+  google::protobuf::Duration clock_skew;
+  clock_skew.set_seconds(1);
+  writer.value()->write(robot_state, clock_skew);
+
+  // THEN the reader reads it, with the acquisition time corrected for the clock skew
+  const auto state = reader.value()->read();
+  ASSERT_THAT(state.has_value(), IsTrue());
+  EXPECT_THAT(state->count, Eq(1U));
+  EXPECT_THAT(state->stamp_ns, Eq(99000000000));
+  // THEN every joint is set, in the order of the joint names
+  for (std::size_t ndx = 0; ndx < kFriendlyJointNames.size(); ++ndx) {
+    EXPECT_THAT(state->joint_valid[ndx], Eq(1));
+    EXPECT_THAT(state->joint_positions[ndx], DoubleNear(0.1 * static_cast<double>(ndx), 1e-9));
+  }
+  // THEN the body pose, velocity and foot contacts are set
+  EXPECT_THAT(state->has_body_pose, Eq(1));
+  EXPECT_THAT(state->body_position, ElementsAre(DoubleEq(1.0), DoubleEq(2.0), DoubleEq(0.5)));
+  EXPECT_THAT(state->has_body_twist, Eq(1));
+  EXPECT_THAT(state->body_linear_velocity, ElementsAre(DoubleEq(0.5), DoubleEq(0.1), DoubleEq(0.0)));
+  EXPECT_THAT(state->foot_count, Eq(4));
+  EXPECT_THAT(state->foot_contacts[0], Eq(::bosdyn::api::FootState::CONTACT_MADE));
+
+  // WHEN a robot state without joints and body pose is written
+  writer.value()->write(::bosdyn::api::RobotState{}, clock_skew);
+
+  // THEN the reader reads that none of them are set anymore
+  const auto empty_state = reader.value()->read();
+  ASSERT_THAT(empty_state.has_value(), IsTrue());
+  EXPECT_THAT(empty_state->count, Eq(2U));
+  EXPECT_THAT(empty_state->joint_valid[0], Eq(0));
+  EXPECT_THAT(empty_state->has_body_pose, Eq(0));
+  EXPECT_THAT(empty_state->foot_count, Eq(0));
+}
+
+TEST(SharedRobotState, ReaderFailsWithoutSegment) {
+  // GIVEN no segment has been created with a name
+  const auto name = makeSegmentName("missing");
+
+  // WHEN a reader opens a segment with that name
+  const auto reader = SharedRobotStateReader::open(name);
+
+  // THEN it fails
+  ASSERT_THAT(reader.has_value(), IsFalse());
+  EXPECT_THAT(reader.error(), HasSubstr(name));
+}
+
+TEST(SharedRobotState, SegmentIsRemovedWithWriter) {
+  // GIVEN a writer which is destroyed
+  const auto name = makeSegmentName("removed");
+  {
+    auto writer = SharedRobotStateWriter::create(name, true);
+    ASSERT_THAT(writer.has_value(), IsTrue()) << writer.error();
+  }
+
+  // WHEN a reader opens the segment of the writer
+  const auto reader = SharedRobotStateReader::open(name);
+
+  // THEN it fails, since the segment was removed
+  EXPECT_THAT(reader.has_value(), IsFalse());
+}
+
+TEST(SharedRobotState, ReaderMapsReplacedSegment) {
+  // GIVEN a writer and a reader of the same segment, with a robot state written to it
+  const auto name = makeSegmentName("replaced");
+  auto writer = SharedRobotStateWriter::create(name, false);
+  ASSERT_THAT(writer.has_value(), IsTrue()) << writer.error();
+  const auto reader = SharedRobotStateReader::open(name);
+  ASSERT_THAT(reader.has_value(), IsTrue()) << reader.error();
+  const auto robot_state = createRobotStateWithAllOutputs();
+  writer.value()->write(robot_state, google::protobuf::Duration{});
+  writer.value()->write(robot_state, google::protobuf::Duration{});
+  ASSERT_THAT(reader.value()->read().has_value(), IsTrue());
+
+  // WHEN a new writer replaces the segment, as a restarted state publisher does, and writes a robot state
+  auto new_writer = SharedRobotStateWriter::create(name, true);
+  ASSERT_THAT(new_writer.has_value(), IsTrue()) << new_writer.error();
+  new_writer.value()->write(robot_state, google::protobuf::Duration{});
+
+  // THEN the reader reads the robot state of the new writer
+  const auto state = reader.value()->read();
+  ASSERT_THAT(state.has_value(), IsTrue());
+  EXPECT_THAT(state->count, Eq(1U));
+  EXPECT_THAT(reader.value()->getOdomFrame(), StrEq("vision"));
+
+  // WHEN the replaced writer is destroyed
+  writer.value().reset();
+
+  // THEN the segment of the new writer is left in place
+  EXPECT_THAT(reader.value()->read().has_value(), IsTrue());
+  EXPECT_THAT(SharedRobotStateReader::open(name).has_value(), IsTrue());
+}
+
+TEST(SharedRobotState, ReaderStopsReadingRemovedSegment) {
+  // GIVEN a writer and a reader of the same segment, with a robot state written to it
+  const auto name = makeSegmentName("retired");
+  auto writer = SharedRobotStateWriter::create(name, false);
+  ASSERT_THAT(writer.has_value(), IsTrue()) << writer.error();
+  const auto reader = SharedRobotStateReader::open(name);
+  ASSERT_THAT(reader.has_value(), IsTrue()) << reader.error();
+  writer.value()->write(createRobotStateWithAllOutputs(), google::protobuf::Duration{});
+  ASSERT_THAT(reader.value()->read().has_value(), IsTrue());
+
+  // WHEN the writer is destroyed
+  writer.value().reset();
+
+  // THEN the reader no longer reads the last robot state written to the removed segment
+  EXPECT_THAT(reader.value()->read().has_value(), IsFalse());
+}
+}  // namespace spot_ros2::test
@@ -5,6 +5,10 @@
 #include <gmock/gmock.h>
 #include <google/protobuf/duration.pb.h>
 #include <google/protobuf/timestamp.pb.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
 #include <geometry_msgs/msg/transform_stamped.hpp>
 #include <memory>
 #include <spot_driver/fake/fake_parameter_interface.hpp>
@@ -18,18 +22,32 @@
 #include <spot_driver/robot_state/state_publisher.hpp>
 #include <spot_driver/robot_state_test_tools.hpp>
 #include <spot_driver/types.hpp>
+#include <spot_msgs/msg/compact_joint_state.hpp>
+#include <spot_msgs/msg/joint_name_manifest.hpp>
+#include <spot_msgs/srv/get_robot_state_at_time.hpp>
 #include <tf2_msgs/msg/tf_message.hpp>
+#include <thread>
 #include <tl_expected/expected.hpp>
 #include <utility>
 
 namespace {
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::AnyNumber;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::Field;
 using ::testing::HasSubstr;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
 using ::testing::InSequence;
 using ::testing::Invoke;
+using ::testing::Optional;
 using ::testing::Property;
 using ::testing::Return;
+using ::testing::SizeIs;
+using ::testing::SaveArg;
+using ::testing::StrEq;
 using ::testing::Unused;
 
 constexpr auto kErrorMessage = "Some error message.";
@@ -45,6 +63,9 @@ class StatePublisherTest : public ::testing::Test {
     mock_logger_interface = std::make_unique<spot_ros2::test::MockLoggerInterface>();
     mock_tf_broadcaster_interface = std::make_unique<spot_ros2::test::MockTfBroadcasterInterface>();
     mock_timer_interface = std::make_unique<spot_ros2::test::MockTimerInterface>();
+    mock_tf_extrapolation_timer_interface = std::make_unique<spot_ros2::test::MockTimerInterface>();
+    // Unless a test says otherwise, the state client polls robot state rather than streaming it
+    EXPECT_CALL(*mock_state_client_interface, isStreaming).Times(AnyNumber()).WillRepeatedly(Return(false));
   }
 
   std::unique_ptr<MockNodeInterface> mock_node_interface;
@@ -52,6 +73,7 @@ class StatePublisherTest : public ::testing::Test {
   std::unique_ptr<MockLoggerInterface> mock_logger_interface;
   std::unique_ptr<MockTfBroadcasterInterface> mock_tf_broadcaster_interface;
   std::unique_ptr<MockTimerInterface> mock_timer_interface;
+  std::unique_ptr<MockTimerInterface> mock_tf_extrapolation_timer_interface;
 
   std::shared_ptr<spot_ros2::test::MockStateClient> mock_state_client_interface =
       std::make_shared<spot_ros2::test::MockStateClient>();
@@ -60,9 +82,10 @@ class StatePublisherTest : public ::testing::Test {
   std::unique_ptr<StatePublisher> robot_state_publisher;
 };
 
-bosdyn::api::RobotState makeRobotState(const bool has_valid_transforms = true) {
+bosdyn::api::RobotState makeRobotState(const bool has_valid_transforms = true,
+                                       const std::int64_t acquisition_seconds = 100) {
   google::protobuf::Timestamp timestamp;
-  timestamp.set_seconds(100);
+  timestamp.set_seconds(acquisition_seconds);
   timestamp.set_nanos(0);
   bosdyn::api::RobotState out;
   addAcquisitionTimestamp(out.mutable_kinematic_state(), timestamp);
@@ -82,12 +105,14 @@ TEST_F(StatePublisherTest, InitSucceeds) {
   // THEN the timer interface's setTimer function is called once with the expected timer period
   auto* timer_interface_ptr = mock_timer_interface.get();
   EXPECT_CALL(*timer_interface_ptr, setTimer(std::chrono::duration<double>{1.0 / 50.0}, _)).Times(1);
+  // THEN the body pose is not extrapolated by default
+  EXPECT_CALL(*mock_tf_extrapolation_timer_interface, setTimer).Times(0);
 
   // WHEN a robot state publisher is constructed
   robot_state_publisher = std::make_unique<StatePublisher>(
       mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
       std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
-      std::move(mock_timer_interface));
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
 }
 
 TEST_F(StatePublisherTest, PublishCallbackTriggers) {
@@ -115,7 +140,7 @@ TEST_F(StatePublisherTest, PublishCallbackTriggers) {
   robot_state_publisher = std::make_unique<StatePublisher>(
       mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
       std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
-      std::move(mock_timer_interface));
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
 
   // WHEN the timer callback is triggered
   timer_interface_ptr->trigger();
@@ -147,7 +172,7 @@ TEST_F(StatePublisherTest, PublishCallbackTriggersNoTfData) {
   robot_state_publisher = std::make_unique<StatePublisher>(
       mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
       std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
-      std::move(mock_timer_interface));
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
 
   // WHEN the timer callback is triggered
   timer_interface_ptr->trigger();
@@ -184,7 +209,7 @@ TEST_F(StatePublisherTest, PublishCallbackTriggersFailGetRobotState) {
   robot_state_publisher = std::make_unique<StatePublisher>(
       mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
       std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
-      std::move(mock_timer_interface));
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
 
   // WHEN the timer callback is triggered
   timer_interface_ptr->trigger();
@@ -216,9 +241,378 @@ TEST_F(StatePublisherTest, PublishCallbackTriggersFailGetClockSkew) {
   robot_state_publisher = std::make_unique<StatePublisher>(
       mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
       std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
-      std::move(mock_timer_interface));
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
 
   // WHEN the timer callback is triggered
   timer_interface_ptr->trigger();
 }
+
+TEST_F(StatePublisherTest, AsyncPollingPublishesEachNewRobotState) {
+  // GIVEN asynchronous robot state polling is enabled
+  fake_parameter_interface->async_robot_state_polling = true;
+
+  // THEN the timer is only used to report polling statistics
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer(std::chrono::duration<double>{10.0}, _)).Times(1);
+
+  // GIVEN the robot answers the first two requests with the same state, and every later request with a newer state
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true, 100)}))
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true, 100)}))
+      .WillRepeatedly(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true, 101)}));
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew)
+      .Times(AnyNumber())
+      .WillRepeatedly(Return(google::protobuf::Duration()));
+
+  // THEN each distinct robot state is published to the appropriate topics and to TF exactly once
+  std::promise<void> published_both_states;
+  int published_count = 0;
+  EXPECT_CALL(*mock_middleware_handle, publishRobotState).Times(2).WillRepeatedly([&](Unused) {
+    if (++published_count == 2) {
+      published_both_states.set_value();
+    }
+  });
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(2);
+
+  // WHEN a robot_state_publisher is constructed
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
+
+  // WHEN the polling thread has had time to receive both states
+  ASSERT_EQ(published_both_states.get_future().wait_for(std::chrono::seconds{5}), std::future_status::ready);
+  robot_state_publisher.reset();
+}
+
+TEST_F(StatePublisherTest, AsyncPollingIsThrottledToPollingRate) {
+  // GIVEN asynchronous robot state polling is enabled at 20 Hz
+  fake_parameter_interface->async_robot_state_polling = true;
+  fake_parameter_interface->async_robot_state_polling_rate = 20.0;
+  EXPECT_CALL(*mock_timer_interface, setTimer).Times(1);
+
+  // GIVEN the robot answers every request immediately with a newer state
+  std::atomic_int request_count{0};
+  EXPECT_CALL(*mock_state_client_interface, getRobotState).WillRepeatedly([&request_count] {
+    return tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true, 100 + request_count++)};
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew)
+      .Times(AnyNumber())
+      .WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_middleware_handle, publishRobotState).Times(AnyNumber());
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(AnyNumber());
+
+  // WHEN a robot_state_publisher is constructed and polls for half a second
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
+  std::this_thread::sleep_for(std::chrono::milliseconds{500});
+  robot_state_publisher.reset();
+
+  // THEN robot state is requested no more often than the polling rate allows
+  EXPECT_GE(request_count.load(), 2);
+  EXPECT_LE(request_count.load(), 12);
+}
+
+TEST_F(StatePublisherTest, AsyncPollingIsThrottledWhenStreamingIsUnavailable) {
+  // GIVEN robot state streaming is requested, but the state client polls robot state because the robot cannot stream
+  fake_parameter_interface->stream_robot_state = true;
+  fake_parameter_interface->async_robot_state_polling = true;
+  fake_parameter_interface->async_robot_state_polling_rate = 20.0;
+  EXPECT_CALL(*mock_state_client_interface, isStreaming).WillRepeatedly(Return(false));
+  EXPECT_CALL(*mock_timer_interface, setTimer).Times(1);
+
+  // GIVEN the robot answers every request immediately with a newer state
+  std::atomic_int request_count{0};
+  EXPECT_CALL(*mock_state_client_interface, getRobotState).WillRepeatedly([&request_count] {
+    return tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true, 100 + request_count++)};
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew)
+      .Times(AnyNumber())
+      .WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_middleware_handle, publishRobotState).Times(AnyNumber());
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(AnyNumber());
+
+  // WHEN a robot_state_publisher is constructed and polls for half a second
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
+  std::this_thread::sleep_for(std::chrono::milliseconds{500});
+  robot_state_publisher.reset();
+
+  // THEN robot state is still requested no more often than the polling rate allows
+  EXPECT_GE(request_count.load(), 2);
+  EXPECT_LE(request_count.load(), 12);
+}
+
+TEST_F(StatePublisherTest, PublishCallbackRespectsOutputRates) {
+  // GIVEN the battery states are published at a very low rate, and the joint states for every robot state
+  fake_parameter_interface->robot_state_publish_rates[RobotStateOutput::BATTERY_STATES] = 0.001;
+  fake_parameter_interface->robot_state_publish_rates[RobotStateOutput::JOINT_STATES] = 0.0;
+
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillRepeatedly(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true)}));
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(2);
+
+  {
+    InSequence seq;
+    // THEN the first robot state is published to both topics
+    EXPECT_CALL(*mock_middleware_handle,
+                publishRobotState(AllOf(Field(&RobotStateMessages::maybe_battery_states, Optional(_)),
+                                        Field(&RobotStateMessages::maybe_joint_states, Optional(_)))))
+        .Times(1);
+    // THEN the second robot state is only published to the joint states topic, since the battery states are not due
+    EXPECT_CALL(*mock_middleware_handle,
+                publishRobotState(AllOf(Field(&RobotStateMessages::maybe_battery_states, Eq(std::nullopt)),
+                                        Field(&RobotStateMessages::maybe_joint_states, Optional(_)))))
+        .Times(1);
+  }
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
+
+  // WHEN the timer callback is triggered twice in quick succession
+  timer_interface_ptr->trigger();
+  timer_interface_ptr->trigger();
+}
+
+TEST_F(StatePublisherTest, PublishCallbackSkipsUnchangedStatus) {
+  // GIVEN status outputs are only published when they change, and the heartbeat will not elapse during the test
+  fake_parameter_interface->publish_status_on_change = true;
+  fake_parameter_interface->status_heartbeat_period = 1000.0;
+  fake_parameter_interface->robot_state_publish_rates[RobotStateOutput::ESTOP_STATES] = 0.0;
+
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(3);
+
+  // GIVEN the estop state is the same in the first two robot states, and changes in the third
+  auto changed_robot_state = makeRobotState(true);
+  auto* estop_state = changed_robot_state.add_estop_states();
+  estop_state->set_name("estop_name");
+  estop_state->set_state(bosdyn::api::EStopState::STATE_ESTOPPED);
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true)}))
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{makeRobotState(true)}))
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{changed_robot_state}));
+
+  {
+    InSequence seq;
+    // THEN the estop state is published with the first robot state
+    EXPECT_CALL(*mock_middleware_handle,
+                publishRobotState(Field(&RobotStateMessages::maybe_estop_states, Optional(_))))
+        .Times(1);
+    // THEN the estop state is not published with the second robot state, since it did not change
+    EXPECT_CALL(*mock_middleware_handle,
+                publishRobotState(Field(&RobotStateMessages::maybe_estop_states, Eq(std::nullopt))))
+        .Times(1);
+    // THEN the estop state is published again with the third robot state, since it changed
+    EXPECT_CALL(*mock_middleware_handle,
+                publishRobotState(Field(&RobotStateMessages::maybe_estop_states, Optional(_))))
+        .Times(1);
+  }
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
+
+  // WHEN the timer callback is triggered three times
+  timer_interface_ptr->trigger();
+  timer_interface_ptr->trigger();
+  timer_interface_ptr->trigger();
+}
+
+TEST_F(StatePublisherTest, RobotStateAtTimeServiceUsesHistory) {
+  using GetRobotStateAtTime = spot_msgs::srv::GetRobotStateAtTime;
+
+  // GIVEN the service which looks up the robot state at a time is created
+  std::function<void(const std::shared_ptr<GetRobotStateAtTime::Request>,
+                     std::shared_ptr<GetRobotStateAtTime::Response>)>
+      service_callback;
+  EXPECT_CALL(*mock_middleware_handle, createGetRobotStateAtTimeService).WillOnce(SaveArg<0>(&service_callback));
+
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillRepeatedly(Return(google::protobuf::Duration()));
+  // GIVEN the robot state acquired at 100 seconds contains joint states and the body pose
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{createRobotStateWithAllOutputs()}));
+
+  // GIVEN a robot_state_publisher which has received the robot state
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
+  timer_interface_ptr->trigger();
+  ASSERT_THAT(static_cast<bool>(service_callback), IsTrue());
+
+  // WHEN the state of the robot at the time of the robot state is requested
+  auto request = std::make_shared<GetRobotStateAtTime::Request>();
+  request->stamp.sec = 100;
+  auto response = std::make_shared<GetRobotStateAtTime::Response>();
+  service_callback(request, response);
+
+  // THEN the joint states and body pose of the robot state are returned
+  EXPECT_THAT(response->success, IsTrue());
+  EXPECT_THAT(response->joint_states.name.size(), Eq(kFriendlyJointNames.size()));
+  EXPECT_THAT(response->body_pose.pose.position.x, Eq(1.0));
+  // THEN the same robot state can be looked up directly in the history
+  EXPECT_THAT(robot_state_publisher->getRobotStateHistory()->getLatest().has_value(), IsTrue());
+
+  // WHEN the state of the robot after the latest robot state is requested
+  request->stamp.sec = 101;
+  service_callback(request, response);
+
+  // THEN the request fails
+  EXPECT_THAT(response->success, IsFalse());
+}
+
+TEST_F(StatePublisherTest, PublishesCompactJointStatesWhenEnabled) {
+  // GIVEN compact joint states are enabled
+  fake_parameter_interface->publish_compact_joint_states = true;
+
+  // THEN the names of the joints in the compact joint states are published once
+  EXPECT_CALL(*mock_middleware_handle,
+              publishJointNameManifest(Field(&spot_msgs::msg::JointNameManifest::name,
+                                             SizeIs(spot_msgs::msg::CompactJointState::JOINT_COUNT))))
+      .Times(1);
+
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{createRobotStateWithAllOutputs()}));
+  // THEN the compact joint states are published along with the joint states
+  EXPECT_CALL(*mock_middleware_handle,
+              publishRobotState(AllOf(Field(&RobotStateMessages::maybe_joint_states, Optional(_)),
+                                      Field(&RobotStateMessages::maybe_compact_joint_states, Optional(_)))))
+      .Times(1);
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
+
+  // WHEN the timer callback is triggered
+  timer_interface_ptr->trigger();
+}
+
+TEST_F(StatePublisherTest, DoesNotPublishCompactJointStatesByDefault) {
+  // GIVEN compact joint states are not enabled
+
+  // THEN the joint names manifest is never published
+  EXPECT_CALL(*mock_middleware_handle, publishJointNameManifest).Times(0);
+
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{createRobotStateWithAllOutputs()}));
+  // THEN only the joint states with names are published
+  EXPECT_CALL(*mock_middleware_handle,
+              publishRobotState(AllOf(Field(&RobotStateMessages::maybe_joint_states, Optional(_)),
+                                      Field(&RobotStateMessages::maybe_compact_joint_states, Eq(std::nullopt)))))
+      .Times(1);
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
+
+  // WHEN the timer callback is triggered
+  timer_interface_ptr->trigger();
+}
+
+TEST_F(StatePublisherTest, PublishesExtrapolatedBodyTf) {
+  // GIVEN the body pose is extrapolated at 100 Hz, far enough to cover the time this test takes
+  fake_parameter_interface->body_tf_extrapolation_rate = 100.0;
+  fake_parameter_interface->body_tf_extrapolation_horizon = 10.0;
+
+  // THEN both timers are set
+  auto* timer_interface_ptr = mock_timer_interface.get();
+  EXPECT_CALL(*timer_interface_ptr, setTimer).Times(1).WillOnce([&](Unused, const std::function<void()>& cb) {
+    timer_interface_ptr->onSetTimer(cb);
+  });
+  auto* tf_extrapolation_timer_interface_ptr = mock_tf_extrapolation_timer_interface.get();
+  EXPECT_CALL(*tf_extrapolation_timer_interface_ptr, setTimer(std::chrono::duration<double>{1.0 / 100.0}, _))
+      .Times(1)
+      .WillOnce([&](Unused, const std::function<void()>& cb) {
+        tf_extrapolation_timer_interface_ptr->onSetTimer(cb);
+      });
+
+  // GIVEN a robot state which was just acquired, in which the body is moving
+  auto robot_state = createRobotStateWithAllOutputs();
+  const auto now = std::chrono::system_clock::now().time_since_epoch();
+  robot_state.mutable_kinematic_state()->mutable_acquisition_timestamp()->set_seconds(
+      std::chrono::duration_cast<std::chrono::seconds>(now).count() - 1);
+  EXPECT_CALL(*mock_time_sync_api, getClockSkew).WillRepeatedly(Return(google::protobuf::Duration()));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .WillOnce(Return(tl::expected<bosdyn::api::RobotState, std::string>{robot_state}));
+  EXPECT_CALL(*mock_middleware_handle, publishRobotState).Times(1);
+  EXPECT_CALL(*mock_tf_broadcaster_interface, sendDynamicTransforms).Times(AnyNumber());
+  // THEN the extrapolated body pose is published to TF as a separate frame, in front of the measured body pose
+  EXPECT_CALL(*mock_tf_broadcaster_interface,
+              sendDynamicTransforms(ElementsAre(AllOf(
+                  Field(&geometry_msgs::msg::TransformStamped::child_frame_id, StrEq("body_extrapolated")),
+                  Field(&geometry_msgs::msg::TransformStamped::header,
+                        Field(&std_msgs::msg::Header::frame_id, StrEq("odom")))))))
+      .Times(1);
+
+  // GIVEN a robot_state_publisher
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
+
+  // WHEN the extrapolation timer is triggered before any robot state was received, and again after one was
+  tf_extrapolation_timer_interface_ptr->trigger();
+  timer_interface_ptr->trigger();
+  tf_extrapolation_timer_interface_ptr->trigger();
+}
+
+TEST_F(StatePublisherTest, DisablesBodyTfExtrapolationWhileStreaming) {
+  // GIVEN body TF extrapolation is enabled, and the state client streams robot state, which carries no body velocity
+  fake_parameter_interface->body_tf_extrapolation_rate = 100.0;
+  EXPECT_CALL(*mock_state_client_interface, isStreaming).WillRepeatedly(Return(true));
+  EXPECT_CALL(*mock_state_client_interface, getRobotState)
+      .Times(AnyNumber())
+      .WillRepeatedly(Return(tl::make_unexpected("No robot state")));
+  EXPECT_CALL(*mock_logger_interface, logError).Times(AnyNumber());
+  // THEN the timer is only used to report polling statistics
+  EXPECT_CALL(*mock_timer_interface, setTimer).Times(1);
+
+  // THEN the body pose is not extrapolated, and a warning says so
+  EXPECT_CALL(*mock_tf_extrapolation_timer_interface, setTimer).Times(0);
+  EXPECT_CALL(*mock_logger_interface, logWarn(HasSubstr("extrapolation"))).Times(1);
+
+  // WHEN a robot_state_publisher is constructed
+  robot_state_publisher = std::make_unique<StatePublisher>(
+      mock_state_client_interface, mock_time_sync_api, std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface));
+  robot_state_publisher.reset();
+}
 }  // namespace spot_ros2::test
@@ -1,6 +1,7 @@
 // Copyright (c) 2024 Boston Dynamics AI Institute LLC. All rights reserved.
 
 #include <gmock/gmock.h>
+#include <chrono>
 #include <exception>
 #include <memory>
 #include <rclcpp/node.hpp>
@@ -20,6 +21,7 @@
 
 namespace {
 using ::testing::_;
+using ::testing::AnyNumber;
 using ::testing::InSequence;
 using ::testing::Return;
 }  // namespace
@@ -35,6 +37,7 @@ class StatePublisherNodeTest : public ::testing::Test {
     mock_logger_interface = std::make_unique<MockLoggerInterface>();
     mock_tf_broadcaster_interface = std::make_unique<MockTfBroadcasterInterface>();
     mock_timer_interface = std::make_unique<MockTimerInterface>();
+    mock_tf_extrapolation_timer_interface = std::make_unique<MockTimerInterface>();
 
     mock_spot_api = std::make_unique<MockSpotApi>();
     mock_time_sync_api = std::make_unique<MockTimeSyncApi>();
@@ -46,6 +49,7 @@ class StatePublisherNodeTest : public ::testing::Test {
   std::unique_ptr<MockLoggerInterface> mock_logger_interface;
   std::unique_ptr<MockTfBroadcasterInterface> mock_tf_broadcaster_interface;
   std::unique_ptr<MockTimerInterface> mock_timer_interface;
+  std::unique_ptr<MockTimerInterface> mock_tf_extrapolation_timer_interface;
 
   std::unique_ptr<MockSpotApi> mock_spot_api;
   std::unique_ptr<MockTimeSyncApi> mock_time_sync_api;
@@ -71,10 +75,10 @@ TEST_F(StatePublisherNodeTest, ConstructionSuccessful) {
   EXPECT_CALL(*mock_logger_interface, logError).Times(0);
 
   // WHEN constructing a StatePublisherNodeTest
-  EXPECT_NO_THROW(StatePublisherNode(std::move(mock_node_interface), std::move(mock_spot_api),
-                                     std::move(mock_middleware_handle), std::move(fake_parameter_interface),
-                                     std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
-                                     std::move(mock_timer_interface)));
+  EXPECT_NO_THROW(StatePublisherNode(
+      std::move(mock_node_interface), std::move(mock_spot_api), std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface)));
 }
 
 TEST_F(StatePublisherNodeTest, ConstructionFailedCreateRobotFailure) {
@@ -99,7 +103,8 @@ TEST_F(StatePublisherNodeTest, ConstructionFailedCreateRobotFailure) {
   EXPECT_THROW(
       StatePublisherNode(std::move(mock_node_interface), std::move(mock_spot_api), std::move(mock_middleware_handle),
                          std::move(fake_parameter_interface), std::move(mock_logger_interface),
-                         std::move(mock_tf_broadcaster_interface), std::move(mock_timer_interface)),
+                         std::move(mock_tf_broadcaster_interface), std::move(mock_timer_interface),
+                         std::move(mock_tf_extrapolation_timer_interface)),
       std::exception);
 }
 
@@ -125,8 +130,59 @@ TEST_F(StatePublisherNodeTest, ConstructionFailedAuthenticateFailure) {
   EXPECT_THROW(
       StatePublisherNode(std::move(mock_node_interface), std::move(mock_spot_api), std::move(mock_middleware_handle),
                          std::move(fake_parameter_interface), std::move(mock_logger_interface),
-                         std::move(mock_tf_broadcaster_interface), std::move(mock_timer_interface)),
+                         std::move(mock_tf_broadcaster_interface), std::move(mock_timer_interface),
+                         std::move(mock_tf_extrapolation_timer_interface)),
       std::exception);
 }
 
+TEST_F(StatePublisherNodeTest, ConstructionUsesStreamingStateClient) {
+  // GIVEN robot state streaming is requested and the Spot API provides a streaming state client
+  fake_parameter_interface->stream_robot_state = true;
+  const auto streaming_state_client = std::make_shared<MockStateClient>();
+  EXPECT_CALL(*streaming_state_client, isStreaming).WillRepeatedly(Return(true));
+  EXPECT_CALL(*streaming_state_client, getRobotState)
+      .Times(AnyNumber())
+      .WillRepeatedly(Return(tl::make_unexpected("No robot state")));
+  EXPECT_CALL(*mock_logger_interface, logError).Times(AnyNumber());
+
+  // THEN the streaming state client is used instead of the polled state client
+  EXPECT_CALL(*mock_spot_api, streamingStateClientInterface).Times(1).WillOnce(Return(streaming_state_client));
+  EXPECT_CALL(*mock_spot_api, stateClientInterface).Times(0);
+  EXPECT_CALL(*mock_spot_api, timeSyncInterface).Times(1);
+
+  // THEN no warnings are logged
+  EXPECT_CALL(*mock_logger_interface, logWarn).Times(0);
+
+  // WHEN constructing a StatePublisherNode
+  EXPECT_NO_THROW(StatePublisherNode(
+      std::move(mock_node_interface), std::move(mock_spot_api), std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface)));
+}
+
+TEST_F(StatePublisherNodeTest, ConstructionFallsBackToPolledStateClient) {
+  // GIVEN robot state streaming is requested but the Spot API cannot provide a streaming state client
+  fake_parameter_interface->stream_robot_state = true;
+  EXPECT_CALL(*mock_spot_api, streamingStateClientInterface).Times(1).WillOnce(Return(nullptr));
+  const auto state_client = std::make_shared<MockStateClient>();
+  EXPECT_CALL(*state_client, isStreaming).WillRepeatedly(Return(false));
+  EXPECT_CALL(*state_client, getRobotState)
+      .Times(AnyNumber())
+      .WillRepeatedly(Return(tl::make_unexpected("No robot state")));
+  EXPECT_CALL(*mock_logger_interface, logError).Times(AnyNumber());
+
+  // THEN a warning is logged
+  EXPECT_CALL(*mock_logger_interface, logWarn).Times(1);
+  // THEN the polled state client is used instead
+  EXPECT_CALL(*mock_spot_api, stateClientInterface).Times(1).WillOnce(Return(state_client));
+  EXPECT_CALL(*mock_spot_api, timeSyncInterface).Times(1);
+  // THEN robot state is polled by the timer at its usual rate, as if streaming had not been requested
+  EXPECT_CALL(*mock_timer_interface, setTimer(std::chrono::duration<double>{1.0 / 50.0}, _)).Times(1);
+
+  // WHEN constructing a StatePublisherNode
+  EXPECT_NO_THROW(StatePublisherNode(
+      std::move(mock_node_interface), std::move(mock_spot_api), std::move(mock_middleware_handle),
+      std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+      std::move(mock_timer_interface), std::move(mock_tf_extrapolation_timer_interface)));
+}
 }  // namespace spot_ros2::test
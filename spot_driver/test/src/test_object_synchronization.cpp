@@ -13,12 +13,14 @@
 #include <rcl/time.h>
 #include <geometry_msgs/msg/detail/transform_stamped__struct.hpp>
 #include <geometry_msgs/msg/transform_stamped.hpp>
+#include <map>
 #include <memory>
 #include <rclcpp/time.hpp>
 #include <spot_driver/fake/fake_parameter_interface.hpp>
 #include <spot_driver/mock/mock_clock_interface.hpp>
 #include <spot_driver/mock/mock_logger_interface.hpp>
 #include <spot_driver/mock/mock_node_interface.hpp>
+#include <spot_driver/mock/mock_object_sync_middleware_handle.hpp>
 #include <spot_driver/mock/mock_state_client.hpp>
 #include <spot_driver/mock/mock_state_publisher_middleware_handle.hpp>
 #include <spot_driver/mock/mock_tf_broadcaster_interface.hpp>
@@ -30,9 +32,15 @@
 #include <spot_driver/robot_state_test_tools.hpp>
 #include <spot_driver/serialization.hpp>
 #include <spot_driver/types.hpp>
+#include <spot_msgs/msg/world_object.hpp>
+#include <spot_msgs/msg/world_object_array.hpp>
+#include <spot_msgs/msg/world_object_detection_array.hpp>
+#include <spot_msgs/srv/list_cached_world_objects.hpp>
+#include <string>
 #include <tf2_msgs/msg/tf_message.hpp>
 #include <tl_expected/expected.hpp>
 #include <utility>
+#include <vector>
 
 namespace {
 using ::testing::_;
@@ -112,24 +120,30 @@ class ObjectSynchronizerForTesting : public ObjectSynchronizer {
  public:
   ObjectSynchronizerForTesting(const std::shared_ptr<WorldObjectClientInterface>& world_object_client_interface,
                                const std::shared_ptr<TimeSyncApi>& time_sync_api,
+                               std::unique_ptr<MiddlewareHandle> middleware_handle,
                                std::unique_ptr<ParameterInterfaceBase> parameter_interface,
                                std::unique_ptr<LoggerInterfaceBase> logger_interface,
                                std::unique_ptr<TfBroadcasterInterfaceBase> tf_broadcaster_interface,
                                std::unique_ptr<TfListenerInterfaceBase> tf_listener_interface,
                                std::unique_ptr<TimerInterfaceBase> world_object_update_timer,
                                std::unique_ptr<TimerInterfaceBase> tf_broadcaster_timer,
+                               std::unique_ptr<TimerInterfaceBase> detection_timer,
                                std::unique_ptr<ClockInterfaceBase> clock_interface)
       : ObjectSynchronizer{world_object_client_interface,
                            time_sync_api,
+                           std::move(middleware_handle),
                            std::move(parameter_interface),
                            std::move(logger_interface),
                            std::move(tf_broadcaster_interface),
                            std::move(tf_listener_interface),
                            std::move(world_object_update_timer),
                            std::move(tf_broadcaster_timer),
+                           std::move(detection_timer),
                            std::move(clock_interface)} {}
 
   void addManagedFrame(const std::string& frame_id) { ObjectSynchronizer::addManagedFrame(frame_id); }
+
+  void syncWorldObjects() { ObjectSynchronizer::syncWorldObjects(); }
 };
 
 class ObjectSynchronizerTest : public ::testing::Test {
@@ -141,27 +155,31 @@ class ObjectSynchronizerTest : public ::testing::Test {
     fake_parameter_interface = std::make_unique<FakeParameterInterface>();
     fake_parameter_interface->spot_name = "MyRobot";
 
+    mock_middleware_handle = std::make_unique<MockObjectSyncMiddlewareHandle>();
     mock_logger_interface = std::make_unique<MockLoggerInterface>();
     mock_tf_broadcaster_interface = std::make_unique<MockTfBroadcasterInterface>();
     mock_tf_listener_interface = std::make_unique<MockTfListenerInterface>();
     mock_world_object_update_timer = std::make_unique<MockTimerInterface>();
     mock_tf_broadcaster_timer = std::make_unique<MockTimerInterface>();
+    mock_detection_timer = std::make_unique<MockTimerInterface>();
     mock_clock_interface = std::make_unique<MockClockInterface>();
 
+    mock_middleware_handle_ptr = mock_middleware_handle.get();
     mock_logger_interface_ptr = mock_logger_interface.get();
     mock_tf_broadcaster_interface_ptr = mock_tf_broadcaster_interface.get();
     mock_tf_listener_interface_ptr = mock_tf_listener_interface.get();
     mock_world_object_update_timer_ptr = mock_world_object_update_timer.get();
     mock_tf_broadcaster_timer_ptr = mock_tf_broadcaster_timer.get();
+    mock_detection_timer_ptr = mock_detection_timer.get();
     mock_clock_interface_ptr = mock_clock_interface.get();
   }
 
   void createObjectSynchronizer() {
     object_synchronizer = std::make_unique<ObjectSynchronizerForTesting>(
-        mock_world_object_client, mock_time_sync_api, std::move(fake_parameter_interface),
-        std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
+        mock_world_object_client, mock_time_sync_api, std::move(mock_middleware_handle),
+        std::move(fake_parameter_interface), std::move(mock_logger_interface), std::move(mock_tf_broadcaster_interface),
         std::move(mock_tf_listener_interface), std::move(mock_world_object_update_timer),
-        std::move(mock_tf_broadcaster_timer), std::move(mock_clock_interface));
+        std::move(mock_tf_broadcaster_timer), std::move(mock_detection_timer), std::move(mock_clock_interface));
   }
 
   void registerTimerCallbacks() const {
@@ -172,6 +190,10 @@ class ObjectSynchronizerTest : public ::testing::Test {
     ON_CALL(*mock_tf_broadcaster_timer_ptr, setTimer).WillByDefault([&](Unused, const std::function<void()>& cb) {
       mock_tf_broadcaster_timer_ptr->onSetTimer(cb);
     });
+
+    ON_CALL(*mock_detection_timer_ptr, setTimer).WillByDefault([&](Unused, const std::function<void()>& cb) {
+      mock_detection_timer_ptr->onSetTimer(cb);
+    });
   }
 
   std::shared_ptr<MockWorldObjectClient> mock_world_object_client;
@@ -180,37 +202,41 @@ class ObjectSynchronizerTest : public ::testing::Test {
   std::unique_ptr<FakeParameterInterface> fake_parameter_interface;
 
   // Don't attempt to access these after createObjectSynchronizer() is called, since they get moved in that function
+  std::unique_ptr<MockObjectSyncMiddlewareHandle> mock_middleware_handle;
   std::unique_ptr<MockLoggerInterface> mock_logger_interface;
   std::unique_ptr<MockTfBroadcasterInterface> mock_tf_broadcaster_interface;
   std::unique_ptr<MockTfListenerInterface> mock_tf_listener_interface;
   std::unique_ptr<MockTimerInterface> mock_world_object_update_timer;
   std::unique_ptr<MockTimerInterface> mock_tf_broadcaster_timer;
+  std::unique_ptr<MockTimerInterface> mock_detection_timer;
   std::unique_ptr<MockClockInterface> mock_clock_interface;
 
   // Use these pointers to interact with the mocks during tests
+  MockObjectSyncMiddlewareHandle* mock_middleware_handle_ptr = nullptr;
   MockLoggerInterface* mock_logger_interface_ptr = nullptr;
   MockTfBroadcasterInterface* mock_tf_broadcaster_interface_ptr = nullptr;
   MockTfListenerInterface* mock_tf_listener_interface_ptr = nullptr;
   MockTimerInterface* mock_world_object_update_timer_ptr = nullptr;
   MockTimerInterface* mock_tf_broadcaster_timer_ptr = nullptr;
+  MockTimerInterface* mock_detection_timer_ptr = nullptr;
   MockClockInterface* mock_clock_interface_ptr = nullptr;
 
   std::unique_ptr<ObjectSynchronizerForTesting> object_synchronizer;
 };
 
 TEST_F(ObjectSynchronizerTest, InitSucceeds) {
-  // THEN the timer interface's setTimer function is called once with the expected timer period
-  EXPECT_CALL(*mock_world_object_update_timer_ptr, setTimer(std::chrono::duration<double>{1.0}, _));
+  // THEN the world object update timer is not set, since it only syncs world objects on TF updates if enabled
+  EXPECT_CALL(*mock_world_object_update_timer, setTimer).Times(0);
+  // THEN the TF broadcaster timer's setTimer function is called once with the expected timer period
   EXPECT_CALL(*mock_tf_broadcaster_timer, setTimer(std::chrono::duration<double>{0.1}, _));
+  // THEN the detection timer is not set, since polling for detections is disabled by default
+  EXPECT_CALL(*mock_detection_timer, setTimer).Times(0);
 
   // WHEN the ObjectSynchronizer is created
   createObjectSynchronizer();
 }
 
 TEST_F(ObjectSynchronizerTest, AddFrameAsWorldObject) {
-  // GIVEN the timer interface's setTimer function registers the internal callback function
-  registerTimerCallbacks();
-
   ON_CALL(*mock_clock_interface_ptr, now).WillByDefault(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}));
 
   // GIVEN the TF listener has info about two frames. One frame is an internal Spot frame, and the other frame is from a
@@ -255,17 +281,14 @@ TEST_F(ObjectSynchronizerTest, AddFrameAsWorldObject) {
   // GIVEN before the callback to sync world objects is triggered, the ObjectSynchronizer has no managed frames
   ASSERT_THAT(object_synchronizer->getManagedFrames(), IsEmpty());
 
-  // WHEN the timer callback is triggered
-  mock_world_object_update_timer_ptr->trigger();
+  // WHEN the world objects are synced
+  object_synchronizer->syncWorldObjects();
 
   // THEN the ObjectSynchronizer is managing a single frame matching the external frame ID which was published via TF.
   EXPECT_THAT(object_synchronizer->getManagedFrames(), AllOf(SizeIs(1), Contains(kExternalFrameId)));
 }
 
 TEST_F(ObjectSynchronizerTest, ModifyFrameForExistingWorldObject) {
-  // GIVEN the timer interface's setTimer function registers the internal callback function to sync the world objects
-  registerTimerCallbacks();
-
   ON_CALL(*mock_clock_interface_ptr, now).WillByDefault(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}));
 
   // GIVEN the TF listener has info about two frames. One frame is an internal Spot frame, and the other frame is from a
@@ -319,17 +342,131 @@ TEST_F(ObjectSynchronizerTest, ModifyFrameForExistingWorldObject) {
   // GIVEN before the callback to sync world objects is triggered, the ObjectSynchronizer has no managed frames
   EXPECT_THAT(object_synchronizer->getManagedFrames(), IsEmpty());
 
-  // WHEN the timer callback is triggered
-  mock_world_object_update_timer_ptr->trigger();
+  // WHEN the world objects are synced
+  object_synchronizer->syncWorldObjects();
 
   // THEN the ObjectSynchronizer is managing the single non-Spot frame which the TF listener has info about
   EXPECT_THAT(object_synchronizer->getManagedFrames(), AllOf(SizeIs(1), Contains(kExternalFrameId)));
 }
 
-TEST_F(ObjectSynchronizerTest, TfLookupError) {
-  // GIVEN the timer interface's setTimer function registers the internal callback function
+TEST_F(ObjectSynchronizerTest, ModifyFrameOnlyIfMovedOrAboutToExpire) {
+  // GIVEN the world objects are synced five times, at the following times
+  EXPECT_CALL(*mock_clock_interface_ptr, now)
+      .WillOnce(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}))
+      .WillOnce(Return(rclcpp::Time{1, 0, RCL_ROS_TIME}))
+      .WillOnce(Return(rclcpp::Time{2, 0, RCL_ROS_TIME}))
+      .WillOnce(Return(rclcpp::Time{3, 0, RCL_ROS_TIME}))
+      .WillOnce(Return(rclcpp::Time{5, 500000000, RCL_ROS_TIME}));
+
+  // GIVEN the TF listener has info about one frame from a non-Spot source
+  ON_CALL(*mock_tf_listener_interface_ptr, getAllFrameNames)
+      .WillByDefault(Return(std::vector<std::string>{kExternalFrameId}));
+
+  // GIVEN the frame does not move between the first two syncs, then moves by half a meter, then by a millimeter, and
+  // then stays put
+  geometry_msgs::msg::TransformStamped moved_half_meter;
+  moved_half_meter.transform.translation.x = 0.5;
+  geometry_msgs::msg::TransformStamped moved_one_millimeter = moved_half_meter;
+  moved_one_millimeter.transform.translation.x = 0.501;
+  EXPECT_CALL(*mock_tf_listener_interface_ptr, lookupTransform("MyRobot/odom", kExternalFrameId, _))
+      .WillOnce(Return(geometry_msgs::msg::TransformStamped{}))
+      .WillOnce(Return(geometry_msgs::msg::TransformStamped{}))
+      .WillOnce(Return(moved_half_meter))
+      .WillOnce(Return(moved_one_millimeter))
+      .WillOnce(Return(moved_one_millimeter));
+
+  // GIVEN Spot's list of world objects includes a mutable object for the frame
+  ::bosdyn::api::ListWorldObjectResponse list_immutable_objects_response;
+  ::bosdyn::api::ListWorldObjectResponse list_mutable_objects;
+  auto* object = list_mutable_objects.add_world_objects();
+  *object->mutable_name() = kExternalFrameId;
+  object->set_id(100);
+  addRootFrame(object->mutable_transforms_snapshot(), "odom");
+  addTransform(object->mutable_transforms_snapshot(), kExternalFrameId, "odom", 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+  {
+    InSequence seq;
+    for (int ndx = 0; ndx < 5; ++ndx) {
+      EXPECT_CALL(*mock_world_object_client, listWorldObjects)
+          .WillOnce(Return(list_immutable_objects_response))
+          .WillOnce(Return(list_mutable_objects))
+          .RetiresOnSaturation();
+    }
+  }
+
+  // THEN the object is modified on the first sync, once the frame moved by half a meter, and once the object is about
+  // to expire, but not when the frame did not move or only moved by less than the threshold
+  EXPECT_CALL(*mock_world_object_client, mutateWorldObject(MutationChangesObject()))
+      .Times(3)
+      .WillRepeatedly(
+          Return(tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>{kMutateObjectResponseSuccess}));
+
+  EXPECT_CALL(*mock_logger_interface_ptr, logWarn).Times(0);
+  EXPECT_CALL(*mock_logger_interface_ptr, logError).Times(0);
+
+  // GIVEN the ObjectSynchronizer has been created
+  // Note: for this test, this must only be called after registering all expected calls with the mocks
+  createObjectSynchronizer();
+
+  // WHEN the world objects are synced five times
+  for (int ndx = 0; ndx < 5; ++ndx) {
+    object_synchronizer->syncWorldObjects();
+  }
+
+  // THEN the ObjectSynchronizer is managing the frame
+  EXPECT_THAT(object_synchronizer->getManagedFrames(), AllOf(SizeIs(1), Contains(kExternalFrameId)));
+}
+
+TEST_F(ObjectSynchronizerTest, SyncOnlyFramesWithTfUpdates) {
+  // GIVEN world objects are synced only for frames which receive new transforms
+  fake_parameter_interface->world_object_sync_on_tf_updates = true;
   registerTimerCallbacks();
 
+  // THEN the TF listener starts tracking updated frames, and the updates are coalesced over a short window
+  EXPECT_CALL(*mock_tf_listener_interface_ptr, startTrackingUpdatedFrames);
+  EXPECT_CALL(*mock_world_object_update_timer_ptr, setTimer(std::chrono::duration<double>{0.2}, _));
+
+  const rclcpp::Time update_stamp{5, 0, RCL_ROS_TIME};
+  ON_CALL(*mock_clock_interface_ptr, now).WillByDefault(Return(update_stamp));
+
+  // GIVEN one frame from a non-Spot source received new transforms before the first sync, and none before the second
+  EXPECT_CALL(*mock_tf_listener_interface_ptr, takeUpdatedFrames)
+      .WillOnce(Return(std::map<std::string, rclcpp::Time>{{kExternalFrameId, update_stamp}}))
+      .WillOnce(Return(std::map<std::string, rclcpp::Time>{}));
+
+  // THEN the TF tree is not polled for all frames
+  EXPECT_CALL(*mock_tf_listener_interface_ptr, getAllFrameNames).Times(0);
+
+  // THEN the updated frame is looked up once, at the stamp of its latest transform
+  EXPECT_CALL(*mock_tf_listener_interface_ptr, lookupTransform("MyRobot/odom", kExternalFrameId, update_stamp))
+      .WillOnce(Return(
+          tl::expected<geometry_msgs::msg::TransformStamped, std::string>{geometry_msgs::msg::TransformStamped{}}));
+
+  // THEN world objects are only listed for the sync which had a frame to update
+  ::bosdyn::api::ListWorldObjectResponse list_objects_response;
+  EXPECT_CALL(*mock_world_object_client, listWorldObjects).Times(2).WillRepeatedly(Return(list_objects_response));
+
+  // THEN one request is sent to add a world object for the updated frame
+  EXPECT_CALL(*mock_world_object_client,
+              mutateWorldObject(AllOf(MutationAddsObject(), MutationTargetsObjectWhoseNameIs(kExternalFrameId))))
+      .WillOnce(
+          Return(tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>{kMutateObjectResponseSuccess}));
+
+  EXPECT_CALL(*mock_logger_interface_ptr, logWarn).Times(0);
+  EXPECT_CALL(*mock_logger_interface_ptr, logError).Times(0);
+
+  // GIVEN the ObjectSynchronizer has been created
+  // Note: for this test, this must only be called after registering all expected calls with the mocks
+  createObjectSynchronizer();
+
+  // WHEN the timer callback is triggered twice
+  mock_world_object_update_timer_ptr->trigger();
+  mock_world_object_update_timer_ptr->trigger();
+
+  // THEN the ObjectSynchronizer is managing the updated frame
+  EXPECT_THAT(object_synchronizer->getManagedFrames(), AllOf(SizeIs(1), Contains(kExternalFrameId)));
+}
+
+TEST_F(ObjectSynchronizerTest, TfLookupError) {
   ON_CALL(*mock_clock_interface_ptr, now).WillByDefault(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}));
 
   // GIVEN the TF listener has info about one frame from a non-Spot source
@@ -355,17 +492,14 @@ TEST_F(ObjectSynchronizerTest, TfLookupError) {
   // GIVEN the ObjectSynchronizer has been created
   createObjectSynchronizer();
 
-  // WHEN the timer callback is triggered
-  mock_world_object_update_timer_ptr->trigger();
+  // WHEN the world objects are synced
+  object_synchronizer->syncWorldObjects();
 
   // THEN the ObjectSynchronizer is not managing any frames after the update
   EXPECT_THAT(object_synchronizer->getManagedFrames(), IsEmpty());
 }
 
 TEST_F(ObjectSynchronizerTest, ListImmutableObjectsError) {
-  // GIVEN the timer interface's setTimer function registers the internal callback function
-  registerTimerCallbacks();
-
   ON_CALL(*mock_clock_interface_ptr, now).WillByDefault(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}));
 
   // GIVEN the TF listener has info about one frame from a non-Spot source
@@ -393,17 +527,14 @@ TEST_F(ObjectSynchronizerTest, ListImmutableObjectsError) {
   // Note: for this test, this must only be called after registering all expected calls with the mocks
   createObjectSynchronizer();
 
-  // WHEN the timer callback is triggered
-  mock_world_object_update_timer_ptr->trigger();
+  // WHEN the world objects are synced
+  object_synchronizer->syncWorldObjects();
 
   // THEN the ObjectSynchronizer is not managing any frames
   EXPECT_THAT(object_synchronizer->getManagedFrames(), IsEmpty());
 }
 
 TEST_F(ObjectSynchronizerTest, ListMutableObjectsError) {
-  // GIVEN the timer interface's setTimer function registers the internal callback function
-  registerTimerCallbacks();
-
   ON_CALL(*mock_clock_interface_ptr, now).WillByDefault(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}));
 
   // GIVEN the TF listener has info about one frame from a non-Spot source
@@ -438,17 +569,14 @@ TEST_F(ObjectSynchronizerTest, ListMutableObjectsError) {
   // GIVEN the ObjectSynchronizer has been created
   createObjectSynchronizer();
 
-  // WHEN the timer callback is triggered
-  mock_world_object_update_timer_ptr->trigger();
+  // WHEN the world objects are synced
+  object_synchronizer->syncWorldObjects();
 
   // THEN the ObjectSynchronizer is not managing any frames
   EXPECT_THAT(object_synchronizer->getManagedFrames(), IsEmpty());
 }
 
 TEST_F(ObjectSynchronizerTest, MutateObjectsError) {
-  // GIVEN the timer interface's setTimer function registers the internal callback function
-  registerTimerCallbacks();
-
   ON_CALL(*mock_clock_interface_ptr, now).WillByDefault(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}));
 
   // GIVEN the TF listener has info about one frame from a non-Spot source
@@ -476,13 +604,65 @@ TEST_F(ObjectSynchronizerTest, MutateObjectsError) {
   // Note: for this test, this must only be called after registering all expected calls with the mocks
   createObjectSynchronizer();
 
-  // WHEN the timer callback is triggered
-  mock_world_object_update_timer_ptr->trigger();
+  // WHEN the world objects are synced
+  object_synchronizer->syncWorldObjects();
 
   // THEN the ObjectSynchronizer is not managing any frames
   EXPECT_THAT(object_synchronizer->getManagedFrames(), IsEmpty());
 }
 
+TEST_F(ObjectSynchronizerTest, AddMoreFramesThanMutationsInFlight) {
+  ON_CALL(*mock_clock_interface_ptr, now).WillByDefault(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}));
+
+  // GIVEN the TF listener has info about more frames from non-Spot sources than requests may be in flight at once
+  std::vector<std::string> external_frame_ids;
+  for (int ndx = 0; ndx < 20; ++ndx) {
+    external_frame_ids.push_back("external_frame_" + std::to_string(ndx));
+  }
+  ON_CALL(*mock_tf_listener_interface_ptr, getAllFrameNames).WillByDefault(Return(external_frame_ids));
+
+  // GIVEN the TF listener will return identity transforms
+  ON_CALL(*mock_tf_listener_interface_ptr, lookupTransform)
+      .WillByDefault(Return(
+          tl::expected<geometry_msgs::msg::TransformStamped, std::string>{geometry_msgs::msg::TransformStamped{}}));
+
+  // GIVEN requesting info about world objects always succeeds
+  ::bosdyn::api::ListWorldObjectResponse list_objects_response;
+  ON_CALL(*mock_world_object_client, listWorldObjects).WillByDefault(Return(list_objects_response));
+
+  // THEN one request is sent to add a world object for each frame, all of which succeed
+  EXPECT_CALL(*mock_world_object_client, mutateWorldObject(MutationAddsObject()))
+      .Times(20)
+      .WillRepeatedly(
+          Return(tl::expected<::bosdyn::api::MutateWorldObjectResponse, std::string>{kMutateObjectResponseSuccess}));
+
+  EXPECT_CALL(*mock_logger_interface_ptr, logWarn).Times(0);
+  EXPECT_CALL(*mock_logger_interface_ptr, logError).Times(0);
+
+  // GIVEN the ObjectSynchronizer has been created
+  // Note: for this test, this must only be called after registering all expected calls with the mocks
+  createObjectSynchronizer();
+
+  // WHEN the world objects are synced
+  object_synchronizer->syncWorldObjects();
+
+  // THEN the responses to all requests are collected, and the ObjectSynchronizer is managing every frame
+  EXPECT_THAT(object_synchronizer->getManagedFrames(), SizeIs(20));
+}
+
+TEST_F(ObjectSynchronizerTest, ManagedFramesKeepTheirFrameIds) {
+  // GIVEN the ObjectSynchronizer has been created
+  createObjectSynchronizer();
+
+  // WHEN frames are added as managed frames by TF frame IDs with and without the robot's prefix
+  object_synchronizer->addManagedFrame("MyRobot/my_object");
+  object_synchronizer->addManagedFrame(kExternalFrameId);
+
+  // THEN the managed frames are listed by the frame IDs they were added by
+  EXPECT_THAT(object_synchronizer->getManagedFrames(),
+              UnorderedElementsAre(StrEq("MyRobot/my_object"), StrEq(kExternalFrameId)));
+}
+
 TEST_F(ObjectSynchronizerTest, PublishWorldObjectTransforms) {
   // GIVEN the callback to broadcast TF data has been registered with the appropriate timer
   registerTimerCallbacks();
@@ -529,4 +709,200 @@ TEST_F(ObjectSynchronizerTest, PublishWorldObjectTransforms) {
   // WHEN the timer callback to broadcast TF data is triggered
   mock_tf_broadcaster_timer_ptr->trigger();
 }
+
+TEST_F(ObjectSynchronizerTest, RebroadcastUnchangedWorldObjectTransforms) {
+  // GIVEN the callback to broadcast TF data has been registered with the appropriate timer
+  registerTimerCallbacks();
+
+  // GIVEN Spot's WorldObject API will report a dock, which is not updated afterwards
+  ::bosdyn::api::ListWorldObjectResponse list_objects_response;
+  auto* object_dock = list_objects_response.add_world_objects();
+  *object_dock->mutable_name() = "dock";
+  object_dock->set_id(99);
+  object_dock->mutable_acquisition_time()->set_seconds(100);
+  object_dock->mutable_dock_properties()->set_dock_id(100);
+  addRootFrame(object_dock->mutable_transforms_snapshot(), "odom");
+  addTransform(object_dock->mutable_transforms_snapshot(), "dock", "odom", 1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+  auto* world_object_client_interface_ptr = mock_world_object_client.get();
+  {
+    InSequence seq;
+    // THEN all world objects are listed first
+    EXPECT_CALL(*world_object_client_interface_ptr,
+                listWorldObjects(Property(&::bosdyn::api::ListWorldObjectRequest::has_timestamp_filter, Eq(false))))
+        .WillOnce(Return(list_objects_response));
+    // THEN afterwards only the world objects acquired after the dock are listed
+    EXPECT_CALL(*world_object_client_interface_ptr,
+                listWorldObjects(Property(&::bosdyn::api::ListWorldObjectRequest::timestamp_filter,
+                                          Property(&google::protobuf::Timestamp::seconds, Eq(100)))))
+        .WillOnce(Return(::bosdyn::api::ListWorldObjectResponse{}));
+  }
+
+  // THEN the transform of the dock is broadcast on both ticks, even though it was only listed once
+  EXPECT_CALL(*mock_tf_broadcaster_interface_ptr,
+              sendDynamicTransforms(AllOf(
+                  SizeIs(1), Contains(Field("child_frame_id", &geometry_msgs::msg::TransformStamped::child_frame_id,
+                                            StrEq("MyRobot/dock"))))))
+      .Times(2);
+
+  // GIVEN the ObjectSynchronizer has been created
+  createObjectSynchronizer();
+
+  // WHEN the timer callback to broadcast TF data is triggered twice
+  mock_tf_broadcaster_timer_ptr->trigger();
+  mock_tf_broadcaster_timer_ptr->trigger();
+}
+
+TEST_F(ObjectSynchronizerTest, PublishAndListCachedWorldObjects) {
+  // GIVEN the callback to broadcast TF data has been registered with the appropriate timer
+  registerTimerCallbacks();
+
+  // GIVEN the callback of the service to list cached world objects is captured
+  std::function<void(const std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Request>,
+                     std::shared_ptr<spot_msgs::srv::ListCachedWorldObjects::Response>)>
+      list_cached_world_objects;
+  EXPECT_CALL(*mock_middleware_handle_ptr, createListCachedWorldObjectsService).WillOnce([&](auto callback) {
+    list_cached_world_objects = callback;
+  });
+
+  // GIVEN Spot's WorldObject API will report a fiducial and a dock, which are not updated afterwards
+  ::bosdyn::api::ListWorldObjectResponse list_objects_response;
+  auto* object_fiducial = list_objects_response.add_world_objects();
+  *object_fiducial->mutable_name() = "world_obj_apriltag_3";
+  object_fiducial->set_id(98);
+  object_fiducial->mutable_acquisition_time()->set_seconds(90);
+  object_fiducial->mutable_apriltag_properties()->set_tag_id(3);
+  *object_fiducial->mutable_apriltag_properties()->mutable_frame_name_fiducial() = "fiducial_3";
+  addRootFrame(object_fiducial->mutable_transforms_snapshot(), "odom");
+  addTransform(object_fiducial->mutable_transforms_snapshot(), "fiducial_3", "odom", 1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+
+  auto* object_dock = list_objects_response.add_world_objects();
+  *object_dock->mutable_name() = "dock";
+  object_dock->set_id(99);
+  object_dock->mutable_acquisition_time()->set_seconds(100);
+  object_dock->mutable_dock_properties()->set_dock_id(520);
+  addRootFrame(object_dock->mutable_transforms_snapshot(), "odom");
+  addTransform(object_dock->mutable_transforms_snapshot(), "dock", "odom", 1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+  auto* world_object_client_interface_ptr = mock_world_object_client.get();
+  EXPECT_CALL(*world_object_client_interface_ptr, listWorldObjects)
+      .WillOnce(Return(list_objects_response))
+      .WillOnce(Return(::bosdyn::api::ListWorldObjectResponse{}));
+
+  // THEN the cached world objects are only published once, since the second listing does not change the cache
+  spot_msgs::msg::WorldObjectArray published_world_objects;
+  EXPECT_CALL(*mock_middleware_handle_ptr, publishWorldObjects).WillOnce([&](const auto& world_objects) {
+    published_world_objects = world_objects;
+  });
+
+  // GIVEN the ObjectSynchronizer has been created
+  createObjectSynchronizer();
+  ASSERT_TRUE(list_cached_world_objects);
+
+  // WHEN the timer callback to broadcast TF data is triggered twice
+  mock_tf_broadcaster_timer_ptr->trigger();
+  mock_tf_broadcaster_timer_ptr->trigger();
+
+  // THEN both objects were published with their types and prefixed frame names
+  ASSERT_THAT(published_world_objects.world_objects, SizeIs(2));
+  EXPECT_THAT(published_world_objects.world_objects[0].type, Eq(spot_msgs::msg::WorldObject::TYPE_APRILTAG));
+  EXPECT_THAT(published_world_objects.world_objects[0].tag_id, Eq(3));
+  EXPECT_THAT(published_world_objects.world_objects[0].frame_name_fiducial, StrEq("MyRobot/fiducial_3"));
+  EXPECT_THAT(published_world_objects.world_objects[1].type, Eq(spot_msgs::msg::WorldObject::TYPE_DOCK));
+  EXPECT_THAT(published_world_objects.world_objects[1].dock_id, Eq(520U));
+
+  // WHEN the cached world objects are listed, filtered by type
+  auto request = std::make_shared<spot_msgs::srv::ListCachedWorldObjects::Request>();
+  request->object_types.push_back(spot_msgs::msg::WorldObject::TYPE_DOCK);
+  auto response = std::make_shared<spot_msgs::srv::ListCachedWorldObjects::Response>();
+  list_cached_world_objects(request, response);
+  // THEN only the dock is listed
+  ASSERT_THAT(response->world_objects.world_objects, SizeIs(1));
+  EXPECT_THAT(response->world_objects.world_objects[0].id, Eq(99));
+
+  // WHEN the cached world objects are listed without filters
+  response = std::make_shared<spot_msgs::srv::ListCachedWorldObjects::Response>();
+  list_cached_world_objects(std::make_shared<spot_msgs::srv::ListCachedWorldObjects::Request>(), response);
+  // THEN both objects are listed
+  EXPECT_THAT(response->world_objects.world_objects, SizeIs(2));
+}
+
+TEST_F(ObjectSynchronizerTest, PublishNewerFiducialAndDockDetections) {
+  // GIVEN polling for detections of fiducials and docks is enabled at 20 Hz
+  fake_parameter_interface->world_object_detection_rate = 20.0;
+  registerTimerCallbacks();
+  // THEN the detection timer is set to the corresponding period
+  EXPECT_CALL(*mock_detection_timer_ptr, setTimer(std::chrono::duration<double>{0.05}, _));
+  ON_CALL(*mock_clock_interface_ptr, now).WillByDefault(Return(rclcpp::Time{0, 0, RCL_ROS_TIME}));
+
+  // GIVEN Spot's WorldObject API will report a fiducial and a dock, and then a newer detection of the fiducial alone
+  ::bosdyn::api::ListWorldObjectResponse list_objects_response;
+  auto* object_fiducial = list_objects_response.add_world_objects();
+  *object_fiducial->mutable_name() = "world_obj_apriltag_3";
+  object_fiducial->set_id(98);
+  object_fiducial->mutable_acquisition_time()->set_seconds(90);
+  object_fiducial->mutable_apriltag_properties()->set_tag_id(3);
+  *object_fiducial->mutable_apriltag_properties()->mutable_frame_name_fiducial() = "fiducial_3";
+  addRootFrame(object_fiducial->mutable_transforms_snapshot(), "odom");
+  addTransform(object_fiducial->mutable_transforms_snapshot(), "fiducial_3", "odom", 1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+
+  auto* object_dock = list_objects_response.add_world_objects();
+  *object_dock->mutable_name() = "dock";
+  object_dock->set_id(99);
+  object_dock->mutable_acquisition_time()->set_seconds(100);
+  object_dock->mutable_dock_properties()->set_dock_id(520);
+  *object_dock->mutable_dock_properties()->mutable_frame_name_dock() = "dock";
+  addRootFrame(object_dock->mutable_transforms_snapshot(), "odom");
+  addTransform(object_dock->mutable_transforms_snapshot(), "dock", "odom", 2.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0);
+
+  ::bosdyn::api::ListWorldObjectResponse newer_fiducial_response;
+  *newer_fiducial_response.add_world_objects() = *object_fiducial;
+  newer_fiducial_response.mutable_world_objects(0)->mutable_acquisition_time()->set_seconds(110);
+
+  // THEN only fiducials and docks are requested, and the listings after the first one are filtered to objects acquired
+  // after the newest one seen so far
+  auto* world_object_client_interface_ptr = mock_world_object_client.get();
+  {
+    InSequence seq;
+    EXPECT_CALL(*world_object_client_interface_ptr,
+                listWorldObjects(AllOf(Property(&::bosdyn::api::ListWorldObjectRequest::object_type_size, Eq(2)),
+                                       Property(&::bosdyn::api::ListWorldObjectRequest::has_timestamp_filter, false))))
+        .WillOnce(Return(list_objects_response));
+    EXPECT_CALL(*world_object_client_interface_ptr,
+                listWorldObjects(Property(&::bosdyn::api::ListWorldObjectRequest::timestamp_filter,
+                                          Property(&google::protobuf::Timestamp::seconds, Eq(100)))))
+        .Times(2)
+        .WillOnce(Return(::bosdyn::api::ListWorldObjectResponse{}))
+        .WillOnce(Return(newer_fiducial_response));
+  }
+
+  // THEN detections are published only for the listings which contain newer acquisitions
+  std::vector<spot_msgs::msg::WorldObjectDetectionArray> published_detections;
+  EXPECT_CALL(*mock_middleware_handle_ptr, publishWorldObjectDetections)
+      .Times(2)
+      .WillRepeatedly([&](const auto& detections) { published_detections.push_back(detections); });
+
+  // GIVEN the ObjectSynchronizer has been created
+  createObjectSynchronizer();
+
+  // WHEN the timer callback to poll for detections is triggered three times
+  mock_detection_timer_ptr->trigger();
+  mock_detection_timer_ptr->trigger();
+  mock_detection_timer_ptr->trigger();
+
+  // THEN the first detections contain both objects with their poses in the prefixed preferred base frame
+  ASSERT_THAT(published_detections, SizeIs(2));
+  ASSERT_THAT(published_detections[0].detections, SizeIs(2));
+  EXPECT_THAT(published_detections[0].header.frame_id, StrEq("MyRobot/odom"));
+  EXPECT_THAT(published_detections[0].detections[0].type, Eq(spot_msgs::msg::WorldObject::TYPE_APRILTAG));
+  EXPECT_THAT(published_detections[0].detections[0].id, Eq(3));
+  EXPECT_THAT(published_detections[0].detections[0].pose.pose.position.x, Eq(1.0));
+  EXPECT_THAT(published_detections[0].detections[0].header.stamp.sec, Eq(90));
+  EXPECT_THAT(published_detections[0].detections[1].type, Eq(spot_msgs::msg::WorldObject::TYPE_DOCK));
+  EXPECT_THAT(published_detections[0].detections[1].id, Eq(520));
+  EXPECT_THAT(published_detections[0].detections[1].pose.pose.position.x, Eq(2.0));
+
+  // THEN the second detections only contain the newer detection of the fiducial
+  ASSERT_THAT(published_detections[1].detections, SizeIs(1));
+  EXPECT_THAT(published_detections[1].detections[0].object_id, Eq(98));
+  EXPECT_THAT(published_detections[1].detections[0].header.stamp.sec, Eq(110));
+}
 }  // namespace spot_ros2::test
@@ -195,6 +195,41 @@ TEST_F(RclcppParameterInterfaceEnvVarTest, GetSpotConfigFromParameters) {
   node_->declare_parameter("publish_depth", publish_depth_images_parameter);
   constexpr auto publish_depth_registered_images_parameter = false;
   node_->declare_parameter("publish_depth_registered", publish_depth_registered_images_parameter);
+  constexpr auto async_robot_state_polling_parameter = true;
+  node_->declare_parameter("async_robot_state_polling", async_robot_state_polling_parameter);
+  constexpr auto async_robot_state_polling_rate_parameter = 100.0;
+  node_->declare_parameter("async_robot_state_polling_rate", async_robot_state_polling_rate_parameter);
+  constexpr auto stream_robot_state_parameter = true;
+  node_->declare_parameter("stream_robot_state", stream_robot_state_parameter);
+  constexpr auto battery_states_publish_rate_parameter = 0.5;
+  node_->declare_parameter("battery_states_publish_rate", battery_states_publish_rate_parameter);
+  constexpr auto joint_states_publish_rate_parameter = 25.0;
+  node_->declare_parameter("joint_states_publish_rate", joint_states_publish_rate_parameter);
+  constexpr auto publish_status_on_change_parameter = true;
+  node_->declare_parameter("publish_status_on_change", publish_status_on_change_parameter);
+  constexpr auto status_heartbeat_period_parameter = 5.0;
+  node_->declare_parameter("status_heartbeat_period", status_heartbeat_period_parameter);
+  constexpr auto publish_compact_joint_states_parameter = true;
+  node_->declare_parameter("publish_compact_joint_states", publish_compact_joint_states_parameter);
+  constexpr auto compact_joint_states_publish_rate_parameter = 100.0;
+  node_->declare_parameter("compact_joint_states_publish_rate", compact_joint_states_publish_rate_parameter);
+  constexpr auto shared_memory_state_name_parameter = "/spot_robot_state";
+  node_->declare_parameter("shared_memory_state_name", shared_memory_state_name_parameter);
+  constexpr auto body_tf_extrapolation_rate_parameter = 200.0;
+  node_->declare_parameter("body_tf_extrapolation_rate", body_tf_extrapolation_rate_parameter);
+  constexpr auto body_tf_extrapolation_horizon_parameter = 0.05;
+  node_->declare_parameter("body_tf_extrapolation_horizon", body_tf_extrapolation_horizon_parameter);
+  constexpr auto world_object_sync_translation_threshold_parameter = 0.05;
+  node_->declare_parameter("world_object_sync_translation_threshold",
+                           world_object_sync_translation_threshold_parameter);
+  constexpr auto world_object_sync_rotation_threshold_parameter = 0.1;
+  node_->declare_parameter("world_object_sync_rotation_threshold", world_object_sync_rotation_threshold_parameter);
+  constexpr auto world_object_sync_on_tf_updates_parameter = true;
+  node_->declare_parameter("world_object_sync_on_tf_updates", world_object_sync_on_tf_updates_parameter);
+  constexpr auto tf_coalescing_rate_parameter = 50.0;
+  node_->declare_parameter("tf_coalescing_rate", tf_coalescing_rate_parameter);
+  constexpr auto world_object_detection_rate_parameter = 20.0;
+  node_->declare_parameter("world_object_detection_rate", world_object_detection_rate_parameter);
 
   // GIVEN we create a RclcppParameterInterface using the node
   RclcppParameterInterface parameter_interface{node_};
@@ -213,6 +248,28 @@ TEST_F(RclcppParameterInterfaceEnvVarTest, GetSpotConfigFromParameters) {
   EXPECT_THAT(parameter_interface.getPublishRGBImages(), Eq(publish_rgb_images_parameter));
   EXPECT_THAT(parameter_interface.getPublishDepthImages(), Eq(publish_depth_images_parameter));
   EXPECT_THAT(parameter_interface.getPublishDepthRegisteredImages(), Eq(publish_depth_registered_images_parameter));
+  EXPECT_THAT(parameter_interface.getAsyncRobotStatePolling(), Eq(async_robot_state_polling_parameter));
+  EXPECT_THAT(parameter_interface.getAsyncRobotStatePollingRate(), Eq(async_robot_state_polling_rate_parameter));
+  EXPECT_THAT(parameter_interface.getStreamRobotState(), Eq(stream_robot_state_parameter));
+  EXPECT_THAT(parameter_interface.getRobotStatePublishRate(RobotStateOutput::BATTERY_STATES),
+              Eq(battery_states_publish_rate_parameter));
+  EXPECT_THAT(parameter_interface.getRobotStatePublishRate(RobotStateOutput::JOINT_STATES),
+              Eq(joint_states_publish_rate_parameter));
+  EXPECT_THAT(parameter_interface.getPublishStatusOnChange(), Eq(publish_status_on_change_parameter));
+  EXPECT_THAT(parameter_interface.getStatusHeartbeatPeriod(), Eq(status_heartbeat_period_parameter));
+  EXPECT_THAT(parameter_interface.getPublishCompactJointStates(), Eq(publish_compact_joint_states_parameter));
+  EXPECT_THAT(parameter_interface.getRobotStatePublishRate(RobotStateOutput::COMPACT_JOINT_STATES),
+              Eq(compact_joint_states_publish_rate_parameter));
+  EXPECT_THAT(parameter_interface.getSharedMemoryStateName(), StrEq(shared_memory_state_name_parameter));
+  EXPECT_THAT(parameter_interface.getBodyTfExtrapolationRate(), Eq(body_tf_extrapolation_rate_parameter));
+  EXPECT_THAT(parameter_interface.getBodyTfExtrapolationHorizon(), Eq(body_tf_extrapolation_horizon_parameter));
+  EXPECT_THAT(parameter_interface.getWorldObjectSyncTranslationThreshold(),
+              Eq(world_object_sync_translation_threshold_parameter));
+  EXPECT_THAT(parameter_interface.getWorldObjectSyncRotationThreshold(),
+              Eq(world_object_sync_rotation_threshold_parameter));
+  EXPECT_THAT(parameter_interface.getWorldObjectSyncOnTfUpdates(), Eq(world_object_sync_on_tf_updates_parameter));
+  EXPECT_THAT(parameter_interface.getTfCoalescingRate(), Eq(tf_coalescing_rate_parameter));
+  EXPECT_THAT(parameter_interface.getWorldObjectDetectionRate(), Eq(world_object_detection_rate_parameter));
 }
 
 TEST_F(RclcppParameterInterfaceEnvVarTest, GetSpotConfigEnvVarsOverruleParameters) {
@@ -272,6 +329,23 @@ TEST_F(RclcppParameterInterfaceEnvVarTest, GetConfigDefaults) {
   EXPECT_THAT(parameter_interface.getPublishRGBImages(), IsTrue());
   EXPECT_THAT(parameter_interface.getPublishDepthImages(), IsTrue());
   EXPECT_THAT(parameter_interface.getPublishDepthRegisteredImages(), IsTrue());
+  EXPECT_THAT(parameter_interface.getAsyncRobotStatePolling(), IsFalse());
+  EXPECT_THAT(parameter_interface.getAsyncRobotStatePollingRate(), Eq(50.0));
+  EXPECT_THAT(parameter_interface.getStreamRobotState(), IsFalse());
+  EXPECT_THAT(parameter_interface.getRobotStatePublishRate(RobotStateOutput::BATTERY_STATES), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getRobotStatePublishRate(RobotStateOutput::ESTOP_STATES), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getRobotStatePublishRate(RobotStateOutput::JOINT_STATES), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getPublishStatusOnChange(), IsFalse());
+  EXPECT_THAT(parameter_interface.getStatusHeartbeatPeriod(), Eq(1.0));
+  EXPECT_THAT(parameter_interface.getPublishCompactJointStates(), IsFalse());
+  EXPECT_THAT(parameter_interface.getSharedMemoryStateName(), StrEq(""));
+  EXPECT_THAT(parameter_interface.getBodyTfExtrapolationRate(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getBodyTfExtrapolationHorizon(), Eq(0.1));
+  EXPECT_THAT(parameter_interface.getWorldObjectSyncTranslationThreshold(), Eq(0.01));
+  EXPECT_THAT(parameter_interface.getWorldObjectSyncRotationThreshold(), Eq(0.01));
+  EXPECT_THAT(parameter_interface.getWorldObjectSyncOnTfUpdates(), IsFalse());
+  EXPECT_THAT(parameter_interface.getTfCoalescingRate(), Eq(0.0));
+  EXPECT_THAT(parameter_interface.getWorldObjectDetectionRate(), Eq(0.0));
 }
 
 TEST_F(RclcppParameterInterfaceEnvVarTest, GetCamerasUsedDefaultWithArm) {